@@ -141,6 +141,29 @@ extern "C" {
  */
 #define SDL_HINT_RENDER_VSYNC               "SDL_RENDER_VSYNC"
 
+/**
+ *  \brief  A variable controlling whether renderers collect render statistics.
+ *
+ *  This variable can be set to the following values:
+ *    "0"       - Don't collect statistics
+ *    "1"       - Collect statistics, reset on every SDL_RenderPresent()
+ *    "2"       - Collect statistics, accumulate until SDL_RenderResetStats()
+ *
+ *  By default statistics are not collected.
+ *
+ *  This variable is checked by SDL_CreateRenderer().
+ */
+#define SDL_HINT_RENDER_STATS               "SDL_RENDER_STATS"
+
+/**
+ *  \brief  A variable naming a file that renderers write a chrome://tracing trace of their backend calls to.
+ *
+ *  By default no trace is written.
+ *
+ *  This variable is checked by SDL_CreateRenderer().
+ */
+#define SDL_HINT_RENDER_TRACE               "SDL_RENDER_TRACE"
+
 /**
  *  \brief  A variable controlling whether the screensaver is enabled. 
  *
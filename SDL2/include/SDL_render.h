@@ -846,6 +846,122 @@ extern DECLSPEC void SDLCALL SDL_DestroyTexture(SDL_Texture * texture);
  */
 extern DECLSPEC void SDLCALL SDL_DestroyRenderer(SDL_Renderer * renderer);
 
+/**
+ *  \brief The renderer backend entry points tracked by the render statistics.
+ *
+ *  \sa SDL_RenderStats
+ */
+typedef enum
+{
+    SDL_RENDERSTAT_CREATETEXTURE,
+    SDL_RENDERSTAT_DESTROYTEXTURE,
+    SDL_RENDERSTAT_UPDATETEXTURE,
+    SDL_RENDERSTAT_LOCKTEXTURE,
+    SDL_RENDERSTAT_UNLOCKTEXTURE,
+    SDL_RENDERSTAT_TEXTURESTATE,    /**< Texture color, alpha and blend mode */
+    SDL_RENDERSTAT_SETRENDERTARGET,
+    SDL_RENDERSTAT_UPDATEVIEWPORT,
+    SDL_RENDERSTAT_UPDATECLIPRECT,
+    SDL_RENDERSTAT_CLEAR,
+    SDL_RENDERSTAT_DRAWPOINTS,
+    SDL_RENDERSTAT_DRAWLINES,
+    SDL_RENDERSTAT_FILLRECTS,
+    SDL_RENDERSTAT_COPY,
+    SDL_RENDERSTAT_COPYEX,
+    SDL_RENDERSTAT_READPIXELS,
+    SDL_RENDERSTAT_PRESENT,
+    SDL_RENDERSTAT_NUM_CALLS
+} SDL_RenderStatCall;
+
+/**
+ *  \brief Counters collected by a renderer with statistics enabled.
+ *
+ *  Calls are counted as they reach the backend, so SDL_RenderDrawRect()
+ *  shows up as a SDL_RENDERSTAT_DRAWLINES call (or fill calls when the
+ *  render scale is not 1).
+ *
+ *  \sa SDL_RenderGetStats()
+ */
+typedef struct SDL_RenderStats
+{
+    Uint32 frames;              /**< SDL_RenderPresent() calls covered */
+    Uint32 draw_calls;          /**< Clear, point, line, fill and copy calls */
+    Uint32 state_changes;       /**< Draw color and blend mode, texture modulation and blend mode, viewport, clip rect, scale and target changes */
+    Uint32 textures_created;
+    Uint32 textures_destroyed;
+    Uint32 texture_uploads;     /**< Texture updates and unlocks */
+    Uint64 bytes_uploaded;
+    Uint32 calls[SDL_RENDERSTAT_NUM_CALLS];     /**< Backend calls per entry point */
+    Uint64 time_ns[SDL_RENDERSTAT_NUM_CALLS];   /**< Nanoseconds spent in each entry point */
+} SDL_RenderStats;
+
+/**
+ *  \brief Turn render statistics on or off for a renderer.
+ *
+ *  \param renderer The renderer to instrument.
+ *  \param enabled SDL_TRUE to start counting, SDL_FALSE to stop.
+ *  \param reset_on_present SDL_TRUE to have SDL_RenderGetStats() report the
+ *                          last presented frame, SDL_FALSE to accumulate until
+ *                          SDL_RenderResetStats() is called.
+ *
+ *  \return 0 on success, or -1 on error
+ *
+ *  Statistics can also be enabled for every renderer created by
+ *  SDL_CreateRenderer() with the SDL_HINT_RENDER_STATS hint.
+ *
+ *  \sa SDL_RenderGetStats()
+ */
+extern DECLSPEC int SDLCALL SDL_RenderSetStatsEnabled(SDL_Renderer * renderer,
+                                                      SDL_bool enabled,
+                                                      SDL_bool reset_on_present);
+
+/**
+ *  \brief Get the render statistics for a renderer.
+ *
+ *  \param renderer The renderer to query.
+ *  \param stats A pointer filled in with the counters for the last presented
+ *               frame, or the running totals if statistics are not reset on
+ *               present.
+ *
+ *  \return 0 on success, or -1 on error
+ */
+extern DECLSPEC int SDLCALL SDL_RenderGetStats(SDL_Renderer * renderer,
+                                               SDL_RenderStats * stats);
+
+/**
+ *  \brief Reset all render statistics of a renderer to zero.
+ *
+ *  \return 0 on success, or -1 on error
+ */
+extern DECLSPEC int SDLCALL SDL_RenderResetStats(SDL_Renderer * renderer);
+
+/**
+ *  \brief Start writing every backend call of a renderer to a trace file.
+ *
+ *  \param renderer The renderer to trace.
+ *  \param file The file to write, in the Trace Event JSON format understood
+ *              by chrome://tracing.
+ *
+ *  \return 0 on success, or -1 if the file couldn't be opened
+ *
+ *  A trace in progress is finished first. Tracing can also be started for
+ *  every renderer created by SDL_CreateRenderer() with the
+ *  SDL_HINT_RENDER_TRACE hint.
+ *
+ *  \sa SDL_RenderStopTrace()
+ */
+extern DECLSPEC int SDLCALL SDL_RenderStartTrace(SDL_Renderer * renderer,
+                                                 const char *file);
+
+/**
+ *  \brief Finish and close the trace file of a renderer.
+ *
+ *  \return 0 on success, or -1 on error
+ *
+ *  \sa SDL_RenderStartTrace()
+ */
+extern DECLSPEC int SDLCALL SDL_RenderStopTrace(SDL_Renderer * renderer);
+
 
 /**
  *  \brief Bind the texture to the current OpenGL/ES/ES2 context for use with
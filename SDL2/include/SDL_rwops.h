@@ -45,6 +45,7 @@ extern "C" {
 #define SDL_RWOPS_JNIFILE   3   /* Android asset */
 #define SDL_RWOPS_MEMORY    4   /* Memory stream */
 #define SDL_RWOPS_MEMORY_RO 5   /* Read-Only memory stream */
+#define SDL_RWOPS_MAPPED    6   /* Read-Only memory-mapped file */
 
 /**
  * This is the read/write operation structure -- very basic.
@@ -165,6 +166,26 @@ extern DECLSPEC SDL_RWops *SDLCALL SDL_RWFromMem(void *mem, int size);
 extern DECLSPEC SDL_RWops *SDLCALL SDL_RWFromConstMem(const void *mem,
                                                       int size);
 
+/**
+ *  Open a file for reading through a memory mapping of it, so code that
+ *  knows about memory streams can read it in place with
+ *  SDL_RWGetMemory().  Where files can't be mapped, the file is read
+ *  into memory instead.
+ */
+extern DECLSPEC SDL_RWops *SDLCALL SDL_RWFromFileMapped(const char *file);
+
+/**
+ *  Get the memory a memory stream or memory-mapped file reads from.
+ *
+ *  \param context The stream
+ *  \param size    Filled in with the size of the data, may be NULL
+ *
+ *  \return the start of the data, valid until the stream is closed, or
+ *          NULL if the stream isn't read from memory.
+ */
+extern DECLSPEC const void *SDLCALL SDL_RWGetMemory(SDL_RWops * context,
+                                                    size_t * size);
+
 /* @} *//* RWFrom functions */
 
 
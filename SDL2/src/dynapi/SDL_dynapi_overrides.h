@@ -597,3 +597,10 @@
 #define SDL_JoystickCurrentPowerLevel SDL_JoystickCurrentPowerLevel_REAL
 #define SDL_GameControllerFromInstanceID SDL_GameControllerFromInstanceID_REAL
 #define SDL_JoystickFromInstanceID SDL_JoystickFromInstanceID_REAL
+#define SDL_RenderSetStatsEnabled SDL_RenderSetStatsEnabled_REAL
+#define SDL_RenderGetStats SDL_RenderGetStats_REAL
+#define SDL_RenderResetStats SDL_RenderResetStats_REAL
+#define SDL_RenderStartTrace SDL_RenderStartTrace_REAL
+#define SDL_RenderStopTrace SDL_RenderStopTrace_REAL
+#define SDL_RWFromFileMapped SDL_RWFromFileMapped_REAL
+#define SDL_RWGetMemory SDL_RWGetMemory_REAL
@@ -631,3 +631,10 @@ SDL_DYNAPI_PROC(int,SDL_GetDisplayDPI,(int a, float *b, float *c, float *d),(a,b
 SDL_DYNAPI_PROC(SDL_JoystickPowerLevel,SDL_JoystickCurrentPowerLevel,(SDL_Joystick *a),(a),return)
 SDL_DYNAPI_PROC(SDL_GameController*,SDL_GameControllerFromInstanceID,(SDL_JoystickID a),(a),return)
 SDL_DYNAPI_PROC(SDL_Joystick*,SDL_JoystickFromInstanceID,(SDL_JoystickID a),(a),return)
+SDL_DYNAPI_PROC(int,SDL_RenderSetStatsEnabled,(SDL_Renderer *a, SDL_bool b, SDL_bool c),(a,b,c),return)
+SDL_DYNAPI_PROC(int,SDL_RenderGetStats,(SDL_Renderer *a, SDL_RenderStats *b),(a,b),return)
+SDL_DYNAPI_PROC(int,SDL_RenderResetStats,(SDL_Renderer *a),(a),return)
+SDL_DYNAPI_PROC(int,SDL_RenderStartTrace,(SDL_Renderer *a, const char *b),(a,b),return)
+SDL_DYNAPI_PROC(int,SDL_RenderStopTrace,(SDL_Renderer *a),(a),return)
+SDL_DYNAPI_PROC(SDL_RWops*,SDL_RWFromFileMapped,(const char *a),(a),return)
+SDL_DYNAPI_PROC(const void*,SDL_RWGetMemory,(SDL_RWops *a, size_t *b),(a,b),return)
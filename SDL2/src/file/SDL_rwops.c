@@ -47,6 +47,19 @@
 #include "nacl_io/nacl_io.h"
 #endif
 
+#if defined(__WIN32__) && !defined(__WINRT__)
+#define HAVE_MAPPED_FILES 1
+#elif defined(__LINUX__) || defined(__ANDROID__) || defined(__MACOSX__) || \
+      defined(__IPHONEOS__) || defined(__FREEBSD__) || defined(__NETBSD__) || \
+      defined(__OPENBSD__) || defined(__BSDI__) || defined(__QNXNTO__) || \
+      defined(__HAIKU__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define HAVE_MAPPED_FILES 1
+#endif
+
 #ifdef __WIN32__
 
 /* Functions to read/write Win32 API file pointers */
@@ -459,6 +472,110 @@ mem_close(SDL_RWops * context)
     return 0;
 }
 
+/* Functions to read mapped files, which are read-only memory streams that
+   let go of their memory when closed */
+
+#ifdef HAVE_MAPPED_FILES
+#ifdef __WIN32__
+static void *
+map_file(const char *file, size_t * size)
+{
+    UINT old_error_mode;
+    HANDLE h, mapping;
+    LARGE_INTEGER length;
+    void *base = NULL;
+
+    /* Do not open a dialog box if failure */
+    old_error_mode =
+        SetErrorMode(SEM_NOOPENFILEERRORBOX | SEM_FAILCRITICALERRORS);
+
+    {
+        LPTSTR tstr = WIN_UTF8ToString(file);
+        h = CreateFile(tstr, GENERIC_READ, FILE_SHARE_READ, NULL,
+                       OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        SDL_free(tstr);
+    }
+
+    /* restore old behavior */
+    SetErrorMode(old_error_mode);
+
+    if (h == INVALID_HANDLE_VALUE) {
+        return NULL;
+    }
+    /* Empty files can't be mapped */
+    if (GetFileSizeEx(h, &length) && length.QuadPart > 0 &&
+        (Uint64) length.QuadPart <= (size_t) -1) {
+        mapping = CreateFileMapping(h, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping) {
+            base = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            *size = (size_t) length.QuadPart;
+            /* The view keeps the mapping open */
+            CloseHandle(mapping);
+        }
+    }
+    CloseHandle(h);
+    return base;
+}
+
+static int SDLCALL
+mapped_close(SDL_RWops * context)
+{
+    if (context) {
+        UnmapViewOfFile(context->hidden.mem.base);
+        SDL_FreeRW(context);
+    }
+    return 0;
+}
+#else
+static void *
+map_file(const char *file, size_t * size)
+{
+    struct stat st;
+    void *base = NULL;
+    int fd;
+
+    fd = open(file, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+    /* Empty files can't be mapped */
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0 &&
+        (Uint64) st.st_size <= (size_t) -1) {
+        base = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (base == MAP_FAILED) {
+            base = NULL;
+        } else {
+            *size = (size_t) st.st_size;
+        }
+    }
+    /* The mapping stays after the file is closed */
+    close(fd);
+    return base;
+}
+
+static int SDLCALL
+mapped_close(SDL_RWops * context)
+{
+    if (context) {
+        munmap(context->hidden.mem.base,
+               context->hidden.mem.stop - context->hidden.mem.base);
+        SDL_FreeRW(context);
+    }
+    return 0;
+}
+#endif /* __WIN32__ */
+#endif /* HAVE_MAPPED_FILES */
+
+static int SDLCALL
+loaded_close(SDL_RWops * context)
+{
+    if (context) {
+        SDL_free(context->hidden.mem.base);
+        SDL_FreeRW(context);
+    }
+    return 0;
+}
+
 
 /* Functions to create SDL_RWops structures from various data sources */
 
@@ -633,6 +750,94 @@ SDL_RWFromConstMem(const void *mem, int size)
     return rwops;
 }
 
+SDL_RWops *
+SDL_RWFromFileMapped(const char *file)
+{
+    SDL_RWops *rwops = NULL;
+    Uint8 *base = NULL;
+    size_t size = 0;
+
+    if (!file || !*file) {
+        SDL_SetError("SDL_RWFromFileMapped(): No file specified");
+        return NULL;
+    }
+
+    rwops = SDL_AllocRW();
+    if (!rwops)
+        return NULL;            /* SDL_SetError already setup by SDL_AllocRW() */
+    rwops->close = loaded_close;
+
+#ifdef HAVE_MAPPED_FILES
+    base = (Uint8 *) map_file(file, &size);
+    if (base) {
+        rwops->close = mapped_close;
+    }
+#endif
+    if (!base) {
+        /* Read the whole file through a regular stream instead */
+        SDL_RWops *src = SDL_RWFromFile(file, "rb");
+        Sint64 length;
+
+        if (!src) {
+            SDL_FreeRW(rwops);
+            return NULL;
+        }
+        length = SDL_RWsize(src);
+        if (length < 0 || (Uint64) length > (size_t) -1) {
+            SDL_SetError("Couldn't get the size of %s", file);
+            SDL_RWclose(src);
+            SDL_FreeRW(rwops);
+            return NULL;
+        }
+        size = (size_t) length;
+        base = (Uint8 *) SDL_malloc(size ? size : 1);
+        if (!base) {
+            SDL_OutOfMemory();
+            SDL_RWclose(src);
+            SDL_FreeRW(rwops);
+            return NULL;
+        }
+        if (size && SDL_RWread(src, base, size, 1) != 1) {
+            SDL_SetError("Couldn't read %s", file);
+            SDL_free(base);
+            SDL_RWclose(src);
+            SDL_FreeRW(rwops);
+            return NULL;
+        }
+        SDL_RWclose(src);
+    }
+
+    rwops->size = mem_size;
+    rwops->seek = mem_seek;
+    rwops->read = mem_read;
+    rwops->write = mem_writeconst;
+    rwops->hidden.mem.base = base;
+    rwops->hidden.mem.here = base;
+    rwops->hidden.mem.stop = base + size;
+    rwops->type = SDL_RWOPS_MAPPED;
+    return rwops;
+}
+
+const void *
+SDL_RWGetMemory(SDL_RWops * context, size_t * size)
+{
+    if (!context) {
+        SDL_InvalidParamError("context");
+        return NULL;
+    }
+    switch (context->type) {
+    case SDL_RWOPS_MEMORY:
+    case SDL_RWOPS_MEMORY_RO:
+    case SDL_RWOPS_MAPPED:
+        if (size) {
+            *size = (size_t) (context->hidden.mem.stop - context->hidden.mem.base);
+        }
+        return context->hidden.mem.base;
+    default:
+        return NULL;
+    }
+}
+
 SDL_RWops *
 SDL_AllocRW(void)
 {
@@ -25,6 +25,7 @@
 #include "SDL_assert.h"
 #include "SDL_hints.h"
 #include "SDL_log.h"
+#include "SDL_timer.h"
 #include "SDL_render.h"
 #include "SDL_sysrender.h"
 #include "software/SDL_render_sw_c.h"
@@ -77,6 +78,135 @@ static char texture_magic;
 
 static int UpdateLogicalSize(SDL_Renderer *renderer);
 
+static const char *render_stat_names[SDL_RENDERSTAT_NUM_CALLS] = {
+    "CreateTexture",
+    "DestroyTexture",
+    "UpdateTexture",
+    "LockTexture",
+    "UnlockTexture",
+    "TextureState",
+    "SetRenderTarget",
+    "UpdateViewport",
+    "UpdateClipRect",
+    "RenderClear",
+    "RenderDrawPoints",
+    "RenderDrawLines",
+    "RenderFillRects",
+    "RenderCopy",
+    "RenderCopyEx",
+    "RenderReadPixels",
+    "RenderPresent"
+};
+
+/* Start timing a backend call, returns 0 when nobody is watching */
+static SDL_INLINE Uint64
+RenderStatsBegin(SDL_Renderer *renderer)
+{
+    if (renderer->stats_enabled || renderer->trace) {
+        return SDL_GetPerformanceCounter();
+    }
+    return 0;
+}
+
+static void
+RenderTraceWrite(SDL_Renderer *renderer, const char *event)
+{
+    if (!renderer->trace_empty) {
+        SDL_RWwrite(renderer->trace, ",\n", 2, 1);
+    }
+    SDL_RWwrite(renderer->trace, event, SDL_strlen(event), 1);
+    renderer->trace_empty = SDL_FALSE;
+}
+
+static double
+RenderTraceMicroseconds(Uint64 ticks)
+{
+    return (double)ticks * 1000000.0 / (double)SDL_GetPerformanceFrequency();
+}
+
+/* Finish timing a backend call started with RenderStatsBegin() */
+static void
+RenderStatsEnd(SDL_Renderer *renderer, SDL_RenderStatCall call, Uint64 start)
+{
+    Uint64 end;
+
+    if (!start) {
+        return;
+    }
+    end = SDL_GetPerformanceCounter();
+
+    if (renderer->stats_enabled) {
+        ++renderer->stats.calls[call];
+        renderer->stats.time_ns[call] += end - start;
+        switch (call) {
+        case SDL_RENDERSTAT_CLEAR:
+        case SDL_RENDERSTAT_DRAWPOINTS:
+        case SDL_RENDERSTAT_DRAWLINES:
+        case SDL_RENDERSTAT_FILLRECTS:
+        case SDL_RENDERSTAT_COPY:
+        case SDL_RENDERSTAT_COPYEX:
+            ++renderer->stats.draw_calls;
+            break;
+        default:
+            break;
+        }
+    }
+    if (renderer->trace) {
+        char event[160];
+
+        SDL_snprintf(event, sizeof(event),
+                     "{\"name\":\"%s\",\"cat\":\"render\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f}",
+                     render_stat_names[call],
+                     RenderTraceMicroseconds(start - renderer->trace_start),
+                     RenderTraceMicroseconds(end - start));
+        RenderTraceWrite(renderer, event);
+    }
+}
+
+static SDL_INLINE void
+RenderStatsStateChange(SDL_Renderer *renderer)
+{
+    if (renderer->stats_enabled) {
+        ++renderer->stats.state_changes;
+    }
+}
+
+static SDL_INLINE void
+RenderStatsUpload(SDL_Renderer *renderer, Uint64 bytes)
+{
+    if (renderer->stats_enabled) {
+        ++renderer->stats.texture_uploads;
+        renderer->stats.bytes_uploaded += bytes;
+    }
+}
+
+/* Close a frame: emit a counter event and roll the frame statistics over */
+static void
+RenderStatsPresent(SDL_Renderer *renderer)
+{
+    if (!renderer->stats_enabled) {
+        return;
+    }
+    ++renderer->stats.frames;
+
+    if (renderer->trace) {
+        char event[256];
+
+        SDL_snprintf(event, sizeof(event),
+                     "{\"name\":\"frame\",\"cat\":\"render\",\"ph\":\"C\",\"pid\":1,\"tid\":1,\"ts\":%.3f,"
+                     "\"args\":{\"draw_calls\":%u,\"state_changes\":%u,\"texture_uploads\":%u,\"textures_created\":%u}}",
+                     RenderTraceMicroseconds(SDL_GetPerformanceCounter() - renderer->trace_start),
+                     renderer->stats.draw_calls, renderer->stats.state_changes,
+                     renderer->stats.texture_uploads, renderer->stats.textures_created);
+        RenderTraceWrite(renderer, event);
+    }
+
+    if (renderer->stats_reset_on_present) {
+        renderer->stats_frame = renderer->stats;
+        SDL_zero(renderer->stats);
+    }
+}
+
 int
 SDL_GetNumRenderDrivers(void)
 {
@@ -303,6 +433,15 @@ SDL_CreateRenderer(SDL_Window * window, int index, Uint32 flags)
 
         SDL_AddEventWatch(SDL_RendererEventWatch, renderer);
 
+        hint = SDL_GetHint(SDL_HINT_RENDER_STATS);
+        if (hint && *hint != '0') {
+            SDL_RenderSetStatsEnabled(renderer, SDL_TRUE, (*hint == '2') ? SDL_FALSE : SDL_TRUE);
+        }
+        hint = SDL_GetHint(SDL_HINT_RENDER_TRACE);
+        if (hint && *hint) {
+            SDL_RenderStartTrace(renderer, hint);
+        }
+
         SDL_LogInfo(SDL_LOG_CATEGORY_RENDER,
                     "Created renderer: %s", renderer->info.name);
     }
@@ -411,6 +550,8 @@ SDL_Texture *
 SDL_CreateTexture(SDL_Renderer * renderer, Uint32 format, int access, int w, int h)
 {
     SDL_Texture *texture;
+    Uint64 start;
+    int status;
 
     CHECK_RENDERER_MAGIC(renderer, NULL);
 
@@ -456,10 +597,16 @@ SDL_CreateTexture(SDL_Renderer * renderer, Uint32 format, int access, int w, int
     renderer->textures = texture;
 
     if (IsSupportedFormat(renderer, format)) {
-        if (renderer->CreateTexture(renderer, texture) < 0) {
+        start = RenderStatsBegin(renderer);
+        status = renderer->CreateTexture(renderer, texture);
+        RenderStatsEnd(renderer, SDL_RENDERSTAT_CREATETEXTURE, start);
+        if (status < 0) {
             SDL_DestroyTexture(texture);
             return NULL;
         }
+        if (renderer->stats_enabled) {
+            ++renderer->stats.textures_created;
+        }
     } else {
         texture->native = SDL_CreateTexture(renderer,
                                 GetClosestSupportedFormat(renderer, format),
@@ -618,6 +765,9 @@ SDL_SetTextureColorMod(SDL_Texture * texture, Uint8 r, Uint8 g, Uint8 b)
     CHECK_TEXTURE_MAGIC(texture, -1);
 
     renderer = texture->renderer;
+    if (r != texture->r || g != texture->g || b != texture->b) {
+        RenderStatsStateChange(renderer);
+    }
     if (r < 255 || g < 255 || b < 255) {
         texture->modMode |= SDL_TEXTUREMODULATE_COLOR;
     } else {
@@ -629,7 +779,10 @@ SDL_SetTextureColorMod(SDL_Texture * texture, Uint8 r, Uint8 g, Uint8 b)
     if (texture->native) {
         return SDL_SetTextureColorMod(texture->native, r, g, b);
     } else if (renderer->SetTextureColorMod) {
-        return renderer->SetTextureColorMod(renderer, texture);
+        Uint64 start = RenderStatsBegin(renderer);
+        int status = renderer->SetTextureColorMod(renderer, texture);
+        RenderStatsEnd(renderer, SDL_RENDERSTAT_TEXTURESTATE, start);
+        return status;
     } else {
         return 0;
     }
@@ -661,6 +814,9 @@ SDL_SetTextureAlphaMod(SDL_Texture * texture, Uint8 alpha)
     CHECK_TEXTURE_MAGIC(texture, -1);
 
     renderer = texture->renderer;
+    if (alpha != texture->a) {
+        RenderStatsStateChange(renderer);
+    }
     if (alpha < 255) {
         texture->modMode |= SDL_TEXTUREMODULATE_ALPHA;
     } else {
@@ -670,7 +826,10 @@ SDL_SetTextureAlphaMod(SDL_Texture * texture, Uint8 alpha)
     if (texture->native) {
         return SDL_SetTextureAlphaMod(texture->native, alpha);
     } else if (renderer->SetTextureAlphaMod) {
-        return renderer->SetTextureAlphaMod(renderer, texture);
+        Uint64 start = RenderStatsBegin(renderer);
+        int status = renderer->SetTextureAlphaMod(renderer, texture);
+        RenderStatsEnd(renderer, SDL_RENDERSTAT_TEXTURESTATE, start);
+        return status;
     } else {
         return 0;
     }
@@ -695,11 +854,17 @@ SDL_SetTextureBlendMode(SDL_Texture * texture, SDL_BlendMode blendMode)
     CHECK_TEXTURE_MAGIC(texture, -1);
 
     renderer = texture->renderer;
+    if (blendMode != texture->blendMode) {
+        RenderStatsStateChange(renderer);
+    }
     texture->blendMode = blendMode;
     if (texture->native) {
         return SDL_SetTextureBlendMode(texture->native, blendMode);
     } else if (renderer->SetTextureBlendMode) {
-        return renderer->SetTextureBlendMode(renderer, texture);
+        Uint64 start = RenderStatsBegin(renderer);
+        int status = renderer->SetTextureBlendMode(renderer, texture);
+        RenderStatsEnd(renderer, SDL_RENDERSTAT_TEXTURESTATE, start);
+        return status;
     } else {
         return 0;
     }
@@ -830,8 +995,15 @@ SDL_UpdateTexture(SDL_Texture * texture, const SDL_Rect * rect,
     } else if (texture->native) {
         return SDL_UpdateTextureNative(texture, rect, pixels, pitch);
     } else {
+        Uint64 start;
+        int status;
+
         renderer = texture->renderer;
-        return renderer->UpdateTexture(renderer, texture, rect, pixels, pitch);
+        start = RenderStatsBegin(renderer);
+        status = renderer->UpdateTexture(renderer, texture, rect, pixels, pitch);
+        RenderStatsEnd(renderer, SDL_RENDERSTAT_UPDATETEXTURE, start);
+        RenderStatsUpload(renderer, (Uint64)rect->w * rect->h * SDL_BYTESPERPIXEL(texture->format));
+        return status;
     }
 }
 
@@ -932,7 +1104,12 @@ int SDL_UpdateYUVTexture(SDL_Texture * texture, const SDL_Rect * rect,
         renderer = texture->renderer;
         SDL_assert(renderer->UpdateTextureYUV);
         if (renderer->UpdateTextureYUV) {
-            return renderer->UpdateTextureYUV(renderer, texture, rect, Yplane, Ypitch, Uplane, Upitch, Vplane, Vpitch);
+            Uint64 start = RenderStatsBegin(renderer);
+            int status = renderer->UpdateTextureYUV(renderer, texture, rect, Yplane, Ypitch, Uplane, Upitch, Vplane, Vpitch);
+            RenderStatsEnd(renderer, SDL_RENDERSTAT_UPDATETEXTURE, start);
+            /* Y plane plus two quarter size chroma planes */
+            RenderStatsUpload(renderer, (Uint64)rect->w * rect->h * 3 / 2);
+            return status;
         } else {
             return SDL_Unsupported();
         }
@@ -984,8 +1161,16 @@ SDL_LockTexture(SDL_Texture * texture, const SDL_Rect * rect,
     } else if (texture->native) {
         return SDL_LockTextureNative(texture, rect, pixels, pitch);
     } else {
+        Uint64 start;
+        int status;
+
         renderer = texture->renderer;
-        return renderer->LockTexture(renderer, texture, rect, pixels, pitch);
+        /* Remembered for the upload statistics on unlock */
+        texture->locked_rect = *rect;
+        start = RenderStatsBegin(renderer);
+        status = renderer->LockTexture(renderer, texture, rect, pixels, pitch);
+        RenderStatsEnd(renderer, SDL_RENDERSTAT_LOCKTEXTURE, start);
+        return status;
     }
 }
 
@@ -1046,8 +1231,13 @@ SDL_UnlockTexture(SDL_Texture * texture)
     } else if (texture->native) {
         SDL_UnlockTextureNative(texture);
     } else {
+        Uint64 start;
+
         renderer = texture->renderer;
+        start = RenderStatsBegin(renderer);
         renderer->UnlockTexture(renderer, texture);
+        RenderStatsEnd(renderer, SDL_RENDERSTAT_UNLOCKTEXTURE, start);
+        RenderStatsUpload(renderer, (Uint64)texture->locked_rect.w * texture->locked_rect.h * SDL_BYTESPERPIXEL(texture->format));
     }
 }
 
@@ -1063,6 +1253,9 @@ SDL_RenderTargetSupported(SDL_Renderer *renderer)
 int
 SDL_SetRenderTarget(SDL_Renderer *renderer, SDL_Texture *texture)
 {
+    Uint64 start;
+    int status;
+
     if (!SDL_RenderTargetSupported(renderer)) {
         return SDL_Unsupported();
     }
@@ -1096,8 +1289,12 @@ SDL_SetRenderTarget(SDL_Renderer *renderer, SDL_Texture *texture)
         renderer->logical_h_backup = renderer->logical_h;
     }
     renderer->target = texture;
+    RenderStatsStateChange(renderer);
 
-    if (renderer->SetRenderTarget(renderer, texture) < 0) {
+    start = RenderStatsBegin(renderer);
+    status = renderer->SetRenderTarget(renderer, texture);
+    RenderStatsEnd(renderer, SDL_RENDERSTAT_SETRENDERTARGET, start);
+    if (status < 0) {
         return -1;
     }
 
@@ -1118,10 +1315,16 @@ SDL_SetRenderTarget(SDL_Renderer *renderer, SDL_Texture *texture)
         renderer->logical_w = renderer->logical_w_backup;
         renderer->logical_h = renderer->logical_h_backup;
     }
-    if (renderer->UpdateViewport(renderer) < 0) {
+    start = RenderStatsBegin(renderer);
+    status = renderer->UpdateViewport(renderer);
+    RenderStatsEnd(renderer, SDL_RENDERSTAT_UPDATEVIEWPORT, start);
+    if (status < 0) {
         return -1;
     }
-    if (renderer->UpdateClipRect(renderer) < 0) {
+    start = RenderStatsBegin(renderer);
+    status = renderer->UpdateClipRect(renderer);
+    RenderStatsEnd(renderer, SDL_RENDERSTAT_UPDATECLIPRECT, start);
+    if (status < 0) {
         return -1;
     }
 
@@ -1218,8 +1421,14 @@ SDL_RenderGetLogicalSize(SDL_Renderer * renderer, int *w, int *h)
 int
 SDL_RenderSetViewport(SDL_Renderer * renderer, const SDL_Rect * rect)
 {
+    SDL_Rect viewport;
+    Uint64 start;
+    int status;
+
     CHECK_RENDERER_MAGIC(renderer, -1);
 
+    viewport = renderer->viewport;
+
     if (rect) {
         renderer->viewport.x = (int)SDL_floor(rect->x * renderer->scale.x);
         renderer->viewport.y = (int)SDL_floor(rect->y * renderer->scale.y);
@@ -1232,7 +1441,13 @@ SDL_RenderSetViewport(SDL_Renderer * renderer, const SDL_Rect * rect)
             return -1;
         }
     }
-    return renderer->UpdateViewport(renderer);
+    if (SDL_memcmp(&viewport, &renderer->viewport, sizeof(viewport)) != 0) {
+        RenderStatsStateChange(renderer);
+    }
+    start = RenderStatsBegin(renderer);
+    status = renderer->UpdateViewport(renderer);
+    RenderStatsEnd(renderer, SDL_RENDERSTAT_UPDATEVIEWPORT, start);
+    return status;
 }
 
 void
@@ -1251,8 +1466,16 @@ SDL_RenderGetViewport(SDL_Renderer * renderer, SDL_Rect * rect)
 int
 SDL_RenderSetClipRect(SDL_Renderer * renderer, const SDL_Rect * rect)
 {
+    SDL_Rect clip_rect;
+    SDL_bool clipping_enabled;
+    Uint64 start;
+    int status;
+
     CHECK_RENDERER_MAGIC(renderer, -1)
 
+    clip_rect = renderer->clip_rect;
+    clipping_enabled = renderer->clipping_enabled;
+
     if (rect) {
         renderer->clipping_enabled = SDL_TRUE;
         renderer->clip_rect.x = (int)SDL_floor(rect->x * renderer->scale.x);
@@ -1263,7 +1486,14 @@ SDL_RenderSetClipRect(SDL_Renderer * renderer, const SDL_Rect * rect)
         renderer->clipping_enabled = SDL_FALSE;
         SDL_zero(renderer->clip_rect);
     }
-    return renderer->UpdateClipRect(renderer);
+    if (clipping_enabled != renderer->clipping_enabled ||
+        SDL_memcmp(&clip_rect, &renderer->clip_rect, sizeof(clip_rect)) != 0) {
+        RenderStatsStateChange(renderer);
+    }
+    start = RenderStatsBegin(renderer);
+    status = renderer->UpdateClipRect(renderer);
+    RenderStatsEnd(renderer, SDL_RENDERSTAT_UPDATECLIPRECT, start);
+    return status;
 }
 
 void
@@ -1291,6 +1521,9 @@ SDL_RenderSetScale(SDL_Renderer * renderer, float scaleX, float scaleY)
 {
     CHECK_RENDERER_MAGIC(renderer, -1);
 
+    if (scaleX != renderer->scale.x || scaleY != renderer->scale.y) {
+        RenderStatsStateChange(renderer);
+    }
     renderer->scale.x = scaleX;
     renderer->scale.y = scaleY;
     return 0;
@@ -1315,6 +1548,9 @@ SDL_SetRenderDrawColor(SDL_Renderer * renderer,
 {
     CHECK_RENDERER_MAGIC(renderer, -1);
 
+    if (r != renderer->r || g != renderer->g || b != renderer->b || a != renderer->a) {
+        RenderStatsStateChange(renderer);
+    }
     renderer->r = r;
     renderer->g = g;
     renderer->b = b;
@@ -1348,6 +1584,9 @@ SDL_SetRenderDrawBlendMode(SDL_Renderer * renderer, SDL_BlendMode blendMode)
 {
     CHECK_RENDERER_MAGIC(renderer, -1);
 
+    if (blendMode != renderer->blendMode) {
+        RenderStatsStateChange(renderer);
+    }
     renderer->blendMode = blendMode;
     return 0;
 }
@@ -1364,13 +1603,19 @@ SDL_GetRenderDrawBlendMode(SDL_Renderer * renderer, SDL_BlendMode *blendMode)
 int
 SDL_RenderClear(SDL_Renderer * renderer)
 {
+    Uint64 start;
+    int status;
+
     CHECK_RENDERER_MAGIC(renderer, -1);
 
     /* Don't draw while we're hidden */
     if (renderer->hidden) {
         return 0;
     }
-    return renderer->RenderClear(renderer);
+    start = RenderStatsBegin(renderer);
+    status = renderer->RenderClear(renderer);
+    RenderStatsEnd(renderer, SDL_RENDERSTAT_CLEAR, start);
+    return status;
 }
 
 int
@@ -1390,6 +1635,7 @@ RenderDrawPointsWithRects(SDL_Renderer * renderer,
     SDL_FRect *frects;
     int i;
     int status;
+    Uint64 start;
 
     frects = SDL_stack_alloc(SDL_FRect, count);
     if (!frects) {
@@ -1402,7 +1648,9 @@ RenderDrawPointsWithRects(SDL_Renderer * renderer,
         frects[i].h = renderer->scale.y;
     }
 
+    start = RenderStatsBegin(renderer);
     status = renderer->RenderFillRects(renderer, frects, count);
+    RenderStatsEnd(renderer, SDL_RENDERSTAT_FILLRECTS, start);
 
     SDL_stack_free(frects);
 
@@ -1416,6 +1664,7 @@ SDL_RenderDrawPoints(SDL_Renderer * renderer,
     SDL_FPoint *fpoints;
     int i;
     int status;
+    Uint64 start;
 
     CHECK_RENDERER_MAGIC(renderer, -1);
 
@@ -1443,7 +1692,9 @@ SDL_RenderDrawPoints(SDL_Renderer * renderer,
         fpoints[i].y = points[i].y * renderer->scale.y;
     }
 
+    start = RenderStatsBegin(renderer);
     status = renderer->RenderDrawPoints(renderer, fpoints, count);
+    RenderStatsEnd(renderer, SDL_RENDERSTAT_DRAWPOINTS, start);
 
     SDL_stack_free(fpoints);
 
@@ -1471,6 +1722,7 @@ RenderDrawLinesWithRects(SDL_Renderer * renderer,
     SDL_FPoint fpoints[2];
     int i, nrects;
     int status;
+    Uint64 start;
 
     frects = SDL_stack_alloc(SDL_FRect, count-1);
     if (!frects) {
@@ -1504,11 +1756,15 @@ RenderDrawLinesWithRects(SDL_Renderer * renderer,
             fpoints[0].y = points[i].y * renderer->scale.y;
             fpoints[1].x = points[i+1].x * renderer->scale.x;
             fpoints[1].y = points[i+1].y * renderer->scale.y;
+            start = RenderStatsBegin(renderer);
             status += renderer->RenderDrawLines(renderer, fpoints, 2);
+            RenderStatsEnd(renderer, SDL_RENDERSTAT_DRAWLINES, start);
         }
     }
 
+    start = RenderStatsBegin(renderer);
     status += renderer->RenderFillRects(renderer, frects, nrects);
+    RenderStatsEnd(renderer, SDL_RENDERSTAT_FILLRECTS, start);
 
     SDL_stack_free(frects);
 
@@ -1525,6 +1781,7 @@ SDL_RenderDrawLines(SDL_Renderer * renderer,
     SDL_FPoint *fpoints;
     int i;
     int status;
+    Uint64 start;
 
     CHECK_RENDERER_MAGIC(renderer, -1);
 
@@ -1552,7 +1809,9 @@ SDL_RenderDrawLines(SDL_Renderer * renderer,
         fpoints[i].y = points[i].y * renderer->scale.y;
     }
 
+    start = RenderStatsBegin(renderer);
     status = renderer->RenderDrawLines(renderer, fpoints, count);
+    RenderStatsEnd(renderer, SDL_RENDERSTAT_DRAWLINES, start);
 
     SDL_stack_free(fpoints);
 
@@ -1639,6 +1898,7 @@ SDL_RenderFillRects(SDL_Renderer * renderer,
     SDL_FRect *frects;
     int i;
     int status;
+    Uint64 start;
 
     CHECK_RENDERER_MAGIC(renderer, -1);
 
@@ -1664,7 +1924,9 @@ SDL_RenderFillRects(SDL_Renderer * renderer,
         frects[i].h = rects[i].h * renderer->scale.y;
     }
 
+    start = RenderStatsBegin(renderer);
     status = renderer->RenderFillRects(renderer, frects, count);
+    RenderStatsEnd(renderer, SDL_RENDERSTAT_FILLRECTS, start);
 
     SDL_stack_free(frects);
 
@@ -1678,6 +1940,8 @@ SDL_RenderCopy(SDL_Renderer * renderer, SDL_Texture * texture,
     SDL_Rect real_srcrect = { 0, 0, 0, 0 };
     SDL_Rect real_dstrect = { 0, 0, 0, 0 };
     SDL_FRect frect;
+    Uint64 start;
+    int status;
 
     CHECK_RENDERER_MAGIC(renderer, -1);
     CHECK_TEXTURE_MAGIC(texture, -1);
@@ -1720,7 +1984,10 @@ SDL_RenderCopy(SDL_Renderer * renderer, SDL_Texture * texture,
     frect.w = real_dstrect.w * renderer->scale.x;
     frect.h = real_dstrect.h * renderer->scale.y;
 
-    return renderer->RenderCopy(renderer, texture, &real_srcrect, &frect);
+    start = RenderStatsBegin(renderer);
+    status = renderer->RenderCopy(renderer, texture, &real_srcrect, &frect);
+    RenderStatsEnd(renderer, SDL_RENDERSTAT_COPY, start);
+    return status;
 }
 
 
@@ -1734,6 +2001,8 @@ SDL_RenderCopyEx(SDL_Renderer * renderer, SDL_Texture * texture,
     SDL_Point real_center;
     SDL_FRect frect;
     SDL_FPoint fcenter;
+    Uint64 start;
+    int status;
 
     if (flip == SDL_FLIP_NONE && angle == 0) { /* fast path when we don't need rotation or flipping */
         return SDL_RenderCopy(renderer, texture, srcrect, dstrect);
@@ -1786,7 +2055,10 @@ SDL_RenderCopyEx(SDL_Renderer * renderer, SDL_Texture * texture,
     fcenter.x = real_center.x * renderer->scale.x;
     fcenter.y = real_center.y * renderer->scale.y;
 
-    return renderer->RenderCopyEx(renderer, texture, &real_srcrect, &frect, angle, &fcenter, flip);
+    start = RenderStatsBegin(renderer);
+    status = renderer->RenderCopyEx(renderer, texture, &real_srcrect, &frect, angle, &fcenter, flip);
+    RenderStatsEnd(renderer, SDL_RENDERSTAT_COPYEX, start);
+    return status;
 }
 
 int
@@ -1794,6 +2066,8 @@ SDL_RenderReadPixels(SDL_Renderer * renderer, const SDL_Rect * rect,
                      Uint32 format, void * pixels, int pitch)
 {
     SDL_Rect real_rect;
+    Uint64 start;
+    int status;
 
     CHECK_RENDERER_MAGIC(renderer, -1);
 
@@ -1822,26 +2096,34 @@ SDL_RenderReadPixels(SDL_Renderer * renderer, const SDL_Rect * rect,
         }
     }
 
-    return renderer->RenderReadPixels(renderer, &real_rect,
-                                      format, pixels, pitch);
+    start = RenderStatsBegin(renderer);
+    status = renderer->RenderReadPixels(renderer, &real_rect,
+                                        format, pixels, pitch);
+    RenderStatsEnd(renderer, SDL_RENDERSTAT_READPIXELS, start);
+    return status;
 }
 
 void
 SDL_RenderPresent(SDL_Renderer * renderer)
 {
+    Uint64 start;
+
     CHECK_RENDERER_MAGIC(renderer, );
 
     /* Don't draw while we're hidden */
-    if (renderer->hidden) {
-        return;
+    if (!renderer->hidden) {
+        start = RenderStatsBegin(renderer);
+        renderer->RenderPresent(renderer);
+        RenderStatsEnd(renderer, SDL_RENDERSTAT_PRESENT, start);
     }
-    renderer->RenderPresent(renderer);
+    RenderStatsPresent(renderer);
 }
 
 void
 SDL_DestroyTexture(SDL_Texture * texture)
 {
     SDL_Renderer *renderer;
+    Uint64 start;
 
     CHECK_TEXTURE_MAGIC(texture, );
 
@@ -1869,7 +2151,12 @@ SDL_DestroyTexture(SDL_Texture * texture)
     }
     SDL_free(texture->pixels);
 
+    if (renderer->stats_enabled && !texture->native) {
+        ++renderer->stats.textures_destroyed;
+    }
+    start = RenderStatsBegin(renderer);
     renderer->DestroyTexture(renderer, texture);
+    RenderStatsEnd(renderer, SDL_RENDERSTAT_DESTROYTEXTURE, start);
     SDL_free(texture);
 }
 
@@ -1885,6 +2172,10 @@ SDL_DestroyRenderer(SDL_Renderer * renderer)
         SDL_DestroyTexture(renderer->textures);
     }
 
+    if (renderer->trace) {
+        SDL_RenderStopTrace(renderer);
+    }
+
     if (renderer->window) {
         SDL_SetWindowData(renderer->window, SDL_WINDOWRENDERDATA, NULL);
     }
@@ -1896,6 +2187,92 @@ SDL_DestroyRenderer(SDL_Renderer * renderer)
     renderer->DestroyRenderer(renderer);
 }
 
+int
+SDL_RenderSetStatsEnabled(SDL_Renderer * renderer, SDL_bool enabled, SDL_bool reset_on_present)
+{
+    CHECK_RENDERER_MAGIC(renderer, -1);
+
+    renderer->stats_enabled = enabled;
+    renderer->stats_reset_on_present = reset_on_present;
+    return 0;
+}
+
+int
+SDL_RenderGetStats(SDL_Renderer * renderer, SDL_RenderStats * stats)
+{
+    const Uint64 freq = SDL_GetPerformanceFrequency();
+    int i;
+
+    CHECK_RENDERER_MAGIC(renderer, -1);
+
+    if (!stats) {
+        return SDL_InvalidParamError("stats");
+    }
+    if (renderer->stats_reset_on_present) {
+        *stats = renderer->stats_frame;
+    } else {
+        *stats = renderer->stats;
+    }
+
+    /* Convert ticks without overflowing on long running totals */
+    for (i = 0; i < SDL_RENDERSTAT_NUM_CALLS; ++i) {
+        const Uint64 ticks = stats->time_ns[i];
+        stats->time_ns[i] = (ticks / freq) * 1000000000 + ((ticks % freq) * 1000000000) / freq;
+    }
+    return 0;
+}
+
+int
+SDL_RenderResetStats(SDL_Renderer * renderer)
+{
+    CHECK_RENDERER_MAGIC(renderer, -1);
+
+    SDL_zero(renderer->stats);
+    SDL_zero(renderer->stats_frame);
+    return 0;
+}
+
+int
+SDL_RenderStartTrace(SDL_Renderer * renderer, const char *file)
+{
+    static const char header[] = "{\"traceEvents\":[\n";
+
+    CHECK_RENDERER_MAGIC(renderer, -1);
+
+    if (!file) {
+        return SDL_InvalidParamError("file");
+    }
+    if (renderer->trace) {
+        SDL_RenderStopTrace(renderer);
+    }
+
+    renderer->trace = SDL_RWFromFile(file, "wb");
+    if (!renderer->trace) {
+        return -1;
+    }
+    SDL_RWwrite(renderer->trace, header, sizeof(header) - 1, 1);
+    renderer->trace_start = SDL_GetPerformanceCounter();
+    renderer->trace_empty = SDL_TRUE;
+    return 0;
+}
+
+int
+SDL_RenderStopTrace(SDL_Renderer * renderer)
+{
+    static const char footer[] = "\n]}\n";
+    int status;
+
+    CHECK_RENDERER_MAGIC(renderer, -1);
+
+    if (!renderer->trace) {
+        return 0;
+    }
+    SDL_RWwrite(renderer->trace, footer, sizeof(footer) - 1, 1);
+    status = SDL_RWclose(renderer->trace);
+    renderer->trace = NULL;
+    return status;
+}
+
 int SDL_GL_BindTexture(SDL_Texture *texture, float *texw, float *texh)
 {
     SDL_Renderer *renderer;
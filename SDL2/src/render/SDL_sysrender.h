@@ -25,6 +25,7 @@
 
 #include "SDL_render.h"
 #include "SDL_events.h"
+#include "SDL_rwops.h"
 #include "SDL_yuv_sw_c.h"
 
 /* The SDL 2D rendering system */
@@ -158,6 +159,17 @@ struct SDL_Renderer
     Uint8 r, g, b, a;                   /**< Color for drawing operations values */
     SDL_BlendMode blendMode;            /**< The drawing blend mode */
 
+    /* Render statistics, times are kept in performance counter ticks */
+    SDL_bool stats_enabled;
+    SDL_bool stats_reset_on_present;
+    SDL_RenderStats stats;
+    SDL_RenderStats stats_frame;
+
+    /* chrome://tracing output */
+    SDL_RWops *trace;
+    Uint64 trace_start;
+    SDL_bool trace_empty;
+
     void *driverdata;
 };
 
@@ -617,6 +617,13 @@ SW_RenderCopyEx(SDL_Renderer * renderer, SDL_Texture * texture,
     final_rect.w = (int)dstrect->w;
     final_rect.h = (int)dstrect->h;
 
+    /* Scale, rotate, flip and blend in one pass without temporary surfaces if we can */
+    if (SDLgfx_canTransformBlit(src, surface)) {
+        return SDLgfx_transformBlit(src, srcrect, surface, &final_rect, angle,
+                                    final_rect.x + center->x, final_rect.y + center->y,
+                                    GetScaleQuality(), flip & SDL_FLIP_HORIZONTAL, flip & SDL_FLIP_VERTICAL);
+    }
+
     /* SDLgfx_rotateSurface doesn't accept a source rectangle, so crop and scale if we need to */
     tmp_rect = final_rect;
     tmp_rect.x = 0;
@@ -39,6 +39,7 @@ Andreas Schiffler -- aschiffler at ferzkopp dot net
 
 #include "SDL.h"
 #include "SDL_rotate.h"
+#include "../../video/SDL_blit.h"
 
 /* ---- Internally used structures */
 
@@ -494,3 +495,319 @@ SDLgfx_rotateSurface(SDL_Surface * src, double angle, int centerx, int centery,
     */
     return (rz_dst);
 }
+
+
+/* !
+\brief Returns whether a surface format can be read and written by the direct transform blitter.
+
+\param fmt The pixel format to check.
+
+\return SDL_TRUE for 32 bit formats with 8 bits per channel.
+*/
+static SDL_bool
+_isTransformFormat(const SDL_PixelFormat * fmt)
+{
+    if (fmt->BytesPerPixel != 4) {
+        return SDL_FALSE;
+    }
+    if ((fmt->Rmask >> fmt->Rshift) != 0xff ||
+        (fmt->Gmask >> fmt->Gshift) != 0xff ||
+        (fmt->Bmask >> fmt->Bshift) != 0xff) {
+        return SDL_FALSE;
+    }
+    if (fmt->Amask && (fmt->Amask >> fmt->Ashift) != 0xff) {
+        return SDL_FALSE;
+    }
+    return SDL_TRUE;
+}
+
+/* !
+\brief Returns whether SDLgfx_transformBlit() can draw 'src' onto 'dst' directly.
+
+The direct path handles 32 bit surfaces with 8 bits per channel and no colorkey.
+Anything else has to go through SDLgfx_rotateSurface() and a regular blit.
+
+\param src The source surface.
+\param dst The destination surface.
+
+\return SDL_TRUE if the direct transform blitter supports this combination.
+*/
+SDL_bool
+SDLgfx_canTransformBlit(SDL_Surface * src, SDL_Surface * dst)
+{
+    if (!src || !dst || !src->map) {
+        return SDL_FALSE;
+    }
+    if (src->map->info.flags & SDL_COPY_COLORKEY) {
+        return SDL_FALSE;
+    }
+    return (_isTransformFormat(src->format) && _isTransformFormat(dst->format));
+}
+
+/* !
+\brief Applies color/alpha modulation and blending of one source color onto a destination pixel.
+
+Uses the same arithmetic as the generated blitters in SDL_blit_auto.c so that
+transformed copies match regular blits.
+
+\param srcR Source red.
+\param srcG Source green.
+\param srcB Source blue.
+\param srcA Source alpha.
+\param dstpixel The current destination pixel.
+\param fmt The destination pixel format.
+\param info The source blit info carrying the copy flags and modulation values.
+
+\return The new destination pixel.
+*/
+static SDL_INLINE Uint32
+_blendTransformPixel(Uint32 srcR, Uint32 srcG, Uint32 srcB, Uint32 srcA,
+                     Uint32 dstpixel, const SDL_PixelFormat * fmt, const SDL_BlitInfo * info)
+{
+    const int flags = info->flags;
+    Uint32 dstR, dstG, dstB, dstA;
+
+    if (flags & SDL_COPY_MODULATE_COLOR) {
+        srcR = (srcR * info->r) / 255;
+        srcG = (srcG * info->g) / 255;
+        srcB = (srcB * info->b) / 255;
+    }
+    if (flags & SDL_COPY_MODULATE_ALPHA) {
+        srcA = (srcA * info->a) / 255;
+    }
+    if (flags & (SDL_COPY_BLEND|SDL_COPY_ADD)) {
+        /* This goes away if we ever use premultiplied alpha */
+        if (srcA < 255) {
+            srcR = (srcR * srcA) / 255;
+            srcG = (srcG * srcA) / 255;
+            srcB = (srcB * srcA) / 255;
+        }
+    }
+
+    RGBA_FROM_8888(dstpixel, fmt, dstR, dstG, dstB, dstA);
+    switch (flags & (SDL_COPY_BLEND|SDL_COPY_ADD|SDL_COPY_MOD)) {
+    case SDL_COPY_BLEND:
+        dstR = srcR + ((255 - srcA) * dstR) / 255;
+        dstG = srcG + ((255 - srcA) * dstG) / 255;
+        dstB = srcB + ((255 - srcA) * dstB) / 255;
+        dstA = srcA + ((255 - srcA) * dstA) / 255;
+        break;
+    case SDL_COPY_ADD:
+        dstR = srcR + dstR; if (dstR > 255) dstR = 255;
+        dstG = srcG + dstG; if (dstG > 255) dstG = 255;
+        dstB = srcB + dstB; if (dstB > 255) dstB = 255;
+        break;
+    case SDL_COPY_MOD:
+        dstR = (srcR * dstR) / 255;
+        dstG = (srcG * dstG) / 255;
+        dstB = (srcB * dstB) / 255;
+        break;
+    default:
+        dstR = srcR;
+        dstG = srcG;
+        dstB = srcB;
+        dstA = srcA;
+        break;
+    }
+    return (dstR << fmt->Rshift) | (dstG << fmt->Gshift) | (dstB << fmt->Bshift) |
+           ((dstA << fmt->Ashift) & fmt->Amask);
+}
+
+/* !
+\brief Bilinear interpolation of one 8 bit channel of four 32 bit pixels.
+
+\param c00 Top left pixel.
+\param c01 Top right pixel.
+\param c10 Bottom left pixel.
+\param c11 Bottom right pixel.
+\param shift Bit position of the channel.
+\param ex Horizontal weight of the right pixels (0..255).
+\param ey Vertical weight of the bottom pixels (0..255).
+
+\return The interpolated channel value.
+*/
+static SDL_INLINE Uint32
+_interpolateChannel(Uint32 c00, Uint32 c01, Uint32 c10, Uint32 c11, int shift, Uint32 ex, Uint32 ey)
+{
+    Uint32 t1 = ((c00 >> shift) & 0xff) * (256 - ex) + ((c01 >> shift) & 0xff) * ex;
+    Uint32 t2 = ((c10 >> shift) & 0xff) * (256 - ex) + ((c11 >> shift) & 0xff) * ex;
+    return (t1 * (256 - ey) + t2 * ey) >> 16;
+}
+
+/* !
+\brief Scales, rotates and flips 'srcrect' of 'src' straight into 'dst' in a single pass.
+
+Every destination pixel inside the clipped bounding box of the transformed
+'dstrect' is mapped back into the source through the inverse transform,
+sampled with nearest neighbour or bilinear filtering and then color modulated
+and blended according to the source surface settings. No intermediate
+surfaces are allocated.
+The surfaces must pass SDLgfx_canTransformBlit().
+
+\param src Source surface.
+\param srcrect The source rectangle to draw.
+\param dst Destination surface.
+\param dstrect The unrotated destination rectangle, the source is scaled to fit it.
+\param angle The angle to rotate clockwise in degrees.
+\param centerx Horizontal destination coordinate of the center of rotation.
+\param centery Vertical destination coordinate of the center of rotation.
+\param smooth Flag indicating bilinear filtering should be used.
+\param flipx Flag indicating horizontal mirroring should be applied.
+\param flipy Flag indicating vertical mirroring should be applied.
+
+\return 0 on success or -1 on failure.
+*/
+int
+SDLgfx_transformBlit(SDL_Surface * src, const SDL_Rect * srcrect, SDL_Surface * dst, const SDL_Rect * dstrect, double angle, double centerx, double centery, int smooth, int flipx, int flipy)
+{
+    const SDL_PixelFormat *srcfmt = src->format;
+    const SDL_PixelFormat *dstfmt = dst->format;
+    const SDL_BlitInfo *info = &src->map->info;
+    const Uint32 opaque = srcfmt->Amask ? 0 : 0xff;
+    double radangle, cangle, sangle, scalex, scaley;
+    double minx, miny, maxx, maxy, x, y, u0, v0, dudx, dvdx, dudy, dvdy;
+    SDL_Rect bounds;
+    Uint8 *srcpixels, *dstrow;
+    int i, j, sw, sh, idudx, idvdx;
+
+    if (srcrect->w <= 0 || srcrect->h <= 0 || dstrect->w <= 0 || dstrect->h <= 0) {
+        return 0;
+    }
+
+    /*
+    * Find the destination bounding box by rotating the corners of dstrect around the center
+    */
+    radangle = angle * (M_PI / 180.0);
+    sangle = SDL_sin(radangle);
+    cangle = SDL_cos(radangle);
+    minx = miny = 1e30;
+    maxx = maxy = -1e30;
+    for (i = 0; i < 4; ++i) {
+        x = ((i & 1) ? (dstrect->x + dstrect->w) : dstrect->x) - centerx;
+        y = ((i & 2) ? (dstrect->y + dstrect->h) : dstrect->y) - centery;
+        u0 = x * cangle - y * sangle + centerx;
+        v0 = x * sangle + y * cangle + centery;
+        minx = MIN(minx, u0);
+        miny = MIN(miny, v0);
+        maxx = MAX(maxx, u0);
+        maxy = MAX(maxy, v0);
+    }
+    bounds.x = (int)SDL_floor(minx);
+    bounds.y = (int)SDL_floor(miny);
+    bounds.w = (int)SDL_ceil(maxx) - bounds.x;
+    bounds.h = (int)SDL_ceil(maxy) - bounds.y;
+    if (!SDL_IntersectRect(&bounds, &dst->clip_rect, &bounds)) {
+        return 0;
+    }
+
+    /*
+    * Inverse transform: source steps per destination pixel, in source pixels
+    */
+    scalex = (double)srcrect->w / dstrect->w;
+    scaley = (double)srcrect->h / dstrect->h;
+    dudx = cangle * scalex;
+    dvdx = -sangle * scaley;
+    dudy = sangle * scalex;
+    dvdy = cangle * scaley;
+    if (flipx) {
+        dudx = -dudx;
+        dudy = -dudy;
+    }
+    if (flipy) {
+        dvdx = -dvdx;
+        dvdy = -dvdy;
+    }
+
+    /* Source position of the center of the first destination pixel */
+    x = bounds.x + 0.5 - centerx;
+    y = bounds.y + 0.5 - centery;
+    u0 = (x * cangle + y * sangle + centerx - dstrect->x) * scalex;
+    v0 = (-x * sangle + y * cangle + centery - dstrect->y) * scaley;
+    if (flipx) {
+        u0 = srcrect->w - u0;
+    }
+    if (flipy) {
+        v0 = srcrect->h - v0;
+    }
+    idudx = (int)(dudx * 65536.0);
+    idvdx = (int)(dvdx * 65536.0);
+    sw = srcrect->w;
+    sh = srcrect->h;
+
+    /*
+    * Lock surfaces
+    */
+    if (SDL_MUSTLOCK(src) && SDL_LockSurface(src) < 0) {
+        return -1;
+    }
+    if (SDL_MUSTLOCK(dst) && SDL_LockSurface(dst) < 0) {
+        if (SDL_MUSTLOCK(src)) {
+            SDL_UnlockSurface(src);
+        }
+        return -1;
+    }
+
+    srcpixels = (Uint8 *) src->pixels + srcrect->y * src->pitch + srcrect->x * 4;
+    dstrow = (Uint8 *) dst->pixels + bounds.y * dst->pitch + bounds.x * 4;
+
+    for (j = 0; j < bounds.h; ++j) {
+        Uint32 *pc = (Uint32 *) dstrow;
+        /* Restart each row from floating point to avoid accumulating fixed point error */
+        int sdx = (int)((u0 + j * dudy) * 65536.0);
+        int sdy = (int)((v0 + j * dvdy) * 65536.0);
+
+        for (i = 0; i < bounds.w; ++i, ++pc, sdx += idudx, sdy += idvdx) {
+            Uint32 r, g, b, a;
+            int dx = (sdx >> 16);
+            int dy = (sdy >> 16);
+
+            if ((unsigned)dx >= (unsigned)sw || (unsigned)dy >= (unsigned)sh) {
+                continue;
+            }
+            if (smooth) {
+                Uint32 c00, c01, c10, c11, ex, ey;
+                const Uint8 *row0, *row1;
+                int x0, y0, x1, y1;
+
+                /* Sample relative to pixel centers, clamping at the edges of srcrect */
+                x0 = ((sdx - 0x8000) >> 16);
+                y0 = ((sdy - 0x8000) >> 16);
+                ex = ((sdx - 0x8000) >> 8) & 0xff;
+                ey = ((sdy - 0x8000) >> 8) & 0xff;
+                x1 = x0 + 1;
+                y1 = y0 + 1;
+                if (x0 < 0) x0 = 0;
+                if (y0 < 0) y0 = 0;
+                if (x1 >= sw) x1 = sw - 1;
+                if (y1 >= sh) y1 = sh - 1;
+                row0 = srcpixels + y0 * src->pitch;
+                row1 = srcpixels + y1 * src->pitch;
+                c00 = ((const Uint32 *) row0)[x0];
+                c01 = ((const Uint32 *) row0)[x1];
+                c10 = ((const Uint32 *) row1)[x0];
+                c11 = ((const Uint32 *) row1)[x1];
+                r = _interpolateChannel(c00, c01, c10, c11, srcfmt->Rshift, ex, ey);
+                g = _interpolateChannel(c00, c01, c10, c11, srcfmt->Gshift, ex, ey);
+                b = _interpolateChannel(c00, c01, c10, c11, srcfmt->Bshift, ex, ey);
+                a = _interpolateChannel(c00, c01, c10, c11, srcfmt->Ashift, ex, ey);
+            } else {
+                Uint32 pixel = ((const Uint32 *) (srcpixels + dy * src->pitch))[dx];
+                RGBA_FROM_8888(pixel, srcfmt, r, g, b, a);
+            }
+            a |= opaque;
+            *pc = _blendTransformPixel(r, g, b, a, *pc, dstfmt, info);
+        }
+        dstrow += dst->pitch;
+    }
+
+    /*
+    * Unlock surfaces
+    */
+    if (SDL_MUSTLOCK(dst)) {
+        SDL_UnlockSurface(dst);
+    }
+    if (SDL_MUSTLOCK(src)) {
+        SDL_UnlockSurface(src);
+    }
+    return 0;
+}
@@ -51,6 +51,19 @@ extern Uint8* SDL_expand_byte[9];
 #define SDL_CPU_SSE2                0x00000008
 #define SDL_CPU_ALTIVEC_PREFETCH    0x00000010
 #define SDL_CPU_ALTIVEC_NOPREFETCH  0x00000020
+#define SDL_CPU_AVX2                0x00000040
+
+/* AVX2 blitters are compiled per function so the rest of SDL keeps the
+   baseline instruction set; they are only chosen if the CPU has AVX2. */
+#if defined(__SSE2__) && (defined(__clang__) || (defined(__GNUC__) && ((__GNUC__ > 4) || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+#include <immintrin.h>
+#define SDL_BLIT_AVX2 1
+#define SDL_TARGETING_AVX2 __attribute__((target("avx2")))
+#elif defined(_MSC_VER) && (_MSC_VER >= 1700) && (defined(_M_IX86) || defined(_M_X64))
+#include <immintrin.h>
+#define SDL_BLIT_AVX2 1
+#define SDL_TARGETING_AVX2
+#endif
 
 typedef struct
 {
@@ -24,6 +24,13 @@
 #include "SDL_blit.h"
 
 
+/* Fills covering more bytes than this use non-temporal stores, so clearing
+   a large framebuffer doesn't evict everything else from the cache.
+   This is roughly the size of a desktop last level cache. */
+#define SDL_FILLRECT_STREAM_THRESHOLD   (8 * 1024 * 1024)
+
+typedef void (*SDL_FillRectFunc) (Uint8 * pixels, int pitch, Uint32 color, int w, int h);
+
 #ifdef __SSE__
 /* *INDENT-OFF* */
 
@@ -45,20 +52,22 @@
     c128 = *(__m128 *)cccc;
 #endif
 
-#define SSE_WORK \
+#define SSE_WORK(store) \
     for (i = n / 64; i--;) { \
-        _mm_stream_ps((float *)(p+0), c128); \
-        _mm_stream_ps((float *)(p+16), c128); \
-        _mm_stream_ps((float *)(p+32), c128); \
-        _mm_stream_ps((float *)(p+48), c128); \
+        store((float *)(p+0), c128); \
+        store((float *)(p+16), c128); \
+        store((float *)(p+32), c128); \
+        store((float *)(p+48), c128); \
         p += 64; \
     }
 
 #define SSE_END
 
-#define DEFINE_SSE_FILLRECT(bpp, type) \
+#define SSE_STREAM_END  _mm_sfence()
+
+#define DEFINE_SSE_FILLRECT_FUNC(bpp, type, name, store, end) \
 static void \
-SDL_FillRect##bpp##SSE(Uint8 *pixels, int pitch, Uint32 color, int w, int h) \
+name(Uint8 *pixels, int pitch, Uint32 color, int w, int h) \
 { \
     int i, n; \
     Uint8 *p = NULL; \
@@ -79,7 +88,7 @@ SDL_FillRect##bpp##SSE(Uint8 *pixels, int pitch, Uint32 color, int w, int h) \
                     p += bpp; \
                 } \
             } \
-            SSE_WORK; \
+            SSE_WORK(store); \
         } \
         if (n & 63) { \
             int remainder = (n & 63); \
@@ -92,43 +101,169 @@ SDL_FillRect##bpp##SSE(Uint8 *pixels, int pitch, Uint32 color, int w, int h) \
         pixels += pitch; \
     } \
  \
-    SSE_END; \
+    end; \
+}
+
+#define DEFINE_SSE_FILLRECT(bpp, type) \
+    DEFINE_SSE_FILLRECT_FUNC(bpp, type, SDL_FillRect##bpp##SSE, _mm_store_ps, SSE_END) \
+    DEFINE_SSE_FILLRECT_FUNC(bpp, type, SDL_FillRect##bpp##SSEStream, _mm_stream_ps, SSE_STREAM_END)
+
+DEFINE_SSE_FILLRECT(1, Uint8)
+DEFINE_SSE_FILLRECT(2, Uint16)
+DEFINE_SSE_FILLRECT(4, Uint32)
+
+/* *INDENT-ON* */
+#endif /* __SSE__ */
+
+#ifdef SDL_BLIT_AVX2
+/* *INDENT-OFF* */
+
+#define AVX2_WORK(store) \
+    for (i = n / 128; i--;) { \
+        store((__m256i *)(p+0), c256); \
+        store((__m256i *)(p+32), c256); \
+        store((__m256i *)(p+64), c256); \
+        store((__m256i *)(p+96), c256); \
+        p += 128; \
+    } \
+    for (i = (n & 127) / 32; i--;) { \
+        store((__m256i *)p, c256); \
+        p += 32; \
+    }
+
+#define AVX2_END
+
+#define AVX2_STREAM_END _mm_sfence()
+
+#define DEFINE_AVX2_FILLRECT_FUNC(bpp, type, name, store, end) \
+static SDL_TARGETING_AVX2 void \
+name(Uint8 *pixels, int pitch, Uint32 color, int w, int h) \
+{ \
+    const __m256i c256 = _mm256_set1_epi32((int)color); \
+    int i, n; \
+    Uint8 *p = NULL; \
+ \
+    while (h--) { \
+        n = w * bpp; \
+        p = pixels; \
+ \
+        if (n > 127) { \
+            int adjust = 32 - ((uintptr_t)p & 31); \
+            if (adjust < 32) { \
+                n -= adjust; \
+                adjust /= bpp; \
+                while (adjust--) { \
+                    *((type *)p) = (type)color; \
+                    p += bpp; \
+                } \
+            } \
+            AVX2_WORK(store); \
+            n &= 31; \
+        } \
+        while (n > 0) { \
+            *((type *)p) = (type)color; \
+            p += bpp; \
+            n -= bpp; \
+        } \
+        pixels += pitch; \
+    } \
+ \
+    end; \
 }
 
+#define DEFINE_AVX2_FILLRECT(bpp, type) \
+    DEFINE_AVX2_FILLRECT_FUNC(bpp, type, SDL_FillRect##bpp##AVX2, _mm256_store_si256, AVX2_END) \
+    DEFINE_AVX2_FILLRECT_FUNC(bpp, type, SDL_FillRect##bpp##AVX2Stream, _mm256_stream_si256, AVX2_STREAM_END)
+
+DEFINE_AVX2_FILLRECT(1, Uint8)
+DEFINE_AVX2_FILLRECT(2, Uint16)
+DEFINE_AVX2_FILLRECT(4, Uint32)
+
+/* *INDENT-ON* */
+#endif /* SDL_BLIT_AVX2 */
+
+/* 24-bit pixels repeat every 3 bytes, so fill whole rows from a pattern
+   that starts at the first pixel and use unaligned stores. */
 static void
-SDL_FillRect1SSE(Uint8 *pixels, int pitch, Uint32 color, int w, int h)
+SDL_Fill3Pattern(Uint8 * pattern, int len, Uint32 color)
 {
+    int i;
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+    Uint8 b1 = (Uint8) (color & 0xFF);
+    Uint8 b2 = (Uint8) ((color >> 8) & 0xFF);
+    Uint8 b3 = (Uint8) ((color >> 16) & 0xFF);
+#elif SDL_BYTEORDER == SDL_BIG_ENDIAN
+    Uint8 b1 = (Uint8) ((color >> 16) & 0xFF);
+    Uint8 b2 = (Uint8) ((color >> 8) & 0xFF);
+    Uint8 b3 = (Uint8) (color & 0xFF);
+#endif
+
+    for (i = 0; i < len; i += 3) {
+        pattern[i + 0] = b1;
+        pattern[i + 1] = b2;
+        pattern[i + 2] = b3;
+    }
+}
+
+#ifdef __SSE2__
+static void
+SDL_FillRect3SSE2(Uint8 * pixels, int pitch, Uint32 color, int w, int h)
+{
+    DECLARE_ALIGNED(Uint8, pattern[48], 16);
+    __m128i c0, c1, c2;
     int i, n;
+    Uint8 *p;
+
+    SDL_Fill3Pattern(pattern, sizeof(pattern), color);
+    c0 = _mm_load_si128((const __m128i *)(pattern + 0));
+    c1 = _mm_load_si128((const __m128i *)(pattern + 16));
+    c2 = _mm_load_si128((const __m128i *)(pattern + 32));
 
-    SSE_BEGIN;
     while (h--) {
-        Uint8 *p = pixels;
-        n = w;
+        n = w * 3;
+        p = pixels;
 
-        if (n > 63) {
-            int adjust = 16 - ((uintptr_t)p & 15);
-            if (adjust) {
-                n -= adjust;
-                SDL_memset(p, color, adjust);
-                p += adjust;
-            }
-            SSE_WORK;
-        }
-        if (n & 63) {
-            int remainder = (n & 63);
-            SDL_memset(p, color, remainder);
+        for (i = n / 48; i--;) {
+            _mm_storeu_si128((__m128i *)(p + 0), c0);
+            _mm_storeu_si128((__m128i *)(p + 16), c1);
+            _mm_storeu_si128((__m128i *)(p + 32), c2);
+            p += 48;
         }
+        SDL_memcpy(p, pattern, n % 48);
         pixels += pitch;
     }
-
-    SSE_END;
 }
-/* DEFINE_SSE_FILLRECT(1, Uint8) */
-DEFINE_SSE_FILLRECT(2, Uint16)
-DEFINE_SSE_FILLRECT(4, Uint32)
+#endif /* __SSE2__ */
 
-/* *INDENT-ON* */
-#endif /* __SSE__ */
+#ifdef SDL_BLIT_AVX2
+static SDL_TARGETING_AVX2 void
+SDL_FillRect3AVX2(Uint8 * pixels, int pitch, Uint32 color, int w, int h)
+{
+    DECLARE_ALIGNED(Uint8, pattern[96], 32);
+    __m256i c0, c1, c2;
+    int i, n;
+    Uint8 *p;
+
+    SDL_Fill3Pattern(pattern, sizeof(pattern), color);
+    c0 = _mm256_load_si256((const __m256i *)(pattern + 0));
+    c1 = _mm256_load_si256((const __m256i *)(pattern + 32));
+    c2 = _mm256_load_si256((const __m256i *)(pattern + 64));
+
+    while (h--) {
+        n = w * 3;
+        p = pixels;
+
+        for (i = n / 96; i--;) {
+            _mm256_storeu_si256((__m256i *)(p + 0), c0);
+            _mm256_storeu_si256((__m256i *)(p + 32), c1);
+            _mm256_storeu_si256((__m256i *)(p + 64), c2);
+            p += 96;
+        }
+        SDL_memcpy(p, pattern, n % 96);
+        pixels += pitch;
+    }
+}
+#endif /* SDL_BLIT_AVX2 */
 
 static void
 SDL_FillRect1(Uint8 * pixels, int pitch, Uint32 color, int w, int h)
@@ -230,32 +365,67 @@ SDL_FillRect4(Uint8 * pixels, int pitch, Uint32 color, int w, int h)
     }
 }
 
+static SDL_FillRectFunc
+SDL_ChooseFillRectFunc(int bpp, SDL_bool stream)
+{
+#ifdef SDL_BLIT_AVX2
+    if (SDL_HasAVX2()) {
+        switch (bpp) {
+        case 1:
+            return stream ? SDL_FillRect1AVX2Stream : SDL_FillRect1AVX2;
+        case 2:
+            return stream ? SDL_FillRect2AVX2Stream : SDL_FillRect2AVX2;
+        case 3:
+            return SDL_FillRect3AVX2;
+        case 4:
+            return stream ? SDL_FillRect4AVX2Stream : SDL_FillRect4AVX2;
+        }
+    }
+#endif
+#ifdef __SSE__
+    if (SDL_HasSSE()) {
+        switch (bpp) {
+        case 1:
+            return stream ? SDL_FillRect1SSEStream : SDL_FillRect1SSE;
+        case 2:
+            return stream ? SDL_FillRect2SSEStream : SDL_FillRect2SSE;
+        case 4:
+            return stream ? SDL_FillRect4SSEStream : SDL_FillRect4SSE;
+        }
+    }
+#endif
+#ifdef __SSE2__
+    if (bpp == 3 && SDL_HasSSE2()) {
+        return SDL_FillRect3SSE2;
+    }
+#endif
+
+    switch (bpp) {
+    case 1:
+        return SDL_FillRect1;
+    case 2:
+        return SDL_FillRect2;
+    case 3:
+        /* 24-bit RGB is a slow path without SIMD */
+        return SDL_FillRect3;
+    case 4:
+        return SDL_FillRect4;
+    }
+    return NULL;
+}
+
 /* 
  * This function performs a fast fill of the given rectangle with 'color'
  */
 int
 SDL_FillRect(SDL_Surface * dst, const SDL_Rect * rect, Uint32 color)
 {
-    SDL_Rect clipped;
-    Uint8 *pixels;
-
     if (!dst) {
         return SDL_SetError("Passed NULL destination surface");
     }
 
-    /* This function doesn't work on surfaces < 8 bpp */
-    if (dst->format->BitsPerPixel < 8) {
-        return SDL_SetError("SDL_FillRect(): Unsupported surface format");
-    }
-
     /* If 'rect' == NULL, then fill the whole surface */
-    if (rect) {
-        /* Perform clipping */
-        if (!SDL_IntersectRect(rect, &dst->clip_rect, &clipped)) {
-            return 0;
-        }
-        rect = &clipped;
-    } else {
+    if (!rect) {
         rect = &dst->clip_rect;
         /* Don't attempt to fill if the surface's clip_rect is empty */
         if (SDL_RectEmpty(rect)) {
@@ -263,59 +433,69 @@ SDL_FillRect(SDL_Surface * dst, const SDL_Rect * rect, Uint32 color)
         }
     }
 
-    /* Perform software fill */
-    if (!dst->pixels) {
-        return SDL_SetError("SDL_FillRect(): You must lock the surface");
+    return SDL_FillRects(dst, rect, 1, color);
+}
+
+/*
+ * Fill all rectangles with the same fill function, choosing it only once
+ */
+int
+SDL_FillRects(SDL_Surface * dst, const SDL_Rect * rects, int count,
+              Uint32 color)
+{
+    SDL_FillRectFunc fill_function = NULL;
+    SDL_FillRectFunc stream_function = NULL;
+    SDL_Rect clipped;
+    Uint8 *pixels;
+    int i, bpp;
+
+    if (!dst) {
+        return SDL_SetError("Passed NULL destination surface");
+    }
+
+    /* This function doesn't work on surfaces < 8 bpp */
+    if (dst->format->BitsPerPixel < 8) {
+        return SDL_SetError("SDL_FillRect(): Unsupported surface format");
     }
 
-    pixels = (Uint8 *) dst->pixels + rect->y * dst->pitch +
-                                     rect->x * dst->format->BytesPerPixel;
+    if (!rects) {
+        return SDL_SetError("SDL_FillRects() passed NULL rects");
+    }
 
-    switch (dst->format->BytesPerPixel) {
+    bpp = dst->format->BytesPerPixel;
+    switch (bpp) {
     case 1:
-        {
-            color |= (color << 8);
-            color |= (color << 16);
-#ifdef __SSE__
-            if (SDL_HasSSE()) {
-                SDL_FillRect1SSE(pixels, dst->pitch, color, rect->w, rect->h);
-                break;
-            }
-#endif
-            SDL_FillRect1(pixels, dst->pitch, color, rect->w, rect->h);
-            break;
-        }
-
+        color |= (color << 8);
+        color |= (color << 16);
+        break;
     case 2:
-        {
-            color |= (color << 16);
-#ifdef __SSE__
-            if (SDL_HasSSE()) {
-                SDL_FillRect2SSE(pixels, dst->pitch, color, rect->w, rect->h);
-                break;
-            }
-#endif
-            SDL_FillRect2(pixels, dst->pitch, color, rect->w, rect->h);
-            break;
+        color |= (color << 16);
+        break;
+    }
+
+    for (i = 0; i < count; ++i) {
+        /* Perform clipping */
+        if (!SDL_IntersectRect(&rects[i], &dst->clip_rect, &clipped)) {
+            continue;
         }
 
-    case 3:
-        /* 24-bit RGB is a slow path, at least for now. */
-        {
-            SDL_FillRect3(pixels, dst->pitch, color, rect->w, rect->h);
-            break;
+        /* Perform software fill */
+        if (!dst->pixels) {
+            return SDL_SetError("SDL_FillRect(): You must lock the surface");
         }
 
-    case 4:
-        {
-#ifdef __SSE__
-            if (SDL_HasSSE()) {
-                SDL_FillRect4SSE(pixels, dst->pitch, color, rect->w, rect->h);
-                break;
+        pixels = (Uint8 *) dst->pixels + clipped.y * dst->pitch + clipped.x * bpp;
+
+        if ((size_t)clipped.w * clipped.h * bpp >= SDL_FILLRECT_STREAM_THRESHOLD) {
+            if (!stream_function) {
+                stream_function = SDL_ChooseFillRectFunc(bpp, SDL_TRUE);
             }
-#endif
-            SDL_FillRect4(pixels, dst->pitch, color, rect->w, rect->h);
-            break;
+            stream_function(pixels, dst->pitch, color, clipped.w, clipped.h);
+        } else {
+            if (!fill_function) {
+                fill_function = SDL_ChooseFillRectFunc(bpp, SDL_FALSE);
+            }
+            fill_function(pixels, dst->pitch, color, clipped.w, clipped.h);
         }
     }
 
@@ -323,21 +503,4 @@ SDL_FillRect(SDL_Surface * dst, const SDL_Rect * rect, Uint32 color)
     return 0;
 }
 
-int
-SDL_FillRects(SDL_Surface * dst, const SDL_Rect * rects, int count,
-              Uint32 color)
-{
-    int i;
-    int status = 0;
-
-    if (!rects) {
-        return SDL_SetError("SDL_FillRects() passed NULL rects");
-    }
-
-    for (i = 0; i < count; ++i) {
-        status += SDL_FillRect(dst, &rects[i], color);
-    }
-    return status;
-}
-
 /* vi: set ts=4 sw=4 expandtab: */
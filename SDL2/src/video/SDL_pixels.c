@@ -23,6 +23,7 @@
 /* General (mostly internal) pixel/color manipulation routines for SDL */
 
 #include "SDL_endian.h"
+#include "SDL_atomic.h"
 #include "SDL_video.h"
 #include "SDL_sysvideo.h"
 #include "SDL_blit.h"
@@ -483,21 +484,30 @@ SDL_MasksToPixelFormatEnum(int bpp, Uint32 Rmask, Uint32 Gmask, Uint32 Bmask,
 }
 
 static SDL_PixelFormat *formats;
+static SDL_SpinLock formats_lock = 0;
 
 SDL_PixelFormat *
 SDL_AllocFormat(Uint32 pixel_format)
 {
     SDL_PixelFormat *format;
+    SDL_PixelFormat *cached;
+
+    SDL_AtomicLock(&formats_lock);
 
     /* Look it up in our list of previously allocated formats */
     for (format = formats; format; format = format->next) {
         if (pixel_format == format->format) {
             ++format->refcount;
+            SDL_AtomicUnlock(&formats_lock);
             return format;
         }
     }
 
-    /* Allocate an empty pixel format structure, and initialize it */
+    SDL_AtomicUnlock(&formats_lock);
+
+    /* Allocate an empty pixel format structure, and initialize it.
+       This is done outside the spinlock, so recheck the list afterwards.
+     */
     format = SDL_malloc(sizeof(*format));
     if (format == NULL) {
         SDL_OutOfMemory();
@@ -510,10 +520,25 @@ SDL_AllocFormat(Uint32 pixel_format)
     }
 
     if (!SDL_ISPIXELFORMAT_INDEXED(pixel_format)) {
+        SDL_AtomicLock(&formats_lock);
+
+        /* Another thread may have cached this format in the meantime */
+        for (cached = formats; cached; cached = cached->next) {
+            if (pixel_format == cached->format) {
+                ++cached->refcount;
+                SDL_AtomicUnlock(&formats_lock);
+                SDL_free(format);
+                return cached;
+            }
+        }
+
         /* Cache the RGB formats */
         format->next = formats;
         formats = format;
+
+        SDL_AtomicUnlock(&formats_lock);
     }
+
     return format;
 }
 
@@ -591,7 +616,11 @@ SDL_FreeFormat(SDL_PixelFormat *format)
         SDL_InvalidParamError("format");
         return;
     }
+
+    SDL_AtomicLock(&formats_lock);
+
     if (--format->refcount > 0) {
+        SDL_AtomicUnlock(&formats_lock);
         return;
     }
 
@@ -607,6 +636,8 @@ SDL_FreeFormat(SDL_PixelFormat *format)
         }
     }
 
+    SDL_AtomicUnlock(&formats_lock);
+
     if (format->palette) {
         SDL_FreePalette(format->palette);
     }
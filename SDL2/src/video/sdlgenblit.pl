@@ -85,6 +85,45 @@ my %set_rgba_string = (
     "BGRA8888" => "_pixel = ((Uint32)_B << 24) | ((Uint32)_G << 16) | ((Uint32)_R << 8) | _A;",
 );
 
+# The combinations that also get SIMD variants, always converted to ARGB
+# internally.  The SIMD code must produce exactly the same pixels as the
+# scalar code, which also handles the leftover pixels at the end of each row.
+my @simd_src_formats = (
+    "ARGB8888",
+    "ABGR8888",
+);
+my @simd_dst_formats = (
+    "RGB888",
+    "ARGB8888",
+);
+
+# Instruction sets in order of preference, and how to spell them.
+# The code templates below are written for SSE2 and rewritten for the others.
+my @simd_isas = (
+    "AVX2",
+    "SSE2",
+);
+
+my %simd_width = (
+    "SSE2" => 4,
+    "AVX2" => 8,
+);
+
+my %simd_guard = (
+    "SSE2" => "defined(__SSE2__)",
+    "AVX2" => "defined(SDL_BLIT_AVX2)",
+);
+
+my %simd_cpu = (
+    "SSE2" => "SDL_CPU_SSE2",
+    "AVX2" => "SDL_CPU_AVX2",
+);
+
+my %simd_attribute = (
+    "SSE2" => "",
+    "AVX2" => "SDL_TARGETING_AVX2 ",
+);
+
 sub open_file {
     my $name = shift;
     open(FILE, ">$name.new") || die "Cant' open $name.new: $!";
@@ -149,6 +188,7 @@ sub output_copyfuncname
     my $scale = shift;
     my $args = shift;
     my $suffix = shift;
+    my $isa = shift;
 
     print FILE "$prefix SDL_Blit_${src}_${dst}";
     if ( $modulate ) {
@@ -160,6 +200,9 @@ sub output_copyfuncname
     if ( $scale ) {
         print FILE "_Scale";
     }
+    if ( $isa ) {
+        print FILE "_$isa";
+    }
     if ( $args ) {
         print FILE "(SDL_BlitInfo *info)";
     }
@@ -296,21 +339,16 @@ __EOF__
     }
 }
 
-sub output_copyfunc
+sub output_copyvars
 {
     my $src = shift;
     my $dst = shift;
     my $modulate = shift;
     my $blend = shift;
-    my $scale = shift;
 
     my $dst_has_alpha = ($dst =~ /A/) ? 1 : 0;
     my $ignore_dst_alpha = !$dst_has_alpha && !$blend;
 
-    output_copyfuncname("static void", $src, $dst, $modulate, $blend, $scale, 1, "\n");
-    print FILE <<__EOF__;
-{
-__EOF__
     if ( $modulate || $blend ) {
         print FILE <<__EOF__;
     const int flags = info->flags;
@@ -357,6 +395,21 @@ __EOF__
 __EOF__
         }
     }
+}
+
+sub output_copyfunc
+{
+    my $src = shift;
+    my $dst = shift;
+    my $modulate = shift;
+    my $blend = shift;
+    my $scale = shift;
+
+    output_copyfuncname("static void", $src, $dst, $modulate, $blend, $scale, 1, "\n");
+    print FILE <<__EOF__;
+{
+__EOF__
+    output_copyvars($src, $dst, $modulate, $blend);
     if ( $scale ) {
         print FILE <<__EOF__;
     int srcy, srcx;
@@ -426,6 +479,210 @@ __EOF__
 __EOF__
 }
 
+sub has_simdfunc
+{
+    my $src = shift;
+    my $dst = shift;
+    my $modulate = shift;
+    my $blend = shift;
+    my $scale = shift;
+
+    if ( $scale || (!$modulate && !$blend) ) {
+        return 0;
+    }
+    if ( !grep { $_ eq $src } @simd_src_formats ) {
+        return 0;
+    }
+    if ( !grep { $_ eq $dst } @simd_dst_formats ) {
+        return 0;
+    }
+    return 1;
+}
+
+sub print_simd
+{
+    my $isa = shift;
+    my $string = shift;
+
+    if ( $isa eq "AVX2" ) {
+        $string =~ s/_mm_/_mm256_/g;
+        $string =~ s/si128/si256/g;
+        $string =~ s/__m128i/__m256i/g;
+    }
+    $string =~ s/_SSE2\(/_${isa}(/g;
+    print FILE $string;
+}
+
+sub output_simdhelpers
+{
+    foreach my $isa (@simd_isas) {
+        print FILE "#if $simd_guard{$isa}\n";
+        print_simd($isa, <<__EOF__);
+/* Exact x / 255 for 0 <= x <= 255 * 255, matching the scalar integer division */
+static SDL_INLINE $simd_attribute{$isa}__m128i SDL_Blit_Div255_SSE2(__m128i x)
+{
+    return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(x, _mm_set1_epi16(1)), _mm_srli_epi16(x, 8)), 8);
+}
+
+static SDL_INLINE $simd_attribute{$isa}__m128i SDL_Blit_Mul255_SSE2(__m128i a, __m128i b)
+{
+    return SDL_Blit_Div255_SSE2(_mm_mullo_epi16(a, b));
+}
+
+/* Copy the alpha of each unpacked ARGB pixel into all of its channels */
+static SDL_INLINE $simd_attribute{$isa}__m128i SDL_Blit_Alpha16_SSE2(__m128i x)
+{
+    return _mm_shufflehi_epi16(_mm_shufflelo_epi16(x, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+/* Swap the red and blue channels of packed ABGR/ARGB pixels */
+static SDL_INLINE $simd_attribute{$isa}__m128i SDL_Blit_SwapRB_SSE2(__m128i x)
+{
+    const __m128i ag = _mm_and_si128(x, _mm_set1_epi32((int)0xFF00FF00));
+    const __m128i r = _mm_and_si128(_mm_srli_epi32(x, 16), _mm_set1_epi32(0xFF));
+    const __m128i b = _mm_slli_epi32(_mm_and_si128(x, _mm_set1_epi32(0xFF)), 16);
+    return _mm_or_si128(ag, _mm_or_si128(r, b));
+}
+
+__EOF__
+        print FILE "#endif /* $simd_guard{$isa} */\n\n";
+    }
+}
+
+sub output_simdfunc
+{
+    my $src = shift;
+    my $dst = shift;
+    my $modulate = shift;
+    my $blend = shift;
+    my $isa = shift;
+    my $width = $simd_width{$isa};
+
+    my $dst_has_alpha = ($dst =~ /A/) ? 1 : 0;
+
+    print FILE "static $simd_attribute{$isa}";
+    output_copyfuncname("void", $src, $dst, $modulate, $blend, 0, 1, "\n", $isa);
+    print FILE <<__EOF__;
+{
+__EOF__
+    output_copyvars($src, $dst, $modulate, $blend);
+    print_simd($isa, <<__EOF__);
+    const __m128i zero = _mm_setzero_si128();
+__EOF__
+    if ( $blend || !$dst_has_alpha ) {
+        print_simd($isa, <<__EOF__);
+    const __m128i amask = _mm_set1_epi32((int)0xFF000000);
+__EOF__
+    }
+    if ( $modulate ) {
+        print_simd($isa, <<__EOF__);
+    const Uint32 modulate = (((flags & SDL_COPY_MODULATE_ALPHA) ? (Uint32)info->a : 0xFF) << 24) |
+                            ((flags & SDL_COPY_MODULATE_COLOR) ? (((Uint32)info->r << 16) | ((Uint32)info->g << 8) | info->b) : 0x00FFFFFF);
+    const __m128i mod16 = _mm_unpacklo_epi8(_mm_set1_epi32((int)modulate), zero);
+__EOF__
+    }
+    if ( $blend ) {
+        print_simd($isa, <<__EOF__);
+    const __m128i amask16 = _mm_unpacklo_epi8(amask, amask);
+    const __m128i full16 = _mm_set1_epi16(0xFF);
+__EOF__
+    }
+    print_simd($isa, <<__EOF__);
+
+    while (info->dst_h--) {
+        Uint32 *src = (Uint32 *)info->src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        int n = info->dst_w;
+        while (n >= $width) {
+            __m128i s = _mm_loadu_si128((const __m128i *)src);
+            __m128i slo, shi;
+__EOF__
+    if ( $src ne "ARGB8888" ) {
+        print_simd($isa, <<__EOF__);
+            s = SDL_Blit_SwapRB_SSE2(s);
+__EOF__
+    }
+    print_simd($isa, <<__EOF__);
+            slo = _mm_unpacklo_epi8(s, zero);
+            shi = _mm_unpackhi_epi8(s, zero);
+__EOF__
+    if ( $modulate ) {
+        print_simd($isa, <<__EOF__);
+            slo = SDL_Blit_Mul255_SSE2(slo, mod16);
+            shi = SDL_Blit_Mul255_SSE2(shi, mod16);
+__EOF__
+    }
+    if ( $blend ) {
+        print_simd($isa, <<__EOF__);
+            {
+                __m128i d = _mm_loadu_si128((const __m128i *)dst);
+                __m128i dlo = _mm_unpacklo_epi8(d, zero);
+                __m128i dhi = _mm_unpackhi_epi8(d, zero);
+                if (flags & (SDL_COPY_BLEND|SDL_COPY_ADD)) {
+                    /* This goes away if we ever use premultiplied alpha */
+                    const __m128i plo = SDL_Blit_Mul255_SSE2(slo, SDL_Blit_Alpha16_SSE2(slo));
+                    const __m128i phi = SDL_Blit_Mul255_SSE2(shi, SDL_Blit_Alpha16_SSE2(shi));
+                    slo = _mm_or_si128(_mm_andnot_si128(amask16, plo), _mm_and_si128(amask16, slo));
+                    shi = _mm_or_si128(_mm_andnot_si128(amask16, phi), _mm_and_si128(amask16, shi));
+                }
+                switch (flags & (SDL_COPY_BLEND|SDL_COPY_ADD|SDL_COPY_MOD)) {
+                case SDL_COPY_BLEND:
+                    dlo = _mm_add_epi16(slo, SDL_Blit_Mul255_SSE2(_mm_sub_epi16(full16, SDL_Blit_Alpha16_SSE2(slo)), dlo));
+                    dhi = _mm_add_epi16(shi, SDL_Blit_Mul255_SSE2(_mm_sub_epi16(full16, SDL_Blit_Alpha16_SSE2(shi)), dhi));
+                    d = _mm_packus_epi16(dlo, dhi);
+                    break;
+                case SDL_COPY_ADD:
+                    s = _mm_adds_epu8(_mm_packus_epi16(slo, shi), d);
+                    d = _mm_or_si128(_mm_andnot_si128(amask, s), _mm_and_si128(amask, d));
+                    break;
+                case SDL_COPY_MOD:
+                    s = _mm_packus_epi16(SDL_Blit_Mul255_SSE2(slo, dlo), SDL_Blit_Mul255_SSE2(shi, dhi));
+                    d = _mm_or_si128(_mm_andnot_si128(amask, s), _mm_and_si128(amask, d));
+                    break;
+                }
+__EOF__
+        if ( !$dst_has_alpha ) {
+            print_simd($isa, <<__EOF__);
+                d = _mm_andnot_si128(amask, d);
+__EOF__
+        }
+        print_simd($isa, <<__EOF__);
+                _mm_storeu_si128((__m128i *)dst, d);
+            }
+__EOF__
+    } else {
+        print_simd($isa, <<__EOF__);
+            s = _mm_packus_epi16(slo, shi);
+__EOF__
+        if ( !$dst_has_alpha ) {
+            print_simd($isa, <<__EOF__);
+            s = _mm_andnot_si128(amask, s);
+__EOF__
+        }
+        print_simd($isa, <<__EOF__);
+            _mm_storeu_si128((__m128i *)dst, s);
+__EOF__
+    }
+    print FILE <<__EOF__;
+            src += $width;
+            dst += $width;
+            n -= $width;
+        }
+        while (n--) {
+__EOF__
+    output_copycore($src, $dst, $modulate, $blend);
+    print FILE <<__EOF__;
+            ++src;
+            ++dst;
+        }
+        info->src += info->src_pitch;
+        info->dst += info->dst_pitch;
+    }
+}
+
+__EOF__
+}
+
 sub output_copyfunc_h
 {
 }
@@ -438,6 +695,45 @@ sub output_copyinc
 #include "SDL_blit_auto.h"
 
 __EOF__
+    output_simdhelpers();
+}
+
+sub copyflags
+{
+    my $modulate = shift;
+    my $blend = shift;
+    my $scale = shift;
+
+    my $flags = "";
+    my $flag = "";
+    if ( $modulate ) {
+        $flag = "SDL_COPY_MODULATE_COLOR | SDL_COPY_MODULATE_ALPHA";
+        if ( $flags eq "" ) {
+            $flags = $flag;
+        } else {
+            $flags = "$flags | $flag";
+        }
+    }
+    if ( $blend ) {
+        $flag = "SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD";
+        if ( $flags eq "" ) {
+            $flags = $flag;
+        } else {
+            $flags = "$flags | $flag";
+        }
+    }
+    if ( $scale ) {
+        $flag = "SDL_COPY_NEAREST";
+        if ( $flags eq "" ) {
+            $flags = $flag;
+        } else {
+            $flags = "$flags | $flag";
+        }
+    }
+    if ( $flags eq "" ) {
+        $flags = "0";
+    }
+    return $flags;
 }
 
 sub output_copyfunctable
@@ -453,37 +749,16 @@ __EOF__
                 for (my $blend = 0; $blend <= 1; ++$blend) {
                     for (my $scale = 0; $scale <= 1; ++$scale) {
                         if ( $modulate || $blend || $scale ) {
-                            print FILE "    { SDL_PIXELFORMAT_$src, SDL_PIXELFORMAT_$dst, ";
-                            my $flags = "";
-                            my $flag = "";
-                            if ( $modulate ) {
-                                $flag = "SDL_COPY_MODULATE_COLOR | SDL_COPY_MODULATE_ALPHA";
-                                if ( $flags eq "" ) {
-                                    $flags = $flag;
-                                } else {
-                                    $flags = "$flags | $flag";
-                                }
-                            }
-                            if ( $blend ) {
-                                $flag = "SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD";
-                                if ( $flags eq "" ) {
-                                    $flags = $flag;
-                                } else {
-                                    $flags = "$flags | $flag";
-                                }
-                            }
-                            if ( $scale ) {
-                                $flag = "SDL_COPY_NEAREST";
-                                if ( $flags eq "" ) {
-                                    $flags = $flag;
-                                } else {
-                                    $flags = "$flags | $flag";
+                            if ( has_simdfunc($src, $dst, $modulate, $blend, $scale) ) {
+                                foreach my $isa (@simd_isas) {
+                                    print FILE "#if $simd_guard{$isa}\n";
+                                    print FILE "    { SDL_PIXELFORMAT_$src, SDL_PIXELFORMAT_$dst, (" . copyflags($modulate, $blend, $scale) . "), $simd_cpu{$isa},";
+                                    output_copyfuncname("", $src, $dst, $modulate, $blend, $scale, 0, " },\n", $isa);
+                                    print FILE "#endif\n";
                                 }
                             }
-                            if ( $flags eq "" ) {
-                                $flags = "0";
-                            }
-                            print FILE "($flags), SDL_CPU_ANY,";
+                            print FILE "    { SDL_PIXELFORMAT_$src, SDL_PIXELFORMAT_$dst, ";
+                            print FILE "(" . copyflags($modulate, $blend, $scale) . "), SDL_CPU_ANY,";
                             output_copyfuncname("", $src_formats[$i], $dst_formats[$j], $modulate, $blend, $scale, 0, " },\n");
                         }
                     }
@@ -509,6 +784,13 @@ sub output_copyfunc_c
                 if ( $modulate || $blend || $scale ) {
                     output_copyfunc($src, $dst, $modulate, $blend, $scale);
                 }
+                if ( has_simdfunc($src, $dst, $modulate, $blend, $scale) ) {
+                    foreach my $isa (@simd_isas) {
+                        print FILE "#if $simd_guard{$isa}\n";
+                        output_simdfunc($src, $dst, $modulate, $blend, $isa);
+                        print FILE "#endif /* $simd_guard{$isa} */\n\n";
+                    }
+                }
             }
         }
     }
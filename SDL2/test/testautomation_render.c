@@ -420,6 +420,220 @@ render_testBlit(void *arg)
 }
 
 
+/* A 4x4 opaque texture with every pixel a different color */
+static const Uint32 _transformPixels[16] = {
+   0xFF000000, 0xFF100000, 0xFF200000, 0xFF300000,
+   0xFF001000, 0xFF101000, 0xFF201000, 0xFF301000,
+   0xFF000020, 0xFF100020, 0xFF200020, 0xFF300020,
+   0xFF002020, 0xFF102020, 0xFF202020, 0xFF302020
+};
+
+static SDL_Texture *
+_createTransformTexture(const Uint32 *pixels, int w, int h)
+{
+   SDL_Texture *texture;
+   int ret;
+
+   texture = SDL_CreateTexture(renderer, RENDER_COMPARE_FORMAT, SDL_TEXTUREACCESS_STATIC, w, h);
+   SDLTest_AssertCheck(texture != NULL, "Verify SDL_CreateTexture result");
+   if (texture == NULL) {
+      return NULL;
+   }
+   ret = SDL_UpdateTexture(texture, NULL, pixels, w * sizeof(Uint32));
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_UpdateTexture, expected: 0, got: %i", ret);
+   ret = SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_NONE);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_SetTextureBlendMode, expected: 0, got: %i", ret);
+   return texture;
+}
+
+/* Draw the 4x4 texture transformed and check where each pixel ended up */
+static void
+_testTransform(SDL_Texture *texture, double angle, SDL_RendererFlip flip, const char *name)
+{
+   SDL_Rect rect = { 8, 8, 4, 4 };
+   Uint32 result[16];
+   int x, y, sx, sy, ret, failed;
+
+   _clearScreen();
+   ret = SDL_RenderCopyEx(renderer, texture, NULL, &rect, angle, NULL, flip);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderCopyEx (%s), expected: 0, got: %i", name, ret);
+   ret = SDL_RenderReadPixels(renderer, &rect, RENDER_COMPARE_FORMAT, result, rect.w * sizeof(Uint32));
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderReadPixels, expected: 0, got: %i", ret);
+
+   failed = 0;
+   for (y = 0; y < 4; y++) {
+      for (x = 0; x < 4; x++) {
+         /* Angles are clockwise, and flipping happens before rotating */
+         if (angle == 90.0) {
+            sx = y;
+            sy = 3 - x;
+         } else if (angle == 180.0) {
+            sx = 3 - x;
+            sy = 3 - y;
+         } else {
+            sx = x;
+            sy = y;
+         }
+         if (flip & SDL_FLIP_HORIZONTAL) {
+            sx = 3 - sx;
+         }
+         if (flip & SDL_FLIP_VERTICAL) {
+            sy = 3 - sy;
+         }
+         if (result[y * 4 + x] != _transformPixels[sy * 4 + sx]) {
+            failed++;
+         }
+      }
+   }
+   SDLTest_AssertCheck(failed == 0, "Validate pixels drawn with %s, expected: 0 wrong, got: %i", name, failed);
+}
+
+/**
+ * @brief Tests blitting rotated by right angles, flipped and scaled.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_RenderCopyEx
+ * http://wiki.libsdl.org/moin.cgi/SDL_RenderReadPixels
+ */
+int
+render_testBlitExTransforms(void *arg)
+{
+   static const Uint32 ramp[2] = { 0xFFFFFFFF, 0xFF000000 };
+   SDL_Texture *texture;
+   SDL_Rect rect;
+   Uint32 result[16 * 16];
+   int x, y, ret, failed, level, last;
+
+   texture = _createTransformTexture(_transformPixels, 4, 4);
+   if (texture == NULL) {
+      return TEST_ABORTED;
+   }
+   _testTransform(texture, 90.0, SDL_FLIP_NONE, "a 90 degree rotation");
+   _testTransform(texture, 180.0, SDL_FLIP_NONE, "a 180 degree rotation");
+   _testTransform(texture, 0.0, SDL_FLIP_HORIZONTAL, "a horizontal flip");
+   _testTransform(texture, 0.0, SDL_FLIP_VERTICAL, "a vertical flip");
+   _testTransform(texture, 90.0, SDL_FLIP_HORIZONTAL, "a 90 degree rotation and a horizontal flip");
+
+   /* Scaled up 4 times with nearest sampling, each pixel becomes a 4x4 block */
+   _clearScreen();
+   rect.x = 8;
+   rect.y = 8;
+   rect.w = 16;
+   rect.h = 16;
+   ret = SDL_RenderCopyEx(renderer, texture, NULL, &rect, 0.0, NULL, SDL_FLIP_VERTICAL);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderCopyEx (scaled), expected: 0, got: %i", ret);
+   ret = SDL_RenderReadPixels(renderer, &rect, RENDER_COMPARE_FORMAT, result, rect.w * sizeof(Uint32));
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderReadPixels, expected: 0, got: %i", ret);
+   failed = 0;
+   for (y = 0; y < 16; y++) {
+      for (x = 0; x < 16; x++) {
+         if (result[y * 16 + x] != _transformPixels[(3 - y / 4) * 4 + x / 4]) {
+            failed++;
+         }
+      }
+   }
+   SDLTest_AssertCheck(failed == 0, "Validate pixels drawn scaled and flipped, expected: 0 wrong, got: %i", failed);
+   SDL_DestroyTexture(texture);
+
+   /* A white and black pair stretched with linear filtering and flipped, as
+      unflipped copies don't go through SDL_RenderCopyEx(), ramps up from black */
+   SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "linear");
+   texture = _createTransformTexture(ramp, 2, 1);
+   if (texture == NULL) {
+      SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "nearest");
+      return TEST_ABORTED;
+   }
+   _clearScreen();
+   rect.w = 16;
+   rect.h = 1;
+   ret = SDL_RenderCopyEx(renderer, texture, NULL, &rect, 0.0, NULL, SDL_FLIP_HORIZONTAL);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderCopyEx (filtered), expected: 0, got: %i", ret);
+   ret = SDL_RenderReadPixels(renderer, &rect, RENDER_COMPARE_FORMAT, result, rect.w * sizeof(Uint32));
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderReadPixels, expected: 0, got: %i", ret);
+   SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "nearest");
+   SDL_DestroyTexture(texture);
+
+   failed = 0;
+   last = -1;
+   for (x = 0; x < 16; x++) {
+      level = result[x] & 0xFF;
+      if (level < last || (result[x] >> 16 & 0xFF) != level || (result[x] >> 8 & 0xFF) != level) {
+         failed++;
+      }
+      last = level;
+   }
+   SDLTest_AssertCheck(failed == 0, "Validate the filtered ramp is grey and never gets darker, expected: 0 wrong, got: %i", failed);
+   SDLTest_AssertCheck((result[0] & 0xFF) < 0x40 && (result[15] & 0xFF) > 0xC0,
+      "Validate the filtered ramp runs from black to white, got: %i to %i", (int)(result[0] & 0xFF), (int)(result[15] & 0xFF));
+   SDLTest_AssertCheck((result[7] & 0xFF) > 0x20 && (result[7] & 0xFF) < 0xE0,
+      "Validate the middle of the filtered ramp is grey, got: %i", (int)(result[7] & 0xFF));
+
+   return TEST_COMPLETED;
+}
+
+
+/**
+ * @brief Tests the render statistics collected per presented frame.
+ *
+ * \sa
+ * SDL_RenderSetStatsEnabled
+ * SDL_RenderGetStats
+ */
+int
+render_testStats(void *arg)
+{
+   int ret;
+   SDL_Rect rect;
+   SDL_Texture *tface;
+   SDL_RenderStats stats;
+
+   ret = SDL_RenderSetStatsEnabled(renderer, SDL_TRUE, SDL_TRUE);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderSetStatsEnabled, expected: 0, got: %i", ret);
+
+   /* Start from a clean frame. */
+   SDL_RenderPresent(renderer);
+
+   tface = _loadTestFace();
+   SDLTest_AssertCheck(tface != NULL,  "Verify _loadTestFace() result");
+   if (tface == NULL) {
+       SDL_RenderSetStatsEnabled(renderer, SDL_FALSE, SDL_FALSE);
+       return TEST_ABORTED;
+   }
+
+   rect.x = 10;
+   rect.y = 10;
+   rect.w = 20;
+   rect.h = 20;
+   SDL_SetRenderDrawColor(renderer, 1, 2, 3, SDL_ALPHA_OPAQUE);
+   SDL_RenderClear(renderer);
+   SDL_RenderFillRect(renderer, &rect);
+   SDL_RenderCopy(renderer, tface, NULL, &rect);
+   SDL_RenderCopy(renderer, tface, NULL, NULL);
+   SDL_RenderPresent(renderer);
+
+   ret = SDL_RenderGetStats(renderer, &stats);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderGetStats, expected: 0, got: %i", ret);
+   SDLTest_AssertCheck(stats.frames == 1, "Verify frames, expected: 1, got: %u", stats.frames);
+   SDLTest_AssertCheck(stats.draw_calls == 4, "Verify draw_calls, expected: 4, got: %u", stats.draw_calls);
+   SDLTest_AssertCheck(stats.calls[SDL_RENDERSTAT_COPY] == 2, "Verify copy calls, expected: 2, got: %u", stats.calls[SDL_RENDERSTAT_COPY]);
+   SDLTest_AssertCheck(stats.calls[SDL_RENDERSTAT_FILLRECTS] == 1, "Verify fill calls, expected: 1, got: %u", stats.calls[SDL_RENDERSTAT_FILLRECTS]);
+   SDLTest_AssertCheck(stats.textures_created >= 1, "Verify textures_created, expected: >= 1, got: %u", stats.textures_created);
+   SDLTest_AssertCheck(stats.bytes_uploaded > 0, "Verify bytes_uploaded is not 0");
+
+   /* The next frame starts from zero again. */
+   SDL_RenderPresent(renderer);
+   ret = SDL_RenderGetStats(renderer, &stats);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderGetStats, expected: 0, got: %i", ret);
+   SDLTest_AssertCheck(stats.draw_calls == 0, "Verify draw_calls after present, expected: 0, got: %u", stats.draw_calls);
+
+   /* Clean up. */
+   SDL_RenderSetStatsEnabled(renderer, SDL_FALSE, SDL_FALSE);
+   SDL_DestroyTexture( tface );
+
+   return TEST_COMPLETED;
+}
+
+
 /**
  * @brief Blits doing color tests.
  *
@@ -1085,9 +1299,15 @@ static const SDLTest_TestCaseReference renderTest6 =
 static const SDLTest_TestCaseReference renderTest7 =
         {  (SDLTest_TestCaseFp)render_testBlitBlend, "render_testBlitBlend", "Tests blitting with blending", TEST_DISABLED };
 
+static const SDLTest_TestCaseReference renderTest8 =
+        { (SDLTest_TestCaseFp)render_testStats, "render_testStats", "Tests per frame render statistics", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest9 =
+        { (SDLTest_TestCaseFp)render_testBlitExTransforms, "render_testBlitExTransforms", "Tests blitting rotated, flipped and scaled", TEST_ENABLED };
+
 /* Sequence of Render test cases */
 static const SDLTest_TestCaseReference *renderTests[] =  {
-    &renderTest1, &renderTest2, &renderTest3, &renderTest4, &renderTest5, &renderTest6, &renderTest7, NULL
+    &renderTest1, &renderTest2, &renderTest3, &renderTest4, &renderTest5, &renderTest6, &renderTest7, &renderTest8, &renderTest9, NULL
 };
 
 /* Render test suite (global) */
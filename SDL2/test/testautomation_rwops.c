@@ -334,6 +334,73 @@ rwops_testFileRead(void)
    return TEST_COMPLETED;
 }
 
+/**
+ * @brief Tests reading from a memory-mapped file.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_RWFromFileMapped
+ * http://wiki.libsdl.org/moin.cgi/SDL_RWGetMemory
+ */
+int
+rwops_testFileMapped(void)
+{
+   SDL_RWops *rw;
+   const void *mem;
+   size_t size;
+   int result;
+
+   /* Missing files fail */
+   rw = SDL_RWFromFileMapped("rwops_missing");
+   SDLTest_AssertPass("Call to SDL_RWFromFileMapped() with a missing file succeeded");
+   SDLTest_AssertCheck(rw == NULL, "Verify opening a missing file with SDL_RWFromFileMapped returns NULL");
+   if (rw != NULL) SDL_RWclose(rw);
+
+   /* Read test. */
+   rw = SDL_RWFromFileMapped(RWopsReadTestFilename);
+   SDLTest_AssertPass("Call to SDL_RWFromFileMapped() succeeded");
+   SDLTest_AssertCheck(rw != NULL, "Verify opening file with SDL_RWFromFileMapped does not return NULL");
+
+   /* Bail out if NULL */
+   if (rw == NULL) return TEST_ABORTED;
+
+   /* Check type */
+   SDLTest_AssertCheck(rw->type == SDL_RWOPS_MAPPED, "Verify RWops type is SDL_RWOPS_MAPPED; expected: %d, got: %d", SDL_RWOPS_MAPPED, rw->type);
+
+   /* The file is readable in place */
+   size = 0;
+   mem = SDL_RWGetMemory(rw, &size);
+   SDLTest_AssertPass("Call to SDL_RWGetMemory() succeeded");
+   SDLTest_AssertCheck(mem != NULL, "Verify SDL_RWGetMemory does not return NULL");
+   SDLTest_AssertCheck(size == sizeof(RWopsHelloWorldTestString) - 1, "Verify size; expected: %d, got: %d", (int)sizeof(RWopsHelloWorldTestString) - 1, (int)size);
+   if (mem != NULL) {
+      SDLTest_AssertCheck(SDL_memcmp(mem, RWopsHelloWorldTestString, size) == 0, "Verify the memory holds the file contents");
+   }
+
+   /* Run generic tests */
+   _testGenericRWopsValidations( rw, 0 );
+
+   /* Close handle */
+   result = SDL_RWclose(rw);
+   SDLTest_AssertPass("Call to SDL_RWclose() succeeded");
+   SDLTest_AssertCheck(result == 0, "Verify result value is 0; got: %d", result);
+
+   /* Memory streams expose their memory, file streams don't */
+   rw = SDL_RWFromConstMem(RWopsHelloWorldCompString, sizeof(RWopsHelloWorldCompString) - 1);
+   if (rw != NULL) {
+      mem = SDL_RWGetMemory(rw, NULL);
+      SDLTest_AssertCheck(mem == RWopsHelloWorldCompString, "Verify SDL_RWGetMemory returns the memory of a const memory stream");
+      SDL_RWclose(rw);
+   }
+   rw = SDL_RWFromFile(RWopsReadTestFilename, "r");
+   if (rw != NULL) {
+      mem = SDL_RWGetMemory(rw, &size);
+      SDLTest_AssertCheck(mem == NULL, "Verify SDL_RWGetMemory returns NULL for a file stream");
+      SDL_RWclose(rw);
+   }
+
+   return TEST_COMPLETED;
+}
+
 /**
  * @brief Tests writing from file.
  *
@@ -733,10 +800,13 @@ static const SDLTest_TestCaseReference rwopsTest9 =
 static const SDLTest_TestCaseReference rwopsTest10 =
         { (SDLTest_TestCaseFp)rwops_testCompareRWFromMemWithRWFromFile, "rwops_testCompareRWFromMemWithRWFromFile", "Compare RWFromMem and RWFromFile RWops for read and seek", TEST_ENABLED };
 
+static const SDLTest_TestCaseReference rwopsTest11 =
+        { (SDLTest_TestCaseFp)rwops_testFileMapped, "rwops_testFileMapped", "Tests reading from a memory-mapped file", TEST_ENABLED };
+
 /* Sequence of RWops test cases */
 static const SDLTest_TestCaseReference *rwopsTests[] =  {
     &rwopsTest1, &rwopsTest2, &rwopsTest3, &rwopsTest4, &rwopsTest5, &rwopsTest6,
-    &rwopsTest7, &rwopsTest8, &rwopsTest9, &rwopsTest10, NULL
+    &rwopsTest7, &rwopsTest8, &rwopsTest9, &rwopsTest10, &rwopsTest11, NULL
 };
 
 /* RWops test suite (global) */
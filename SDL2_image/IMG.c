@@ -27,13 +27,53 @@
 
 #include "SDL_image.h"
 
+/* Texture atlases can be packed from the images in a directory, and
+   cached images are told apart by the canonical path and time of a file */
+#ifdef __WIN32__
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+#ifndef ARRAYSIZE
 #define ARRAYSIZE(a) (sizeof(a) / sizeof((a)[0]))
+#endif
+
+/* Files are mapped where SDL can, so the loaders read them from memory */
+#ifdef SDL_RWOPS_MAPPED
+#define IMG_RWFromFile(file)    SDL_RWFromFileMapped(file)
+#else
+#define IMG_RWFromFile(file)    SDL_RWFromFile(file, "rb")
+#endif
+
+/* Loaders able to decode into the pixel format textures are created in */
+extern SDL_Surface *IMG_LoadNativeJPG_RW(SDL_RWops *src, Uint32 opaque, Uint32 alpha);
+extern SDL_Surface *IMG_LoadNativePNG_RW(SDL_RWops *src, Uint32 opaque, Uint32 alpha);
+extern SDL_Surface *IMG_LoadNativeWEBP_RW(SDL_RWops *src, Uint32 opaque, Uint32 alpha);
+
+/* The GIF decoder can also stream the frames of an animation */
+extern void *IMG_OpenGIFFrames(SDL_RWops *src, int *width, int *height);
+extern int IMG_ReadGIFFrame(void *frames, SDL_RWops *src, SDL_Surface **image, SDL_Rect *rect, int *delay, int *disposal);
+extern void IMG_CloseGIFFrames(void *frames);
+
+#if !defined(__APPLE__) || defined(SDL_IMAGE_USE_COMMON_BACKEND)
+#define NATIVE_JPG  IMG_LoadNativeJPG_RW
+#define NATIVE_PNG  IMG_LoadNativePNG_RW
+#define GIF_FRAMES  1
+#else
+#define NATIVE_JPG  NULL
+#define NATIVE_PNG  NULL
+#define GIF_FRAMES  0   /* ImageIO loads GIFs, as still images */
+#endif
 
 /* Table of image detection and loading functions */
 static struct {
     char *type;
     int (SDLCALL *is)(SDL_RWops *src);
     SDL_Surface *(SDLCALL *load)(SDL_RWops *src);
+    SDL_Surface *(*load_native)(SDL_RWops *src, Uint32 opaque, Uint32 alpha);
 } supported[] = {
     /* keep magicless formats first */
     { "TGA", NULL,      IMG_LoadTGA_RW },
@@ -41,16 +81,59 @@ static struct {
     { "ICO", IMG_isICO, IMG_LoadICO_RW },
     { "BMP", IMG_isBMP, IMG_LoadBMP_RW },
     { "GIF", IMG_isGIF, IMG_LoadGIF_RW },
-    { "JPG", IMG_isJPG, IMG_LoadJPG_RW },
+    { "JPG", IMG_isJPG, IMG_LoadJPG_RW, NATIVE_JPG },
     { "LBM", IMG_isLBM, IMG_LoadLBM_RW },
     { "PCX", IMG_isPCX, IMG_LoadPCX_RW },
-    { "PNG", IMG_isPNG, IMG_LoadPNG_RW },
+    { "PNG", IMG_isPNG, IMG_LoadPNG_RW, NATIVE_PNG },
     { "PNM", IMG_isPNM, IMG_LoadPNM_RW }, /* P[BGP]M share code */
     { "TIF", IMG_isTIF, IMG_LoadTIF_RW },
     { "XCF", IMG_isXCF, IMG_LoadXCF_RW },
     { "XPM", IMG_isXPM, IMG_LoadXPM_RW },
     { "XV",  IMG_isXV,  IMG_LoadXV_RW  },
-    { "WEBP", IMG_isWEBP, IMG_LoadWEBP_RW },
+    { "WEBP", IMG_isWEBP, IMG_LoadWEBP_RW, IMG_LoadNativeWEBP_RW },
+};
+
+/* Signatures telling formats apart by the first bytes of the file, so
+   the type can be found with a single read.  Some formats need a second
+   magic further in.  Formats without a signature are only loaded when
+   named by the type hint.
+ */
+#define IMG_SNIFF_SIZE  32
+
+static const struct {
+    char *type;
+    int offset;
+    const char *magic;
+    int size;
+    int offset2;
+    const char *magic2;
+    int size2;
+} signatures[] = {
+    { "CUR",  0, "\0\0\2\0", 4 },
+    { "ICO",  0, "\0\0\1\0", 4 },
+    { "BMP",  0, "BM", 2 },
+    { "GIF",  0, "GIF87a", 6 },
+    { "GIF",  0, "GIF89a", 6 },
+    { "JPG",  0, "\xFF\xD8\xFF", 3 },
+    { "LBM",  0, "FORM", 4, 8, "PBM ", 4 },
+    { "LBM",  0, "FORM", 4, 8, "ILBM", 4 },
+    { "PCX",  0, "\x0A\x05\x00", 3 },
+    { "PCX",  0, "\x0A\x05\x01", 3 },
+    { "PNG",  0, "\x89PNG", 4 },
+    { "PNM",  0, "P1", 2 },
+    { "PNM",  0, "P2", 2 },
+    { "PNM",  0, "P3", 2 },
+    { "PNM",  0, "P4", 2 },
+    { "PNM",  0, "P5", 2 },
+    { "PNM",  0, "P6", 2 },
+    { "TIF",  0, "II\x2A\0", 4 },
+    { "TIF",  0, "MM\0\x2A", 4 },
+    { "XCF",  0, "gimp xcf ", 9 },
+    { "XPM",  0, "/* XPM */", 9 },
+    { "XV",   0, "P7 332", 6 },
+    { "WEBP", 0, "RIFF", 4, 8, "WEBPVP8 ", 8 },
+    { "WEBP", 0, "RIFF", 4, 8, "WEBPVP8X", 8 },
+    { "WEBP", 0, "RIFF", 4, 8, "WEBPVP8L", 8 },
 };
 
 const SDL_version *IMG_Linked_Version(void)
@@ -101,7 +184,11 @@ int IMG_Init(int flags)
             result |= IMG_INIT_WEBP;
         }
     }
-    initialized |= result;
+    /* Loaders call this on every image, maybe from several threads once
+       everything is loaded, so leave the flags alone when nothing's new */
+    if ((initialized & result) != result) {
+        initialized |= result;
+    }
 
     return result;
 }
@@ -127,7 +214,7 @@ void IMG_Quit()
 /* Load an image from a file */
 SDL_Surface *IMG_Load(const char *file)
 {
-    SDL_RWops *src = SDL_RWFromFile(file, "rb");
+    SDL_RWops *src = IMG_RWFromFile(file);
     const char *ext = SDL_strrchr(file, '.');
     if(ext) {
         ext++;
@@ -159,8 +246,103 @@ static int IMG_string_equals(const char *str1, const char *str2)
     return (!*str1 && !*str2);
 }
 
-/* Load an image from an SDL datasource, optionally specifying the type */
-SDL_Surface *IMG_LoadTyped_RW(SDL_RWops *src, int freesrc, const char *type)
+/* Find where the red, green, blue and alpha (or unused) bytes of a pixel
+   sit in memory, for loaders decoding into a 32-bit format.  Returns 0,
+   or -1 if the format doesn't have a byte for each channel.
+ */
+int IMG_FormatByteOrder(Uint32 format, int order[4])
+{
+    Uint32 masks[4];
+    int bpp;
+    int used = 0;
+    int i, shift;
+
+    if ( format == 0 || SDL_ISPIXELFORMAT_FOURCC(format) ||
+         !SDL_PixelFormatEnumToMasks(format, &bpp,
+                &masks[0], &masks[1], &masks[2], &masks[3]) || bpp != 32 ) {
+        return -1;
+    }
+    for ( i = 0; i < 4; ++i ) {
+        if ( masks[i] == 0 ) {
+            continue;
+        }
+        for ( shift = 0; shift < 32 && masks[i] != (0xFFu << shift); shift += 8 )
+            ;
+        if ( shift == 32 ) {
+            return -1;
+        }
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+        order[i] = shift / 8;
+#else
+        order[i] = 3 - shift / 8;
+#endif
+        used |= 1 << order[i];
+    }
+    if ( masks[0] == 0 || masks[1] == 0 || masks[2] == 0 ) {
+        return -1;
+    }
+    if ( masks[3] == 0 ) {
+        /* The byte left over is padding */
+        for ( i = 0; used & (1 << i); ++i )
+            ;
+        order[3] = i;
+    }
+    return 0;
+}
+
+/* Find the entry in supported[] for an image: a magicless format named
+   by the type hint, or else the format whose signature the first bytes
+   of the image match.  Returns -1 if the type isn't known.
+ */
+static int IMG_DetectType(SDL_RWops *src, const char *type)
+{
+    Uint8 magic[IMG_SNIFF_SIZE];
+    Sint64 start;
+    int size;
+    int i, j;
+
+    /* magicless formats */
+    if ( type ) {
+        for ( i=0; i < ARRAYSIZE(supported); ++i ) {
+            if ( !supported[i].is && IMG_string_equals(type, supported[i].type) ) {
+                return i;
+            }
+        }
+    }
+
+    start = SDL_RWtell(src);
+    size = (int)SDL_RWread(src, magic, 1, sizeof(magic));
+    SDL_RWseek(src, start, RW_SEEK_SET);
+
+    for ( j=0; j < ARRAYSIZE(signatures); ++j ) {
+        if ( signatures[j].offset + signatures[j].size > size ||
+             SDL_memcmp(magic + signatures[j].offset, signatures[j].magic, signatures[j].size) != 0 ) {
+            continue;
+        }
+        if ( signatures[j].magic2 &&
+             (signatures[j].offset2 + signatures[j].size2 > size ||
+              SDL_memcmp(magic + signatures[j].offset2, signatures[j].magic2, signatures[j].size2) != 0) ) {
+            continue;
+        }
+        /* icons and cursors must hold at least one image */
+        if ( (SDL_strcmp(signatures[j].type, "ICO") == 0 ||
+              SDL_strcmp(signatures[j].type, "CUR") == 0) &&
+             (size < 6 || (magic[4] | magic[5]) == 0) ) {
+            continue;
+        }
+        for ( i=0; i < ARRAYSIZE(supported); ++i ) {
+            if ( IMG_string_equals(signatures[j].type, supported[i].type) ) {
+                return i;
+            }
+        }
+    }
+    return -1;
+}
+
+/* Load an image, decoding it into the opaque or alpha format if its
+   loader can, and in whatever format suits the image otherwise */
+static SDL_Surface *IMG_LoadFormat_RW(SDL_RWops *src, int freesrc, const char *type,
+                                      Uint32 opaque, Uint32 alpha)
 {
     int i;
     SDL_Surface *image;
@@ -180,37 +362,398 @@ SDL_Surface *IMG_LoadTyped_RW(SDL_RWops *src, int freesrc, const char *type)
     }
 
     /* Detect the type of image being loaded */
-    image = NULL;
-    for ( i=0; i < ARRAYSIZE(supported); ++i ) {
-        if(supported[i].is) {
-            if(!supported[i].is(src))
-                continue;
-        } else {
-            /* magicless format */
-            if(!type
-               || !IMG_string_equals(type, supported[i].type))
-                continue;
+    i = IMG_DetectType(src, type);
+    if ( i < 0 ) {
+        if ( freesrc ) {
+            SDL_RWclose(src);
         }
+        IMG_SetError("Unsupported image format");
+        return NULL;
+    }
 #ifdef DEBUG_IMGLIB
-        fprintf(stderr, "IMGLIB: Loading image as %s\n",
-            supported[i].type);
+    fprintf(stderr, "IMGLIB: Loading image as %s\n",
+        supported[i].type);
 #endif
+
+    /* Loaders that aren't compiled in fail without saying why */
+    SDL_ClearError();
+    if ( supported[i].load_native && (opaque || alpha) ) {
+        image = supported[i].load_native(src, opaque, alpha);
+    } else {
         image = supported[i].load(src);
-        if(freesrc)
+    }
+    if ( !image && !*SDL_GetError() ) {
+        IMG_SetError("Unsupported image format");
+    }
+    if(freesrc)
+        SDL_RWclose(src);
+    return image;
+}
+
+/* Load an image from an SDL datasource, optionally specifying the type */
+SDL_Surface *IMG_LoadTyped_RW(SDL_RWops *src, int freesrc, const char *type)
+{
+    return IMG_LoadFormat_RW(src, freesrc, type, 0, 0);
+}
+
+/* A frame kept in memory, as the canvas looked once it was drawn */
+typedef struct {
+    SDL_Surface *canvas;
+    IMG_AnimationFrame frame;
+} IMG_CachedFrame;
+
+struct _IMG_Animation {
+    SDL_RWops *src;
+    int freesrc;
+    void *gif;                  /* the GIF decoder, NULL for still images */
+    Sint64 first;               /* where the first frame starts */
+    SDL_Surface *canvas;
+    SDL_Surface *previous;      /* the canvas before a frame disposed to previous */
+    IMG_AnimationFrame shown;   /* the frame last drawn, still to be disposed */
+    int index;                  /* the next frame to return */
+    int decoded;                /* the next frame the decoder will read */
+    int frames;                 /* the number of frames, -1 until the end is seen */
+    IMG_CachedFrame *cache;
+    int cache_size;
+    int cached;
+    Sint64 resume;              /* where decoding goes on after a full cache */
+    SDL_Surface *resume_previous;
+};
+
+static SDL_Surface *IMG_CreateCanvas(int width, int height)
+{
+    /* New surfaces come cleared, which is transparent in ARGB8888 */
+    SDL_Surface *canvas = SDL_CreateRGBSurface(0, width, height, 32,
+                                               0x00FF0000, 0x0000FF00,
+                                               0x000000FF, 0xFF000000);
+    if (canvas) {
+        SDL_SetSurfaceBlendMode(canvas, SDL_BLENDMODE_NONE);
+    }
+    return canvas;
+}
+
+static void IMG_CopyCanvas(SDL_Surface *dst, SDL_Surface *src)
+{
+    SDL_memcpy(dst->pixels, src->pixels, src->h * src->pitch);
+}
+
+static SDL_Surface *IMG_DuplicateCanvas(SDL_Surface *canvas, SDL_Surface *copy)
+{
+    if (!copy) {
+        copy = IMG_CreateCanvas(canvas->w, canvas->h);
+        if (!copy) {
+            return NULL;
+        }
+    }
+    IMG_CopyCanvas(copy, canvas);
+    return copy;
+}
+
+static IMG_Disposal IMG_GIFDisposal(int disposal)
+{
+    switch (disposal) {
+    case 2:
+        return IMG_DISPOSE_BACKGROUND;
+    case 3:
+        return IMG_DISPOSE_PREVIOUS;
+    default:
+        return IMG_DISPOSE_NONE;
+    }
+}
+
+IMG_Animation *IMG_OpenAnimation(const char *file, int cache_frames)
+{
+    SDL_RWops *src = IMG_RWFromFile(file);
+    if (!src) {
+        /* The error message has been set in SDL_RWFromFile */
+        return NULL;
+    }
+    return IMG_OpenAnimation_RW(src, 1, cache_frames);
+}
+
+IMG_Animation *IMG_OpenAnimation_RW(SDL_RWops *src, int freesrc, int cache_frames)
+{
+    IMG_Animation *anim;
+    int width, height;
+
+    if (!src) {
+        /* The error message has been set in SDL_RWFromFile */
+        return NULL;
+    }
+    anim = (IMG_Animation *)SDL_calloc(1, sizeof(*anim));
+    if (!anim) {
+        SDL_OutOfMemory();
+        if (freesrc) {
             SDL_RWclose(src);
-        return image;
+        }
+        return NULL;
     }
+    anim->src = src;
+    anim->freesrc = freesrc;
+    anim->frames = -1;
 
-    if ( freesrc ) {
-        SDL_RWclose(src);
+    if (GIF_FRAMES && IMG_isGIF(src)) {
+        anim->gif = IMG_OpenGIFFrames(src, &width, &height);
+        if (!anim->gif) {
+            goto error;
+        }
+        anim->first = SDL_RWtell(src);
+        anim->canvas = IMG_CreateCanvas(width, height);
+        if (!anim->canvas) {
+            goto error;
+        }
+        if (cache_frames > 0) {
+            anim->cache = (IMG_CachedFrame *)SDL_calloc(cache_frames, sizeof(*anim->cache));
+            if (!anim->cache) {
+                SDL_OutOfMemory();
+                goto error;
+            }
+            anim->cache_size = cache_frames;
+        }
+    } else {
+        /* Anything else is a single frame, served from the cache */
+        SDL_Surface *image = IMG_LoadTyped_RW(src, 0, NULL);
+        if (!image) {
+            goto error;
+        }
+        anim->cache = (IMG_CachedFrame *)SDL_calloc(1, sizeof(*anim->cache));
+        if (!anim->cache) {
+            SDL_FreeSurface(image);
+            SDL_OutOfMemory();
+            goto error;
+        }
+        anim->cache_size = 1;
+        anim->cache[0].canvas = SDL_ConvertSurfaceFormat(image, SDL_PIXELFORMAT_ARGB8888, 0);
+        SDL_FreeSurface(image);
+        if (!anim->cache[0].canvas) {
+            goto error;
+        }
+        anim->cache[0].frame.rect.w = anim->cache[0].canvas->w;
+        anim->cache[0].frame.rect.h = anim->cache[0].canvas->h;
+        anim->cached = 1;
+        anim->frames = 1;
+
+        if (freesrc) {
+            SDL_RWclose(src);
+        }
+        anim->src = NULL;
     }
-    IMG_SetError("Unsupported image format");
+    return anim;
+
+error:
+    IMG_CloseAnimation(anim);
     return NULL;
 }
 
+static void IMG_DisposeFrame(IMG_Animation *anim)
+{
+    switch (anim->shown.disposal) {
+    case IMG_DISPOSE_BACKGROUND:
+        SDL_FillRect(anim->canvas, &anim->shown.rect, 0);
+        break;
+    case IMG_DISPOSE_PREVIOUS:
+        IMG_CopyCanvas(anim->canvas, anim->previous);
+        break;
+    default:
+        break;
+    }
+    anim->shown.disposal = IMG_DISPOSE_NONE;
+}
+
+static int IMG_CacheFrame(IMG_Animation *anim, const IMG_AnimationFrame *frame)
+{
+    IMG_CachedFrame *entry = &anim->cache[frame->index];
+
+    entry->canvas = IMG_DuplicateCanvas(anim->canvas, NULL);
+    if (!entry->canvas) {
+        return -1;
+    }
+    entry->frame = *frame;
+    anim->cached = frame->index + 1;
+
+    if (anim->cached == anim->cache_size) {
+        /* Remember how to carry on decoding after the last cached frame */
+        anim->resume = SDL_RWtell(anim->src);
+        if (frame->disposal == IMG_DISPOSE_PREVIOUS) {
+            anim->resume_previous = IMG_DuplicateCanvas(anim->previous, NULL);
+            if (!anim->resume_previous) {
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+int IMG_ReadAnimationFrame(IMG_Animation *anim, SDL_Surface **canvas, IMG_AnimationFrame *frame)
+{
+    SDL_Surface *image;
+    SDL_Rect rect, bounds;
+    int delay, disposal, status;
+
+    if (!anim) {
+        IMG_SetError("Passed a NULL animation");
+        return -1;
+    }
+    if (anim->frames >= 0 && anim->index >= anim->frames) {
+        return 0;
+    }
+
+    if (anim->index < anim->cached) {
+        *canvas = anim->cache[anim->index].canvas;
+        *frame = anim->cache[anim->index].frame;
+        ++anim->index;
+        return 1;
+    }
+
+    if (anim->index != anim->decoded) {
+        /* Replayed the cache, pick decoding up where the cache ends */
+        IMG_CachedFrame *last = &anim->cache[anim->index - 1];
+
+        IMG_CopyCanvas(anim->canvas, last->canvas);
+        anim->shown = last->frame;
+        if (anim->shown.disposal == IMG_DISPOSE_PREVIOUS) {
+            IMG_CopyCanvas(anim->previous, anim->resume_previous);
+        }
+        if (SDL_RWseek(anim->src, anim->resume, RW_SEEK_SET) < 0) {
+            return -1;
+        }
+        anim->decoded = anim->index;
+    }
+
+    IMG_DisposeFrame(anim);
+    status = IMG_ReadGIFFrame(anim->gif, anim->src, &image, &rect, &delay, &disposal);
+    if (status <= 0) {
+        if (status == 0) {
+            anim->frames = anim->index;
+        }
+        return status;
+    }
+
+    frame->index = anim->index;
+    frame->delay = delay;
+    frame->disposal = IMG_GIFDisposal(disposal);
+    bounds.x = 0;
+    bounds.y = 0;
+    bounds.w = anim->canvas->w;
+    bounds.h = anim->canvas->h;
+    if (!SDL_IntersectRect(&rect, &bounds, &frame->rect)) {
+        SDL_zero(frame->rect);
+    }
+
+    if (frame->disposal == IMG_DISPOSE_PREVIOUS) {
+        anim->previous = IMG_DuplicateCanvas(anim->canvas, anim->previous);
+        if (!anim->previous) {
+            SDL_FreeSurface(image);
+            return -1;
+        }
+    }
+    status = SDL_BlitSurface(image, NULL, anim->canvas, &rect);
+    SDL_FreeSurface(image);
+    if (status < 0) {
+        return -1;
+    }
+    anim->shown = *frame;
+
+    if (frame->index < anim->cache_size && IMG_CacheFrame(anim, frame) < 0) {
+        return -1;
+    }
+    ++anim->index;
+    anim->decoded = anim->index;
+
+    *canvas = anim->canvas;
+    return 1;
+}
+
+int IMG_RewindAnimation(IMG_Animation *anim)
+{
+    if (!anim) {
+        IMG_SetError("Passed a NULL animation");
+        return -1;
+    }
+    anim->index = 0;
+    if (anim->cached > 0) {
+        /* The cache is replayed, then decoding carries on after it */
+        return 0;
+    }
+    if (SDL_RWseek(anim->src, anim->first, RW_SEEK_SET) < 0) {
+        return -1;
+    }
+    SDL_FillRect(anim->canvas, NULL, 0);
+    anim->shown.disposal = IMG_DISPOSE_NONE;
+    anim->decoded = 0;
+    return 0;
+}
+
+void IMG_CloseAnimation(IMG_Animation *anim)
+{
+    int i;
+
+    if (!anim) {
+        return;
+    }
+    for (i = 0; i < anim->cached; ++i) {
+        SDL_FreeSurface(anim->cache[i].canvas);
+    }
+    SDL_free(anim->cache);
+    SDL_FreeSurface(anim->resume_previous);
+    SDL_FreeSurface(anim->previous);
+    SDL_FreeSurface(anim->canvas);
+    if (anim->gif) {
+        IMG_CloseGIFFrames(anim->gif);
+    }
+    if (anim->src && anim->freesrc) {
+        SDL_RWclose(anim->src);
+    }
+    SDL_free(anim);
+}
+
 #if SDL_VERSION_ATLEAST(2,0,0)
+/* The formats SDL_CreateTextureFromSurface() picks for images without
+   and with alpha.  Images decoded into them are uploaded as they are.
+ */
+static void IMG_TextureFormats(SDL_Renderer *renderer, Uint32 *opaque, Uint32 *alpha)
+{
+    SDL_RendererInfo info;
+    SDL_bool found_opaque = SDL_FALSE;
+    SDL_bool found_alpha = SDL_FALSE;
+    Uint32 i;
+
+    *opaque = *alpha = 0;
+    if ( SDL_GetRendererInfo(renderer, &info) < 0 || info.num_texture_formats == 0 ) {
+        return;
+    }
+    *opaque = *alpha = info.texture_formats[0];
+    for ( i = 0; i < info.num_texture_formats; ++i ) {
+        Uint32 format = info.texture_formats[i];
+        if ( SDL_ISPIXELFORMAT_FOURCC(format) ) {
+            continue;
+        }
+        if ( SDL_ISPIXELFORMAT_ALPHA(format) ) {
+            if ( !found_alpha ) {
+                *alpha = format;
+                found_alpha = SDL_TRUE;
+            }
+        } else if ( !found_opaque ) {
+            *opaque = format;
+            found_opaque = SDL_TRUE;
+        }
+    }
+}
+
 SDL_Texture *IMG_LoadTexture(SDL_Renderer *renderer, const char *file)
 {
+#if !defined(__APPLE__) || defined(SDL_IMAGE_USE_COMMON_BACKEND)
+    SDL_RWops *src = IMG_RWFromFile(file);
+    const char *ext = SDL_strrchr(file, '.');
+    if(ext) {
+        ext++;
+    }
+    if(!src) {
+        /* The error message has been set in SDL_RWFromFile */
+        return NULL;
+    }
+    return IMG_LoadTextureTyped_RW(renderer, src, 1, ext);
+#else
     SDL_Texture *texture = NULL;
     SDL_Surface *surface = IMG_Load(file);
     if (surface) {
@@ -218,27 +761,1797 @@ SDL_Texture *IMG_LoadTexture(SDL_Renderer *renderer, const char *file)
         SDL_FreeSurface(surface);
     }
     return texture;
+#endif
 }
 
 SDL_Texture *IMG_LoadTexture_RW(SDL_Renderer *renderer, SDL_RWops *src, int freesrc)
 {
-    SDL_Texture *texture = NULL;
-    SDL_Surface *surface = IMG_Load_RW(src, freesrc);
-    if (surface) {
-        texture = SDL_CreateTextureFromSurface(renderer, surface);
-        SDL_FreeSurface(surface);
-    }
-    return texture;
+    return IMG_LoadTextureTyped_RW(renderer, src, freesrc, NULL);
 }
 
 SDL_Texture *IMG_LoadTextureTyped_RW(SDL_Renderer *renderer, SDL_RWops *src, int freesrc, const char *type)
 {
     SDL_Texture *texture = NULL;
-    SDL_Surface *surface = IMG_LoadTyped_RW(src, freesrc, type);
+    SDL_Surface *surface;
+    Uint32 opaque, alpha;
+
+    IMG_TextureFormats(renderer, &opaque, &alpha);
+    surface = IMG_LoadFormat_RW(src, freesrc, type, opaque, alpha);
     if (surface) {
         texture = SDL_CreateTextureFromSurface(renderer, surface);
         SDL_FreeSurface(surface);
     }
     return texture;
 }
+
+/* Background loading */
+
+enum {
+    IMG_ASYNC_QUEUED,
+    IMG_ASYNC_DECODING,
+    IMG_ASYNC_DECODED
+};
+
+typedef struct _IMG_AsyncJob {
+    Uint32 id;
+    int priority;
+    int state;
+    SDL_bool cancelled;
+    char *file;
+    IMG_AsyncCallback callback;
+    void *userdata;
+    SDL_Surface *surface;
+    char *error;
+    struct _IMG_AsyncJob *next;
+} IMG_AsyncJob;
+
+struct _IMG_AsyncLoader {
+    SDL_Renderer *renderer;
+    Uint32 opaque;
+    Uint32 alpha;
+    Uint32 event_type;
+    SDL_mutex *lock;
+    SDL_cond *wake;
+    SDL_Thread **threads;
+    int num_threads;
+    SDL_bool quit;
+    Uint32 next_id;
+    IMG_AsyncJob *jobs;     /* highest priority first, then oldest first */
+};
+
+static void IMG_FreeAsyncJob(IMG_AsyncJob *job)
+{
+    if ( job->surface ) {
+        SDL_FreeSurface(job->surface);
+    }
+    SDL_free(job->error);
+    SDL_free(job->file);
+    SDL_free(job);
+}
+
+static void IMG_InsertAsyncJob(IMG_AsyncLoader *loader, IMG_AsyncJob *job)
+{
+    IMG_AsyncJob **prev = &loader->jobs;
+
+    while ( *prev && (*prev)->priority >= job->priority ) {
+        prev = &(*prev)->next;
+    }
+    job->next = *prev;
+    *prev = job;
+}
+
+/* Unlink a job from the list, returning it */
+static IMG_AsyncJob *IMG_RemoveAsyncJob(IMG_AsyncLoader *loader, IMG_AsyncJob *job)
+{
+    IMG_AsyncJob **prev = &loader->jobs;
+
+    while ( *prev != job ) {
+        prev = &(*prev)->next;
+    }
+    *prev = job->next;
+    job->next = NULL;
+    return job;
+}
+
+static IMG_AsyncJob *IMG_FindAsyncJob(IMG_AsyncLoader *loader, Uint32 id, int state)
+{
+    IMG_AsyncJob *job;
+
+    for ( job = loader->jobs; job; job = job->next ) {
+        if ( job->cancelled ) {
+            continue;
+        }
+        if ( id ? (job->id == id) : (job->state == state) ) {
+            return job;
+        }
+    }
+    return NULL;
+}
+
+static SDL_Surface *IMG_DecodeAsyncJob(IMG_AsyncLoader *loader, const char *file)
+{
+    SDL_RWops *src = IMG_RWFromFile(file);
+    const char *ext = SDL_strrchr(file, '.');
+
+    if ( ext ) {
+        ext++;
+    }
+    if ( !src ) {
+        return NULL;
+    }
+    return IMG_LoadFormat_RW(src, 1, ext, loader->opaque, loader->alpha);
+}
+
+static int SDLCALL IMG_AsyncThread(void *data)
+{
+    IMG_AsyncLoader *loader = (IMG_AsyncLoader *)data;
+    IMG_AsyncJob *job;
+    SDL_Surface *surface;
+    SDL_Event event;
+
+    SDL_LockMutex(loader->lock);
+    while ( !loader->quit ) {
+        job = IMG_FindAsyncJob(loader, 0, IMG_ASYNC_QUEUED);
+        if ( !job ) {
+            SDL_CondWait(loader->wake, loader->lock);
+            continue;
+        }
+        job->state = IMG_ASYNC_DECODING;
+        SDL_UnlockMutex(loader->lock);
+
+        surface = IMG_DecodeAsyncJob(loader, job->file);
+
+        SDL_LockMutex(loader->lock);
+        if ( job->cancelled ) {
+            if ( surface ) {
+                SDL_FreeSurface(surface);
+            }
+            IMG_FreeAsyncJob(IMG_RemoveAsyncJob(loader, job));
+            continue;
+        }
+        job->surface = surface;
+        if ( !surface ) {
+            job->error = SDL_strdup(IMG_GetError());
+        }
+        job->state = IMG_ASYNC_DECODED;
+
+        /* Push the event unlocked, in case an event watcher calls back in */
+        if ( loader->event_type != (Uint32)-1 ) {
+            SDL_zero(event);
+            event.type = loader->event_type;
+            event.user.code = (Sint32)job->id;
+            event.user.data1 = job->userdata;
+            SDL_UnlockMutex(loader->lock);
+            SDL_PushEvent(&event);
+            SDL_LockMutex(loader->lock);
+        }
+    }
+    SDL_UnlockMutex(loader->lock);
+    return 0;
+}
+
+IMG_AsyncLoader *IMG_CreateAsyncLoader(SDL_Renderer *renderer, int threads)
+{
+    IMG_AsyncLoader *loader;
+    int i;
+
+    if ( !renderer ) {
+        IMG_SetError("Parameter 'renderer' is invalid");
+        return NULL;
+    }
+    if ( threads <= 0 ) {
+        threads = SDL_max(SDL_GetCPUCount() - 1, 1);
+    }
+
+    loader = (IMG_AsyncLoader *)SDL_calloc(1, sizeof(*loader));
+    if ( !loader ) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    loader->renderer = renderer;
+    loader->next_id = 1;
+    IMG_TextureFormats(renderer, &loader->opaque, &loader->alpha);
+    loader->event_type = SDL_RegisterEvents(1);
+
+    /* IMG_Init() isn't safe to call from several threads at once, so
+       load whatever libraries the workers might need up front */
+    IMG_Init(IMG_INIT_JPG | IMG_INIT_PNG | IMG_INIT_TIF | IMG_INIT_WEBP);
+
+    loader->lock = SDL_CreateMutex();
+    loader->wake = SDL_CreateCond();
+    loader->threads = (SDL_Thread **)SDL_calloc(threads, sizeof(*loader->threads));
+    if ( !loader->lock || !loader->wake || !loader->threads ) {
+        IMG_FreeAsyncLoader(loader);
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    for ( i = 0; i < threads; ++i ) {
+        loader->threads[i] = SDL_CreateThread(IMG_AsyncThread, "IMG_Async", loader);
+        if ( !loader->threads[i] ) {
+            break;
+        }
+        ++loader->num_threads;
+    }
+    if ( loader->num_threads == 0 ) {
+        IMG_FreeAsyncLoader(loader);
+        return NULL;
+    }
+    return loader;
+}
+
+Uint32 IMG_LoadAsync(IMG_AsyncLoader *loader, const char *file, int priority, IMG_AsyncCallback callback, void *userdata)
+{
+    IMG_AsyncJob *job;
+    Uint32 id;
+
+    if ( !loader || !file || !callback ) {
+        IMG_SetError("Parameter '%s' is invalid", !loader ? "loader" : !file ? "file" : "callback");
+        return 0;
+    }
+    job = (IMG_AsyncJob *)SDL_calloc(1, sizeof(*job));
+    if ( job ) {
+        job->file = SDL_strdup(file);
+    }
+    if ( !job || !job->file ) {
+        SDL_free(job);
+        SDL_OutOfMemory();
+        return 0;
+    }
+    job->priority = priority;
+    job->state = IMG_ASYNC_QUEUED;
+    job->callback = callback;
+    job->userdata = userdata;
+
+    SDL_LockMutex(loader->lock);
+    id = job->id = loader->next_id++;
+    if ( loader->next_id == 0 ) {
+        loader->next_id = 1;
+    }
+    IMG_InsertAsyncJob(loader, job);
+    SDL_CondSignal(loader->wake);
+    SDL_UnlockMutex(loader->lock);
+
+    return id;
+}
+
+int IMG_SetAsyncPriority(IMG_AsyncLoader *loader, Uint32 job, int priority)
+{
+    IMG_AsyncJob *found;
+
+    if ( !loader || !job ) {
+        return -1;
+    }
+    SDL_LockMutex(loader->lock);
+    found = IMG_FindAsyncJob(loader, job, 0);
+    if ( found ) {
+        IMG_RemoveAsyncJob(loader, found);
+        found->priority = priority;
+        IMG_InsertAsyncJob(loader, found);
+    }
+    SDL_UnlockMutex(loader->lock);
+
+    return found ? 0 : -1;
+}
+
+int IMG_CancelAsync(IMG_AsyncLoader *loader, Uint32 job)
+{
+    IMG_AsyncJob *found;
+
+    if ( !loader || !job ) {
+        return -1;
+    }
+    SDL_LockMutex(loader->lock);
+    found = IMG_FindAsyncJob(loader, job, 0);
+    if ( found ) {
+        if ( found->state == IMG_ASYNC_DECODING ) {
+            /* The worker frees it when it's done */
+            found->cancelled = SDL_TRUE;
+        } else {
+            IMG_FreeAsyncJob(IMG_RemoveAsyncJob(loader, found));
+        }
+    }
+    SDL_UnlockMutex(loader->lock);
+
+    return found ? 0 : -1;
+}
+
+int IMG_UpdateAsync(IMG_AsyncLoader *loader, Uint32 budget_ms)
+{
+    Uint64 start = SDL_GetPerformanceCounter();
+    Uint64 budget = (SDL_GetPerformanceFrequency() * budget_ms) / 1000;
+    IMG_AsyncJob *job;
+    SDL_Texture *texture;
+    int uploaded = 0;
+    int pending = 0;
+
+    if ( !loader ) {
+        return 0;
+    }
+
+    /* The job list says which images are ready, the events only wake
+       the application up */
+    if ( loader->event_type != (Uint32)-1 ) {
+        SDL_FlushEvent(loader->event_type);
+    }
+
+    SDL_LockMutex(loader->lock);
+    while ( (job = IMG_FindAsyncJob(loader, 0, IMG_ASYNC_DECODED)) != NULL ) {
+        if ( uploaded > 0 && SDL_GetPerformanceCounter() - start >= budget ) {
+            break;
+        }
+        IMG_RemoveAsyncJob(loader, job);
+        SDL_UnlockMutex(loader->lock);
+
+        texture = NULL;
+        if ( job->surface ) {
+            texture = SDL_CreateTextureFromSurface(loader->renderer, job->surface);
+        } else {
+            IMG_SetError("%s", job->error ? job->error : "Out of memory");
+        }
+        job->callback(job->userdata, job->id, texture);
+        IMG_FreeAsyncJob(job);
+        ++uploaded;
+
+        SDL_LockMutex(loader->lock);
+    }
+    for ( job = loader->jobs; job; job = job->next ) {
+        if ( !job->cancelled ) {
+            ++pending;
+        }
+    }
+    SDL_UnlockMutex(loader->lock);
+
+    return pending;
+}
+
+Uint32 IMG_GetAsyncEventType(IMG_AsyncLoader *loader)
+{
+    return loader ? loader->event_type : (Uint32)-1;
+}
+
+void IMG_FreeAsyncLoader(IMG_AsyncLoader *loader)
+{
+    IMG_AsyncJob *job;
+    int i;
+
+    if ( !loader ) {
+        return;
+    }
+    if ( loader->lock && loader->wake ) {
+        SDL_LockMutex(loader->lock);
+        loader->quit = SDL_TRUE;
+        SDL_CondBroadcast(loader->wake);
+        SDL_UnlockMutex(loader->lock);
+    }
+    for ( i = 0; i < loader->num_threads; ++i ) {
+        SDL_WaitThread(loader->threads[i], NULL);
+    }
+    while ( (job = loader->jobs) != NULL ) {
+        loader->jobs = job->next;
+        IMG_FreeAsyncJob(job);
+    }
+    if ( loader->event_type != (Uint32)-1 ) {
+        SDL_FlushEvent(loader->event_type);
+    }
+    if ( loader->wake ) {
+        SDL_DestroyCond(loader->wake);
+    }
+    if ( loader->lock ) {
+        SDL_DestroyMutex(loader->lock);
+    }
+    SDL_free(loader->threads);
+    SDL_free(loader);
+}
+
+/* Texture atlases */
+
+#define IMG_ATLAS_SIZE      2048
+#define IMG_ATLAS_HEADER    "IMGATLAS 1"
+
+typedef struct {
+    char *name;
+    int page;
+    SDL_Rect rect;
+} IMG_AtlasImage;
+
+typedef struct {
+    char *file;             /* where the page is saved, if it is */
+    SDL_Surface *surface;
+    SDL_Texture *texture;
+} IMG_AtlasPage;
+
+struct _IMG_Atlas {
+    IMG_AtlasImage *images; /* sorted by name */
+    int num_images;
+    IMG_AtlasPage *pages;
+    int num_pages;
+    SDL_Renderer *renderer; /* the one the textures were made for */
+};
+
+/* The free space left on a page being packed, as maximal rectangles */
+typedef struct {
+    SDL_Rect *rects;
+    int count;
+    int size;
+} IMG_FreeRects;
+
+static int IMG_AddFreeRect(IMG_FreeRects *free_rects, const SDL_Rect *rect)
+{
+    if ( free_rects->count == free_rects->size ) {
+        int size = free_rects->size ? free_rects->size * 2 : 16;
+        SDL_Rect *rects = (SDL_Rect *)SDL_realloc(free_rects->rects, size * sizeof(*rects));
+        if ( !rects ) {
+            return SDL_OutOfMemory();
+        }
+        free_rects->rects = rects;
+        free_rects->size = size;
+    }
+    free_rects->rects[free_rects->count++] = *rect;
+    return 0;
+}
+
+static SDL_bool IMG_RectContains(const SDL_Rect *outer, const SDL_Rect *inner)
+{
+    return (inner->x >= outer->x && inner->y >= outer->y &&
+            inner->x + inner->w <= outer->x + outer->w &&
+            inner->y + inner->h <= outer->y + outer->h) ? SDL_TRUE : SDL_FALSE;
+}
+
+/* Find the free rectangle leaving the shortest side over when a w by h
+   area is put in its corner, returning 0 if none is big enough */
+static int IMG_FindFreeRect(const IMG_FreeRects *free_rects, int w, int h, SDL_Rect *place, int *short_side, int *long_side)
+{
+    int i, over_w, over_h, s, l;
+    int found = 0;
+
+    for ( i = 0; i < free_rects->count; ++i ) {
+        const SDL_Rect *rect = &free_rects->rects[i];
+        if ( rect->w < w || rect->h < h ) {
+            continue;
+        }
+        over_w = rect->w - w;
+        over_h = rect->h - h;
+        s = SDL_min(over_w, over_h);
+        l = SDL_max(over_w, over_h);
+        if ( !found || s < *short_side || (s == *short_side && l < *long_side) ) {
+            place->x = rect->x;
+            place->y = rect->y;
+            place->w = w;
+            place->h = h;
+            *short_side = s;
+            *long_side = l;
+            found = 1;
+        }
+    }
+    return found;
+}
+
+/* Take a placed rectangle out of the free space: every free rectangle
+   it overlaps is replaced by the up to four pieces of it left around
+   the placed one, and pieces inside other free rectangles are dropped */
+static int IMG_UseFreeRect(IMG_FreeRects *free_rects, const SDL_Rect *used)
+{
+    IMG_FreeRects split;
+    SDL_Rect piece;
+    int i, j;
+
+    SDL_zero(split);
+    for ( i = 0; i < free_rects->count; ++i ) {
+        const SDL_Rect *rect = &free_rects->rects[i];
+        if ( !SDL_HasIntersection(rect, used) ) {
+            if ( IMG_AddFreeRect(&split, rect) < 0 ) {
+                goto failed;
+            }
+            continue;
+        }
+        if ( used->y > rect->y ) {
+            piece = *rect;
+            piece.h = used->y - rect->y;
+            if ( IMG_AddFreeRect(&split, &piece) < 0 ) {
+                goto failed;
+            }
+        }
+        if ( used->y + used->h < rect->y + rect->h ) {
+            piece = *rect;
+            piece.y = used->y + used->h;
+            piece.h = rect->y + rect->h - piece.y;
+            if ( IMG_AddFreeRect(&split, &piece) < 0 ) {
+                goto failed;
+            }
+        }
+        if ( used->x > rect->x ) {
+            piece = *rect;
+            piece.w = used->x - rect->x;
+            if ( IMG_AddFreeRect(&split, &piece) < 0 ) {
+                goto failed;
+            }
+        }
+        if ( used->x + used->w < rect->x + rect->w ) {
+            piece = *rect;
+            piece.x = used->x + used->w;
+            piece.w = rect->x + rect->w - piece.x;
+            if ( IMG_AddFreeRect(&split, &piece) < 0 ) {
+                goto failed;
+            }
+        }
+    }
+
+    for ( i = 0; i < split.count; ++i ) {
+        for ( j = 0; j < split.count; ++j ) {
+            if ( i != j && IMG_RectContains(&split.rects[j], &split.rects[i]) &&
+                 (!IMG_RectContains(&split.rects[i], &split.rects[j]) || i > j) ) {
+                split.rects[i--] = split.rects[--split.count];
+                break;
+            }
+        }
+    }
+
+    SDL_free(free_rects->rects);
+    *free_rects = split;
+    return 0;
+
+failed:
+    SDL_free(split.rects);
+    return -1;
+}
+
+static int IMG_CompareAtlasImages(const void *a, const void *b)
+{
+    return SDL_strcmp(((const IMG_AtlasImage *)a)->name, ((const IMG_AtlasImage *)b)->name);
+}
+
+/* Sort the images by name for lookups, names must be unique */
+static int IMG_SortAtlasImages(IMG_Atlas *atlas)
+{
+    int i;
+
+    SDL_qsort(atlas->images, atlas->num_images, sizeof(*atlas->images), IMG_CompareAtlasImages);
+    for ( i = 1; i < atlas->num_images; ++i ) {
+        if ( SDL_strcmp(atlas->images[i - 1].name, atlas->images[i].name) == 0 ) {
+            return IMG_SetError("More than one image is named %s", atlas->images[i].name);
+        }
+    }
+    return 0;
+}
+
+static IMG_AtlasImage *IMG_FindAtlasImage(IMG_Atlas *atlas, const char *name)
+{
+    int lo = 0, hi = atlas->num_images - 1, mid, cmp;
+
+    while ( lo <= hi ) {
+        mid = (lo + hi) / 2;
+        cmp = SDL_strcmp(name, atlas->images[mid].name);
+        if ( cmp == 0 ) {
+            return &atlas->images[mid];
+        }
+        if ( cmp < 0 ) {
+            hi = mid - 1;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    return NULL;
+}
+
+static int IMG_AddAtlasImage(IMG_Atlas *atlas, const char *name, size_t length)
+{
+    IMG_AtlasImage *images;
+    char *copy;
+
+    images = (IMG_AtlasImage *)SDL_realloc(atlas->images, (atlas->num_images + 1) * sizeof(*images));
+    if ( !images ) {
+        return SDL_OutOfMemory();
+    }
+    atlas->images = images;
+    copy = (char *)SDL_malloc(length + 1);
+    if ( !copy ) {
+        return SDL_OutOfMemory();
+    }
+    SDL_memcpy(copy, name, length);
+    copy[length] = '\0';
+    SDL_zero(images[atlas->num_images]);
+    images[atlas->num_images++].name = copy;
+    return 0;
+}
+
+static int IMG_AddAtlasPage(IMG_Atlas *atlas)
+{
+    IMG_AtlasPage *pages;
+
+    pages = (IMG_AtlasPage *)SDL_realloc(atlas->pages, (atlas->num_pages + 1) * sizeof(*pages));
+    if ( !pages ) {
+        return SDL_OutOfMemory();
+    }
+    atlas->pages = pages;
+    SDL_zero(pages[atlas->num_pages]);
+    return atlas->num_pages++;
+}
+
+/* The length of a path up to and including its last separator */
+static size_t IMG_DirectoryLength(const char *path)
+{
+    size_t length = SDL_strlen(path);
+
+    while ( length > 0 && path[length - 1] != '/' && path[length - 1] != '\\' ) {
+        --length;
+    }
+    return length;
+}
+
+static char *IMG_JoinPath(const char *dir, size_t dir_length, const char *file, size_t file_length)
+{
+    char *path = (char *)SDL_malloc(dir_length + file_length + 2);
+
+    if ( !path ) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    SDL_memcpy(path, dir, dir_length);
+    if ( dir_length > 0 && dir[dir_length - 1] != '/' && dir[dir_length - 1] != '\\' ) {
+        path[dir_length++] = '/';
+    }
+    SDL_memcpy(path + dir_length, file, file_length);
+    path[dir_length + file_length] = '\0';
+    return path;
+}
+
+/* Read a whole text file, NUL-terminated */
+static char *IMG_ReadTextFile(const char *file)
+{
+    SDL_RWops *src = SDL_RWFromFile(file, "rb");
+    Sint64 size;
+    char *text;
+
+    if ( !src ) {
+        return NULL;
+    }
+    size = SDL_RWsize(src);
+    text = (size >= 0) ? (char *)SDL_malloc((size_t)size + 1) : NULL;
+    if ( !text ) {
+        SDL_OutOfMemory();
+    } else if ( size > 0 && SDL_RWread(src, text, (size_t)size, 1) != 1 ) {
+        SDL_free(text);
+        text = NULL;
+    } else {
+        text[size] = '\0';
+    }
+    SDL_RWclose(src);
+    return text;
+}
+
+/* Split off the next line of a text, without its line ending */
+static char *IMG_NextLine(char **text)
+{
+    char *line = *text;
+    char *end;
+
+    if ( !*line ) {
+        return NULL;
+    }
+    end = line;
+    while ( *end && *end != '\r' && *end != '\n' ) {
+        ++end;
+    }
+    *text = end;
+    while ( **text == '\r' || **text == '\n' ) {
+        ++*text;
+    }
+    *end = '\0';
+    return line;
+}
+
+/* Image files are told apart by their extension in a directory */
+static SDL_bool IMG_IsImageFile(const char *file)
+{
+    static const char *others[] = { "JPEG", "TIFF", "PBM", "PGM", "PPM" };
+    const char *ext = SDL_strrchr(file, '.');
+    int i;
+
+    if ( !ext || ext == file ) {
+        return SDL_FALSE;
+    }
+    ++ext;
+    for ( i = 0; i < ARRAYSIZE(supported); ++i ) {
+        if ( IMG_string_equals(ext, supported[i].type) ) {
+            return SDL_TRUE;
+        }
+    }
+    for ( i = 0; i < ARRAYSIZE(others); ++i ) {
+        if ( IMG_string_equals(ext, others[i]) ) {
+            return SDL_TRUE;
+        }
+    }
+    return SDL_FALSE;
+}
+
+/* The images to pack, named by their path without the extension */
+typedef struct {
+    char **files;
+    int count;
+    size_t name_start;      /* where the names start in the paths */
+} IMG_AtlasFiles;
+
+static int IMG_AddAtlasFile(IMG_AtlasFiles *files, char *path)
+{
+    char **list;
+
+    if ( !path ) {
+        return -1;
+    }
+    list = (char **)SDL_realloc(files->files, (files->count + 1) * sizeof(*list));
+    if ( !list ) {
+        SDL_free(path);
+        return SDL_OutOfMemory();
+    }
+    files->files = list;
+    list[files->count++] = path;
+    return 0;
+}
+
+#ifdef __WIN32__
+/* File names are UTF-8 in SDL, the wide Windows API takes UTF-16 */
+static WCHAR *IMG_UTF8ToWide(const char *utf8)
+{
+    return (WCHAR *)SDL_iconv_string("UTF-16LE", "UTF-8", utf8, SDL_strlen(utf8) + 1);
+}
+
+static char *IMG_WideToUTF8(const WCHAR *wide)
+{
+    return SDL_iconv_string("UTF-8", "UTF-16LE", (const char *)wide, (SDL_wcslen(wide) + 1) * sizeof(WCHAR));
+}
+#endif
+
+/* List the image files in a directory, returning 1 if it is one */
+static int IMG_ListAtlasDirectory(const char *dir, IMG_AtlasFiles *files)
+{
+    size_t dir_length = SDL_strlen(dir);
+#ifdef __WIN32__
+    WIN32_FIND_DATAW data;
+    HANDLE find;
+    char *pattern, *name;
+    WCHAR *wpattern;
+    int status = 0;
+
+    pattern = IMG_JoinPath(dir, dir_length, "*", 1);
+    if ( !pattern ) {
+        return -1;
+    }
+    wpattern = IMG_UTF8ToWide(pattern);
+    SDL_free(pattern);
+    if ( !wpattern ) {
+        return SDL_OutOfMemory();
+    }
+    find = FindFirstFileW(wpattern, &data);
+    SDL_free(wpattern);
+    if ( find == INVALID_HANDLE_VALUE ) {
+        return 0;
+    }
+    do {
+        if ( data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY ) {
+            continue;
+        }
+        name = IMG_WideToUTF8(data.cFileName);
+        if ( !name ) {
+            status = SDL_OutOfMemory();
+        } else if ( IMG_IsImageFile(name) ) {
+            status = IMG_AddAtlasFile(files, IMG_JoinPath(dir, dir_length, name, SDL_strlen(name)));
+        }
+        SDL_free(name);
+    } while ( status == 0 && FindNextFileW(find, &data) );
+    FindClose(find);
+    if ( status < 0 ) {
+        return -1;
+    }
+#else
+    DIR *handle = opendir(dir);
+    struct dirent *entry;
+    struct stat info;
+    char *path;
+
+    if ( !handle ) {
+        return 0;
+    }
+    while ( (entry = readdir(handle)) != NULL ) {
+        if ( !IMG_IsImageFile(entry->d_name) ) {
+            continue;
+        }
+        path = IMG_JoinPath(dir, dir_length, entry->d_name, SDL_strlen(entry->d_name));
+        if ( path && (stat(path, &info) < 0 || !S_ISREG(info.st_mode)) ) {
+            SDL_free(path);
+            continue;
+        }
+        if ( IMG_AddAtlasFile(files, path) < 0 ) {
+            closedir(handle);
+            return -1;
+        }
+    }
+    closedir(handle);
+#endif
+    files->name_start = dir_length;
+    if ( dir_length > 0 && dir[dir_length - 1] != '/' && dir[dir_length - 1] != '\\' ) {
+        ++files->name_start;
+    }
+    return 1;
+}
+
+/* List the image files in a manifest, one to a line relative to it,
+   skipping blank lines and lines starting with '#' */
+static int IMG_ReadAtlasManifest(const char *manifest, IMG_AtlasFiles *files)
+{
+    size_t dir_length = IMG_DirectoryLength(manifest);
+    char *text = IMG_ReadTextFile(manifest);
+    char *next = text;
+    char *line;
+    size_t length;
+
+    if ( !text ) {
+        return -1;
+    }
+    while ( (line = IMG_NextLine(&next)) != NULL ) {
+        while ( *line == ' ' || *line == '\t' ) {
+            ++line;
+        }
+        length = SDL_strlen(line);
+        while ( length > 0 && (line[length - 1] == ' ' || line[length - 1] == '\t') ) {
+            --length;
+        }
+        if ( length == 0 || *line == '#' ) {
+            continue;
+        }
+        if ( IMG_AddAtlasFile(files, IMG_JoinPath(manifest, dir_length, line, length)) < 0 ) {
+            SDL_free(text);
+            return -1;
+        }
+    }
+    SDL_free(text);
+    files->name_start = dir_length;
+    return 0;
+}
+
+static int IMG_CompareFiles(const void *a, const void *b)
+{
+    return SDL_strcmp(*(char * const *)a, *(char * const *)b);
+}
+
+/* An image to pack, with the padding after it */
+typedef struct {
+    int index;
+    int w;
+    int h;
+} IMG_AtlasPiece;
+
+/* Pack the biggest images first, which MaxRects does best with */
+static int IMG_ComparePieces(const void *a, const void *b)
+{
+    const IMG_AtlasPiece *pa = (const IMG_AtlasPiece *)a;
+    const IMG_AtlasPiece *pb = (const IMG_AtlasPiece *)b;
+    int da = SDL_max(pa->w, pa->h), db = SDL_max(pb->w, pb->h);
+
+    if ( da != db ) {
+        return db - da;
+    }
+    if ( pa->w * pa->h != pb->w * pb->h ) {
+        return pb->w * pb->h - pa->w * pa->h;
+    }
+    return pa->index - pb->index;
+}
+
+static int IMG_PowerOfTwo(int size)
+{
+    int power = 1;
+
+    while ( power < size ) {
+        power *= 2;
+    }
+    return power;
+}
+
+/* Lay out the images on pages, then draw them there */
+static int IMG_PackAtlas(IMG_Atlas *atlas, SDL_Surface **surfaces, int max_size, int padding)
+{
+    IMG_AtlasPiece *pieces;
+    IMG_FreeRects *free_rects = NULL, *more;
+    IMG_AtlasImage *image;
+    SDL_Rect place, bin;
+    int *extent = NULL;
+    int i, p, s, l, status = -1;
+
+    /* Pages are sized in powers of two, none of them over max_size */
+    while ( max_size & (max_size - 1) ) {
+        max_size &= max_size - 1;
+    }
+
+    pieces = (IMG_AtlasPiece *)SDL_malloc(atlas->num_images * sizeof(*pieces));
+    if ( !pieces ) {
+        return SDL_OutOfMemory();
+    }
+    for ( i = 0; i < atlas->num_images; ++i ) {
+        pieces[i].index = i;
+        pieces[i].w = surfaces[i]->w + padding;
+        pieces[i].h = surfaces[i]->h + padding;
+    }
+    SDL_qsort(pieces, atlas->num_images, sizeof(*pieces), IMG_ComparePieces);
+
+    /* The padding before the first row and column is left off the bins */
+    bin.x = 0;
+    bin.y = 0;
+    bin.w = max_size - padding;
+    bin.h = max_size - padding;
+    for ( i = 0; i < atlas->num_images; ++i ) {
+        image = &atlas->images[pieces[i].index];
+        if ( pieces[i].w > bin.w || pieces[i].h > bin.h ) {
+            IMG_SetError("%s is too big for a %dx%d atlas page", image->name, max_size, max_size);
+            goto done;
+        }
+        for ( p = 0; p < atlas->num_pages; ++p ) {
+            if ( IMG_FindFreeRect(&free_rects[p], pieces[i].w, pieces[i].h, &place, &s, &l) ) {
+                break;
+            }
+        }
+        if ( p == atlas->num_pages ) {
+            more = (IMG_FreeRects *)SDL_realloc(free_rects, (atlas->num_pages + 1) * sizeof(*free_rects));
+            if ( !more ) {
+                SDL_OutOfMemory();
+                goto done;
+            }
+            free_rects = more;
+            SDL_zero(free_rects[p]);
+            if ( IMG_AddAtlasPage(atlas) < 0 ) {
+                goto done;
+            }
+            if ( IMG_AddFreeRect(&free_rects[p], &bin) < 0 ) {
+                goto done;
+            }
+            IMG_FindFreeRect(&free_rects[p], pieces[i].w, pieces[i].h, &place, &s, &l);
+        }
+        if ( IMG_UseFreeRect(&free_rects[p], &place) < 0 ) {
+            goto done;
+        }
+        image->page = p;
+        image->rect.x = place.x + padding;
+        image->rect.y = place.y + padding;
+        image->rect.w = surfaces[pieces[i].index]->w;
+        image->rect.h = surfaces[pieces[i].index]->h;
+    }
+
+    /* Each page is cut down to the power of two sizes holding its images */
+    extent = (int *)SDL_calloc(atlas->num_pages * 2 + 1, sizeof(*extent));
+    if ( !extent ) {
+        SDL_OutOfMemory();
+        goto done;
+    }
+    for ( i = 0; i < atlas->num_images; ++i ) {
+        image = &atlas->images[i];
+        extent[image->page * 2] = SDL_max(extent[image->page * 2], image->rect.x + image->rect.w + padding);
+        extent[image->page * 2 + 1] = SDL_max(extent[image->page * 2 + 1], image->rect.y + image->rect.h + padding);
+    }
+    for ( p = 0; p < atlas->num_pages; ++p ) {
+        atlas->pages[p].surface = IMG_CreateCanvas(IMG_PowerOfTwo(extent[p * 2]), IMG_PowerOfTwo(extent[p * 2 + 1]));
+        if ( !atlas->pages[p].surface ) {
+            goto done;
+        }
+    }
+    for ( i = 0; i < atlas->num_images; ++i ) {
+        image = &atlas->images[i];
+        SDL_SetSurfaceBlendMode(surfaces[i], SDL_BLENDMODE_NONE);
+        if ( SDL_BlitSurface(surfaces[i], NULL, atlas->pages[image->page].surface, &image->rect) < 0 ) {
+            goto done;
+        }
+    }
+    status = 0;
+
+done:
+    if ( free_rects ) {
+        for ( p = 0; p < atlas->num_pages; ++p ) {
+            SDL_free(free_rects[p].rects);
+        }
+        SDL_free(free_rects);
+    }
+    SDL_free(extent);
+    SDL_free(pieces);
+    return status;
+}
+
+IMG_Atlas *IMG_CreateAtlas(const char *source, int max_size, int padding)
+{
+    IMG_AtlasFiles files;
+    IMG_Atlas *atlas;
+    SDL_Surface **surfaces = NULL;
+    SDL_Surface *image;
+    const char *name, *ext;
+    int i, status;
+
+    if ( !source ) {
+        SDL_InvalidParamError("source");
+        return NULL;
+    }
+    if ( max_size <= 0 ) {
+        max_size = IMG_ATLAS_SIZE;
+    }
+    padding = SDL_max(padding, 0);
+
+    atlas = (IMG_Atlas *)SDL_calloc(1, sizeof(*atlas));
+    if ( !atlas ) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    SDL_zero(files);
+    status = IMG_ListAtlasDirectory(source, &files);
+    if ( status == 0 ) {
+        status = IMG_ReadAtlasManifest(source, &files);
+    }
+    if ( status < 0 ) {
+        goto failed;
+    }
+    if ( files.count == 0 ) {
+        IMG_SetError("There are no images in %s", source);
+        goto failed;
+    }
+    SDL_qsort(files.files, files.count, sizeof(*files.files), IMG_CompareFiles);
+
+    surfaces = (SDL_Surface **)SDL_calloc(files.count + 1, sizeof(*surfaces));
+    if ( !surfaces ) {
+        SDL_OutOfMemory();
+        goto failed;
+    }
+    for ( i = 0; i < files.count; ++i ) {
+        image = IMG_Load(files.files[i]);
+        if ( !image ) {
+            goto failed;
+        }
+        surfaces[i] = SDL_ConvertSurfaceFormat(image, SDL_PIXELFORMAT_ARGB8888, 0);
+        SDL_FreeSurface(image);
+        if ( !surfaces[i] ) {
+            goto failed;
+        }
+        name = files.files[i] + files.name_start;
+        ext = SDL_strrchr(name, '.');
+        if ( !ext || ext < name + IMG_DirectoryLength(name) ) {
+            ext = name + SDL_strlen(name);
+        }
+        if ( IMG_AddAtlasImage(atlas, name, ext - name) < 0 ) {
+            goto failed;
+        }
+    }
+
+    if ( IMG_PackAtlas(atlas, surfaces, max_size, padding) < 0 ) {
+        goto failed;
+    }
+    if ( IMG_SortAtlasImages(atlas) < 0 ) {
+        goto failed;
+    }
+    goto done;
+
+failed:
+    IMG_FreeAtlas(atlas);
+    atlas = NULL;
+done:
+    for ( i = 0; i < files.count; ++i ) {
+        if ( surfaces ) {
+            SDL_FreeSurface(surfaces[i]);
+        }
+        SDL_free(files.files[i]);
+    }
+    SDL_free(files.files);
+    SDL_free(surfaces);
+    return atlas;
+}
+
+static SDL_Surface *IMG_GetAtlasPageSurface(IMG_AtlasPage *page)
+{
+    if ( !page->surface ) {
+        page->surface = IMG_Load(page->file);
+    }
+    return page->surface;
+}
+
+static int IMG_WriteAtlasLine(SDL_RWops *dst, const char *prefix, const char *text)
+{
+    size_t length = SDL_strlen(text);
+
+    if ( SDL_RWwrite(dst, prefix, SDL_strlen(prefix), 1) != 1 ||
+         (length > 0 && SDL_RWwrite(dst, text, length, 1) != 1) ||
+         SDL_RWwrite(dst, "\n", 1, 1) != 1 ) {
+        return -1;
+    }
+    return 0;
+}
+
+int IMG_SaveAtlas(IMG_Atlas *atlas, const char *index)
+{
+    size_t dir_length, base_length;
+    const char *base, *ext;
+    char *file;
+    char prefix[64];
+    SDL_RWops *dst;
+    int i, status = 0;
+
+    if ( !atlas ) {
+        return SDL_InvalidParamError("atlas");
+    }
+    if ( !index ) {
+        return SDL_InvalidParamError("index");
+    }
+
+    /* Pages loaded from another index are read in before anything is written */
+    for ( i = 0; i < atlas->num_pages; ++i ) {
+        if ( !IMG_GetAtlasPageSurface(&atlas->pages[i]) ) {
+            return -1;
+        }
+    }
+
+    /* The pages are saved beside the index: "icons.atlas" has "icons_0.png"... */
+    dir_length = IMG_DirectoryLength(index);
+    base = index + dir_length;
+    ext = SDL_strrchr(base, '.');
+    base_length = (ext && ext > base) ? (size_t)(ext - base) : SDL_strlen(base);
+    for ( i = 0; i < atlas->num_pages; ++i ) {
+        SDL_snprintf(prefix, sizeof(prefix), "_%d.png", i);
+        file = (char *)SDL_malloc(dir_length + base_length + SDL_strlen(prefix) + 1);
+        if ( !file ) {
+            return SDL_OutOfMemory();
+        }
+        SDL_memcpy(file, index, dir_length + base_length);
+        SDL_strlcpy(file + dir_length + base_length, prefix, SDL_strlen(prefix) + 1);
+        if ( IMG_SavePNG(atlas->pages[i].surface, file) < 0 ) {
+            SDL_free(file);
+            return -1;
+        }
+        SDL_free(atlas->pages[i].file);
+        atlas->pages[i].file = file;
+    }
+
+    dst = SDL_RWFromFile(index, "wb");
+    if ( !dst ) {
+        return -1;
+    }
+    status = IMG_WriteAtlasLine(dst, IMG_ATLAS_HEADER, "");
+    for ( i = 0; i < atlas->num_pages && status == 0; ++i ) {
+        status = IMG_WriteAtlasLine(dst, "page ", atlas->pages[i].file + dir_length);
+    }
+    for ( i = 0; i < atlas->num_images && status == 0; ++i ) {
+        const IMG_AtlasImage *image = &atlas->images[i];
+        SDL_snprintf(prefix, sizeof(prefix), "image %d %d %d %d %d ", image->page,
+                     image->rect.x, image->rect.y, image->rect.w, image->rect.h);
+        status = IMG_WriteAtlasLine(dst, prefix, image->name);
+    }
+    if ( SDL_RWclose(dst) < 0 ) {
+        status = -1;
+    }
+    return status;
+}
+
+IMG_Atlas *IMG_LoadAtlas(const char *index)
+{
+    IMG_Atlas *atlas;
+    IMG_AtlasImage *image;
+    size_t dir_length;
+    char *text, *next, *line, *p;
+    long v[5];
+    int i, page;
+
+    if ( !index ) {
+        SDL_InvalidParamError("index");
+        return NULL;
+    }
+    text = IMG_ReadTextFile(index);
+    if ( !text ) {
+        return NULL;
+    }
+    atlas = (IMG_Atlas *)SDL_calloc(1, sizeof(*atlas));
+    if ( !atlas ) {
+        SDL_OutOfMemory();
+        SDL_free(text);
+        return NULL;
+    }
+
+    dir_length = IMG_DirectoryLength(index);
+    next = text;
+    line = IMG_NextLine(&next);
+    if ( !line || SDL_strcmp(line, IMG_ATLAS_HEADER) != 0 ) {
+        goto corrupt;
+    }
+    while ( (line = IMG_NextLine(&next)) != NULL ) {
+        if ( SDL_strncmp(line, "page ", 5) == 0 ) {
+            page = IMG_AddAtlasPage(atlas);
+            if ( page < 0 ) {
+                goto failed;
+            }
+            atlas->pages[page].file = IMG_JoinPath(index, dir_length, line + 5, SDL_strlen(line + 5));
+            if ( !atlas->pages[page].file ) {
+                goto failed;
+            }
+        } else if ( SDL_strncmp(line, "image ", 6) == 0 ) {
+            p = line + 6;
+            for ( i = 0; i < 5; ++i ) {
+                v[i] = SDL_strtol(p, &p, 10);
+                if ( v[i] < 0 || v[i] > 0x7FFFFFFF ) {
+                    goto corrupt;
+                }
+            }
+            if ( *p != ' ' || v[0] >= atlas->num_pages ||
+                 v[3] > 0x7FFFFFFF - v[1] || v[4] > 0x7FFFFFFF - v[2] ) {
+                goto corrupt;
+            }
+            ++p;
+            if ( IMG_AddAtlasImage(atlas, p, SDL_strlen(p)) < 0 ) {
+                goto failed;
+            }
+            image = &atlas->images[atlas->num_images - 1];
+            image->page = (int)v[0];
+            image->rect.x = (int)v[1];
+            image->rect.y = (int)v[2];
+            image->rect.w = (int)v[3];
+            image->rect.h = (int)v[4];
+        } else if ( *line ) {
+            goto corrupt;
+        }
+    }
+    if ( IMG_SortAtlasImages(atlas) < 0 ) {
+        goto failed;
+    }
+    SDL_free(text);
+    return atlas;
+
+corrupt:
+    IMG_SetError("%s is not an image atlas index", index);
+failed:
+    IMG_FreeAtlas(atlas);
+    SDL_free(text);
+    return NULL;
+}
+
+int IMG_GetAtlasImage(IMG_Atlas *atlas, SDL_Renderer *renderer, const char *name, SDL_Texture **texture, SDL_Rect *srcrect)
+{
+    IMG_AtlasImage *image;
+    IMG_AtlasPage *page;
+
+    if ( !atlas ) {
+        return SDL_InvalidParamError("atlas");
+    }
+    if ( !name ) {
+        return SDL_InvalidParamError("name");
+    }
+    image = IMG_FindAtlasImage(atlas, name);
+    if ( !image ) {
+        return IMG_SetError("There is no image named %s in the atlas", name);
+    }
+    if ( texture ) {
+        if ( !renderer ) {
+            return SDL_InvalidParamError("renderer");
+        }
+        if ( atlas->renderer && atlas->renderer != renderer ) {
+            return IMG_SetError("The atlas textures were made for another renderer");
+        }
+        atlas->renderer = renderer;
+        page = &atlas->pages[image->page];
+        if ( !page->texture ) {
+            if ( page->surface ) {
+                page->texture = SDL_CreateTextureFromSurface(renderer, page->surface);
+            } else {
+                page->texture = IMG_LoadTexture(renderer, page->file);
+            }
+            if ( !page->texture ) {
+                return -1;
+            }
+        }
+        *texture = page->texture;
+    }
+    if ( srcrect ) {
+        *srcrect = image->rect;
+    }
+    return 0;
+}
+
+void IMG_FreeAtlas(IMG_Atlas *atlas)
+{
+    int i;
+
+    if ( !atlas ) {
+        return;
+    }
+    for ( i = 0; i < atlas->num_pages; ++i ) {
+        if ( atlas->pages[i].texture ) {
+            SDL_DestroyTexture(atlas->pages[i].texture);
+        }
+        SDL_FreeSurface(atlas->pages[i].surface);
+        SDL_free(atlas->pages[i].file);
+    }
+    for ( i = 0; i < atlas->num_images; ++i ) {
+        SDL_free(atlas->images[i].name);
+    }
+    SDL_free(atlas->pages);
+    SDL_free(atlas->images);
+    SDL_free(atlas);
+}
+
+/* Image cache */
+
+/* A decoded image, or a texture of one for a renderer */
+typedef struct _IMG_CachedImage {
+    Uint32 hash;
+    char *path;             /* canonical, so every way of naming a file hits */
+    Sint64 mtime;           /* with the length, tells when the file changed */
+    Sint64 length;
+    int width;              /* the size asked for, 0 for unconstrained */
+    int height;
+    SDL_Renderer *renderer; /* NULL for a surface */
+
+    SDL_Surface *surface;
+    SDL_Texture *texture;
+    int texture_refs;
+    size_t bytes;
+
+    struct _IMG_CachedImage *prev;  /* most recently used first */
+    struct _IMG_CachedImage *next;
+} IMG_CachedImage;
+
+struct _IMG_ImageCache {
+    IMG_CachedImage *head;
+    IMG_CachedImage *tail;
+    size_t surface_bytes;
+    size_t max_surface_bytes;
+    size_t texture_bytes;
+    size_t max_texture_bytes;
+    Uint32 hits;
+    Uint32 misses;
+    Uint32 evictions;
+};
+
+/* Find the canonical path of a file and when it was last changed */
+static char *IMG_StatFile(const char *file, Sint64 *mtime, Sint64 *length)
+{
+    char *path;
+#ifdef __WIN32__
+    WIN32_FILE_ATTRIBUTE_DATA info;
+    WCHAR *wfile = IMG_UTF8ToWide(file);
+    WCHAR *wpath = NULL;
+    DWORD size;
+
+    if ( !wfile ) {
+        return NULL;
+    }
+    size = GetFullPathNameW(wfile, 0, NULL, NULL);
+    if ( size > 0 ) {
+        wpath = (WCHAR *)SDL_malloc(size * sizeof(WCHAR));
+    }
+    path = NULL;
+    if ( wpath && GetFullPathNameW(wfile, size, wpath, NULL) > 0 &&
+         GetFileAttributesExW(wpath, GetFileExInfoStandard, &info) ) {
+        /* Windows file names don't care about case */
+        CharLowerW(wpath);
+        path = IMG_WideToUTF8(wpath);
+        *mtime = ((Sint64)info.ftLastWriteTime.dwHighDateTime << 32) | info.ftLastWriteTime.dwLowDateTime;
+        *length = ((Sint64)info.nFileSizeHigh << 32) | info.nFileSizeLow;
+    }
+    SDL_free(wpath);
+    SDL_free(wfile);
+#else
+    struct stat info;
+    char *real = realpath(file, NULL);
+
+    if ( !real || stat(real, &info) < 0 ) {
+        free(real);
+        return NULL;
+    }
+    /* realpath() allocates with malloc(), which SDL_free() may not be */
+    path = SDL_strdup(real);
+    free(real);
+    if ( !path ) {
+        return NULL;
+    }
+    /* Files written twice in a second still differ in the nanoseconds */
+#if defined(__APPLE__)
+    *mtime = (Sint64)info.st_mtimespec.tv_sec * 1000000000 + info.st_mtimespec.tv_nsec;
+#elif defined(st_mtime)
+    /* st_mtime is a macro for st_mtim.tv_sec where st_mtim is there */
+    *mtime = (Sint64)info.st_mtim.tv_sec * 1000000000 + info.st_mtim.tv_nsec;
+#else
+    *mtime = (Sint64)info.st_mtime * 1000000000;
+#endif
+    *length = (Sint64)info.st_size;
+#endif
+    return path;
+}
+
+/* Get the key of an image file.  Names that aren't files on disk, such as
+   Android assets SDL_RWFromFile() reads from the APK, are keyed by the
+   name itself and taken to never change.
+ */
+static char *IMG_StatImage(const char *file, Sint64 *mtime, Sint64 *length)
+{
+    char *path = IMG_StatFile(file, mtime, length);
+
+    if ( !path ) {
+        *mtime = 0;
+        *length = -1;
+        path = SDL_strdup(file);
+        if ( !path ) {
+            SDL_OutOfMemory();
+        }
+    }
+    return path;
+}
+
+static Uint32 IMG_HashCachedImage(const char *path, Sint64 mtime, int width, int height, SDL_Renderer *renderer)
+{
+    /* FNV-1a over the path, then the rest of the key */
+    Uint32 hash = 2166136261u;
+    const Uint8 *p;
+
+    for ( p = (const Uint8 *)path; *p; ++p ) {
+        hash = (hash ^ *p) * 16777619u;
+    }
+    hash = (hash ^ (Uint32)mtime) * 16777619u;
+    hash = (hash ^ (Uint32)width) * 16777619u;
+    hash = (hash ^ (Uint32)height) * 16777619u;
+    hash = (hash ^ (Uint32)(size_t)renderer) * 16777619u;
+    return hash;
+}
+
+static void IMG_UnlinkCachedImage(IMG_ImageCache *cache, IMG_CachedImage *image)
+{
+    if ( image->prev ) {
+        image->prev->next = image->next;
+    } else {
+        cache->head = image->next;
+    }
+    if ( image->next ) {
+        image->next->prev = image->prev;
+    } else {
+        cache->tail = image->prev;
+    }
+    image->prev = image->next = NULL;
+}
+
+static void IMG_PushCachedImage(IMG_ImageCache *cache, IMG_CachedImage *image)
+{
+    image->prev = NULL;
+    image->next = cache->head;
+    if ( cache->head ) {
+        cache->head->prev = image;
+    } else {
+        cache->tail = image;
+    }
+    cache->head = image;
+}
+
+static void IMG_FreeCachedImage(IMG_ImageCache *cache, IMG_CachedImage *image)
+{
+    IMG_UnlinkCachedImage(cache, image);
+    if ( image->surface ) {
+        SDL_FreeSurface(image->surface);
+        cache->surface_bytes -= image->bytes;
+    }
+    if ( image->texture ) {
+        SDL_DestroyTexture(image->texture);
+        cache->texture_bytes -= image->bytes;
+    }
+    SDL_free(image->path);
+    SDL_free(image);
+}
+
+/* Drop least recently used images nobody holds until both budgets fit */
+static void IMG_TrimImageCache(IMG_ImageCache *cache)
+{
+    IMG_CachedImage *image = cache->tail;
+
+    while ( image && (cache->surface_bytes > cache->max_surface_bytes ||
+                      cache->texture_bytes > cache->max_texture_bytes) ) {
+        IMG_CachedImage *prev = image->prev;
+
+        if ( image->surface ? (cache->surface_bytes > cache->max_surface_bytes &&
+                               image->surface->refcount == 1)
+                            : (cache->texture_bytes > cache->max_texture_bytes &&
+                               image->texture_refs == 0) ) {
+            IMG_FreeCachedImage(cache, image);
+            ++cache->evictions;
+        }
+        image = prev;
+    }
+}
+
+static IMG_CachedImage *IMG_FindCachedImage(IMG_ImageCache *cache, Uint32 hash, const char *path, Sint64 mtime, Sint64 length, int width, int height, SDL_Renderer *renderer)
+{
+    IMG_CachedImage *image;
+
+    for ( image = cache->head; image; image = image->next ) {
+        if ( image->hash == hash &&
+             image->mtime == mtime &&
+             image->length == length &&
+             image->width == width &&
+             image->height == height &&
+             image->renderer == renderer &&
+             SDL_strcmp(image->path, path) == 0 ) {
+            if ( image != cache->head ) {
+                IMG_UnlinkCachedImage(cache, image);
+                IMG_PushCachedImage(cache, image);
+            }
+            return image;
+        }
+    }
+    return NULL;
+}
+
+static IMG_CachedImage *IMG_AddCachedImage(IMG_ImageCache *cache, Uint32 hash, const char *path, Sint64 mtime, Sint64 length, int width, int height, SDL_Renderer *renderer)
+{
+    IMG_CachedImage *image = (IMG_CachedImage *)SDL_calloc(1, sizeof(*image));
+
+    if ( image ) {
+        image->path = SDL_strdup(path);
+    }
+    if ( !image || !image->path ) {
+        SDL_free(image);
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    image->hash = hash;
+    image->mtime = mtime;
+    image->length = length;
+    image->width = width;
+    image->height = height;
+    image->renderer = renderer;
+    IMG_PushCachedImage(cache, image);
+    return image;
+}
+
+/* Load an image scaled to fit in width by height, keeping its aspect
+   ratio.  JPEG images are scaled down most of the way as they are decoded.
+ */
+static SDL_Surface *IMG_LoadSized(const char *file, int width, int height, Uint32 opaque, Uint32 alpha)
+{
+    SDL_RWops *src = IMG_RWFromFile(file);
+    const char *ext = SDL_strrchr(file, '.');
+    SDL_Surface *surface;
+    SDL_Surface *sized;
+    int w, h;
+
+    if ( ext ) {
+        ext++;
+    }
+    if ( !src ) {
+        return NULL;
+    }
+    if ( (width || height) && IMG_isJPG(src) ) {
+        surface = IMG_LoadJPG_Scaled_RW(src, width, height);
+        SDL_RWclose(src);
+    } else {
+        surface = IMG_LoadFormat_RW(src, 1, ext, opaque, alpha);
+    }
+    if ( !surface || (!width && !height) ) {
+        return surface;
+    }
+
+    if ( width && (!height || (Sint64)surface->w * height >= (Sint64)surface->h * width) ) {
+        w = width;
+        h = (int)((Sint64)surface->h * width / surface->w);
+    } else {
+        w = (int)((Sint64)surface->w * height / surface->h);
+        h = height;
+    }
+    if ( w < 1 ) {
+        w = 1;
+    }
+    if ( h < 1 ) {
+        h = 1;
+    }
+    if ( w == surface->w && h == surface->h ) {
+        return surface;
+    }
+    sized = IMG_CreateCanvas(w, h);
+    if ( sized ) {
+        /* Copy alpha rather than blend it onto the transparent canvas */
+        SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_NONE);
+        if ( SDL_BlitScaled(surface, NULL, sized, NULL) < 0 ) {
+            SDL_FreeSurface(sized);
+            sized = NULL;
+        }
+    }
+    SDL_FreeSurface(surface);
+    return sized;
+}
+
+/* Find the decoded image in the cache, loading it if it isn't there */
+static IMG_CachedImage *IMG_CacheSurface(IMG_ImageCache *cache, const char *path, Sint64 mtime, Sint64 length, int width, int height, Uint32 opaque, Uint32 alpha, SDL_bool *hit)
+{
+    Uint32 hash = IMG_HashCachedImage(path, mtime, width, height, NULL);
+    IMG_CachedImage *image;
+    SDL_Surface *surface;
+
+    image = IMG_FindCachedImage(cache, hash, path, mtime, length, width, height, NULL);
+    *hit = image ? SDL_TRUE : SDL_FALSE;
+    if ( image ) {
+        return image;
+    }
+    surface = IMG_LoadSized(path, width, height, opaque, alpha);
+    if ( !surface ) {
+        return NULL;
+    }
+    image = IMG_AddCachedImage(cache, hash, path, mtime, length, width, height, NULL);
+    if ( !image ) {
+        SDL_FreeSurface(surface);
+        return NULL;
+    }
+    image->surface = surface;
+    image->bytes = (size_t)surface->pitch * surface->h;
+    cache->surface_bytes += image->bytes;
+    return image;
+}
+
+IMG_ImageCache *IMG_CreateImageCache(size_t max_surface_bytes, size_t max_texture_bytes)
+{
+    IMG_ImageCache *cache = (IMG_ImageCache *)SDL_calloc(1, sizeof(*cache));
+
+    if ( !cache ) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    cache->max_surface_bytes = max_surface_bytes;
+    cache->max_texture_bytes = max_texture_bytes;
+    return cache;
+}
+
+void IMG_ClearImageCache(IMG_ImageCache *cache)
+{
+    if ( !cache ) {
+        return;
+    }
+    /* Surfaces still held by callers live on until they free them */
+    while ( cache->head ) {
+        IMG_FreeCachedImage(cache, cache->head);
+    }
+}
+
+void IMG_DestroyImageCache(IMG_ImageCache *cache)
+{
+    if ( !cache ) {
+        return;
+    }
+    IMG_ClearImageCache(cache);
+    SDL_free(cache);
+}
+
+SDL_Surface *IMG_CacheLoad(IMG_ImageCache *cache, const char *file, int width, int height)
+{
+    IMG_CachedImage *image;
+    SDL_Surface *surface;
+    Sint64 mtime, length;
+    SDL_bool hit;
+    char *path;
+
+    if ( !file ) {
+        SDL_InvalidParamError("file");
+        return NULL;
+    }
+    if ( width < 0 || height < 0 ) {
+        SDL_InvalidParamError(width < 0 ? "width" : "height");
+        return NULL;
+    }
+    if ( !cache ) {
+        return IMG_LoadSized(file, width, height, 0, 0);
+    }
+    path = IMG_StatImage(file, &mtime, &length);
+    if ( !path ) {
+        return NULL;
+    }
+    image = IMG_CacheSurface(cache, path, mtime, length, width, height, 0, 0, &hit);
+    SDL_free(path);
+    if ( hit ) {
+        ++cache->hits;
+    } else {
+        ++cache->misses;
+    }
+    if ( !image ) {
+        return NULL;
+    }
+    /* Take the caller's reference before trimming, so it survives */
+    surface = image->surface;
+    ++surface->refcount;
+    IMG_TrimImageCache(cache);
+    return surface;
+}
+
+SDL_Texture *IMG_CacheLoadTexture(IMG_ImageCache *cache, SDL_Renderer *renderer, const char *file, int width, int height)
+{
+    IMG_CachedImage *image;
+    IMG_CachedImage *decoded;
+    SDL_Texture *texture;
+    Uint32 hash, format, opaque, alpha;
+    Sint64 mtime, length;
+    SDL_bool hit;
+    char *path;
+    int w, h;
+
+    if ( !cache ) {
+        SDL_InvalidParamError("cache");
+        return NULL;
+    }
+    if ( !renderer ) {
+        SDL_InvalidParamError("renderer");
+        return NULL;
+    }
+    if ( !file ) {
+        SDL_InvalidParamError("file");
+        return NULL;
+    }
+    if ( width < 0 || height < 0 ) {
+        SDL_InvalidParamError(width < 0 ? "width" : "height");
+        return NULL;
+    }
+    path = IMG_StatImage(file, &mtime, &length);
+    if ( !path ) {
+        return NULL;
+    }
+    hash = IMG_HashCachedImage(path, mtime, width, height, renderer);
+    image = IMG_FindCachedImage(cache, hash, path, mtime, length, width, height, renderer);
+    if ( image ) {
+        ++cache->hits;
+    } else {
+        ++cache->misses;
+
+        /* Upload the decoded image if it is still around, and keep it
+           for other renderers, or for when the texture is evicted */
+        IMG_TextureFormats(renderer, &opaque, &alpha);
+        decoded = IMG_CacheSurface(cache, path, mtime, length, width, height, opaque, alpha, &hit);
+        if ( decoded ) {
+            texture = SDL_CreateTextureFromSurface(renderer, decoded->surface);
+            image = texture ? IMG_AddCachedImage(cache, hash, path, mtime, length, width, height, renderer) : NULL;
+            if ( !image ) {
+                if ( texture ) {
+                    SDL_DestroyTexture(texture);
+                }
+            } else {
+                image->texture = texture;
+                SDL_QueryTexture(texture, &format, NULL, &w, &h);
+                image->bytes = (size_t)w * h * (SDL_BYTESPERPIXEL(format) ? SDL_BYTESPERPIXEL(format) : 4);
+                cache->texture_bytes += image->bytes;
+            }
+        }
+    }
+    SDL_free(path);
+    if ( !image ) {
+        return NULL;
+    }
+    ++image->texture_refs;
+    texture = image->texture;
+    IMG_TrimImageCache(cache);
+    return texture;
+}
+
+void IMG_ReleaseCachedTexture(IMG_ImageCache *cache, SDL_Texture *texture)
+{
+    IMG_CachedImage *image;
+
+    if ( !cache || !texture ) {
+        return;
+    }
+    for ( image = cache->head; image; image = image->next ) {
+        if ( image->texture == texture ) {
+            if ( image->texture_refs > 0 ) {
+                --image->texture_refs;
+            }
+            break;
+        }
+    }
+    IMG_TrimImageCache(cache);
+}
+
+void IMG_GetImageCacheStats(const IMG_ImageCache *cache, Uint32 *hits, Uint32 *misses, Uint32 *evictions, size_t *surface_bytes, size_t *texture_bytes)
+{
+    if ( hits ) {
+        *hits = cache ? cache->hits : 0;
+    }
+    if ( misses ) {
+        *misses = cache ? cache->misses : 0;
+    }
+    if ( evictions ) {
+        *evictions = cache ? cache->evictions : 0;
+    }
+    if ( surface_bytes ) {
+        *surface_bytes = cache ? cache->surface_bytes : 0;
+    }
+    if ( texture_bytes ) {
+        *texture_bytes = cache ? cache->texture_bytes : 0;
+    }
+}
 #endif /* SDL 2.0 */
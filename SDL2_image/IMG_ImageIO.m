@@ -742,6 +742,12 @@ SDL_Surface* IMG_LoadJPG_RW (SDL_RWops *src)
     return LoadImageFromRWops (src, kUTTypeJPEG);
 }
 
+// ImageIO decodes at full size, callers scale the image as they draw it.
+SDL_Surface* IMG_LoadJPG_Scaled_RW (SDL_RWops *src, int width, int height)
+{
+    return LoadImageFromRWops (src, kUTTypeJPEG);
+}
+
 SDL_Surface* IMG_LoadPNG_RW (SDL_RWops *src)
 {
     return LoadImageFromRWops (src, kUTTypePNG);
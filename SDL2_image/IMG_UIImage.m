@@ -425,6 +425,10 @@ SDL_Surface* IMG_LoadJPG_RW(SDL_RWops *src)
 {
     return LoadImageFromRWops(src, kUTTypeJPEG);
 }
+SDL_Surface* IMG_LoadJPG_Scaled_RW(SDL_RWops *src, int width, int height)
+{
+    return LoadImageFromRWops(src, kUTTypeJPEG);
+}
 SDL_Surface* IMG_LoadPNG_RW(SDL_RWops *src)
 {
     return LoadImageFromRWops(src, kUTTypePNG);
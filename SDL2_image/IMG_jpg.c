@@ -45,6 +45,12 @@
 /* Define this for quicker (but less perfect) JPEG identification */
 #define FAST_IS_JPEG
 
+/* libjpeg 7 and later, and libjpeg-turbo, can scale by any number of
+   eighths, older versions only by 1/2, 1/4 and 1/8 */
+#if JPEG_LIB_VERSION >= 70 || defined(LIBJPEG_TURBO_VERSION)
+#define JPEG_SCALE_EIGHTHS
+#endif
+
 static struct {
     int loaded;
     void *handle;
@@ -239,11 +245,12 @@ int IMG_isJPG(SDL_RWops *src)
     return(is_JPG);
 }
 
-#define INPUT_BUFFER_SIZE   4096
+#define INPUT_BUFFER_SIZE   (64 * 1024)
 typedef struct {
     struct jpeg_source_mgr pub;
 
     SDL_RWops *ctx;
+    size_t loaded;      /* bytes of the current input that came from ctx */
     Uint8 buffer[INPUT_BUFFER_SIZE];
 } my_source_mgr;
 
@@ -265,12 +272,31 @@ static boolean fill_input_buffer (j_decompress_ptr cinfo)
     my_source_mgr * src = (my_source_mgr *) cinfo->src;
     int nbytes;
 
+#ifdef SDL_RWOPS_MAPPED
+    /* Memory streams and mapped files are handed over whole at the start */
+    if (src->pub.next_input_byte == NULL) {
+        Sint64 pos = SDL_RWtell(src->ctx);
+        size_t size;
+        const Uint8 *mem = (const Uint8 *) SDL_RWGetMemory(src->ctx, &size);
+        if (mem && pos >= 0 && (Uint64)pos < size) {
+            src->pub.next_input_byte = mem + pos;
+            src->pub.bytes_in_buffer = size - (size_t)pos;
+            src->loaded = src->pub.bytes_in_buffer;
+            SDL_RWseek(src->ctx, 0, RW_SEEK_END);
+            return TRUE;
+        }
+    }
+#endif
+
     nbytes = SDL_RWread(src->ctx, src->buffer, 1, INPUT_BUFFER_SIZE);
     if (nbytes <= 0) {
         /* Insert a fake EOI marker */
         src->buffer[0] = (Uint8) 0xFF;
         src->buffer[1] = (Uint8) JPEG_EOI;
         nbytes = 2;
+        src->loaded = 0;
+    } else {
+        src->loaded = nbytes;
     }
     src->pub.next_input_byte = src->buffer;
     src->pub.bytes_in_buffer = nbytes;
@@ -317,8 +343,12 @@ static void skip_input_data (j_decompress_ptr cinfo, long num_bytes)
  */
 static void term_source (j_decompress_ptr cinfo)
 {
-    /* We don't actually need to do anything */
-    return;
+    my_source_mgr * src = (my_source_mgr *) cinfo->src;
+
+    /* Give back what was read past the end of the image */
+    if (src->loaded && src->pub.bytes_in_buffer <= src->loaded) {
+        SDL_RWseek(src->ctx, -(Sint64) src->pub.bytes_in_buffer, RW_SEEK_CUR);
+    }
 }
 
 /*
@@ -351,6 +381,7 @@ static void jpeg_SDL_RW_src (j_decompress_ptr cinfo, SDL_RWops *ctx)
   src->pub.resync_to_restart = lib.jpeg_resync_to_restart; /* use default method */
   src->pub.term_source = term_source;
   src->ctx = ctx;
+  src->loaded = 0;
   src->pub.bytes_in_buffer = 0; /* forces fill_input_buffer on first read */
   src->pub.next_input_byte = NULL; /* until buffer loaded */
 }
@@ -371,14 +402,87 @@ static void output_no_message(j_common_ptr cinfo)
     /* do nothing */
 }
 
-/* Load a JPEG type image from an SDL datasource */
-SDL_Surface *IMG_LoadJPG_RW(SDL_RWops *src)
+/* Pick the smallest scale whose output is still at least as large as
+   the image scaled to fit in width by height.  A width or height of 0
+   doesn't constrain the scale.
+ */
+static void JPG_SetScale(j_decompress_ptr cinfo, int width, int height)
+{
+    unsigned int num;
+
+    if ( width <= 0 && height <= 0 ) {
+        return;
+    }
+    cinfo->scale_denom = 8;
+#ifdef JPEG_SCALE_EIGHTHS
+    for ( num = 1; num < 8; ++num ) {
+#else
+    for ( num = 1; num < 8; num *= 2 ) {
+#endif
+        cinfo->scale_num = num;
+        lib.jpeg_calc_output_dimensions(cinfo);
+        if ( (width > 0 && cinfo->output_width >= (JDIMENSION)width) ||
+             (height > 0 && cinfo->output_height >= (JDIMENSION)height) ) {
+            return;
+        }
+    }
+    cinfo->scale_num = 8;
+}
+
+extern int IMG_FormatByteOrder(Uint32 format, int order[4]);
+
+/* Have libjpeg-turbo write 32-bit pixels in the given byte order, or
+   return 0 if the RGB rows have to be spread out by JPG_ExpandRow() */
+static int JPG_SetByteOrder(j_decompress_ptr cinfo, const int order[4])
+{
+#ifdef JCS_EXTENSIONS
+    if ( order[3] == 3 && order[1] == 1 ) {
+        cinfo->out_color_space = (order[0] == 0) ? JCS_EXT_RGBX : JCS_EXT_BGRX;
+        return 1;
+    }
+    if ( order[3] == 0 && order[1] == 2 ) {
+        cinfo->out_color_space = (order[0] == 1) ? JCS_EXT_XRGB : JCS_EXT_XBGR;
+        return 1;
+    }
+#endif
+    return 0;
+}
+
+/* Spread a row of RGB pixels at the start of a 32-bit row out in place */
+static void JPG_ExpandRow(Uint8 *row, int width, const int order[4])
+{
+    Uint8 *src = row + width * 3;
+    Uint8 *dst = row + width * 4;
+    Uint8 r, g, b;
+
+    while ( width-- ) {
+        src -= 3;
+        dst -= 4;
+        r = src[0];
+        g = src[1];
+        b = src[2];
+        dst[order[0]] = r;
+        dst[order[1]] = g;
+        dst[order[2]] = b;
+        dst[order[3]] = 0xFF;
+    }
+}
+
+/* The most scanlines asked of libjpeg at once */
+#define JPG_MAX_SCANLINES   16
+
+static SDL_Surface *LoadJPG_RW(SDL_RWops *src, int width, int height, volatile Uint32 format)
 {
     Sint64 start;
     struct jpeg_decompress_struct cinfo;
-    JSAMPROW rowptr[1];
+    JSAMPROW rowptr[JPG_MAX_SCANLINES];
+    int lines, i, n;
     SDL_Surface *volatile surface = NULL;
     struct my_error_mgr jerr;
+    Uint32 Rmask, Gmask, Bmask, Amask;
+    int bpp;
+    int order[4];
+    volatile int expand = 0;
 
     if ( !src ) {
         /* The error message has been set in SDL_RWFromFile */
@@ -408,6 +512,7 @@ SDL_Surface *IMG_LoadJPG_RW(SDL_RWops *src)
     lib.jpeg_create_decompress(&cinfo);
     jpeg_SDL_RW_src(&cinfo, src);
     lib.jpeg_read_header(&cinfo, TRUE);
+    JPG_SetScale(&cinfo, width, height);
 
     if(cinfo.num_components == 4) {
         /* Set 32-bit Raw output */
@@ -424,26 +529,36 @@ SDL_Surface *IMG_LoadJPG_RW(SDL_RWops *src)
                            0x0000FF00, 0x00FF0000, 0xFF000000, 0x000000FF);
 #endif
     } else {
-        /* Set 24-bit RGB output */
+        /* Set 24-bit RGB output, or 32-bit in the format asked for */
         cinfo.out_color_space = JCS_RGB;
         cinfo.quantize_colors = FALSE;
 #ifdef FAST_JPEG
-        cinfo.scale_num   = 1;
-        cinfo.scale_denom = 1;
         cinfo.dct_method = JDCT_FASTEST;
         cinfo.do_fancy_upsampling = FALSE;
 #endif
+        if ( format && IMG_FormatByteOrder(format, order) == 0 ) {
+            expand = !JPG_SetByteOrder(&cinfo, order);
+        } else {
+            format = 0;
+        }
         lib.jpeg_calc_output_dimensions(&cinfo);
 
         /* Allocate an output surface to hold the image */
-        surface = SDL_CreateRGBSurface(SDL_SWSURFACE,
-                cinfo.output_width, cinfo.output_height, 24,
+        if ( format ) {
+            SDL_PixelFormatEnumToMasks(format, &bpp, &Rmask, &Gmask, &Bmask, &Amask);
+            surface = SDL_CreateRGBSurface(SDL_SWSURFACE,
+                    cinfo.output_width, cinfo.output_height, 32,
+                    Rmask, Gmask, Bmask, Amask);
+        } else {
+            surface = SDL_CreateRGBSurface(SDL_SWSURFACE,
+                    cinfo.output_width, cinfo.output_height, 24,
 #if SDL_BYTEORDER == SDL_LIL_ENDIAN
-                           0x0000FF, 0x00FF00, 0xFF0000,
+                               0x0000FF, 0x00FF00, 0xFF0000,
 #else
-                           0xFF0000, 0x00FF00, 0x0000FF,
+                               0xFF0000, 0x00FF00, 0x0000FF,
 #endif
-                           0);
+                               0);
+        }
     }
 
     if ( surface == NULL ) {
@@ -455,10 +570,25 @@ SDL_Surface *IMG_LoadJPG_RW(SDL_RWops *src)
 
     /* Decompress the image */
     lib.jpeg_start_decompress(&cinfo);
+
+    /* Read a multiple of the rows libjpeg produces in one go, so they are
+       written straight into the surface instead of through its own buffer */
+    lines = JPG_MAX_SCANLINES - JPG_MAX_SCANLINES % cinfo.rec_outbuf_height;
+    if ( lines <= 0 ) {
+        lines = 1;
+    }
     while ( cinfo.output_scanline < cinfo.output_height ) {
-        rowptr[0] = (JSAMPROW)(Uint8 *)surface->pixels +
-                            cinfo.output_scanline * surface->pitch;
-        lib.jpeg_read_scanlines(&cinfo, rowptr, (JDIMENSION) 1);
+        n = (int)SDL_min((JDIMENSION)lines, cinfo.output_height - cinfo.output_scanline);
+        for ( i = 0; i < n; ++i ) {
+            rowptr[i] = (JSAMPROW)(Uint8 *)surface->pixels +
+                                (cinfo.output_scanline + i) * surface->pitch;
+        }
+        n = (int)lib.jpeg_read_scanlines(&cinfo, rowptr, (JDIMENSION) n);
+        if ( expand ) {
+            for ( i = 0; i < n; ++i ) {
+                JPG_ExpandRow(rowptr[i], cinfo.output_width, order);
+            }
+        }
     }
     lib.jpeg_finish_decompress(&cinfo);
     lib.jpeg_destroy_decompress(&cinfo);
@@ -466,6 +596,24 @@ SDL_Surface *IMG_LoadJPG_RW(SDL_RWops *src)
     return(surface);
 }
 
+/* Load a JPEG type image from an SDL datasource */
+SDL_Surface *IMG_LoadJPG_RW(SDL_RWops *src)
+{
+    return LoadJPG_RW(src, 0, 0, 0);
+}
+
+/* Load a JPEG type image scaled down by libjpeg while it is decoded */
+SDL_Surface *IMG_LoadJPG_Scaled_RW(SDL_RWops *src, int width, int height)
+{
+    return LoadJPG_RW(src, width, height, 0);
+}
+
+/* Load a JPEG straight into a 32-bit format, JPEGs never having alpha */
+SDL_Surface *IMG_LoadNativeJPG_RW(SDL_RWops *src, Uint32 opaque, Uint32 alpha)
+{
+    return LoadJPG_RW(src, 0, 0, opaque ? opaque : alpha);
+}
+
 #else
 
 int IMG_InitJPG()
@@ -490,6 +638,16 @@ SDL_Surface *IMG_LoadJPG_RW(SDL_RWops *src)
     return(NULL);
 }
 
+SDL_Surface *IMG_LoadJPG_Scaled_RW(SDL_RWops *src, int width, int height)
+{
+    return(NULL);
+}
+
+SDL_Surface *IMG_LoadNativeJPG_RW(SDL_RWops *src, Uint32 opaque, Uint32 alpha)
+{
+    return(NULL);
+}
+
 #endif /* LOAD_JPG */
 
 #endif /* !defined(__APPLE__) || defined(SDL_IMAGE_USE_COMMON_BACKEND) */
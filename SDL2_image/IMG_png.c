@@ -23,6 +23,35 @@
 
 #include "SDL_image.h"
 
+/* We'll always have PNG save support */
+#define SAVE_PNG
+
+#if defined(LOAD_PNG) || defined(SAVE_PNG)
+
+/* miniz inflates image data for the loader and deflates it for the saver */
+#include "miniz.h"
+
+static Uint8 PNG_Paeth(int a, int b, int c)
+{
+    int pa = b - c;
+    int pb = a - c;
+    int pc = pa + pb;
+
+    if (pa < 0) pa = -pa;
+    if (pb < 0) pb = -pb;
+    if (pc < 0) pc = -pc;
+
+    if (pa <= pb && pa <= pc) {
+        return (Uint8)a;
+    } else if (pb <= pc) {
+        return (Uint8)b;
+    } else {
+        return (Uint8)c;
+    }
+}
+
+#endif /* LOAD_PNG || SAVE_PNG */
+
 #if !defined(__APPLE__) || defined(SDL_IMAGE_USE_COMMON_BACKEND)
 
 #ifdef LOAD_PNG
@@ -94,11 +123,14 @@ static struct {
     void (*png_read_image) (png_structp png_ptr, png_bytepp image);
     void (*png_read_info) (png_structp png_ptr, png_infop info_ptr);
     void (*png_read_update_info) (png_structp png_ptr, png_infop info_ptr);
+    void (*png_set_bgr) (png_structp png_ptr);
     void (*png_set_expand) (png_structp png_ptr);
+    void (*png_set_filler) (png_structp png_ptr, png_uint_32 filler, int flags);
     void (*png_set_gray_to_rgb) (png_structp png_ptr);
     void (*png_set_packing) (png_structp png_ptr);
     void (*png_set_read_fn) (png_structp png_ptr, png_voidp io_ptr, png_rw_ptr read_data_fn);
     void (*png_set_strip_16) (png_structp png_ptr);
+    void (*png_set_swap_alpha) (png_structp png_ptr);
     int (*png_sig_cmp) (png_const_bytep sig, png_size_t start, png_size_t num_to_check);
 #ifndef LIBPNG_VERSION_12
     jmp_buf* (*png_set_longjmp_fn) (png_structp, png_longjmp_ptr, size_t);
@@ -197,6 +229,13 @@ int IMG_InitPNG()
             SDL_UnloadObject(lib.handle);
             return -1;
         }
+        lib.png_set_bgr =
+            (void (*) (png_structp))
+            SDL_LoadFunction(lib.handle, "png_set_bgr");
+        if ( lib.png_set_bgr == NULL ) {
+            SDL_UnloadObject(lib.handle);
+            return -1;
+        }
         lib.png_set_expand =
             (void (*) (png_structp))
             SDL_LoadFunction(lib.handle, "png_set_expand");
@@ -204,6 +243,13 @@ int IMG_InitPNG()
             SDL_UnloadObject(lib.handle);
             return -1;
         }
+        lib.png_set_filler =
+            (void (*) (png_structp, png_uint_32, int))
+            SDL_LoadFunction(lib.handle, "png_set_filler");
+        if ( lib.png_set_filler == NULL ) {
+            SDL_UnloadObject(lib.handle);
+            return -1;
+        }
         lib.png_set_gray_to_rgb =
             (void (*) (png_structp))
             SDL_LoadFunction(lib.handle, "png_set_gray_to_rgb");
@@ -232,6 +278,13 @@ int IMG_InitPNG()
             SDL_UnloadObject(lib.handle);
             return -1;
         }
+        lib.png_set_swap_alpha =
+            (void (*) (png_structp))
+            SDL_LoadFunction(lib.handle, "png_set_swap_alpha");
+        if ( lib.png_set_swap_alpha == NULL ) {
+            SDL_UnloadObject(lib.handle);
+            return -1;
+        }
         lib.png_sig_cmp =
             (int (*) (png_const_bytep, png_size_t, png_size_t))
             SDL_LoadFunction(lib.handle, "png_sig_cmp");
@@ -279,11 +332,14 @@ int IMG_InitPNG()
         lib.png_read_image = png_read_image;
         lib.png_read_info = png_read_info;
         lib.png_read_update_info = png_read_update_info;
+        lib.png_set_bgr = png_set_bgr;
         lib.png_set_expand = png_set_expand;
+        lib.png_set_filler = png_set_filler;
         lib.png_set_gray_to_rgb = png_set_gray_to_rgb;
         lib.png_set_packing = png_set_packing;
         lib.png_set_read_fn = png_set_read_fn;
         lib.png_set_strip_16 = png_set_strip_16;
+        lib.png_set_swap_alpha = png_set_swap_alpha;
         lib.png_sig_cmp = png_sig_cmp;
 #ifndef LIBPNG_VERSION_12
         lib.png_set_longjmp_fn = png_set_longjmp_fn;
@@ -329,18 +385,416 @@ int IMG_isPNG(SDL_RWops *src)
     return(is_PNG);
 }
 
+/* PNG data is read through a large buffer, or straight out of memory
+   when the data source holds it all there, rather than in the handful
+   of bytes at a time that libpng asks for.
+ */
+#define PNG_INPUT_BUFFER    (64 * 1024)
+
+typedef struct {
+    SDL_RWops *src;
+    Sint64 start;
+    const Uint8 *data;
+    size_t pos;
+    size_t len;
+    Uint8 *buffer;              /* NULL when reading from memory */
+    Uint8 tail[8];              /* the last 8 bytes read */
+} PNG_Input;
+
+static int PNG_InitInput(PNG_Input *in, SDL_RWops *src)
+{
+    SDL_zerop(in);
+    in->src = src;
+    in->start = SDL_RWtell(src);
+#ifdef SDL_RWOPS_MAPPED
+    {
+        size_t size;
+        const Uint8 *mem = (const Uint8 *)SDL_RWGetMemory(src, &size);
+        if (mem && in->start >= 0 && (Uint64)in->start <= size) {
+            in->data = mem + in->start;
+            in->len = size - (size_t)in->start;
+            return 0;
+        }
+    }
+#endif
+    in->buffer = (Uint8 *)SDL_malloc(PNG_INPUT_BUFFER);
+    if (!in->buffer) {
+        return SDL_OutOfMemory();
+    }
+    in->data = in->buffer;
+    return 0;
+}
+
+/* Leave the data source just past the data that was used */
+static void PNG_QuitInput(PNG_Input *in)
+{
+    if (in->buffer) {
+        if (in->pos < in->len) {
+            SDL_RWseek(in->src, -(Sint64)(in->len - in->pos), RW_SEEK_CUR);
+        }
+        SDL_free(in->buffer);
+    } else if (in->data) {
+        SDL_RWseek(in->src, in->start + in->pos, RW_SEEK_SET);
+    }
+    SDL_zerop(in);
+}
+
+static size_t PNG_FillInput(PNG_Input *in)
+{
+    if (in->buffer) {
+        in->pos = 0;
+        in->len = SDL_RWread(in->src, in->buffer, 1, PNG_INPUT_BUFFER);
+    }
+    return in->len - in->pos;
+}
+
+static size_t PNG_Read(PNG_Input *in, Uint8 *area, size_t size)
+{
+    size_t total = 0, n;
+
+    while (total < size) {
+        if (in->pos == in->len && PNG_FillInput(in) == 0) {
+            break;
+        }
+        n = SDL_min(in->len - in->pos, size - total);
+        SDL_memcpy(area + total, in->data + in->pos, n);
+        in->pos += n;
+        total += n;
+    }
+    if (total >= sizeof(in->tail)) {
+        SDL_memcpy(in->tail, area + total - sizeof(in->tail), sizeof(in->tail));
+    } else if (total > 0) {
+        SDL_memmove(in->tail, in->tail + total, sizeof(in->tail) - total);
+        SDL_memcpy(in->tail + sizeof(in->tail) - total, area, total);
+    }
+    return total;
+}
+
 /* Load a PNG type image from an SDL datasource */
 static void png_read_data(png_structp ctx, png_bytep area, png_size_t size)
 {
-    SDL_RWops *src;
+    PNG_Input *in;
 
-    src = (SDL_RWops *)lib.png_get_io_ptr(ctx);
-    SDL_RWread(src, area, size, 1);
+    in = (PNG_Input *)lib.png_get_io_ptr(ctx);
+    PNG_Read(in, area, size);
 }
-SDL_Surface *IMG_LoadPNG_RW(SDL_RWops *src)
+
+/* Non-interlaced 8-bit RGB and RGBA images are decoded by a pipeline on
+   machines with more than one CPU: a thread reads the image data, checks
+   it and inflates it a batch of rows at a time, while the calling thread
+   unfilters the rows and stores them in the surface.  libpng would do it
+   all on the one thread, a row at a time.  The pipeline takes over once
+   libpng has read the header up to the first IDAT chunk.
+ */
+#define PNG_PIPELINE_SLOTS  4
+#define PNG_PIPELINE_BYTES  (128 * 1024)
+
+typedef struct {
+    PNG_Input *input;
+    Uint32 chunk_left;          /* bytes of the current IDAT chunk not yet read */
+    Uint32 crc;                 /* the CRC of the current chunk so far */
+    Uint32 crc_table[256];
+    tinfl_decompressor inflate;
+    Uint8 *dict;                /* the inflate window */
+    size_t dict_ofs;
+    size_t dict_avail;
+    int height;
+    size_t stride;              /* bytes in a row, after its filter byte */
+    int slot_rows;
+    int batches;
+    Uint8 *slots;               /* batches of filtered rows being passed along */
+    int failed;                 /* set by the inflate thread */
+    SDL_atomic_t cancel;        /* set by the calling thread */
+    SDL_sem *empty;
+    SDL_sem *full;
+} PNG_Pipeline;
+
+static Uint32 PNG_BE32(const Uint8 *p)
+{
+    return ((Uint32)p[0] << 24) | ((Uint32)p[1] << 16) | ((Uint32)p[2] << 8) | p[3];
+}
+
+static Uint32 PNG_UpdateCRC(const PNG_Pipeline *pipe, Uint32 crc, const Uint8 *data, size_t size)
+{
+    while (size--) {
+        crc = pipe->crc_table[(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+/* Finish the current chunk and move on to the next, which must be IDAT */
+static int PNG_NextChunk(PNG_Pipeline *pipe)
+{
+    Uint8 header[12];
+
+    if (PNG_Read(pipe->input, header, sizeof(header)) != sizeof(header) ||
+        PNG_BE32(header) != (pipe->crc ^ 0xFFFFFFFF) ||
+        SDL_memcmp(&header[8], "IDAT", 4) != 0) {
+        return -1;
+    }
+    pipe->chunk_left = PNG_BE32(&header[4]);
+    pipe->crc = PNG_UpdateCRC(pipe, 0xFFFFFFFF, &header[8], 4);
+    return 0;
+}
+
+/* Inflate the next size bytes of image data */
+static int PNG_Inflate(PNG_Pipeline *pipe, Uint8 *out, size_t size)
+{
+    PNG_Input *in = pipe->input;
+    tinfl_status status;
+    size_t in_bytes, out_bytes;
+
+    while (size > 0) {
+        if (pipe->dict_avail > 0) {
+            out_bytes = SDL_min(pipe->dict_avail, size);
+            SDL_memcpy(out, pipe->dict + pipe->dict_ofs, out_bytes);
+            out += out_bytes;
+            size -= out_bytes;
+            pipe->dict_avail -= out_bytes;
+            pipe->dict_ofs = (pipe->dict_ofs + out_bytes) & (TINFL_LZ_DICT_SIZE - 1);
+            continue;
+        }
+        if (pipe->chunk_left == 0) {
+            if (PNG_NextChunk(pipe) < 0) {
+                return -1;
+            }
+            continue;
+        }
+        if (in->pos == in->len && PNG_FillInput(in) == 0) {
+            return -1;
+        }
+        in_bytes = SDL_min(in->len - in->pos, pipe->chunk_left);
+        out_bytes = TINFL_LZ_DICT_SIZE - pipe->dict_ofs;
+        status = tinfl_decompress(&pipe->inflate, in->data + in->pos, &in_bytes,
+                                  pipe->dict, pipe->dict + pipe->dict_ofs, &out_bytes,
+                                  TINFL_FLAG_PARSE_ZLIB_HEADER | TINFL_FLAG_HAS_MORE_INPUT);
+        pipe->crc = PNG_UpdateCRC(pipe, pipe->crc, in->data + in->pos, in_bytes);
+        in->pos += in_bytes;
+        pipe->chunk_left -= (Uint32)in_bytes;
+        pipe->dict_avail = out_bytes;
+        if (status < 0 || (status == TINFL_STATUS_DONE && out_bytes == 0)) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int PNG_BatchRows(const PNG_Pipeline *pipe, int batch)
+{
+    return SDL_min(pipe->slot_rows, pipe->height - batch * pipe->slot_rows);
+}
+
+static Uint8 *PNG_BatchSlot(const PNG_Pipeline *pipe, int batch)
+{
+    return pipe->slots + (size_t)(batch % PNG_PIPELINE_SLOTS) * pipe->slot_rows * (pipe->stride + 1);
+}
+
+static int PNG_FillSlot(PNG_Pipeline *pipe, int batch)
+{
+    return PNG_Inflate(pipe, PNG_BatchSlot(pipe, batch),
+                       (size_t)PNG_BatchRows(pipe, batch) * (pipe->stride + 1));
+}
+
+static int SDLCALL PNG_InflateThread(void *data)
+{
+    PNG_Pipeline *pipe = (PNG_Pipeline *)data;
+    int batch;
+
+    for (batch = 0; batch < pipe->batches; ++batch) {
+        SDL_SemWait(pipe->empty);
+        if (SDL_AtomicGet(&pipe->cancel)) {
+            break;
+        }
+        if (PNG_FillSlot(pipe, batch) < 0) {
+            pipe->failed = 1;
+            SDL_SemPost(pipe->full);
+            break;
+        }
+        SDL_SemPost(pipe->full);
+    }
+    return 0;
+}
+
+/* Undo the filter on a row, in place after its filter byte */
+static int PNG_UnfilterRow(Uint8 *row, const Uint8 *prior, size_t stride, int bpp)
+{
+    size_t i;
+
+    switch (row[-1]) {
+    case 0:
+        break;
+    case 1:
+        for (i = bpp; i < stride; ++i) {
+            row[i] += row[i - bpp];
+        }
+        break;
+    case 2:
+        for (i = 0; i < stride; ++i) {
+            row[i] += prior[i];
+        }
+        break;
+    case 3:
+        for (i = 0; i < (size_t)bpp; ++i) {
+            row[i] += prior[i] >> 1;
+        }
+        for (; i < stride; ++i) {
+            row[i] += (row[i - bpp] + prior[i]) >> 1;
+        }
+        break;
+    case 4:
+        for (i = 0; i < (size_t)bpp; ++i) {
+            row[i] += prior[i];
+        }
+        for (; i < stride; ++i) {
+            row[i] += PNG_Paeth(row[i - bpp], prior[i], prior[i - bpp]);
+        }
+        break;
+    default:
+        return -1;
+    }
+    return 0;
+}
+
+/* Store an unfiltered row in the surface, spread out into the byte
+   order of a 32-bit format if there is one */
+static void PNG_StoreRow(Uint8 *dst, const Uint8 *src, int width, int channels, const int *order)
+{
+    int r, g, b, a;
+
+    if (!order) {
+        SDL_memcpy(dst, src, (size_t)width * channels);
+        return;
+    }
+    r = order[0];
+    g = order[1];
+    b = order[2];
+    a = order[3];
+    if (channels == 3) {
+        while (width--) {
+            dst[r] = src[0];
+            dst[g] = src[1];
+            dst[b] = src[2];
+            dst[a] = 0xFF;
+            src += 3;
+            dst += 4;
+        }
+    } else {
+        while (width--) {
+            dst[r] = src[0];
+            dst[g] = src[1];
+            dst[b] = src[2];
+            dst[a] = src[3];
+            src += 4;
+            dst += 4;
+        }
+    }
+}
+
+/* Decode the image data after the IDAT chunk header libpng stopped at */
+static int PNG_DecodePipelined(PNG_Input *in, SDL_Surface *surface, int channels, const int *order)
+{
+    PNG_Pipeline pipe;
+    SDL_Thread *thread = NULL;
+    Uint8 *last;
+    Uint8 *row;
+    const Uint8 *prior;
+    int batch, rows, y = 0;
+    int status = 0;
+    Uint32 c, v;
+    int k;
+
+    SDL_zero(pipe);
+    pipe.input = in;
+    for (c = 0; c < 256; ++c) {
+        v = c;
+        for (k = 0; k < 8; ++k) {
+            v = (v & 1) ? (0xEDB88320 ^ (v >> 1)) : (v >> 1);
+        }
+        pipe.crc_table[c] = v;
+    }
+    pipe.chunk_left = PNG_BE32(in->tail);
+    pipe.crc = PNG_UpdateCRC(&pipe, 0xFFFFFFFF, &in->tail[4], 4);
+    tinfl_init(&pipe.inflate);
+    pipe.height = surface->h;
+    pipe.stride = (size_t)surface->w * channels;
+    pipe.slot_rows = (int)SDL_max(PNG_PIPELINE_BYTES / (pipe.stride + 1), 1);
+    pipe.slot_rows = SDL_min(pipe.slot_rows, surface->h);
+    pipe.batches = (surface->h + pipe.slot_rows - 1) / pipe.slot_rows;
+
+    pipe.dict = (Uint8 *)SDL_malloc(TINFL_LZ_DICT_SIZE);
+    pipe.slots = (Uint8 *)SDL_malloc(PNG_PIPELINE_SLOTS * pipe.slot_rows * (pipe.stride + 1));
+    last = (Uint8 *)SDL_calloc(1, pipe.stride);
+    if (!pipe.dict || !pipe.slots || !last) {
+        status = SDL_OutOfMemory();
+        goto done;
+    }
+
+    /* Without a thread, the batches are inflated here in turn */
+    pipe.empty = SDL_CreateSemaphore(PNG_PIPELINE_SLOTS);
+    pipe.full = SDL_CreateSemaphore(0);
+    if (pipe.empty && pipe.full) {
+        thread = SDL_CreateThread(PNG_InflateThread, "IMG_LoadPNG", &pipe);
+    }
+
+    for (batch = 0; batch < pipe.batches && status == 0; ++batch) {
+        if (thread) {
+            SDL_SemWait(pipe.full);
+            if (pipe.failed) {
+                status = -1;
+                break;
+            }
+        } else if (PNG_FillSlot(&pipe, batch) < 0) {
+            status = -1;
+            break;
+        }
+        row = PNG_BatchSlot(&pipe, batch) + 1;
+        prior = last;
+        for (rows = PNG_BatchRows(&pipe, batch); rows--; ++y) {
+            if (PNG_UnfilterRow(row, prior, pipe.stride, channels) < 0) {
+                status = -1;
+                break;
+            }
+            PNG_StoreRow((Uint8 *)surface->pixels + y * surface->pitch,
+                         row, surface->w, channels, order);
+            prior = row;
+            row += pipe.stride + 1;
+        }
+        /* The slot goes back to the inflate thread, so keep its last row */
+        SDL_memcpy(last, prior, pipe.stride);
+        if (thread) {
+            SDL_SemPost(pipe.empty);
+        }
+    }
+
+    if (thread) {
+        if (status < 0) {
+            SDL_AtomicSet(&pipe.cancel, 1);
+            SDL_SemPost(pipe.empty);
+        }
+        SDL_WaitThread(thread, NULL);
+    }
+
+done:
+    if (pipe.empty) {
+        SDL_DestroySemaphore(pipe.empty);
+    }
+    if (pipe.full) {
+        SDL_DestroySemaphore(pipe.full);
+    }
+    SDL_free(pipe.dict);
+    SDL_free(pipe.slots);
+    SDL_free(last);
+    return status;
+}
+
+extern int IMG_FormatByteOrder(Uint32 format, int order[4]);
+
+/* Load a PNG, decoding it into the opaque or alpha format if it can */
+static SDL_Surface *LoadPNG_RW(SDL_RWops *src, Uint32 opaque, Uint32 alpha)
 {
     Sint64 start;
     const char *error;
+    PNG_Input input;
     SDL_Surface *volatile surface;
     png_structp png_ptr;
     png_infop info_ptr;
@@ -355,6 +809,10 @@ SDL_Surface *IMG_LoadPNG_RW(SDL_RWops *src)
     int row, i;
     int ckey = -1;
     png_color_16 *transv;
+    volatile Uint32 format = 0;
+    int order[4];
+    int bpp;
+    volatile int pipeline = 0;
 
     if ( !src ) {
         /* The error message has been set in SDL_RWFromFile */
@@ -370,6 +828,11 @@ SDL_Surface *IMG_LoadPNG_RW(SDL_RWops *src)
     error = NULL;
     png_ptr = NULL; info_ptr = NULL; row_pointers = NULL; surface = NULL;
 
+    if (PNG_InitInput(&input, src) < 0) {
+        error = "Out of memory";
+        goto done;
+    }
+
     /* Create the PNG loading context structure */
     png_ptr = lib.png_create_read_struct(PNG_LIBPNG_VER_STRING,
                       NULL,NULL,NULL);
@@ -400,13 +863,21 @@ SDL_Surface *IMG_LoadPNG_RW(SDL_RWops *src)
     }
 
     /* Set up the input control */
-    lib.png_set_read_fn(png_ptr, src, png_read_data);
+    lib.png_set_read_fn(png_ptr, &input, png_read_data);
 
     /* Read PNG header info */
     lib.png_read_info(png_ptr, info_ptr);
     lib.png_get_IHDR(png_ptr, info_ptr, &width, &height, &bit_depth,
             &color_type, &interlace_type, NULL, NULL);
 
+    /* Plain 8-bit RGB and RGBA images can go through the pipeline */
+    if ( bit_depth == 8 && interlace_type == PNG_INTERLACE_NONE &&
+         (color_type == PNG_COLOR_TYPE_RGB || color_type == PNG_COLOR_TYPE_RGB_ALPHA) &&
+         !lib.png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS) &&
+         SDL_memcmp(&input.tail[4], "IDAT", 4) == 0 && SDL_GetCPUCount() > 1 ) {
+        pipeline = (color_type == PNG_COLOR_TYPE_RGB) ? 3 : 4;
+    }
+
     /* tell libpng to strip 16 bit/color files down to 8 bits/color */
     lib.png_set_strip_16(png_ptr) ;
 
@@ -419,10 +890,36 @@ SDL_Surface *IMG_LoadPNG_RW(SDL_RWops *src)
     if (color_type == PNG_COLOR_TYPE_GRAY)
         lib.png_set_expand(png_ptr);
 
+    /* libpng can write 32-bit pixels with alpha (or filler) first or
+       last and with red and blue either way round */
+    if ( opaque || alpha ) {
+        SDL_bool has_alpha = ((color_type & PNG_COLOR_MASK_ALPHA) ||
+                lib.png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS)) ? SDL_TRUE : SDL_FALSE;
+        format = has_alpha ? alpha : opaque;
+        if ( IMG_FormatByteOrder(format, order) < 0 ||
+             (order[3] != 0 && order[3] != 3) ||
+             order[1] != (order[3] == 3 ? 1 : 2) ) {
+            format = 0;
+        }
+        if ( format ) {
+            lib.png_set_expand(png_ptr);
+            if ( !(color_type & PNG_COLOR_MASK_COLOR) )
+                lib.png_set_gray_to_rgb(png_ptr);
+            if ( order[0] > order[2] )
+                lib.png_set_bgr(png_ptr);
+            if ( !has_alpha )
+                lib.png_set_filler(png_ptr, 0xFF, order[3] == 0 ? PNG_FILLER_BEFORE : PNG_FILLER_AFTER);
+            else if ( order[3] == 0 )
+                lib.png_set_swap_alpha(png_ptr);
+        }
+    }
+
     /* For images with a single "transparent colour", set colour key;
        if more than one index has transparency, or if partially transparent
        entries exist, use full alpha channel */
-    if (lib.png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS)) {
+    if ( format ) {
+        /* Transparency has been expanded to an alpha channel */
+    } else if (lib.png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS)) {
         int num_trans;
         Uint8 *trans;
         lib.png_get_tRNS(png_ptr, info_ptr, &trans, &num_trans, &transv);
@@ -462,7 +959,10 @@ SDL_Surface *IMG_LoadPNG_RW(SDL_RWops *src)
     /* Allocate the SDL surface to hold the image */
     Rmask = Gmask = Bmask = Amask = 0 ;
     num_channels = lib.png_get_channels(png_ptr, info_ptr);
-    if ( num_channels >= 3 ) {
+    if ( format ) {
+        SDL_PixelFormatEnumToMasks(format, &bpp, &Rmask, &Gmask, &Bmask, &Amask);
+        num_channels = 4;
+    } else if ( num_channels >= 3 ) {
 #if SDL_BYTEORDER == SDL_LIL_ENDIAN
         Rmask = 0x000000FF;
         Gmask = 0x0000FF00;
@@ -494,6 +994,13 @@ SDL_Surface *IMG_LoadPNG_RW(SDL_RWops *src)
         SDL_SetColorKey(surface, SDL_TRUE, ckey);
     }
 
+    if ( pipeline ) {
+        if ( PNG_DecodePipelined(&input, surface, pipeline, format ? order : NULL) < 0 ) {
+            error = "Error reading the PNG file.";
+        }
+        goto done;
+    }
+
     /* Create the array of pointers to image data */
     row_pointers = (png_bytep*) SDL_malloc(sizeof(png_bytep)*height);
     if (!row_pointers) {
@@ -548,6 +1055,7 @@ done:   /* Clean up and return */
     if ( row_pointers ) {
         SDL_free(row_pointers);
     }
+    PNG_QuitInput(&input);
     if ( error ) {
         SDL_RWseek(src, start, RW_SEEK_SET);
         if ( surface ) {
@@ -559,6 +1067,16 @@ done:   /* Clean up and return */
     return(surface);
 }
 
+SDL_Surface *IMG_LoadPNG_RW(SDL_RWops *src)
+{
+    return LoadPNG_RW(src, 0, 0);
+}
+
+SDL_Surface *IMG_LoadNativePNG_RW(SDL_RWops *src, Uint32 opaque, Uint32 alpha)
+{
+    return LoadPNG_RW(src, opaque, alpha);
+}
+
 #else
 
 int IMG_InitPNG()
@@ -583,56 +1101,523 @@ SDL_Surface *IMG_LoadPNG_RW(SDL_RWops *src)
     return(NULL);
 }
 
+SDL_Surface *IMG_LoadNativePNG_RW(SDL_RWops *src, Uint32 opaque, Uint32 alpha)
+{
+    return(NULL);
+}
+
 #endif /* LOAD_PNG */
 
 #endif /* !defined(__APPLE__) || defined(SDL_IMAGE_USE_COMMON_BACKEND) */
 
-/* We'll always have PNG save support */
-#define SAVE_PNG
-
 #ifdef SAVE_PNG
 
-#include "miniz.h"
+/* PNG images are saved a strip of rows at a time.  Each strip is
+   converted, filtered and deflated on its own, ending on a sync flush
+   so the strips join up into one zlib stream, and the strips are
+   shared out among worker threads that run a few strips ahead of the
+   writer.
+ */
+#define PNG_STRIP_BYTES     (256 * 1024)
+#define PNG_DEFAULT_LEVEL   6
+
+typedef struct {
+    tdefl_output_buffer out;    /* the deflated strip */
+    size_t size;                /* bytes of filtered rows */
+    Uint32 adler;               /* Adler-32 of the filtered rows */
+    int status;                 /* 0 while pending, 1 when done, -1 on errors */
+} PNG_Strip;
+
+typedef struct {
+    const Uint8 *pixels;
+    int pitch;
+    Uint32 format;
+    Uint32 png_format;
+    int width;
+    int height;
+    int bpp;
+    mz_uint flags;
+    int level;
+    IMG_PNGFilter filter;
+    int strip_rows;
+    int strips;
+    PNG_Strip *strip;
+    int next;                   /* the next strip to encode */
+    int written;                /* the next strip to write */
+    int window;                 /* how far encoding may run ahead */
+    int failed;
+    SDL_mutex *lock;
+    SDL_cond *cond;
+} PNG_Saver;
+
+typedef struct {
+    tdefl_compressor *deflate;
+    Uint8 *rows;                /* the strip converted, after the row above it */
+    Uint8 *filtered;
+    Uint8 *trial;               /* a row with each filter, for IMG_PNG_FILTER_ADAPTIVE */
+    Uint8 *zero;                /* the row above the image */
+} PNG_Worker;
+
+static void PNG_Lock(PNG_Saver *saver)
+{
+    if (saver->lock) {
+        SDL_LockMutex(saver->lock);
+    }
+}
 
-int IMG_SavePNG(SDL_Surface *surface, const char *file)
+static void PNG_Unlock(PNG_Saver *saver)
 {
-    SDL_RWops *dst = SDL_RWFromFile(file, "wb");
-    if (dst) {
-        return IMG_SavePNG_RW(surface, dst, 1);
-    } else {
+    if (saver->lock) {
+        SDL_UnlockMutex(saver->lock);
+    }
+}
+
+static void PNG_FreeWorker(PNG_Worker *worker)
+{
+    SDL_free(worker->deflate);
+    SDL_free(worker->rows);
+    SDL_free(worker->filtered);
+    SDL_free(worker->trial);
+    SDL_free(worker->zero);
+}
+
+static int PNG_InitWorker(PNG_Saver *saver, PNG_Worker *worker)
+{
+    size_t stride = (size_t)saver->width * saver->bpp;
+
+    worker->deflate = (tdefl_compressor *)SDL_malloc(sizeof(*worker->deflate));
+    worker->rows = (Uint8 *)SDL_malloc((saver->strip_rows + 1) * stride);
+    worker->filtered = (Uint8 *)SDL_malloc(saver->strip_rows * (stride + 1));
+    worker->trial = (Uint8 *)SDL_malloc(5 * (stride + 1));
+    worker->zero = (Uint8 *)SDL_calloc(1, stride);
+    if (!worker->deflate || !worker->rows || !worker->filtered ||
+        !worker->trial || !worker->zero) {
+        PNG_FreeWorker(worker);
+        SDL_zerop(worker);
+        return SDL_OutOfMemory();
+    }
+    return 0;
+}
+
+/* The filter types match the PNG filter numbers */
+static void PNG_FilterRow(IMG_PNGFilter filter, const Uint8 *row, const Uint8 *prior, int stride, int bpp, Uint8 *out)
+{
+    int i;
+
+    *out++ = (Uint8)filter;
+    switch (filter) {
+    case IMG_PNG_FILTER_SUB:
+        for (i = 0; i < bpp; ++i) {
+            out[i] = row[i];
+        }
+        for (; i < stride; ++i) {
+            out[i] = row[i] - row[i - bpp];
+        }
+        break;
+    case IMG_PNG_FILTER_UP:
+        for (i = 0; i < stride; ++i) {
+            out[i] = row[i] - prior[i];
+        }
+        break;
+    case IMG_PNG_FILTER_AVERAGE:
+        for (i = 0; i < bpp; ++i) {
+            out[i] = row[i] - (prior[i] >> 1);
+        }
+        for (; i < stride; ++i) {
+            out[i] = row[i] - ((row[i - bpp] + prior[i]) >> 1);
+        }
+        break;
+    case IMG_PNG_FILTER_PAETH:
+        for (i = 0; i < bpp; ++i) {
+            out[i] = row[i] - prior[i];
+        }
+        for (; i < stride; ++i) {
+            out[i] = row[i] - PNG_Paeth(row[i - bpp], prior[i], prior[i - bpp]);
+        }
+        break;
+    default:
+        SDL_memcpy(out, row, stride);
+        break;
+    }
+}
+
+/* Pick the filter leaving the smallest sum of signed bytes, as libpng does */
+static void PNG_FilterRowAdaptive(PNG_Worker *worker, const Uint8 *row, const Uint8 *prior, int stride, int bpp, Uint8 *out)
+{
+    Uint32 sum, best_sum = 0xFFFFFFFF;
+    int filter, best = 0, i;
+
+    for (filter = IMG_PNG_FILTER_NONE; filter <= IMG_PNG_FILTER_PAETH; ++filter) {
+        Uint8 *trial = worker->trial + filter * (stride + 1);
+
+        PNG_FilterRow((IMG_PNGFilter)filter, row, prior, stride, bpp, trial);
+        sum = 0;
+        for (i = 1; i <= stride; ++i) {
+            int value = (Sint8)trial[i];
+            sum += (value < 0) ? -value : value;
+        }
+        if (sum < best_sum) {
+            best_sum = sum;
+            best = filter;
+        }
+    }
+    SDL_memcpy(out, worker->trial + best * (stride + 1), stride + 1);
+}
+
+static int PNG_EncodeStrip(PNG_Saver *saver, PNG_Worker *worker, int index)
+{
+    PNG_Strip *strip = &saver->strip[index];
+    int stride = saver->width * saver->bpp;
+    int y = index * saver->strip_rows;
+    int rows = SDL_min(saver->strip_rows, saver->height - y);
+    int first = (y > 0) ? y - 1 : y;
+    int last = (index == saver->strips - 1);
+    const Uint8 *prior;
+    const Uint8 *row;
+    Uint8 *out;
+    int i;
+
+    if (SDL_ConvertPixels(saver->width, y + rows - first,
+                          saver->format, saver->pixels + first * saver->pitch, saver->pitch,
+                          saver->png_format, worker->rows, stride) < 0) {
+        return -1;
+    }
+    prior = (y > 0) ? worker->rows : worker->zero;
+    row = worker->rows + (y - first) * stride;
+    out = worker->filtered;
+    for (i = 0; i < rows; ++i) {
+        if (saver->filter == IMG_PNG_FILTER_ADAPTIVE) {
+            PNG_FilterRowAdaptive(worker, row, prior, stride, saver->bpp, out);
+        } else {
+            PNG_FilterRow(saver->filter, row, prior, stride, saver->bpp, out);
+        }
+        prior = row;
+        row += stride;
+        out += stride + 1;
+    }
+    strip->size = out - worker->filtered;
+    strip->adler = (Uint32)mz_adler32(MZ_ADLER32_INIT, worker->filtered, strip->size);
+
+    strip->out.m_expandable = MZ_TRUE;
+    if (index == 0) {
+        /* The zlib header, flagging the compression level like zlib does */
+        Uint8 header[2];
+        header[0] = 0x78;
+        header[1] = (saver->level < 2) ? 0x01 : (saver->level < 6) ? 0x5E : (saver->level == 6) ? 0x9C : 0xDA;
+        if (!tdefl_output_buffer_putter(header, sizeof(header), &strip->out)) {
+            return -1;
+        }
+    }
+    if (tdefl_init(worker->deflate, tdefl_output_buffer_putter, &strip->out, saver->flags) != TDEFL_STATUS_OKAY ||
+        tdefl_compress_buffer(worker->deflate, worker->filtered, strip->size, last ? TDEFL_FINISH : TDEFL_SYNC_FLUSH) !=
+            (last ? TDEFL_STATUS_DONE : TDEFL_STATUS_OKAY)) {
+        return -1;
+    }
+    return 0;
+}
+
+/* Encode a strip without holding the lock, which is held on entry */
+static void PNG_RunStrip(PNG_Saver *saver, PNG_Worker *worker, int index)
+{
+    int status;
+
+    PNG_Unlock(saver);
+    status = PNG_EncodeStrip(saver, worker, index);
+    PNG_Lock(saver);
+
+    saver->strip[index].status = (status < 0) ? -1 : 1;
+    if (status < 0) {
+        saver->failed = 1;
+    }
+    if (saver->cond) {
+        SDL_CondBroadcast(saver->cond);
+    }
+}
+
+static int SDLCALL PNG_SaveThread(void *data)
+{
+    PNG_Saver *saver = (PNG_Saver *)data;
+    PNG_Worker worker;
+
+    /* Without memory for a worker, the writer and other threads do the work */
+    if (PNG_InitWorker(saver, &worker) < 0) {
         return -1;
     }
+    PNG_Lock(saver);
+    while (!saver->failed && saver->next < saver->strips) {
+        if (saver->next >= saver->written + saver->window) {
+            SDL_CondWait(saver->cond, saver->lock);
+            continue;
+        }
+        PNG_RunStrip(saver, &worker, saver->next++);
+    }
+    PNG_Unlock(saver);
+    PNG_FreeWorker(&worker);
+    return 0;
 }
 
-int IMG_SavePNG_RW(SDL_Surface *surface, SDL_RWops *dst, int freedst)
+/* Adler-32 of two pieces of data joined together, as zlib's adler32_combine() */
+static Uint32 PNG_CombineAdler32(Uint32 adler1, Uint32 adler2, size_t len2)
 {
-    int result = -1;
+    const Uint32 base = 65521;
+    Uint32 rem = (Uint32)(len2 % base);
+    Uint32 sum1 = adler1 & 0xFFFF;
+    Uint32 sum2 = (rem * sum1) % base;
+
+    sum1 += (adler2 & 0xFFFF) + base - 1;
+    sum2 += (adler1 >> 16) + (adler2 >> 16) + base - rem;
+    if (sum1 >= base) sum1 -= base;
+    if (sum1 >= base) sum1 -= base;
+    if (sum2 >= (base << 1)) sum2 -= (base << 1);
+    if (sum2 >= base) sum2 -= base;
+    return sum1 | (sum2 << 16);
+}
 
-    if (dst) {
+static int PNG_WriteChunk(SDL_RWops *dst, const char *type, const void *data, size_t size)
+{
+    mz_ulong crc = mz_crc32(MZ_CRC32_INIT, (const mz_uint8 *)type, 4);
+    if (size) {
+        crc = mz_crc32(crc, (const mz_uint8 *)data, size);
+    }
+
+    if (!SDL_WriteBE32(dst, (Uint32)size) || !SDL_RWwrite(dst, type, 4, 1) ||
+        (size && !SDL_RWwrite(dst, data, size, 1)) || !SDL_WriteBE32(dst, (Uint32)crc)) {
+        return -1;
+    }
+    return 0;
+}
+
+static int PNG_WriteHeader(SDL_RWops *dst, PNG_Saver *saver)
+{
+    static const Uint8 signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    Uint8 ihdr[13];
+
+    ihdr[0] = (Uint8)(saver->width >> 24);
+    ihdr[1] = (Uint8)(saver->width >> 16);
+    ihdr[2] = (Uint8)(saver->width >> 8);
+    ihdr[3] = (Uint8)saver->width;
+    ihdr[4] = (Uint8)(saver->height >> 24);
+    ihdr[5] = (Uint8)(saver->height >> 16);
+    ihdr[6] = (Uint8)(saver->height >> 8);
+    ihdr[7] = (Uint8)saver->height;
+    ihdr[8] = 8;                            /* bit depth */
+    ihdr[9] = (saver->bpp == 4) ? 6 : 2;    /* RGBA or RGB */
+    ihdr[10] = 0;                           /* deflate */
+    ihdr[11] = 0;                           /* adaptive filtering */
+    ihdr[12] = 0;                           /* not interlaced */
+
+    if (!SDL_RWwrite(dst, signature, sizeof(signature), 1) ||
+        PNG_WriteChunk(dst, "IHDR", ihdr, sizeof(ihdr)) < 0) {
+        return -1;
+    }
+    return 0;
+}
+
+static int PNG_SaveSurface(SDL_Surface *surface, SDL_RWops *dst, int level, IMG_PNGFilter filter, int threads)
+{
 #if SDL_BYTEORDER == SDL_LIL_ENDIAN
-        static const Uint32 png_format = SDL_PIXELFORMAT_ABGR8888;
+    static const Uint32 png_format = SDL_PIXELFORMAT_ABGR8888;
 #else
-        static const Uint32 png_format = SDL_PIXELFORMAT_RGBA8888;
+    static const Uint32 png_format = SDL_PIXELFORMAT_RGBA8888;
 #endif
-        size_t size;
-        void *png = NULL;
+    /* The probes miniz uses for each level, as in tdefl_write_image_to_png_file_in_memory_ex() */
+    static const mz_uint num_probes[11] = { 0, 1, 6, 32, 16, 32, 128, 256, 512, 768, 1500 };
+    PNG_Saver saver;
+    PNG_Worker worker;
+    SDL_Thread **thread = NULL;
+    SDL_Surface *cvt = NULL;
+    Uint32 adler = MZ_ADLER32_INIT;
+    int write_error = 0;
+    int helpers = 0, i, result = -1;
+
+    SDL_zero(saver);
+    SDL_zero(worker);
+    if (level < 0) {
+        level = PNG_DEFAULT_LEVEL;
+    }
+    saver.level = SDL_min(level, 10);
+    saver.flags = num_probes[saver.level];
+    saver.filter = (filter >= IMG_PNG_FILTER_NONE && filter <= IMG_PNG_FILTER_ADAPTIVE) ? filter : IMG_PNG_FILTER_ADAPTIVE;
+    saver.width = surface->w;
+    saver.height = surface->h;
+
+    /* Rows are converted a strip at a time, unless a palette or colorkey
+       needs the whole surface converted up front */
+    if (SDL_ISPIXELFORMAT_INDEXED(surface->format->format) ||
+        SDL_ISPIXELFORMAT_FOURCC(surface->format->format) ||
+        SDL_GetColorKey(surface, NULL) == 0) {
+        cvt = SDL_ConvertSurfaceFormat(surface, png_format, 0);
+        if (!cvt) {
+            return -1;
+        }
+        surface = cvt;
+    }
+    if (SDL_LockSurface(surface) < 0) {
+        SDL_FreeSurface(cvt);
+        return -1;
+    }
+    saver.pixels = (const Uint8 *)surface->pixels;
+    saver.pitch = surface->pitch;
+    saver.format = surface->format->format;
+    if (surface->format->Amask) {
+        saver.png_format = png_format;
+        saver.bpp = 4;
+    } else {
+        saver.png_format = SDL_PIXELFORMAT_RGB24;
+        saver.bpp = 3;
+    }
 
-        if (surface->format->format == png_format) {
-            png = tdefl_write_image_to_png_file_in_memory(surface->pixels, surface->w, surface->h, surface->format->BytesPerPixel, surface->pitch, &size);
-        } else {
-            SDL_Surface *cvt = SDL_ConvertSurfaceFormat(surface, png_format, 0);
-            if (cvt) {
-                png = tdefl_write_image_to_png_file_in_memory(cvt->pixels, cvt->w, cvt->h, cvt->format->BytesPerPixel, cvt->pitch, &size);
-                SDL_FreeSurface(cvt);
+    saver.strip_rows = SDL_max(1, PNG_STRIP_BYTES / (saver.width * saver.bpp + 1));
+    saver.strips = SDL_max(1, (saver.height + saver.strip_rows - 1) / saver.strip_rows);
+    saver.strip = (PNG_Strip *)SDL_calloc(saver.strips, sizeof(*saver.strip));
+    if (!saver.strip) {
+        SDL_OutOfMemory();
+        goto done;
+    }
+    if (PNG_InitWorker(&saver, &worker) < 0) {
+        goto done;
+    }
+
+    if (threads <= 0) {
+        threads = SDL_GetCPUCount();
+    }
+    threads = SDL_min(threads, saver.strips);
+    saver.window = SDL_max(threads, 1) * 2;
+    if (threads > 1) {
+        saver.lock = SDL_CreateMutex();
+        saver.cond = SDL_CreateCond();
+        thread = (SDL_Thread **)SDL_calloc(threads - 1, sizeof(*thread));
+        if (saver.lock && saver.cond && thread) {
+            for (helpers = 0; helpers < threads - 1; ++helpers) {
+                thread[helpers] = SDL_CreateThread(PNG_SaveThread, "IMG_SavePNG", &saver);
+                if (!thread[helpers]) {
+                    break;
+                }
             }
         }
-        if (png) {
-            if (SDL_RWwrite(dst, png, size, 1)) {
-                result = 0;
+        if (!helpers) {
+            /* Carry on with just the calling thread */
+            if (saver.cond) {
+                SDL_DestroyCond(saver.cond);
+                saver.cond = NULL;
             }
-            SDL_free(png);
+            if (saver.lock) {
+                SDL_DestroyMutex(saver.lock);
+                saver.lock = NULL;
+            }
+        }
+    }
+
+    if (PNG_WriteHeader(dst, &saver) < 0) {
+        SDL_SetError("Couldn't write PNG header");
+        write_error = 1;
+        PNG_Lock(&saver);
+        saver.failed = 1;
+        /* Wake helpers waiting for the window to move on, so they quit */
+        if (saver.cond) {
+            SDL_CondBroadcast(saver.cond);
+        }
+        PNG_Unlock(&saver);
+    }
+
+    /* Write the strips in order, helping to encode them meanwhile */
+    PNG_Lock(&saver);
+    while (!saver.failed && saver.written < saver.strips) {
+        PNG_Strip *strip = &saver.strip[saver.written];
+
+        if (strip->status > 0) {
+            int status;
+
+            PNG_Unlock(&saver);
+            status = PNG_WriteChunk(dst, "IDAT", strip->out.m_pBuf, strip->out.m_size);
+            adler = saver.written ? PNG_CombineAdler32(adler, strip->adler, strip->size) : strip->adler;
+            SDL_free(strip->out.m_pBuf);
+            strip->out.m_pBuf = NULL;
+            PNG_Lock(&saver);
+
+            if (status < 0) {
+                write_error = 1;
+                saver.failed = 1;
+            }
+            ++saver.written;
+            if (saver.cond) {
+                SDL_CondBroadcast(saver.cond);
+            }
+        } else if (saver.next < saver.strips && saver.next < saver.written + saver.window) {
+            PNG_RunStrip(&saver, &worker, saver.next++);
+        } else {
+            SDL_CondWait(saver.cond, saver.lock);
+        }
+    }
+    PNG_Unlock(&saver);
+
+    if (!saver.failed) {
+        Uint8 trailer[4];
+        trailer[0] = (Uint8)(adler >> 24);
+        trailer[1] = (Uint8)(adler >> 16);
+        trailer[2] = (Uint8)(adler >> 8);
+        trailer[3] = (Uint8)adler;
+        if (PNG_WriteChunk(dst, "IDAT", trailer, sizeof(trailer)) == 0 &&
+            PNG_WriteChunk(dst, "IEND", NULL, 0) == 0) {
+            result = 0;
+        }
+    } else if (!write_error) {
+        /* Errors in other threads can't be passed on */
+        SDL_SetError("Failed to convert and save image");
+    }
+
+done:
+    for (i = 0; i < helpers; ++i) {
+        SDL_WaitThread(thread[i], NULL);
+    }
+    SDL_free(thread);
+    if (saver.cond) {
+        SDL_DestroyCond(saver.cond);
+    }
+    if (saver.lock) {
+        SDL_DestroyMutex(saver.lock);
+    }
+    if (saver.strip) {
+        for (i = 0; i < saver.strips; ++i) {
+            SDL_free(saver.strip[i].out.m_pBuf);
+        }
+        SDL_free(saver.strip);
+    }
+    PNG_FreeWorker(&worker);
+    SDL_UnlockSurface(surface);
+    SDL_FreeSurface(cvt);
+    return result;
+}
+
+int IMG_SavePNG(SDL_Surface *surface, const char *file)
+{
+    return IMG_SavePNGEx(surface, file, -1, IMG_PNG_FILTER_ADAPTIVE, 0);
+}
+
+int IMG_SavePNG_RW(SDL_Surface *surface, SDL_RWops *dst, int freedst)
+{
+    return IMG_SavePNGEx_RW(surface, dst, freedst, -1, IMG_PNG_FILTER_ADAPTIVE, 0);
+}
+
+int IMG_SavePNGEx(SDL_Surface *surface, const char *file, int level, IMG_PNGFilter filter, int threads)
+{
+    SDL_RWops *dst = SDL_RWFromFile(file, "wb");
+    if (dst) {
+        return IMG_SavePNGEx_RW(surface, dst, 1, level, filter, threads);
+    } else {
+        return -1;
+    }
+}
+
+int IMG_SavePNGEx_RW(SDL_Surface *surface, SDL_RWops *dst, int freedst, int level, IMG_PNGFilter filter, int threads)
+{
+    int result = -1;
+
+    if (dst) {
+        if (surface) {
+            result = PNG_SaveSurface(surface, dst, level, filter, threads);
         } else {
-            SDL_SetError("Failed to convert and save image");
+            SDL_SetError("Passed NULL surface");
         }
         if (freedst) {
             SDL_RWclose(dst);
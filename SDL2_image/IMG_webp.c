@@ -50,6 +50,8 @@ static struct {
     VP8StatusCode (*webp_get_features_internal) (const uint8_t *data, size_t data_size, WebPBitstreamFeatures* features, int decoder_abi_version);
     uint8_t*    (*webp_decode_rgb_into) (const uint8_t* data, size_t data_size, uint8_t* output_buffer, size_t output_buffer_size, int output_stride);
     uint8_t*    (*webp_decode_rgba_into) (const uint8_t* data, size_t data_size, uint8_t* output_buffer, size_t output_buffer_size, int output_stride);
+    uint8_t*    (*webp_decode_bgra_into) (const uint8_t* data, size_t data_size, uint8_t* output_buffer, size_t output_buffer_size, int output_stride);
+    uint8_t*    (*webp_decode_argb_into) (const uint8_t* data, size_t data_size, uint8_t* output_buffer, size_t output_buffer_size, int output_stride);
 } lib;
 
 #ifdef LOAD_WEBP_DYNAMIC
@@ -84,6 +86,22 @@ int IMG_InitWEBP()
             SDL_UnloadObject(lib.handle);
             return -1;
         }
+
+        lib.webp_decode_bgra_into =
+            ( uint8_t* (*) (const uint8_t*, size_t, uint8_t*, size_t, int ) )
+            SDL_LoadFunction(lib.handle, "WebPDecodeBGRAInto" );
+        if ( lib.webp_decode_bgra_into == NULL ) {
+            SDL_UnloadObject(lib.handle);
+            return -1;
+        }
+
+        lib.webp_decode_argb_into =
+            ( uint8_t* (*) (const uint8_t*, size_t, uint8_t*, size_t, int ) )
+            SDL_LoadFunction(lib.handle, "WebPDecodeARGBInto" );
+        if ( lib.webp_decode_argb_into == NULL ) {
+            SDL_UnloadObject(lib.handle);
+            return -1;
+        }
     }
     ++lib.loaded;
 
@@ -116,6 +134,8 @@ int IMG_InitWEBP()
         lib.webp_get_features_internal = WebPGetFeaturesInternal;
         lib.webp_decode_rgb_into = WebPDecodeRGBInto;
         lib.webp_decode_rgba_into = WebPDecodeRGBAInto;
+        lib.webp_decode_bgra_into = WebPDecodeBGRAInto;
+        lib.webp_decode_argb_into = WebPDecodeARGBInto;
     }
     ++lib.loaded;
 
@@ -174,7 +194,9 @@ int IMG_isWEBP(SDL_RWops *src)
     return webp_getinfo( src, NULL );
 }
 
-SDL_Surface *IMG_LoadWEBP_RW(SDL_RWops *src)
+extern int IMG_FormatByteOrder(Uint32 format, int order[4]);
+
+static SDL_Surface *LoadWEBP_RW(SDL_RWops *src, Uint32 opaque, Uint32 alpha)
 {
     Sint64 start;
     const char *error = NULL;
@@ -186,8 +208,13 @@ SDL_Surface *IMG_LoadWEBP_RW(SDL_RWops *src)
     WebPBitstreamFeatures features;
     int raw_data_size;
     uint8_t *raw_data = NULL;
+    const uint8_t *data = NULL;
     int r;
     uint8_t *ret;
+    uint8_t *(*decode_into)(const uint8_t*, size_t, uint8_t*, size_t, int) = NULL;
+    Uint32 format;
+    int order[4];
+    int bpp;
 
     if ( !src ) {
         /* The error message has been set in SDL_RWFromFile */
@@ -206,19 +233,34 @@ SDL_Surface *IMG_LoadWEBP_RW(SDL_RWops *src)
         goto error;
     }
 
-    // seek to start of file
-    SDL_RWseek(src, 0, RW_SEEK_SET );
-
-    raw_data = (uint8_t*) SDL_malloc( raw_data_size );
-    if ( raw_data == NULL ) {
-        error = "Failed to allocate enought buffer for WEBP";
-        goto error;
+#ifdef SDL_RWOPS_MAPPED
+    /* Memory streams and mapped files are decoded in place */
+    {
+        size_t size;
+        const uint8_t *mem = (const uint8_t *) SDL_RWGetMemory( src, &size );
+        if ( mem && (size_t)raw_data_size <= size ) {
+            data = mem;
+            SDL_RWseek(src, raw_data_size, RW_SEEK_SET);
+        }
     }
+#endif
 
-    r = SDL_RWread(src, raw_data, 1, raw_data_size );
-    if ( r != raw_data_size ) {
-        error = "Failed to read WEBP";
-        goto error;
+    if ( data == NULL ) {
+        // seek to start of file
+        SDL_RWseek(src, 0, RW_SEEK_SET );
+
+        raw_data = (uint8_t*) SDL_malloc( raw_data_size );
+        if ( raw_data == NULL ) {
+            error = "Failed to allocate enought buffer for WEBP";
+            goto error;
+        }
+
+        r = SDL_RWread(src, raw_data, 1, raw_data_size );
+        if ( r != raw_data_size ) {
+            error = "Failed to read WEBP";
+            goto error;
+        }
+        data = raw_data;
     }
 
 #if 0
@@ -230,11 +272,40 @@ SDL_Surface *IMG_LoadWEBP_RW(SDL_RWops *src)
     }
 #endif
 
-    if ( lib.webp_get_features_internal( raw_data, raw_data_size, &features, WEBP_DECODER_ABI_VERSION ) != VP8_STATUS_OK ) {
+    if ( lib.webp_get_features_internal( data, raw_data_size, &features, WEBP_DECODER_ABI_VERSION ) != VP8_STATUS_OK ) {
         error = "WebPGetFeatures has failed";
         goto error;
     }
 
+    /* libwebp writes 32-bit pixels in RGBA, BGRA or ARGB byte order */
+    format = features.has_alpha ? alpha : opaque;
+    if ( IMG_FormatByteOrder(format, order) == 0 ) {
+        if ( order[0] == 0 && order[1] == 1 && order[2] == 2 ) {
+            decode_into = lib.webp_decode_rgba_into;
+        } else if ( order[0] == 2 && order[1] == 1 && order[2] == 0 ) {
+            decode_into = lib.webp_decode_bgra_into;
+        } else if ( order[0] == 1 && order[1] == 2 && order[2] == 3 ) {
+            decode_into = lib.webp_decode_argb_into;
+        }
+    }
+
+    if ( decode_into ) {
+        SDL_PixelFormatEnumToMasks(format, &bpp, &Rmask, &Gmask, &Bmask, &Amask);
+        surface = SDL_CreateRGBSurface(SDL_SWSURFACE,
+                features.width, features.height, 32, Rmask,Gmask,Bmask,Amask);
+        if ( surface == NULL ) {
+            error = "Failed to allocate SDL_Surface";
+            goto error;
+        }
+        ret = decode_into( data, raw_data_size, (uint8_t *)surface->pixels, surface->pitch * surface->h,  surface->pitch );
+        if ( !ret ) {
+            error = "Failed to decode WEBP";
+            goto error;
+        }
+        SDL_free( raw_data );
+        return surface;
+    }
+
     /* Check if it's ok !*/
 #if SDL_BYTEORDER == SDL_LIL_ENDIAN
     Rmask = 0x000000FF;
@@ -261,9 +332,9 @@ SDL_Surface *IMG_LoadWEBP_RW(SDL_RWops *src)
     }
 
     if ( features.has_alpha ) {
-        ret = lib.webp_decode_rgba_into( raw_data, raw_data_size, (uint8_t *)surface->pixels, surface->pitch * surface->h,  surface->pitch );
+        ret = lib.webp_decode_rgba_into( data, raw_data_size, (uint8_t *)surface->pixels, surface->pitch * surface->h,  surface->pitch );
     } else {
-        ret = lib.webp_decode_rgb_into( raw_data, raw_data_size, (uint8_t *)surface->pixels, surface->pitch * surface->h,  surface->pitch );
+        ret = lib.webp_decode_rgb_into( data, raw_data_size, (uint8_t *)surface->pixels, surface->pitch * surface->h,  surface->pitch );
     }
 
     if ( !ret ) {
@@ -296,6 +367,16 @@ error:
     return(NULL);
 }
 
+SDL_Surface *IMG_LoadWEBP_RW(SDL_RWops *src)
+{
+    return LoadWEBP_RW(src, 0, 0);
+}
+
+SDL_Surface *IMG_LoadNativeWEBP_RW(SDL_RWops *src, Uint32 opaque, Uint32 alpha)
+{
+    return LoadWEBP_RW(src, opaque, alpha);
+}
+
 #else
 
 int IMG_InitWEBP()
@@ -320,4 +401,9 @@ SDL_Surface *IMG_LoadWEBP_RW(SDL_RWops *src)
     return(NULL);
 }
 
+SDL_Surface *IMG_LoadNativeWEBP_RW(SDL_RWops *src, Uint32 opaque, Uint32 alpha)
+{
+    return(NULL);
+}
+
 #endif /* LOAD_WEBP */
@@ -906,16 +906,20 @@ static int color_to_rgb(char *spec, int speclen, Uint32 *rgb)
 #define MAX(a, b) ((a) > (b) ? (a) : (b))
 #endif
 
-static char *linebuf;
-static int buflen;
-static char *error;
+/* The line buffer and error of a load, kept per call so images can be
+   loaded on several threads at once */
+typedef struct {
+    char *linebuf;
+    int buflen;
+    char *error;
+} xpm_state;
 
 /*
  * Read next line from the source.
  * If len > 0, it's assumed to be at least len chars (for efficiency).
  * Return NULL and set error upon EOF or parse error.
  */
-static char *get_next_line(char ***lines, SDL_RWops *src, int len)
+static char *get_next_line(char ***lines, SDL_RWops *src, int len, xpm_state *state)
 {
     char *linebufnew;
 
@@ -926,51 +930,49 @@ static char *get_next_line(char ***lines, SDL_RWops *src, int len)
         int n;
         do {
             if (SDL_RWread(src, &c, 1, 1) <= 0) {
-                error = "Premature end of data";
+                state->error = "Premature end of data";
                 return NULL;
             }
         } while (c != '"');
         if (len) {
             len += 4;   /* "\",\n\0" */
-            if (len > buflen){
-                buflen = len;
-                linebufnew = (char *)SDL_realloc(linebuf, buflen);
+            if (len > state->buflen){
+                state->buflen = len;
+                linebufnew = (char *)SDL_realloc(state->linebuf, state->buflen);
                 if (!linebufnew) {
-                    SDL_free(linebuf);
-                    error = "Out of memory";
+                    state->error = "Out of memory";
                     return NULL;
                 }
-                linebuf = linebufnew;
+                state->linebuf = linebufnew;
             }
-            if (SDL_RWread(src, linebuf, len - 1, 1) <= 0) {
-                error = "Premature end of data";
+            if (SDL_RWread(src, state->linebuf, len - 1, 1) <= 0) {
+                state->error = "Premature end of data";
                 return NULL;
             }
             n = len - 2;
         } else {
             n = 0;
             do {
-                if (n >= buflen - 1) {
-                    if (buflen == 0)
-                        buflen = 16;
-                    buflen *= 2;
-                    linebufnew = (char *)SDL_realloc(linebuf, buflen);
+                if (n >= state->buflen - 1) {
+                    if (state->buflen == 0)
+                        state->buflen = 16;
+                    state->buflen *= 2;
+                    linebufnew = (char *)SDL_realloc(state->linebuf, state->buflen);
                     if (!linebufnew) {
-                        SDL_free(linebuf);
-                        error = "Out of memory";
+                        state->error = "Out of memory";
                         return NULL;
                     }
-                    linebuf = linebufnew;
+                    state->linebuf = linebufnew;
                 }
-                if (SDL_RWread(src, linebuf + n, 1, 1) <= 0) {
-                    error = "Premature end of data";
+                if (SDL_RWread(src, state->linebuf + n, 1, 1) <= 0) {
+                    state->error = "Premature end of data";
                     return NULL;
                 }
-            } while (linebuf[n++] != '"');
+            } while (state->linebuf[n++] != '"');
             n--;
         }
-        linebuf[n] = '\0';
-        return linebuf;
+        state->linebuf[n] = '\0';
+        return state->linebuf;
     }
 }
 
@@ -1002,10 +1004,11 @@ static SDL_Surface *load_xpm(char **xpm, SDL_RWops *src)
     char *line;
     char ***xpmlines = NULL;
     int pixels_len;
+    xpm_state state;
 
-    error = NULL;
-    linebuf = NULL;
-    buflen = 0;
+    state.error = NULL;
+    state.linebuf = NULL;
+    state.buflen = 0;
 
     if (src)
         start = SDL_RWtell(src);
@@ -1013,7 +1016,7 @@ static SDL_Surface *load_xpm(char **xpm, SDL_RWops *src)
     if (xpm)
         xpmlines = &xpm;
 
-    line = get_next_line(xpmlines, src, 0);
+    line = get_next_line(xpmlines, src, 0, &state);
     if (!line)
         goto done;
     /*
@@ -1027,13 +1030,13 @@ static SDL_Surface *load_xpm(char **xpm, SDL_RWops *src)
      */
     if (SDL_sscanf(line, "%d %d %d %d", &w, &h, &ncolors, &cpp) != 4
        || w <= 0 || h <= 0 || ncolors <= 0 || cpp <= 0) {
-        error = "Invalid format description";
+        state.error = "Invalid format description";
         goto done;
     }
 
     keystrings = (char *)SDL_malloc(ncolors * cpp);
     if (!keystrings) {
-        error = "Out of memory";
+        state.error = "Out of memory";
         goto done;
     }
     nextkey = keystrings;
@@ -1058,12 +1061,12 @@ static SDL_Surface *load_xpm(char **xpm, SDL_RWops *src)
     /* Read the colors */
     colors = create_colorhash(ncolors);
     if (!colors) {
-        error = "Out of memory";
+        state.error = "Out of memory";
         goto done;
     }
     for (index = 0; index < ncolors; ++index ) {
         char *p;
-        line = get_next_line(xpmlines, src, 0);
+        line = get_next_line(xpmlines, src, 0, &state);
         if (!line)
             goto done;
 
@@ -1077,7 +1080,7 @@ static SDL_Surface *load_xpm(char **xpm, SDL_RWops *src)
 
             SKIPSPACE(p);
             if (!*p) {
-                error = "colour parse error";
+                state.error = "colour parse error";
                 goto done;
             }
             nametype = *p;
@@ -1112,7 +1115,7 @@ static SDL_Surface *load_xpm(char **xpm, SDL_RWops *src)
     pixels_len = w * cpp;
     dst = (Uint8 *)image->pixels;
     for (y = 0; y < h; y++) {
-        line = get_next_line(xpmlines, src, pixels_len);
+        line = get_next_line(xpmlines, src, pixels_len, &state);
         if (!line)
             goto done;
 
@@ -1137,20 +1140,20 @@ static SDL_Surface *load_xpm(char **xpm, SDL_RWops *src)
     }
 
 done:
-    if (error) {
+    if (state.error) {
         if ( src )
             SDL_RWseek(src, start, RW_SEEK_SET);
         if ( image ) {
             SDL_FreeSurface(image);
             image = NULL;
         }
-        IMG_SetError("%s", error);
+        IMG_SetError("%s", state.error);
     }
     if (keystrings)
         SDL_free(keystrings);
     free_colorhash(colors);
-    if (linebuf)
-        SDL_free(linebuf);
+    if (state.linebuf)
+        SDL_free(state.linebuf);
     return(image);
 }
 
@@ -91,6 +91,106 @@ extern DECLSPEC SDL_Surface * SDLCALL IMG_Load_RW(SDL_RWops *src, int freesrc);
 extern DECLSPEC SDL_Texture * SDLCALL IMG_LoadTexture(SDL_Renderer *renderer, const char *file);
 extern DECLSPEC SDL_Texture * SDLCALL IMG_LoadTexture_RW(SDL_Renderer *renderer, SDL_RWops *src, int freesrc);
 extern DECLSPEC SDL_Texture * SDLCALL IMG_LoadTextureTyped_RW(SDL_Renderer *renderer, SDL_RWops *src, int freesrc, const char *type);
+
+/* Load images into render textures in the background.
+
+   Images are decoded by a pool of worker threads, highest priority
+   first; 'threads' may be 0 for one thread per spare CPU.  Each job is
+   given an id, which is 0 if it couldn't be started.
+
+   IMG_UpdateAsync() must be called once a frame from the thread that
+   uses the renderer.  It creates textures for decoded images until
+   'budget_ms' milliseconds have passed (always at least one) and hands
+   each to its job's callback, or NULL with IMG_GetError() set if the
+   image couldn't be loaded.  The callback owns the texture.  It returns
+   the number of jobs still to be delivered.
+
+   An event of type IMG_GetAsyncEventType() is pushed as each image is
+   decoded, so a loop waiting in SDL_WaitEvent() wakes up to upload it.
+   Its user.code is the job id and data1 the job's userdata; the event
+   needs no handling beyond calling IMG_UpdateAsync().
+
+   Jobs can be cancelled or reprioritized until they are delivered, and
+   return -1 if the job is unknown.  Freeing the loader drops every job
+   that hasn't been delivered without calling its callback.
+ */
+typedef struct _IMG_AsyncLoader IMG_AsyncLoader;
+typedef void (SDLCALL *IMG_AsyncCallback)(void *userdata, Uint32 job, SDL_Texture *texture);
+
+extern DECLSPEC IMG_AsyncLoader * SDLCALL IMG_CreateAsyncLoader(SDL_Renderer *renderer, int threads);
+extern DECLSPEC Uint32 SDLCALL IMG_LoadAsync(IMG_AsyncLoader *loader, const char *file, int priority, IMG_AsyncCallback callback, void *userdata);
+extern DECLSPEC int SDLCALL IMG_SetAsyncPriority(IMG_AsyncLoader *loader, Uint32 job, int priority);
+extern DECLSPEC int SDLCALL IMG_CancelAsync(IMG_AsyncLoader *loader, Uint32 job);
+extern DECLSPEC int SDLCALL IMG_UpdateAsync(IMG_AsyncLoader *loader, Uint32 budget_ms);
+extern DECLSPEC Uint32 SDLCALL IMG_GetAsyncEventType(IMG_AsyncLoader *loader);
+extern DECLSPEC void SDLCALL IMG_FreeAsyncLoader(IMG_AsyncLoader *loader);
+
+/* Pack many small images onto a few texture atlas pages, so they can all
+   be drawn from one or two textures.
+
+   IMG_CreateAtlas() loads the images in 'source', which is either a
+   directory, whose image files are packed, or a manifest listing image
+   files one to a line relative to it; blank lines and lines starting
+   with '#' are skipped.  Each image is named by its path from there
+   without the extension, "icons/open.png" becoming "icons/open".  The
+   images are packed with MaxRects onto pages up to 'max_size' pixels
+   square (0 for 2048), rounded down to a power of two, with at least
+   'padding' transparent pixels around each, and every page is cut down
+   to power of two sides.
+
+   IMG_SaveAtlas() writes a text index naming the pages and the image
+   rectangles on them, and saves the pages beside it as PNG files named
+   after it: "ui.atlas" has "ui_0.png", "ui_1.png" and so on.  Atlases
+   can be packed at build time and opened with IMG_LoadAtlas().
+
+   IMG_GetAtlasImage() finds an image by name, returning the texture of
+   its page and where it is on it.  The textures are made for the first
+   renderer asked for as they are needed, and belong to the atlas.
+ */
+typedef struct _IMG_Atlas IMG_Atlas;
+
+extern DECLSPEC IMG_Atlas * SDLCALL IMG_CreateAtlas(const char *source, int max_size, int padding);
+extern DECLSPEC int SDLCALL IMG_SaveAtlas(IMG_Atlas *atlas, const char *index);
+extern DECLSPEC IMG_Atlas * SDLCALL IMG_LoadAtlas(const char *index);
+extern DECLSPEC int SDLCALL IMG_GetAtlasImage(IMG_Atlas *atlas, SDL_Renderer *renderer, const char *name, SDL_Texture **texture, SDL_Rect *srcrect);
+extern DECLSPEC void SDLCALL IMG_FreeAtlas(IMG_Atlas *atlas);
+
+/* An image cache keeps decoded images and their textures around, keyed
+   by the canonical path of the file, when it was last changed and the
+   size asked for, so loading an image again is only a lookup.  Images
+   whose files change are loaded afresh.  Names SDL_RWFromFile() opens
+   but that aren't files, like Android assets, are keyed by the name and
+   never reloaded.  A width and height of 0 load an
+   image at its own size; otherwise it is scaled to fit in them keeping
+   its aspect ratio, either being 0 leaving that side unconstrained.
+   Decoded images and textures each have their own budget, and the least
+   recently used ones beyond it are dropped.  Those still in use are
+   never dropped, and a texture miss uploads the decoded image if it is
+   still cached.
+   Surfaces returned by the cache are shared: they must not be modified,
+   and are released with SDL_FreeSurface() as usual.  Textures are
+   released with IMG_ReleaseCachedTexture().  The cache is used from one
+   thread.
+   Clearing or destroying the cache destroys the textures it created, so
+   do it before destroying their renderer.
+ */
+typedef struct _IMG_ImageCache IMG_ImageCache;
+
+extern DECLSPEC IMG_ImageCache * SDLCALL IMG_CreateImageCache(size_t max_surface_bytes, size_t max_texture_bytes);
+extern DECLSPEC void SDLCALL IMG_ClearImageCache(IMG_ImageCache *cache);
+extern DECLSPEC void SDLCALL IMG_DestroyImageCache(IMG_ImageCache *cache);
+
+/* Get an image from the cache, loading it if it isn't there.  With a NULL
+   cache the image is just loaded.
+ */
+extern DECLSPEC SDL_Surface * SDLCALL IMG_CacheLoad(IMG_ImageCache *cache, const char *file, int width, int height);
+extern DECLSPEC SDL_Texture * SDLCALL IMG_CacheLoadTexture(IMG_ImageCache *cache, SDL_Renderer *renderer, const char *file, int width, int height);
+extern DECLSPEC void SDLCALL IMG_ReleaseCachedTexture(IMG_ImageCache *cache, SDL_Texture *texture);
+
+/* Get the image cache counters and the bytes it holds.  Each load is a
+   hit or a miss.  Any of the pointers may be NULL.
+ */
+extern DECLSPEC void SDLCALL IMG_GetImageCacheStats(const IMG_ImageCache *cache, Uint32 *hits, Uint32 *misses, Uint32 *evictions, size_t *surface_bytes, size_t *texture_bytes);
 #endif /* SDL 2.0 */
 
 /* Functions to detect a file type, given a seekable source */
@@ -128,10 +228,76 @@ extern DECLSPEC SDL_Surface * SDLCALL IMG_LoadWEBP_RW(SDL_RWops *src);
 
 extern DECLSPEC SDL_Surface * SDLCALL IMG_ReadXPMFromArray(char **xpm);
 
+/* Load a JPEG image scaled down while it is decoded, which takes a
+   fraction of the time and memory of loading it at full size.  The
+   image comes out at the smallest scale libjpeg supports that is still
+   at least as large as the image scaled to fit in width by height; a
+   width or height of 0 leaves that side unconstrained.  Backends that
+   can't scale JPEG images load them at full size.
+ */
+extern DECLSPEC SDL_Surface * SDLCALL IMG_LoadJPG_Scaled_RW(SDL_RWops *src, int width, int height);
+
+/* Play animated images a frame at a time.
+
+   Frames are decoded on demand and drawn onto a canvas the size of the
+   animation, which is what IMG_ReadAnimationFrame() returns; it belongs
+   to the animation and is only valid until the next call.  Animated
+   GIFs are streamed from the data source, which must stay open; other
+   images come out as a single frame.
+
+   The first 'cache_frames' frames are kept once drawn, so short loops
+   are decoded only once and long ones replay their start from memory,
+   at the cost of one canvas per cached frame.
+
+   IMG_ReadAnimationFrame() returns 1 with the next frame, 0 after the
+   last one, or -1 on errors.  IMG_RewindAnimation() starts it again.
+ */
+typedef enum
+{
+    IMG_DISPOSE_NONE,       /* the frame stays on the canvas */
+    IMG_DISPOSE_BACKGROUND, /* its area is cleared to transparent */
+    IMG_DISPOSE_PREVIOUS    /* the canvas goes back to what it was before */
+} IMG_Disposal;
+
+typedef struct
+{
+    int index;              /* number of the frame, from 0 */
+    int delay;              /* how long to show it, in milliseconds */
+    IMG_Disposal disposal;  /* what happens to it before the next frame */
+    SDL_Rect rect;          /* the area of the canvas it was drawn in */
+} IMG_AnimationFrame;
+
+typedef struct _IMG_Animation IMG_Animation;
+
+extern DECLSPEC IMG_Animation * SDLCALL IMG_OpenAnimation(const char *file, int cache_frames);
+extern DECLSPEC IMG_Animation * SDLCALL IMG_OpenAnimation_RW(SDL_RWops *src, int freesrc, int cache_frames);
+extern DECLSPEC int SDLCALL IMG_ReadAnimationFrame(IMG_Animation *anim, SDL_Surface **canvas, IMG_AnimationFrame *frame);
+extern DECLSPEC int SDLCALL IMG_RewindAnimation(IMG_Animation *anim);
+extern DECLSPEC void SDLCALL IMG_CloseAnimation(IMG_Animation *anim);
+
 /* Individual saving functions */
 extern DECLSPEC int SDLCALL IMG_SavePNG(SDL_Surface *surface, const char *file);
 extern DECLSPEC int SDLCALL IMG_SavePNG_RW(SDL_Surface *surface, SDL_RWops *dst, int freedst);
 
+/* Save a PNG with a chosen compression level, from 0 (fastest) to 10
+   (smallest), or -1 for the default of 6, and row filter.  The image is
+   compressed in strips of rows on up to 'threads' threads, 0 meaning
+   one per CPU, and written out as each strip finishes.  IMG_SavePNG()
+   uses the defaults with the adaptive filter.
+ */
+typedef enum
+{
+    IMG_PNG_FILTER_NONE,
+    IMG_PNG_FILTER_SUB,
+    IMG_PNG_FILTER_UP,
+    IMG_PNG_FILTER_AVERAGE,
+    IMG_PNG_FILTER_PAETH,
+    IMG_PNG_FILTER_ADAPTIVE     /* the best of the above for each row */
+} IMG_PNGFilter;
+
+extern DECLSPEC int SDLCALL IMG_SavePNGEx(SDL_Surface *surface, const char *file, int level, IMG_PNGFilter filter, int threads);
+extern DECLSPEC int SDLCALL IMG_SavePNGEx_RW(SDL_Surface *surface, SDL_RWops *dst, int freedst, int level, IMG_PNGFilter filter, int threads);
+
 /* We'll use SDL for reporting errors */
 #define IMG_SetError    SDL_SetError
 #define IMG_GetError    SDL_GetError
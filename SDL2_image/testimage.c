@@ -0,0 +1,139 @@
+/*
+  testimage:  Checks of the SDL image library that need no display.
+  Copyright (C) 1997-2016 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/* Save and load images in memory and check the results, exiting with
+   the number of failed checks.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "SDL.h"
+#include "SDL_image.h"
+
+static int failures = 0;
+
+static void check(int ok, const char *what)
+{
+    printf("%s: %s\n", ok ? "pass" : "FAIL", what);
+    if ( !ok ) {
+        ++failures;
+    }
+}
+
+/* A stream that is slow to fail every write, so helper threads have
+   filled their window of strips by the time the writer gives up */
+static Sint64 SDLCALL failing_seek(SDL_RWops *context, Sint64 offset, int whence)
+{
+    return 0;
+}
+
+static size_t SDLCALL failing_read(SDL_RWops *context, void *ptr, size_t size, size_t maxnum)
+{
+    return 0;
+}
+
+static size_t SDLCALL failing_write(SDL_RWops *context, const void *ptr, size_t size, size_t num)
+{
+    SDL_Delay(200);
+    return 0;
+}
+
+static int SDLCALL failing_close(SDL_RWops *context)
+{
+    SDL_FreeRW(context);
+    return 0;
+}
+
+static void test_png_save(void)
+{
+    SDL_Surface *surface, *loaded;
+    SDL_RWops *dst;
+    Uint8 *data;
+    Uint8 r, g, b, a;
+    size_t size;
+
+    /* Tall enough to be split into several strips */
+    surface = SDL_CreateRGBSurface(0, 256, 2550, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
+    check(surface != NULL, "create a surface to save");
+    if ( !surface ) {
+        return;
+    }
+    SDL_FillRect(surface, NULL, 0x80402010);
+
+    size = 4 * 1024 * 1024;
+    data = (Uint8 *)SDL_malloc(size);
+    dst = data ? SDL_RWFromMem(data, (int)size) : NULL;
+    if ( dst ) {
+        check(IMG_SavePNGEx_RW(surface, dst, 0, -1, IMG_PNG_FILTER_ADAPTIVE, 2) == 0,
+              "save a PNG on two threads");
+        SDL_RWseek(dst, 0, RW_SEEK_SET);
+        loaded = IMG_LoadPNG_RW(dst);
+        if ( loaded && SDL_LockSurface(loaded) == 0 ) {
+            SDL_GetRGBA(*(const Uint32 *)loaded->pixels, loaded->format, &r, &g, &b, &a);
+            SDL_UnlockSurface(loaded);
+        } else {
+            r = g = b = a = 0;
+        }
+        check(loaded && loaded->w == surface->w && loaded->h == surface->h &&
+              r == 0x40 && g == 0x20 && b == 0x10 && a == 0x80,
+              "load the saved PNG back");
+        SDL_FreeSurface(loaded);
+        SDL_RWclose(dst);
+    } else {
+        check(0, "open a memory stream");
+    }
+    SDL_free(data);
+
+    /* A failed header write must stop the helper threads, not hang */
+    dst = SDL_AllocRW();
+    if ( dst ) {
+        dst->seek = failing_seek;
+        dst->read = failing_read;
+        dst->write = failing_write;
+        dst->close = failing_close;
+        SDL_ClearError();
+        check(IMG_SavePNGEx_RW(surface, dst, 1, -1, IMG_PNG_FILTER_ADAPTIVE, 2) < 0 &&
+              *SDL_GetError() != '\0',
+              "saving to a failing stream returns an error");
+    } else {
+        check(0, "create a failing stream");
+    }
+    SDL_FreeSurface(surface);
+}
+
+int main(int argc, char *argv[])
+{
+    if ( SDL_Init(0) < 0 ) {
+        fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return(2);
+    }
+
+    test_png_save();
+
+    IMG_Quit();
+    SDL_Quit();
+    printf("%d failed\n", failures);
+    return(failures);
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -29,12 +29,18 @@
 #include FT_OUTLINE_H
 #include FT_STROKER_H
 #include FT_GLYPH_H
+#include FT_SIZES_H
 #include FT_TRUETYPE_IDS_H
 
 #include "SDL.h"
 #include "SDL_endian.h"
 #include "SDL_ttf.h"
 
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define TTF_USE_NEON
+#endif
+
 /* FIXME: Right now we assume the gray-scale renderer Freetype is using
    supports 256 shades of gray, but we should instead key off of num_grays
    in the result FT_Bitmap after the FT_Render_Glyph() call. */
@@ -48,6 +54,12 @@
 #define CACHED_BITMAP   0x01
 #define CACHED_PIXMAP   0x02
 
+/* The glyph cache is set associative: a glyph may live in any of the
+   GLYPH_CACHE_WAYS slots of the set its key hashes to, and the least
+   recently used slot of the set is recycled on a miss. */
+#define GLYPH_CACHE_WAYS        8
+#define GLYPH_CACHE_DEFAULT     256
+
 /* Cached glyph information */
 typedef struct cached_glyph {
     int stored;
@@ -60,14 +72,45 @@ typedef struct cached_glyph {
     int maxy;
     int yoffset;
     int advance;
-    Uint16 cached;
+    Uint32 cached;      /* the codepoint */
+    Uint32 state;       /* the glyph state it was rendered with */
+    Uint32 lru;         /* last use, for replacement in the set */
 } c_glyph;
 
+/* A font file opened once and shared by every size opened from it */
+typedef struct shared_face {
+    FT_Face face;
+    int refcount;
+
+    /* Faces opened by file name are shared, keyed by file and face index */
+    char *file;
+    long index;
+    const void *data;   /* the file in memory, if the face reads from there */
+    struct shared_face *next;
+
+    /* Identifies the font file in glyph cache files, see Face_Hash() */
+    Uint32 hash;
+    SDL_bool hashed;
+
+    /* We are responsible for closing the font stream */
+    SDL_RWops *src;
+    int freesrc;
+    FT_Open_Args args;
+
+    /* FreeType wants a face used by one thread at a time, so every
+       size reaching the FT_Face, its glyph slot or the stream holds this */
+    SDL_mutex *lock;
+} s_face;
+
 /* The structure used to hold internal font information */
 struct _TTF_Font {
     /* Freetype2 maintains all sorts of useful info itself */
     FT_Face face;
 
+    /* The face is shared between sizes, each font has its own size object */
+    s_face *shared;
+    FT_Size size;
+
     /* We'll cache these ourselves */
     int height;
     int ascent;
@@ -92,18 +135,70 @@ struct _TTF_Font {
 
     /* Cache for style-transformed glyphs */
     c_glyph *current;
-    c_glyph cache[257]; /* 257 is a prime */
-
-    /* We are responsible for closing the font stream */
-    SDL_RWops *src;
-    int freesrc;
-    FT_Open_Args args;
+    c_glyph *cache;
+    int cache_size;
+    Uint32 cache_sets_mask;
+    Uint32 cache_clock;
+    Uint32 cache_hits;
+    Uint32 cache_misses;
+    Uint32 cache_evictions;
+    Uint32 cache_generation;
+
+    /* Style, outline and hinting bits the cached glyphs are keyed with */
+    Uint32 glyph_state;
 
     /* For non-scalable formats, we must remember which font index size */
     int font_size_family;
 
     /* really just flags passed into FT_Load_Glyph */
     int hinting;
+
+    /* Scratch layout for the TTF_SizeUTF8() and TTF_RenderUTF8_*() calls */
+    TTF_Layout *layout;
+
+    /* Lines of the last TTF_RenderUTF8_Blended_Wrapped() call */
+    TTF_WrappedText *wrap;
+
+    /* Never reused, so text caches can tell fonts apart */
+    Uint32 id;
+
+    /* The size asked for, to open more fonts like this one */
+    int ptsize;
+
+    /* Glyphs read by TTF_LoadGlyphCache(), in the file layout, either
+       in the mapped file or in a copy of it */
+    const Uint8 *disk;
+    SDL_RWops *disk_src;
+    Uint32 disk_size;
+    Uint32 disk_count;
+};
+
+/* A character of laid out text and where it goes */
+typedef struct laid_glyph {
+    Uint32 ch;
+    int offset;         /* byte offset of the character in the UTF-8 text */
+    int x;              /* pen position, the glyph is drawn at x + minx */
+    c_glyph *glyph;     /* cache slot it was positioned with */
+} l_glyph;
+
+/* A run of positioned glyphs, shared by sizing and rendering */
+struct _TTF_Layout {
+    TTF_Font *font;
+    l_glyph *glyphs;
+    int num_glyphs;
+    int max_glyphs;
+    int textlen;
+
+    /* The font state the positions were computed with */
+    SDL_bool positioned;
+    Uint32 state;
+    int style;
+    int kerning;
+    Uint32 generation;
+
+    int end;            /* pen position after the last glyph */
+    int width;
+    int height;
 };
 
 /* Handle a style only if the font does not already handle it */
@@ -121,6 +216,12 @@ struct _TTF_Font {
 static FT_Library library;
 static int TTF_initialized = 0;
 static int TTF_byteswapped = 0;
+static s_face *TTF_shared_faces = NULL;
+static Uint32 TTF_font_ids = 0;
+
+/* Serializes the FT_Library, the shared faces and opening and closing
+   fonts.  Taken before a face lock, never while holding one. */
+static SDL_mutex *TTF_lock = NULL;
 
 #define TTF_CHECKPOINTER(p, errval)                 \
     if ( !TTF_initialized ) {                   \
@@ -132,6 +233,8 @@ static int TTF_byteswapped = 0;
         return errval;                      \
     }
 
+static void TTF_UpdateGlyphState(TTF_Font *font);
+
 /* Gets the top row of the underline. The outline
    is taken into account.
 */
@@ -215,6 +318,98 @@ static void TTF_initLineMectrics(const TTF_Font *font, const SDL_Surface *textbu
     *pheight = height;
 }
 
+/* Combine a row of coverage into an 8-bit surface.  Overlapping glyph
+   edges keep the strongest coverage instead of ORing the bits together.
+*/
+static void TTF_combineRow_8(Uint8 *dst, const Uint8 *src, int n)
+{
+#if defined(__SSE2__)
+    for ( ; n >= 16; n -= 16, src += 16, dst += 16 ) {
+        __m128i s = _mm_loadu_si128((const __m128i *)src);
+        __m128i d = _mm_loadu_si128((const __m128i *)dst);
+        _mm_storeu_si128((__m128i *)dst, _mm_max_epu8(d, s));
+    }
+#elif defined(TTF_USE_NEON)
+    for ( ; n >= 16; n -= 16, src += 16, dst += 16 ) {
+        vst1q_u8(dst, vmaxq_u8(vld1q_u8(dst), vld1q_u8(src)));
+    }
+#endif
+    for ( ; n > 0; --n, ++src, ++dst ) {
+        if ( *src > *dst ) {
+            *dst = *src;
+        }
+    }
+}
+
+/* Combine a row of coverage into the alpha of a 32-bit ARGB surface */
+static void TTF_combineRow_32(Uint32 *dst, const Uint8 *src, int n)
+{
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+
+    /* Coverage goes in the top byte of each pixel, and the per-byte max
+       leaves the color bytes alone */
+    for ( ; n >= 16; n -= 16, src += 16, dst += 16 ) {
+        __m128i s = _mm_loadu_si128((const __m128i *)src);
+        __m128i lo = _mm_unpacklo_epi8(zero, s);
+        __m128i hi = _mm_unpackhi_epi8(zero, s);
+        __m128i *d = (__m128i *)dst;
+
+        _mm_storeu_si128(d + 0, _mm_max_epu8(_mm_loadu_si128(d + 0), _mm_unpacklo_epi16(zero, lo)));
+        _mm_storeu_si128(d + 1, _mm_max_epu8(_mm_loadu_si128(d + 1), _mm_unpackhi_epi16(zero, lo)));
+        _mm_storeu_si128(d + 2, _mm_max_epu8(_mm_loadu_si128(d + 2), _mm_unpacklo_epi16(zero, hi)));
+        _mm_storeu_si128(d + 3, _mm_max_epu8(_mm_loadu_si128(d + 3), _mm_unpackhi_epi16(zero, hi)));
+    }
+    for ( ; n >= 4; n -= 4, src += 4, dst += 4 ) {
+        int four;
+        __m128i s;
+
+        SDL_memcpy(&four, src, sizeof(four));
+        s = _mm_cvtsi32_si128(four);
+        s = _mm_unpacklo_epi16(zero, _mm_unpacklo_epi8(zero, s));
+        _mm_storeu_si128((__m128i *)dst, _mm_max_epu8(_mm_loadu_si128((const __m128i *)dst), s));
+    }
+#elif defined(TTF_USE_NEON)
+    for ( ; n >= 8; n -= 8, src += 8, dst += 8 ) {
+        uint8x8_t s = vld1_u8(src);
+        uint8x8x4_t d = vld4_u8((const uint8_t *)dst);
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+        d.val[3] = vmax_u8(d.val[3], s);
+#else
+        d.val[0] = vmax_u8(d.val[0], s);
+#endif
+        vst4_u8((uint8_t *)dst, d);
+    }
+#endif
+    for ( ; n > 0; --n, ++src, ++dst ) {
+        Uint32 alpha = (Uint32)*src << 24;
+        if ( alpha > (*dst & 0xFF000000) ) {
+            *dst = (*dst & 0x00FFFFFF) | alpha;
+        }
+    }
+}
+
+/* Fill a row of a 32-bit surface with one pixel value */
+static void TTF_fillRow_32(Uint32 *dst, Uint32 pixel, int n)
+{
+#if defined(__SSE2__)
+    const __m128i p = _mm_set1_epi32((int)pixel);
+
+    for ( ; n >= 4; n -= 4, dst += 4 ) {
+        _mm_storeu_si128((__m128i *)dst, p);
+    }
+#elif defined(TTF_USE_NEON)
+    const uint32x4_t p = vdupq_n_u32(pixel);
+
+    for ( ; n >= 4; n -= 4, dst += 4 ) {
+        vst1q_u32(dst, p);
+    }
+#endif
+    for ( ; n > 0; --n ) {
+        *dst++ = pixel;
+    }
+}
+
 /* Draw a solid line of underline_height (+ optional outline)
    at the given row. The row value must take the
    outline into account.
@@ -267,7 +462,6 @@ static void TTF_drawLine_Blended(const TTF_Font *font, const SDL_Surface *textbu
     Uint8 *dst8; /* destination, byte version */
     Uint32 *dst;
     int height;
-    int col;
     Uint32 pixel = color | 0xFF000000; /* Amask */
 
     TTF_initLineMectrics(font, textbuf, row, &dst8, &height);
@@ -275,9 +469,7 @@ static void TTF_drawLine_Blended(const TTF_Font *font, const SDL_Surface *textbu
 
     /* Draw line */
     for ( line=height; line>0 && dst < dst_check; --line ) {
-        for ( col=0; col < textbuf->w; ++col ) {
-            dst[col] = pixel;
-        }
+        TTF_fillRow_32(dst, pixel, textbuf->w);
         dst += textbuf->pitch/4;
     }
 }
@@ -340,6 +532,13 @@ int TTF_Init( void )
         if ( error ) {
             TTF_SetFTError("Couldn't init FreeType engine", error);
             status = -1;
+        } else {
+            TTF_lock = SDL_CreateMutex();
+            if ( TTF_lock == NULL ) {
+                TTF_SetError("Couldn't create mutex");
+                FT_Done_FreeType( library );
+                status = -1;
+            }
         }
     }
     if ( status == 0 ) {
@@ -365,29 +564,66 @@ static unsigned long RWread(
     return (unsigned long)SDL_RWread( src, buffer, 1, (int)count );
 }
 
-TTF_Font* TTF_OpenFontIndexRW( SDL_RWops *src, int freesrc, int ptsize, long index )
+static void Release_Face( s_face *shared )
+{
+    if ( --shared->refcount > 0 ) {
+        return;
+    }
+    if ( shared->file ) {
+        s_face **prev = &TTF_shared_faces;
+        while ( *prev != shared ) {
+            prev = &(*prev)->next;
+        }
+        *prev = shared->next;
+        SDL_free( shared->file );
+    }
+    if ( shared->face ) {
+        FT_Done_Face( shared->face );
+    }
+    if ( shared->args.stream ) {
+        SDL_free( shared->args.stream );
+    }
+    if ( shared->freesrc ) {
+        SDL_RWclose( shared->src );
+    }
+    if ( shared->lock ) {
+        SDL_DestroyMutex( shared->lock );
+    }
+    SDL_free( shared );
+}
+
+static void Set_Charmap( FT_Face face )
 {
-    TTF_Font* font;
-    FT_Error error;
-    FT_Face face;
-    FT_Fixed scale;
-    FT_Stream stream;
     FT_CharMap found;
-    Sint64 position;
     int i;
 
-    if ( ! TTF_initialized ) {
-        TTF_SetError( "Library not initialized" );
-        if ( src && freesrc ) {
-            SDL_RWclose( src );
+    /* Set charmap for loaded font */
+    found = 0;
+    for (i = 0; i < face->num_charmaps; i++) {
+        FT_CharMap charmap = face->charmaps[i];
+        if ((charmap->platform_id == 3 && charmap->encoding_id == 1) /* Windows Unicode */
+         || (charmap->platform_id == 3 && charmap->encoding_id == 0) /* Windows Symbol */
+         || (charmap->platform_id == 2 && charmap->encoding_id == 1) /* ISO Unicode */
+         || (charmap->platform_id == 0)) { /* Apple Unicode */
+            found = charmap;
+            break;
         }
-        return NULL;
     }
-
-    if ( ! src ) {
-        TTF_SetError( "Passed a NULL font source" );
-        return NULL;
+    if ( found ) {
+        /* If this fails, continue using the default charmap */
+        FT_Set_Charmap(face, found);
     }
+}
+
+/* Open a face reading from the stream as FreeType needs it */
+static s_face *Open_Face_RW( SDL_RWops *src, int freesrc, long index )
+{
+    s_face *shared;
+    FT_Error error;
+    FT_Stream stream;
+    Sint64 position;
+    const Uint8 *data;
+    size_t size;
 
     /* Check to make sure we can seek in this stream */
     position = SDL_RWtell(src);
@@ -399,65 +635,152 @@ TTF_Font* TTF_OpenFontIndexRW( SDL_RWops *src, int freesrc, int ptsize, long ind
         return NULL;
     }
 
-    font = (TTF_Font*)SDL_malloc(sizeof *font);
-    if ( font == NULL ) {
+    shared = (s_face *)SDL_calloc(1, sizeof(*shared));
+    if ( shared == NULL ) {
         TTF_SetError( "Out of memory" );
         if ( freesrc ) {
             SDL_RWclose( src );
         }
         return NULL;
     }
-    SDL_memset(font, 0, sizeof(*font));
-
-    font->src = src;
-    font->freesrc = freesrc;
-
-    stream = (FT_Stream)SDL_malloc(sizeof(*stream));
-    if ( stream == NULL ) {
-        TTF_SetError( "Out of memory" );
-        TTF_CloseFont( font );
+    shared->refcount = 1;
+    shared->src = src;
+    shared->freesrc = freesrc;
+
+    shared->lock = SDL_CreateMutex();
+    if ( shared->lock == NULL ) {
+        TTF_SetError( "Couldn't create mutex" );
+        Release_Face( shared );
         return NULL;
     }
-    SDL_memset(stream, 0, sizeof(*stream));
 
-    stream->read = RWread;
-    stream->descriptor.pointer = src;
-    stream->pos = (unsigned long)position;
-    stream->size = (unsigned long)(SDL_RWsize(src) - position);
+    /* Memory streams and mapped files are parsed in place */
+    data = (const Uint8 *)SDL_RWGetMemory( src, &size );
+    if ( data && (Sint64)size > position ) {
+        shared->data = data + position;
+        shared->args.flags = FT_OPEN_MEMORY;
+        shared->args.memory_base = (const FT_Byte *)shared->data;
+        shared->args.memory_size = (FT_Long)(size - (size_t)position);
+    } else {
+        stream = (FT_Stream)SDL_malloc(sizeof(*stream));
+        if ( stream == NULL ) {
+            TTF_SetError( "Out of memory" );
+            Release_Face( shared );
+            return NULL;
+        }
+        SDL_memset(stream, 0, sizeof(*stream));
+
+        stream->read = RWread;
+        stream->descriptor.pointer = src;
+        stream->pos = (unsigned long)position;
+        stream->size = (unsigned long)(SDL_RWsize(src) - position);
 
-    font->args.flags = FT_OPEN_STREAM;
-    font->args.stream = stream;
+        shared->args.flags = FT_OPEN_STREAM;
+        shared->args.stream = stream;
+    }
 
-    error = FT_Open_Face( library, &font->args, index, &font->face );
+    error = FT_Open_Face( library, &shared->args, index, &shared->face );
     if ( error ) {
         TTF_SetFTError( "Couldn't load font file", error );
-        TTF_CloseFont( font );
+        Release_Face( shared );
         return NULL;
     }
-    face = font->face;
+    Set_Charmap( shared->face );
 
-    /* Set charmap for loaded font */
-    found = 0;
-    for (i = 0; i < face->num_charmaps; i++) {
-        FT_CharMap charmap = face->charmaps[i];
-        if ((charmap->platform_id == 3 && charmap->encoding_id == 1) /* Windows Unicode */
-         || (charmap->platform_id == 3 && charmap->encoding_id == 0) /* Windows Symbol */
-         || (charmap->platform_id == 2 && charmap->encoding_id == 1) /* ISO Unicode */
-         || (charmap->platform_id == 0)) { /* Apple Unicode */
-            found = charmap;
-            break;
+    return shared;
+}
+
+/* Open a face from a file, or share the one already open for it.
+   The file is mapped once and parsed in place by every size. */
+static s_face *Open_Face_File( const char *file, long index )
+{
+    s_face *shared;
+    SDL_RWops *src;
+
+    for ( shared = TTF_shared_faces; shared; shared = shared->next ) {
+        if ( shared->index == index && SDL_strcmp( shared->file, file ) == 0 ) {
+            ++shared->refcount;
+            return shared;
         }
     }
-    if ( found ) {
-        /* If this fails, continue using the default charmap */
-        FT_Set_Charmap(face, found);
+
+    src = SDL_RWFromFileMapped( file );
+    if ( src == NULL ) {
+        /* Not a regular file, stream it without sharing */
+        src = SDL_RWFromFile( file, "rb" );
+        if ( src == NULL ) {
+            return NULL;
+        }
+        return Open_Face_RW( src, 1, index );
+    }
+    shared = Open_Face_RW( src, 1, index );
+    if ( shared == NULL ) {
+        return NULL;
+    }
+
+    /* If we can't remember the name, the face just isn't shared */
+    shared->file = SDL_strdup( file );
+    if ( shared->file ) {
+        shared->index = index;
+        shared->next = TTF_shared_faces;
+        TTF_shared_faces = shared;
+    }
+    return shared;
+}
+
+/* Sizes opened from the same file share the FT_Face, make ours current
+   before asking FreeType for anything that depends on the size.
+   The face lock must be held until FreeType is done with it. */
+static void Activate_Size( TTF_Font* font )
+{
+    if ( font->face->size != font->size ) {
+        FT_Activate_Size( font->size );
+    }
+}
+
+/* Create a font of the given size on a face, taking over its reference */
+static TTF_Font* Open_Font( s_face *shared, int ptsize )
+{
+    TTF_Font* font;
+    FT_Error error;
+    FT_Face face;
+    FT_Fixed scale;
+
+    font = (TTF_Font*)SDL_malloc(sizeof *font);
+    if ( font == NULL ) {
+        TTF_SetError( "Out of memory" );
+        Release_Face( shared );
+        return NULL;
+    }
+    SDL_memset(font, 0, sizeof(*font));
+
+    font->id = ++TTF_font_ids;
+    font->ptsize = ptsize;
+    font->shared = shared;
+    font->face = shared->face;
+    face = font->face;
+
+    if ( TTF_SetGlyphCacheSize( font, GLYPH_CACHE_DEFAULT ) < 0 ) {
+        TTF_CloseFont( font );
+        return NULL;
+    }
+
+    SDL_LockMutex( shared->lock );
+    error = FT_New_Size( face, &font->size );
+    if ( error ) {
+        SDL_UnlockMutex( shared->lock );
+        TTF_SetFTError( "Couldn't create font size", error );
+        TTF_CloseFont( font );
+        return NULL;
     }
+    FT_Activate_Size( font->size );
 
     /* Make sure that our font face is scalable (global metrics) */
     if ( FT_IS_SCALABLE(face) ) {
         /* Set the character size and use default DPI (72) */
-        error = FT_Set_Char_Size( font->face, 0, ptsize * 64, 0, 0 );
+        error = FT_Set_Char_Size( face, 0, ptsize * 64, 0, 0 );
         if ( error ) {
+            SDL_UnlockMutex( shared->lock );
             TTF_SetFTError( "Couldn't set font size", error );
             TTF_CloseFont( font );
             return NULL;
@@ -496,6 +819,7 @@ TTF_Font* TTF_OpenFontIndexRW( SDL_RWops *src, int freesrc, int ptsize, long ind
         font->underline_offset = FT_FLOOR(face->underline_position);
         font->underline_height = FT_FLOOR(face->underline_thickness);
     }
+    SDL_UnlockMutex( shared->lock );
 
     if ( font->underline_height < 1 ) {
         font->underline_height = 1;
@@ -526,11 +850,37 @@ TTF_Font* TTF_OpenFontIndexRW( SDL_RWops *src, int freesrc, int ptsize, long ind
     font->style = font->face_style;
     font->outline = 0;
     font->kerning = 1;
-    font->glyph_overhang = face->size->metrics.y_ppem / 10;
+    font->glyph_overhang = font->size->metrics.y_ppem / 10;
     /* x offset = cos(((90.0-12)/360)*2*M_PI), or 12 degree angle */
     font->glyph_italics = 0.207f;
     font->glyph_italics *= font->height;
+    TTF_UpdateGlyphState( font );
+
+    return font;
+}
+
+TTF_Font* TTF_OpenFontIndexRW( SDL_RWops *src, int freesrc, int ptsize, long index )
+{
+    s_face *shared;
+    TTF_Font *font;
+
+    if ( ! TTF_initialized ) {
+        TTF_SetError( "Library not initialized" );
+        if ( src && freesrc ) {
+            SDL_RWclose( src );
+        }
+        return NULL;
+    }
 
+    if ( ! src ) {
+        TTF_SetError( "Passed a NULL font source" );
+        return NULL;
+    }
+
+    SDL_LockMutex( TTF_lock );
+    shared = Open_Face_RW( src, freesrc, index );
+    font = shared ? Open_Font( shared, ptsize ) : NULL;
+    SDL_UnlockMutex( TTF_lock );
     return font;
 }
 
@@ -541,11 +891,16 @@ TTF_Font* TTF_OpenFontRW( SDL_RWops *src, int freesrc, int ptsize )
 
 TTF_Font* TTF_OpenFontIndex( const char *file, int ptsize, long index )
 {
-    SDL_RWops *rw = SDL_RWFromFile(file, "rb");
-    if ( rw == NULL ) {
-        return NULL;
-    }
-    return TTF_OpenFontIndexRW(rw, 1, ptsize, index);
+    s_face *shared;
+    TTF_Font *font;
+
+    TTF_CHECKPOINTER(file, NULL);
+
+    SDL_LockMutex( TTF_lock );
+    shared = Open_Face_File( file, index );
+    font = shared ? Open_Font( shared, ptsize ) : NULL;
+    SDL_UnlockMutex( TTF_lock );
+    return font;
 }
 
 TTF_Font* TTF_OpenFont( const char *file, int ptsize )
@@ -553,6 +908,55 @@ TTF_Font* TTF_OpenFont( const char *file, int ptsize )
     return TTF_OpenFontIndex(file, ptsize, 0);
 }
 
+TTF_Font* TTF_DuplicateFont( TTF_Font *font )
+{
+    TTF_Font *copy;
+
+    TTF_CHECKPOINTER(font, NULL);
+
+    SDL_LockMutex( TTF_lock );
+    ++font->shared->refcount;
+    copy = Open_Font( font->shared, font->ptsize );
+    SDL_UnlockMutex( TTF_lock );
+    if ( copy == NULL ) {
+        return NULL;
+    }
+    if ( copy->cache_size != font->cache_size &&
+         TTF_SetGlyphCacheSize( copy, font->cache_size ) < 0 ) {
+        TTF_CloseFont( copy );
+        return NULL;
+    }
+    copy->style = font->style;
+    copy->outline = font->outline;
+    copy->kerning = font->kerning;
+    copy->hinting = font->hinting;
+    TTF_UpdateGlyphState( copy );
+
+    /* The copy can do without the cache file if there's no memory for it */
+    if ( font->disk ) {
+        Uint8 *disk = (Uint8 *)SDL_malloc( font->disk_size );
+        if ( disk ) {
+            SDL_memcpy( disk, font->disk, font->disk_size );
+            copy->disk = disk;
+            copy->disk_size = font->disk_size;
+            copy->disk_count = font->disk_count;
+        }
+    }
+    return copy;
+}
+
+/* Let go of the glyphs read by TTF_LoadGlyphCache() */
+static void Free_Disk( TTF_Font* font )
+{
+    if ( font->disk_src ) {
+        SDL_RWclose( font->disk_src );
+        font->disk_src = NULL;
+    } else {
+        SDL_free( (void *)font->disk );
+    }
+    font->disk = NULL;
+}
+
 static void Flush_Glyph( c_glyph* glyph )
 {
     glyph->stored = 0;
@@ -571,17 +975,18 @@ static void Flush_Glyph( c_glyph* glyph )
 static void Flush_Cache( TTF_Font* font )
 {
     int i;
-    int size = sizeof( font->cache ) / sizeof( font->cache[0] );
+    int size = font->cache_size;
 
     for ( i = 0; i < size; ++i ) {
-        if ( font->cache[i].cached ) {
+        if ( font->cache[i].stored ) {
             Flush_Glyph( &font->cache[i] );
         }
-
     }
+    font->current = NULL;
 }
 
-static FT_Error Load_Glyph( TTF_Font* font, Uint16 ch, c_glyph* cached, int want )
+/* Load and render a glyph into a cache slot, the face lock must be held */
+static FT_Error Load_Face_Glyph( TTF_Font* font, Uint32 ch, c_glyph* cached, int want )
 {
     FT_Face face;
     FT_Error error;
@@ -594,6 +999,7 @@ static FT_Error Load_Glyph( TTF_Font* font, Uint16 ch, c_glyph* cached, int want
     }
 
     face = font->face;
+    Activate_Size( font );
 
     /* Load the glyph */
     if ( ! cached->index ) {
@@ -895,52 +1301,672 @@ static FT_Error Load_Glyph( TTF_Font* font, Uint16 ch, c_glyph* cached, int want
     return 0;
 }
 
-static FT_Error Find_Glyph( TTF_Font* font, Uint16 ch, int want )
+static FT_Error Load_Glyph( TTF_Font* font, Uint32 ch, c_glyph* cached, int want )
 {
-    int retval = 0;
-    int hsize = sizeof( font->cache ) / sizeof( font->cache[0] );
+    FT_Error error;
+
+    if ( !font || !font->face ) {
+        return FT_Err_Invalid_Handle;
+    }
 
-    int h = ch % hsize;
-    font->current = &font->cache[h];
+    SDL_LockMutex( font->shared->lock );
+    error = Load_Face_Glyph( font, ch, cached, want );
+    SDL_UnlockMutex( font->shared->lock );
+    return error;
+}
 
-    if (font->current->cached != ch)
-        Flush_Glyph( font->current );
+static FT_Error Get_Kerning( TTF_Font* font, FT_UInt prev_index, FT_UInt index, FT_Vector* delta )
+{
+    FT_Error error;
 
-    if ( (font->current->stored & want) != want ) {
-        retval = Load_Glyph( font, ch, font->current, want );
-    }
-    return retval;
+    SDL_LockMutex( font->shared->lock );
+    Activate_Size( font );
+    error = FT_Get_Kerning( font->face, prev_index, index, ft_kerning_default, delta );
+    SDL_UnlockMutex( font->shared->lock );
+    return error;
 }
 
-void TTF_CloseFont( TTF_Font* font )
+/* Glyph cache files hold glyphs as Load_Face_Glyph() leaves them in the
+   cache.  Every field is a little endian Uint32 and every record has the
+   same size, so the file can be used where it lies: a header, then the
+   records sorted by glyph state and codepoint, then the bitmaps.
+ */
+#define GLYPH_FILE_MAGIC0       0x47465454  /* "TTFGLYPH" */
+#define GLYPH_FILE_MAGIC1       0x4850594C
+#define GLYPH_FILE_VERSION      1
+
+#define GF_MAGIC0       0       /* header words */
+#define GF_MAGIC1       1
+#define GF_VERSION      2
+#define GF_FREETYPE     3
+#define GF_HASH         4
+#define GF_FACE_SIZE    5
+#define GF_FACE_INDEX   6
+#define GF_PTSIZE       7
+#define GF_COUNT        8
+#define GF_HEADER       10
+
+#define GR_CH           0       /* record words */
+#define GR_STATE        1
+#define GR_INDEX        2
+#define GR_STORED       3
+#define GR_MINX         4
+#define GR_MAXX         5
+#define GR_MINY         6
+#define GR_MAXY         7
+#define GR_YOFFSET      8
+#define GR_ADVANCE      9
+#define GR_BITMAP       10      /* width, rows, pitch and file offset */
+#define GR_PIXMAP       14
+#define GR_RECORD       18
+
+/* A glyph going to a cache file, from the glyph cache or the loaded file */
+typedef struct saved_glyph {
+    Uint32 ch;
+    Uint32 state;
+    Uint32 stored;
+    const c_glyph *glyph;
+    const Uint8 *record;
+} d_glyph;
+
+static Uint32 Disk_Word( const Uint8* words, int i )
 {
-    if ( font ) {
-        Flush_Cache( font );
-        if ( font->face ) {
-            FT_Done_Face( font->face );
-        }
-        if ( font->args.stream ) {
-            SDL_free( font->args.stream );
-        }
-        if ( font->freesrc ) {
-            SDL_RWclose( font->src );
+    Uint32 word;
+
+    SDL_memcpy( &word, words + i * 4, 4 );
+    return SDL_SwapLE32( word );
+}
+
+/* A checksum of the font file, so cache files don't outlive a font update */
+static Uint32 Face_Hash( s_face* shared )
+{
+    Uint32 hash;
+
+    SDL_LockMutex( shared->lock );
+    if ( !shared->hashed ) {
+        const Uint8 *p;
+        size_t n;
+
+        hash = 2166136261u;
+        if ( shared->data ) {
+            p = (const Uint8 *)shared->data;
+            n = (size_t)shared->args.memory_size;
+            while ( n-- ) {
+                hash = (hash ^ *p++) * 16777619u;
+            }
+        } else {
+            /* A streamed face is only read on demand, go by its names */
+            FT_Face face = shared->face;
+            const char *name;
+
+            for ( name = face->family_name; name && *name; ++name ) {
+                hash = (hash ^ (Uint8)*name) * 16777619u;
+            }
+            for ( name = face->style_name; name && *name; ++name ) {
+                hash = (hash ^ (Uint8)*name) * 16777619u;
+            }
+            hash = (hash ^ (Uint32)face->num_glyphs) * 16777619u;
         }
-        SDL_free( font );
+        shared->hash = hash;
+        shared->hashed = SDL_TRUE;
     }
+    hash = shared->hash;
+    SDL_UnlockMutex( shared->lock );
+    return hash;
 }
 
-/* Gets the number of bytes used by a null terminated UCS2 string */
-static size_t UCS2_len(const Uint16 *text)
+/* The header a cache file for this font must start with */
+static void Disk_Header( TTF_Font* font, Uint32 header[GF_HEADER] )
 {
-    size_t count = 0;
-    while (*text++) {
-        ++count;
+    s_face *shared = font->shared;
+    FT_Int major, minor, patch;
+
+    FT_Library_Version( library, &major, &minor, &patch );
+    SDL_memset( header, 0, GF_HEADER * sizeof(*header) );
+    header[GF_MAGIC0] = GLYPH_FILE_MAGIC0;
+    header[GF_MAGIC1] = GLYPH_FILE_MAGIC1;
+    header[GF_VERSION] = GLYPH_FILE_VERSION;
+    header[GF_FREETYPE] = ((Uint32)major << 16) | ((Uint32)minor << 8) | (Uint32)patch;
+    header[GF_HASH] = Face_Hash( shared );
+    if ( shared->data ) {
+        header[GF_FACE_SIZE] = (Uint32)shared->args.memory_size;
+    } else {
+        header[GF_FACE_SIZE] = (Uint32)shared->args.stream->size;
     }
-    return count * sizeof(*text);
+    header[GF_FACE_INDEX] = (Uint32)font->face->face_index;
+    header[GF_PTSIZE] = (Uint32)font->ptsize;
 }
 
-/* Convert a Latin-1 string to a UTF-8 string */
-static void LATIN1_to_UTF8(const char *src, Uint8 *dst)
+static const Uint8* Find_Disk_Glyph( TTF_Font* font, Uint32 ch, Uint32 state )
+{
+    const Uint8 *records = font->disk + GF_HEADER * 4;
+    Uint32 lo = 0;
+    Uint32 hi = font->disk_count;
+
+    while ( lo < hi ) {
+        Uint32 mid = lo + (hi - lo) / 2;
+        const Uint8 *record = records + mid * GR_RECORD * 4;
+        Uint32 key = Disk_Word( record, GR_STATE );
+
+        if ( key == state ) {
+            key = Disk_Word( record, GR_CH );
+            if ( key == ch ) {
+                return record;
+            }
+            if ( key < ch ) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        } else if ( key < state ) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return NULL;
+}
+
+static int Load_Disk_Bitmap( TTF_Font* font, const Uint8* words, FT_Bitmap* dst )
+{
+    size_t size;
+
+    SDL_memset( dst, 0, sizeof(*dst) );
+    dst->width = (int)Disk_Word( words, 0 );
+    dst->rows = (int)Disk_Word( words, 1 );
+    dst->pitch = (int)Disk_Word( words, 2 );
+    size = (size_t)dst->pitch * dst->rows;
+    if ( size ) {
+        dst->buffer = (unsigned char *)SDL_malloc( size );
+        if ( !dst->buffer ) {
+            return -1;
+        }
+        SDL_memcpy( dst->buffer, font->disk + Disk_Word( words, 3 ), size );
+    }
+    return 0;
+}
+
+/* Fill a fresh cache slot from the loaded cache file, if it has the glyph */
+static void Load_Disk_Glyph( TTF_Font* font, Uint32 ch, c_glyph* cached )
+{
+    const Uint8 *record = Find_Disk_Glyph( font, ch, cached->state );
+    Uint32 stored;
+
+    if ( !record ) {
+        return;
+    }
+    stored = Disk_Word( record, GR_STORED );
+    cached->index = Disk_Word( record, GR_INDEX );
+    if ( stored & CACHED_METRICS ) {
+        cached->minx = (int)Disk_Word( record, GR_MINX );
+        cached->maxx = (int)Disk_Word( record, GR_MAXX );
+        cached->miny = (int)Disk_Word( record, GR_MINY );
+        cached->maxy = (int)Disk_Word( record, GR_MAXY );
+        cached->yoffset = (int)Disk_Word( record, GR_YOFFSET );
+        cached->advance = (int)Disk_Word( record, GR_ADVANCE );
+        cached->stored |= CACHED_METRICS;
+    }
+    if ( (stored & CACHED_BITMAP) &&
+         Load_Disk_Bitmap( font, record + GR_BITMAP * 4, &cached->bitmap ) == 0 ) {
+        cached->stored |= CACHED_BITMAP;
+    }
+    if ( (stored & CACHED_PIXMAP) &&
+         Load_Disk_Bitmap( font, record + GR_PIXMAP * 4, &cached->pixmap ) == 0 ) {
+        cached->stored |= CACHED_PIXMAP;
+    }
+    cached->cached = ch;
+}
+
+static FT_Error Find_Glyph( TTF_Font* font, Uint32 ch, int want )
+{
+    int retval = 0;
+    Uint32 state = font->glyph_state;
+    Uint32 set = (ch + state * 0x9E3779B9) & font->cache_sets_mask;
+    c_glyph *slot = &font->cache[set * GLYPH_CACHE_WAYS];
+    c_glyph *victim = slot;
+    int i;
+
+    /* Look for the glyph in its set, remembering the oldest slot */
+    font->current = NULL;
+    for ( i = 0; i < GLYPH_CACHE_WAYS; ++i, ++slot ) {
+        if ( slot->stored && slot->cached == ch && slot->state == state ) {
+            font->current = slot;
+            ++font->cache_hits;
+            break;
+        }
+        if ( victim->stored && (!slot->stored || slot->lru < victim->lru) ) {
+            victim = slot;
+        }
+    }
+    if ( !font->current ) {
+        ++font->cache_misses;
+        if ( victim->stored ) {
+            ++font->cache_evictions;
+            Flush_Glyph( victim );
+        }
+        victim->state = state;
+        font->current = victim;
+    }
+    font->current->lru = ++font->cache_clock;
+
+    if ( (font->current->stored & want) != want ) {
+        /* A glyph from the cache file doesn't need FreeType at all */
+        if ( font->disk && !font->current->stored ) {
+            Load_Disk_Glyph( font, ch, font->current );
+        }
+        if ( (font->current->stored & want) != want ) {
+            retval = Load_Glyph( font, ch, font->current, want );
+        }
+    }
+    return retval;
+}
+
+int TTF_SetGlyphCacheSize( TTF_Font* font, int size )
+{
+    c_glyph *cache;
+    int sets;
+
+    if ( size < GLYPH_CACHE_WAYS ) {
+        size = GLYPH_CACHE_WAYS;
+    }
+
+    /* Round the number of sets up to a power of two */
+    sets = 1;
+    while ( sets * GLYPH_CACHE_WAYS < size ) {
+        sets <<= 1;
+    }
+    size = sets * GLYPH_CACHE_WAYS;
+
+    cache = (c_glyph *)SDL_calloc( size, sizeof( *cache ) );
+    if ( cache == NULL ) {
+        TTF_SetError( "Out of memory" );
+        return -1;
+    }
+    if ( font->cache ) {
+        Flush_Cache( font );
+        SDL_free( font->cache );
+    }
+    font->current = NULL;
+    ++font->cache_generation;
+    font->cache = cache;
+    font->cache_size = size;
+    font->cache_sets_mask = (Uint32)(sets - 1);
+    return 0;
+}
+
+int TTF_GetGlyphCacheSize( const TTF_Font* font )
+{
+    return font->cache_size;
+}
+
+void TTF_GetGlyphCacheStats( const TTF_Font* font, Uint32 *hits, Uint32 *misses, Uint32 *evictions )
+{
+    if ( hits ) {
+        *hits = font->cache_hits;
+    }
+    if ( misses ) {
+        *misses = font->cache_misses;
+    }
+    if ( evictions ) {
+        *evictions = font->cache_evictions;
+    }
+}
+
+void TTF_ResetGlyphCacheStats( TTF_Font* font )
+{
+    font->cache_hits = 0;
+    font->cache_misses = 0;
+    font->cache_evictions = 0;
+}
+
+static int Count_Stored( Uint32 stored )
+{
+    return !!(stored & CACHED_METRICS) + !!(stored & CACHED_BITMAP) + !!(stored & CACHED_PIXMAP);
+}
+
+/* Sort by key, the most complete copy of a glyph first */
+static int Compare_Saved_Glyphs( const void *a, const void *b )
+{
+    const d_glyph *A = (const d_glyph *)a;
+    const d_glyph *B = (const d_glyph *)b;
+
+    if ( A->state != B->state ) {
+        return (A->state < B->state) ? -1 : 1;
+    }
+    if ( A->ch != B->ch ) {
+        return (A->ch < B->ch) ? -1 : 1;
+    }
+    return Count_Stored( B->stored ) - Count_Stored( A->stored );
+}
+
+/* Where the bitmap or pixmap of a glyph to save is, empty if it has none */
+static void Saved_Bitmap( TTF_Font* font, const d_glyph* saved, int which, FT_Bitmap* bitmap )
+{
+    SDL_memset( bitmap, 0, sizeof(*bitmap) );
+    if ( !(saved->stored & which) ) {
+        return;
+    }
+    if ( saved->glyph ) {
+        *bitmap = (which == CACHED_BITMAP) ? saved->glyph->bitmap : saved->glyph->pixmap;
+    } else {
+        const Uint8 *words = saved->record + ((which == CACHED_BITMAP) ? GR_BITMAP : GR_PIXMAP) * 4;
+        bitmap->width = (int)Disk_Word( words, 0 );
+        bitmap->rows = (int)Disk_Word( words, 1 );
+        bitmap->pitch = (int)Disk_Word( words, 2 );
+        bitmap->buffer = (unsigned char *)font->disk + Disk_Word( words, 3 );
+    }
+}
+
+/* Read the glyphs of a mapped cache file into memory, so the file can be
+   written over without pulling the pages from under the font */
+static int Copy_Disk( TTF_Font* font )
+{
+    Uint8 *disk;
+
+    if ( !font->disk_src ) {
+        return 0;
+    }
+    disk = (Uint8 *)SDL_malloc( font->disk_size );
+    if ( disk == NULL ) {
+        TTF_SetError( "Out of memory" );
+        return -1;
+    }
+    SDL_memcpy( disk, font->disk, font->disk_size );
+    SDL_RWclose( font->disk_src );
+    font->disk_src = NULL;
+    font->disk = disk;
+    return 0;
+}
+
+int TTF_SaveGlyphCache( TTF_Font* font, const char *file )
+{
+    d_glyph *glyphs;
+    Uint8 *data;
+    Uint32 *words;
+    Uint32 header[GF_HEADER];
+    Uint32 offset;
+    FT_Bitmap bitmap;
+    SDL_RWops *dst;
+    int count, kept;
+    int i, j;
+    int retval = 0;
+
+    TTF_CHECKPOINTER(font, -1);
+    TTF_CHECKPOINTER(file, -1);
+
+    glyphs = (d_glyph *)SDL_malloc( (font->cache_size + font->disk_count) * sizeof(*glyphs) );
+    if ( glyphs == NULL ) {
+        TTF_SetError( "Out of memory" );
+        return -1;
+    }
+
+    /* Everything in the glyph cache and the file loaded, once each */
+    count = 0;
+    for ( i = 0; i < font->cache_size; ++i ) {
+        const c_glyph *glyph = &font->cache[i];
+        if ( glyph->stored & CACHED_METRICS ) {
+            glyphs[count].ch = glyph->cached;
+            glyphs[count].state = glyph->state;
+            glyphs[count].stored = (Uint32)glyph->stored;
+            glyphs[count].glyph = glyph;
+            glyphs[count].record = NULL;
+            ++count;
+        }
+    }
+    for ( i = 0; i < (int)font->disk_count; ++i ) {
+        const Uint8 *record = font->disk + (GF_HEADER + i * GR_RECORD) * 4;
+        glyphs[count].ch = Disk_Word( record, GR_CH );
+        glyphs[count].state = Disk_Word( record, GR_STATE );
+        glyphs[count].stored = Disk_Word( record, GR_STORED );
+        glyphs[count].glyph = NULL;
+        glyphs[count].record = record;
+        ++count;
+    }
+    SDL_qsort( glyphs, count, sizeof(*glyphs), Compare_Saved_Glyphs );
+    kept = 0;
+    for ( i = 0; i < count; ++i ) {
+        if ( kept > 0 &&
+             glyphs[kept-1].ch == glyphs[i].ch &&
+             glyphs[kept-1].state == glyphs[i].state ) {
+            continue;
+        }
+        glyphs[kept++] = glyphs[i];
+    }
+
+    /* The whole file is put together in memory first, the glyphs loaded
+       may come from the very file being written */
+    offset = (GF_HEADER + kept * GR_RECORD) * 4;
+    for ( i = 0; i < kept; ++i ) {
+        for ( j = 0; j < 2; ++j ) {
+            Saved_Bitmap( font, &glyphs[i], j ? CACHED_PIXMAP : CACHED_BITMAP, &bitmap );
+            offset += ((Uint32)(bitmap.pitch * bitmap.rows) + 3) & ~3;
+        }
+    }
+    data = (Uint8 *)SDL_calloc( 1, offset );
+    if ( data == NULL ) {
+        TTF_SetError( "Out of memory" );
+        SDL_free( glyphs );
+        return -1;
+    }
+    words = (Uint32 *)data;
+    Disk_Header( font, header );
+    header[GF_COUNT] = (Uint32)kept;
+    for ( i = 0; i < GF_HEADER; ++i ) {
+        words[i] = SDL_SwapLE32( header[i] );
+    }
+
+    /* The bitmaps follow the records, each padded to a whole word */
+    offset = (GF_HEADER + kept * GR_RECORD) * 4;
+    for ( i = 0; i < kept; ++i ) {
+        const d_glyph *saved = &glyphs[i];
+        Uint32 *record = words + GF_HEADER + i * GR_RECORD;
+        Uint32 fields[GR_RECORD];
+
+        SDL_memset( fields, 0, sizeof(fields) );
+        fields[GR_CH] = saved->ch;
+        fields[GR_STATE] = saved->state;
+        fields[GR_STORED] = saved->stored & (CACHED_METRICS|CACHED_BITMAP|CACHED_PIXMAP);
+        if ( saved->glyph ) {
+            fields[GR_INDEX] = saved->glyph->index;
+            fields[GR_MINX] = (Uint32)saved->glyph->minx;
+            fields[GR_MAXX] = (Uint32)saved->glyph->maxx;
+            fields[GR_MINY] = (Uint32)saved->glyph->miny;
+            fields[GR_MAXY] = (Uint32)saved->glyph->maxy;
+            fields[GR_YOFFSET] = (Uint32)saved->glyph->yoffset;
+            fields[GR_ADVANCE] = (Uint32)saved->glyph->advance;
+        } else {
+            for ( j = GR_INDEX; j <= GR_ADVANCE; ++j ) {
+                fields[j] = Disk_Word( saved->record, j );
+            }
+        }
+        for ( j = 0; j < 2; ++j ) {
+            int at = j ? GR_PIXMAP : GR_BITMAP;
+            size_t size;
+            Saved_Bitmap( font, saved, j ? CACHED_PIXMAP : CACHED_BITMAP, &bitmap );
+            fields[at] = (Uint32)bitmap.width;
+            fields[at+1] = (Uint32)bitmap.rows;
+            fields[at+2] = (Uint32)bitmap.pitch;
+            fields[at+3] = offset;
+            size = (size_t)bitmap.pitch * bitmap.rows;
+            if ( size ) {
+                SDL_memcpy( data + offset, bitmap.buffer, size );
+            }
+            offset += ((Uint32)size + 3) & ~3;
+        }
+        for ( j = 0; j < GR_RECORD; ++j ) {
+            record[j] = SDL_SwapLE32( fields[j] );
+        }
+    }
+
+    SDL_free( glyphs );
+
+    /* Truncating the file a font has mapped would take its glyphs away */
+    if ( Copy_Disk( font ) < 0 ) {
+        SDL_free( data );
+        return -1;
+    }
+    dst = SDL_RWFromFile( file, "wb" );
+    if ( dst == NULL ) {
+        SDL_free( data );
+        return -1;
+    }
+    if ( SDL_RWwrite( dst, data, offset, 1 ) != 1 ) {
+        TTF_SetError( "Couldn't write glyph cache file" );
+        retval = -1;
+    }
+    SDL_RWclose( dst );
+    SDL_free( data );
+    return retval;
+}
+
+static SDL_bool Check_Disk_Bitmap( const Uint8* words, Uint32 size )
+{
+    Uint64 width = Disk_Word( words, 0 );
+    Uint64 rows = Disk_Word( words, 1 );
+    Uint64 pitch = Disk_Word( words, 2 );
+    Uint64 offset = Disk_Word( words, 3 );
+
+    return ( pitch >= width && pitch <= 0x7FFFFFFF && rows <= 0x7FFFFFFF &&
+             offset + pitch * rows <= size );
+}
+
+/* Glyph metrics are used as offsets from the pen, keep them in order
+   and small enough that adding them up can't overflow */
+#define GLYPH_FILE_MAX_COORD    0x7FFF
+
+static SDL_bool Check_Disk_Metrics( const Uint8* record )
+{
+    int minx = (int)Disk_Word( record, GR_MINX );
+    int maxx = (int)Disk_Word( record, GR_MAXX );
+    int miny = (int)Disk_Word( record, GR_MINY );
+    int maxy = (int)Disk_Word( record, GR_MAXY );
+    int yoffset = (int)Disk_Word( record, GR_YOFFSET );
+    int advance = (int)Disk_Word( record, GR_ADVANCE );
+    Uint32 stored = Disk_Word( record, GR_STORED );
+
+    if ( stored & ~(Uint32)(CACHED_METRICS|CACHED_BITMAP|CACHED_PIXMAP) ) {
+        return SDL_FALSE;
+    }
+    if ( !(stored & CACHED_METRICS) ) {
+        /* Bitmaps are only placed by the metrics that come with them */
+        return ( !(stored & (CACHED_BITMAP|CACHED_PIXMAP)) );
+    }
+    return ( minx <= maxx && miny <= maxy &&
+             minx >= -GLYPH_FILE_MAX_COORD && maxx <= GLYPH_FILE_MAX_COORD &&
+             miny >= -GLYPH_FILE_MAX_COORD && maxy <= GLYPH_FILE_MAX_COORD &&
+             yoffset >= -GLYPH_FILE_MAX_COORD && yoffset <= GLYPH_FILE_MAX_COORD &&
+             advance >= -GLYPH_FILE_MAX_COORD && advance <= GLYPH_FILE_MAX_COORD );
+}
+
+int TTF_LoadGlyphCache( TTF_Font* font, const char *file )
+{
+    SDL_RWops *src;
+    size_t size;
+    const Uint8 *disk;
+    Uint32 header[GF_HEADER];
+    Uint32 count;
+    Uint64 key, last = 0;
+    Uint32 i;
+
+    TTF_CHECKPOINTER(font, -1);
+    TTF_CHECKPOINTER(file, -1);
+
+    /* The glyphs are used straight from the mapped file */
+    src = SDL_RWFromFileMapped( file );
+    if ( src == NULL ) {
+        return -1;
+    }
+    disk = (const Uint8 *)SDL_RWGetMemory( src, &size );
+    if ( disk == NULL || size < GF_HEADER * 4 || size > 0x7FFFFFFF ) {
+        TTF_SetError( "Not a glyph cache file" );
+        SDL_RWclose( src );
+        return -1;
+    }
+
+    /* The glyphs are only good for the font file, size and FreeType
+       version they were rendered with */
+    Disk_Header( font, header );
+    if ( Disk_Word( disk, GF_MAGIC0 ) != header[GF_MAGIC0] ||
+         Disk_Word( disk, GF_MAGIC1 ) != header[GF_MAGIC1] ||
+         Disk_Word( disk, GF_VERSION ) != header[GF_VERSION] ) {
+        TTF_SetError( "Not a glyph cache file" );
+        SDL_RWclose( src );
+        return -1;
+    }
+    for ( i = GF_FREETYPE; i < GF_COUNT; ++i ) {
+        if ( Disk_Word( disk, i ) != header[i] ) {
+            TTF_SetError( "Glyph cache file is for another font" );
+            SDL_RWclose( src );
+            return -1;
+        }
+    }
+
+    /* Check everything the lookups will trust */
+    count = Disk_Word( disk, GF_COUNT );
+    if ( count > ((Uint32)size / 4 - GF_HEADER) / GR_RECORD ) {
+        TTF_SetError( "Corrupt glyph cache file" );
+        SDL_RWclose( src );
+        return -1;
+    }
+    for ( i = 0; i < count; ++i ) {
+        const Uint8 *record = disk + (GF_HEADER + i * GR_RECORD) * 4;
+
+        key = ((Uint64)Disk_Word( record, GR_STATE ) << 32) | Disk_Word( record, GR_CH );
+        if ( (i > 0 && key <= last) ||
+             !Check_Disk_Metrics( record ) ||
+             !Check_Disk_Bitmap( record + GR_BITMAP * 4, (Uint32)size ) ||
+             !Check_Disk_Bitmap( record + GR_PIXMAP * 4, (Uint32)size ) ) {
+            TTF_SetError( "Corrupt glyph cache file" );
+            SDL_RWclose( src );
+            return -1;
+        }
+        last = key;
+    }
+
+    Free_Disk( font );
+    font->disk = disk;
+    font->disk_src = src;
+    font->disk_size = (Uint32)size;
+    font->disk_count = count;
+    return 0;
+}
+
+void TTF_CloseFont( TTF_Font* font )
+{
+    if ( font ) {
+        if ( font->cache ) {
+            Flush_Cache( font );
+            SDL_free( font->cache );
+        }
+        TTF_FreeWrappedText( font->wrap );
+        TTF_FreeLayout( font->layout );
+        Free_Disk( font );
+        SDL_LockMutex( TTF_lock );
+        if ( font->size ) {
+            SDL_LockMutex( font->shared->lock );
+            FT_Done_Size( font->size );
+            SDL_UnlockMutex( font->shared->lock );
+        }
+        if ( font->shared ) {
+            Release_Face( font->shared );
+        }
+        SDL_UnlockMutex( TTF_lock );
+        SDL_free( font );
+    }
+}
+
+/* Gets the number of bytes used by a null terminated UCS2 string */
+static size_t UCS2_len(const Uint16 *text)
+{
+    size_t count = 0;
+    while (*text++) {
+        ++count;
+    }
+    return count * sizeof(*text);
+}
+
+/* Convert a Latin-1 string to a UTF-8 string */
+static void LATIN1_to_UTF8(const char *src, Uint8 *dst)
 {
     while (*src) {
         Uint8 ch = *(Uint8*)src++;
@@ -1128,11 +2154,27 @@ char *TTF_FontFaceStyleName(const TTF_Font *font)
 
 int TTF_GlyphIsProvided(const TTF_Font *font, Uint16 ch)
 {
-  return(FT_Get_Char_Index(font->face, ch));
+  return TTF_GlyphIsProvided32(font, ch);
+}
+
+int TTF_GlyphIsProvided32(const TTF_Font *font, Uint32 ch)
+{
+  FT_UInt index;
+
+  SDL_LockMutex(font->shared->lock);
+  index = FT_Get_Char_Index(font->face, ch);
+  SDL_UnlockMutex(font->shared->lock);
+  return(index);
 }
 
 int TTF_GlyphMetrics(TTF_Font *font, Uint16 ch,
                      int* minx, int* maxx, int* miny, int* maxy, int* advance)
+{
+    return TTF_GlyphMetrics32(font, ch, minx, maxx, miny, maxy, advance);
+}
+
+int TTF_GlyphMetrics32(TTF_Font *font, Uint32 ch,
+                       int* minx, int* maxx, int* miny, int* maxy, int* advance)
 {
     FT_Error error;
 
@@ -1166,28 +2208,64 @@ int TTF_GlyphMetrics(TTF_Font *font, Uint16 ch,
     return 0;
 }
 
-int TTF_SizeText(TTF_Font *font, const char *text, int *w, int *h)
+/* Make the cached glyph of a laid out character current.  The slot it
+   was positioned with is reused unless it has been recycled since.
+*/
+static FT_Error Find_Laid_Glyph(TTF_Layout *layout, l_glyph *laid, int want)
 {
-    int status = -1;
-    Uint8 *utf8;
+    TTF_Font *font = layout->font;
+    c_glyph *glyph = laid->glyph;
+    FT_Error error;
 
-    TTF_CHECKPOINTER(text, -1);
+    if ( glyph && layout->generation == font->cache_generation &&
+         glyph->stored && glyph->cached == laid->ch &&
+         glyph->state == font->glyph_state ) {
+        font->current = glyph;
+        glyph->lru = ++font->cache_clock;
+        ++font->cache_hits;
+        if ( (glyph->stored & want) == want ) {
+            return 0;
+        }
+        return Load_Glyph(font, laid->ch, glyph, want);
+    }
 
-    utf8 = SDL_stack_alloc(Uint8, SDL_strlen(text)*2+1);
-    if ( utf8 ) {
-        LATIN1_to_UTF8(text, utf8);
-        status = TTF_SizeUTF8(font, (char *)utf8, w, h);
-        SDL_stack_free(utf8);
-    } else {
-        SDL_OutOfMemory();
+    error = Find_Glyph(font, laid->ch, want);
+    laid->glyph = font->current;
+    return error;
+}
+
+static int Layout_Reserve(TTF_Layout *layout, int count)
+{
+    l_glyph *glyphs;
+    int max;
+
+    if ( count <= layout->max_glyphs ) {
+        return 0;
     }
-    return status;
+    max = layout->max_glyphs ? layout->max_glyphs : 16;
+    while ( max < count ) {
+        max *= 2;
+    }
+    glyphs = (l_glyph *)SDL_realloc(layout->glyphs, max * sizeof(*glyphs));
+    if ( glyphs == NULL ) {
+        TTF_SetError("Out of memory");
+        return -1;
+    }
+    layout->glyphs = glyphs;
+    layout->max_glyphs = max;
+    return 0;
 }
 
-int TTF_SizeUTF8(TTF_Font *font, const char *text, int *w, int *h)
+/* Compute the pen position of every laid out character and the size of
+   the surface they are rendered into.  This is the only place glyph
+   metrics and kerning are looked up for a string.
+*/
+static int Layout_Position(TTF_Layout *layout)
 {
-    int status;
+    TTF_Font *font = layout->font;
+    int i;
     int x, z;
+    int xoffset;
     int minx, maxx;
     int miny, maxy;
     c_glyph *glyph;
@@ -1195,14 +2273,11 @@ int TTF_SizeUTF8(TTF_Font *font, const char *text, int *w, int *h)
     FT_Long use_kerning;
     FT_UInt prev_index = 0;
     int outline_delta = 0;
-    size_t textlen;
-
-    TTF_CHECKPOINTER(text, -1);
 
     /* Initialize everything to 0 */
-    status = 0;
     minx = maxx = 0;
     miny = maxy = 0;
+    xoffset = 0;
 
     /* check kerning */
     use_kerning = FT_HAS_KERNING( font->face ) && font->kerning;
@@ -1213,46 +2288,31 @@ int TTF_SizeUTF8(TTF_Font *font, const char *text, int *w, int *h)
     }
 
     /* Load each character and sum it's bounding box */
-    textlen = SDL_strlen(text);
-    x= 0;
-    while ( textlen > 0 ) {
-        Uint16 c = UTF8_getch(&text, &textlen);
-        if ( c == UNICODE_BOM_NATIVE || c == UNICODE_BOM_SWAPPED ) {
-            continue;
-        }
+    x = 0;
+    for ( i = 0; i < layout->num_glyphs; ++i ) {
+        l_glyph *laid = &layout->glyphs[i];
 
-        error = Find_Glyph(font, c, CACHED_METRICS);
+        error = Find_Glyph(font, laid->ch, CACHED_METRICS);
         if ( error ) {
+            layout->positioned = SDL_FALSE;
             TTF_SetFTError("Couldn't find glyph", error);
             return -1;
         }
         glyph = font->current;
+        laid->glyph = glyph;
 
         /* handle kerning */
         if ( use_kerning && prev_index && glyph->index ) {
             FT_Vector delta;
-            FT_Get_Kerning( font->face, prev_index, glyph->index, ft_kerning_default, &delta );
+            Get_Kerning( font, prev_index, glyph->index, &delta );
             x += delta.x >> 6;
         }
 
-#if 0
-        if ( (ch == text) && (glyph->minx < 0) ) {
-        /* Fixes the texture wrapping bug when the first letter
-         * has a negative minx value or horibearing value.  The entire
-         * bounding box must be adjusted to be bigger so the entire
-         * letter can fit without any texture corruption or wrapping.
-         *
-         * Effects: First enlarges bounding box.
-         * Second, xstart has to start ahead of its normal spot in the
-         * negative direction of the negative minx value.
-         * (pushes everything to the right).
-         *
-         * This will make the memory copy of the glyph bitmap data
-         * work out correctly.
-         * */
-            z -= glyph->minx;
+        /* Compensate for wrap around bug with negative minx's */
+        if ( i == 0 && glyph->minx < 0 ) {
+            xoffset = -glyph->minx;
         }
-#endif
+        laid->x = x + xoffset;
 
         z = x + glyph->minx;
         if ( minx > z ) {
@@ -1279,337 +2339,285 @@ int TTF_SizeUTF8(TTF_Font *font, const char *text, int *w, int *h)
         }
         prev_index = glyph->index;
     }
+    layout->end = x + xoffset;
 
-    /* Fill the bounds rectangle */
-    if ( w ) {
-        /* Add outline extra width */
-        *w = (maxx - minx) + outline_delta;
+    /* Add outline extra width */
+    layout->width = (maxx - minx) + outline_delta;
+
+    /* Some fonts descend below font height (FletcherGothicFLF) */
+    /* Add outline extra height */
+    layout->height = (font->ascent - miny) + outline_delta;
+    if ( layout->height < font->height ) {
+        layout->height = font->height;
     }
-    if ( h ) {
-        /* Some fonts descend below font height (FletcherGothicFLF) */
-        /* Add outline extra height */
-        *h = (font->ascent - miny) + outline_delta;
-        if ( *h < font->height ) {
-            *h = font->height;
-        }
-        /* Update height according to the needs of the underline style */
-        if ( TTF_HANDLE_STYLE_UNDERLINE(font) ) {
-            int bottom_row = TTF_underline_bottom_row(font);
-            if ( *h < bottom_row ) {
-                *h = bottom_row;
-            }
+    /* Update height according to the needs of the underline style */
+    if ( TTF_HANDLE_STYLE_UNDERLINE(font) ) {
+        int bottom_row = TTF_underline_bottom_row(font);
+        if ( layout->height < bottom_row ) {
+            layout->height = bottom_row;
         }
     }
-    return status;
+
+    layout->positioned = SDL_TRUE;
+    layout->state = font->glyph_state;
+    layout->style = font->style;
+    layout->kerning = font->kerning;
+    layout->generation = font->cache_generation;
+    return 0;
 }
 
-int TTF_SizeUNICODE(TTF_Font *font, const Uint16 *text, int *w, int *h)
+/* Position the layout again if the font style changed since it was laid out */
+static int Layout_Update(TTF_Layout *layout)
 {
-    int status = -1;
-    Uint8 *utf8;
+    TTF_Font *font = layout->font;
 
-    TTF_CHECKPOINTER(text, -1);
+    if ( layout->positioned &&
+         layout->state == font->glyph_state &&
+         layout->style == font->style &&
+         layout->kerning == font->kerning ) {
+        return 0;
+    }
+    return Layout_Position(layout);
+}
 
-    utf8 = SDL_stack_alloc(Uint8, UCS2_len(text)*3+1);
-    if ( utf8 ) {
-        UCS2_to_UTF8(text, utf8);
-        status = TTF_SizeUTF8(font, (char *)utf8, w, h);
-        SDL_stack_free(utf8);
-    } else {
-        SDL_OutOfMemory();
+/* Decode len bytes of UTF-8 text into the layout and position it */
+static int Layout_SetTextN(TTF_Layout *layout, const char *text, size_t len)
+{
+    const char *start = text;
+    size_t textlen = len;
+    int count = 0;
+
+    /* Every character takes at least one byte */
+    if ( Layout_Reserve(layout, (int)textlen) < 0 ) {
+        return -1;
     }
-    return status;
+    while ( textlen > 0 ) {
+        int offset = (int)(text - start);
+        Uint32 c = UTF8_getch(&text, &textlen);
+        if ( c == UNICODE_BOM_NATIVE || c == UNICODE_BOM_SWAPPED ) {
+            continue;
+        }
+        layout->glyphs[count].ch = c;
+        layout->glyphs[count].offset = offset;
+        layout->glyphs[count].glyph = NULL;
+        ++count;
+    }
+    layout->num_glyphs = count;
+    layout->textlen = (int)(text - start);
+    return Layout_Position(layout);
 }
 
-SDL_Surface *TTF_RenderText_Solid(TTF_Font *font,
-                const char *text, SDL_Color fg)
+static int Layout_SetText(TTF_Layout *layout, const char *text)
 {
-    SDL_Surface *surface = NULL;
-    Uint8 *utf8;
-
-    TTF_CHECKPOINTER(text, NULL);
+    return Layout_SetTextN(layout, text, SDL_strlen(text));
+}
 
-    utf8 = SDL_stack_alloc(Uint8, SDL_strlen(text)*2+1);
-    if ( utf8 ) {
-        LATIN1_to_UTF8(text, utf8);
-        surface = TTF_RenderUTF8_Solid(font, (char *)utf8, fg);
-        SDL_stack_free(utf8);
-    } else {
-        SDL_OutOfMemory();
+static TTF_Layout *TTF_FontLayout(TTF_Font *font)
+{
+    if ( !font->layout ) {
+        font->layout = TTF_CreateLayout(font);
     }
-    return surface;
+    return font->layout;
 }
 
-SDL_Surface *TTF_RenderUTF8_Solid(TTF_Font *font,
-                const char *text, SDL_Color fg)
+static TTF_WrappedText *TTF_FontWrap(TTF_Font *font)
 {
-    SDL_bool first;
-    int xstart;
-    int width;
-    int height;
-    SDL_Surface* textbuf;
-    SDL_Palette* palette;
-    Uint8* src;
-    Uint8* dst;
-    Uint8 *dst_check;
-    int row, col;
-    c_glyph *glyph;
+    if ( !font->wrap ) {
+        font->wrap = TTF_CreateWrappedText(font, 0);
+    }
+    return font->wrap;
+}
 
-    FT_Bitmap *current;
-    FT_Error error;
-    FT_Long use_kerning;
-    FT_UInt prev_index = 0;
-    size_t textlen;
+TTF_Layout *TTF_CreateLayout(TTF_Font *font)
+{
+    TTF_Layout *layout;
 
-    TTF_CHECKPOINTER(text, NULL);
+    TTF_CHECKPOINTER(font, NULL);
 
-    /* Get the dimensions of the text surface */
-    if ( ( TTF_SizeUTF8(font, text, &width, &height) < 0 ) || !width ) {
-        TTF_SetError( "Text has zero width" );
+    layout = (TTF_Layout *)SDL_calloc(1, sizeof(*layout));
+    if ( layout == NULL ) {
+        TTF_SetError("Out of memory");
         return NULL;
     }
+    layout->font = font;
+    return layout;
+}
 
-    /* Create the target surface */
-    textbuf = SDL_CreateRGBSurface(SDL_SWSURFACE, width, height, 8, 0, 0, 0, 0);
-    if ( textbuf == NULL ) {
-        return NULL;
-    }
+int TTF_SetLayoutTextUTF8(TTF_Layout *layout, const char *text)
+{
+    TTF_CHECKPOINTER(layout, -1);
+    TTF_CHECKPOINTER(text, -1);
 
-    /* Adding bound checking to avoid all kinds of memory corruption errors
-       that may occur. */
-    dst_check = (Uint8*)textbuf->pixels + textbuf->pitch * textbuf->h;
+    return Layout_SetText(layout, text);
+}
 
-    /* Fill the palette with the foreground color */
-    palette = textbuf->format->palette;
-    palette->colors[0].r = 255 - fg.r;
-    palette->colors[0].g = 255 - fg.g;
-    palette->colors[0].b = 255 - fg.b;
-    palette->colors[1].r = fg.r;
-    palette->colors[1].g = fg.g;
-    palette->colors[1].b = fg.b;
-    SDL_SetColorKey( textbuf, SDL_TRUE, 0 );
+int TTF_SizeLayout(TTF_Layout *layout, int *w, int *h)
+{
+    TTF_CHECKPOINTER(layout, -1);
 
-    /* check kerning */
-    use_kerning = FT_HAS_KERNING( font->face ) && font->kerning;
+    if ( Layout_Update(layout) < 0 ) {
+        return -1;
+    }
+    if ( w ) {
+        *w = layout->width;
+    }
+    if ( h ) {
+        *h = layout->height;
+    }
+    return 0;
+}
 
-    /* Load and render each character */
-    textlen = SDL_strlen(text);
-    first = SDL_TRUE;
-    xstart = 0;
-    while ( textlen > 0 ) {
-        Uint16 c = UTF8_getch(&text, &textlen);
-        if ( c == UNICODE_BOM_NATIVE || c == UNICODE_BOM_SWAPPED ) {
-            continue;
-        }
+int TTF_GetLayoutCaretX(TTF_Layout *layout, int offset)
+{
+    int i;
 
-        error = Find_Glyph(font, c, CACHED_METRICS|CACHED_BITMAP);
-        if ( error ) {
-            TTF_SetFTError("Couldn't find glyph", error);
-            SDL_FreeSurface( textbuf );
-            return NULL;
-        }
-        glyph = font->current;
-        current = &glyph->bitmap;
-        /* Ensure the width of the pixmap is correct. On some cases,
-         * freetype may report a larger pixmap than possible.*/
-        width = current->width;
-        if (font->outline <= 0 && width > glyph->maxx - glyph->minx) {
-            width = glyph->maxx - glyph->minx;
-        }
-        /* do kerning, if possible AC-Patch */
-        if ( use_kerning && prev_index && glyph->index ) {
-            FT_Vector delta;
-            FT_Get_Kerning( font->face, prev_index, glyph->index, ft_kerning_default, &delta );
-            xstart += delta.x >> 6;
-        }
-        /* Compensate for wrap around bug with negative minx's */
-        if ( first && (glyph->minx < 0) ) {
-            xstart -= glyph->minx;
+    TTF_CHECKPOINTER(layout, -1);
+
+    if ( Layout_Update(layout) < 0 ) {
+        return -1;
+    }
+    for ( i = 0; i < layout->num_glyphs; ++i ) {
+        if ( layout->glyphs[i].offset >= offset ) {
+            return layout->glyphs[i].x;
         }
-        first = SDL_FALSE;
+    }
+    return layout->end;
+}
 
-        for ( row = 0; row < current->rows; ++row ) {
-            /* Make sure we don't go either over, or under the
-             * limit */
-            if ( row+glyph->yoffset < 0 ) {
-                continue;
-            }
-            if ( row+glyph->yoffset >= textbuf->h ) {
-                continue;
-            }
-            dst = (Uint8*) textbuf->pixels +
-                (row+glyph->yoffset) * textbuf->pitch +
-                xstart + glyph->minx;
-            src = current->buffer + row * current->pitch;
+int TTF_GetLayoutOffsetAtX(TTF_Layout *layout, int x)
+{
+    int i;
 
-            for ( col=width; col>0 && dst < dst_check; --col ) {
-                *dst++ |= *src++;
-            }
-        }
+    TTF_CHECKPOINTER(layout, -1);
 
-        xstart += glyph->advance;
-        if ( TTF_HANDLE_STYLE_BOLD(font) ) {
-            xstart += font->glyph_overhang;
-        }
-        prev_index = glyph->index;
+    if ( Layout_Update(layout) < 0 ) {
+        return -1;
     }
-
-    /* Handle the underline style */
-    if ( TTF_HANDLE_STYLE_UNDERLINE(font) ) {
-        row = TTF_underline_top_row(font);
-        TTF_drawLine_Solid(font, textbuf, row);
+    for ( i = 0; i < layout->num_glyphs; ++i ) {
+        int left = layout->glyphs[i].x;
+        int right = (i+1 < layout->num_glyphs) ? layout->glyphs[i+1].x : layout->end;
+        if ( x < (left + right) / 2 ) {
+            return layout->glyphs[i].offset;
+        }
     }
+    return layout->textlen;
+}
 
-    /* Handle the strikethrough style */
-    if ( TTF_HANDLE_STYLE_STRIKETHROUGH(font) ) {
-        row = TTF_strikethrough_top_row(font);
-        TTF_drawLine_Solid(font, textbuf, row);
+void TTF_FreeLayout(TTF_Layout *layout)
+{
+    if ( layout ) {
+        SDL_free(layout->glyphs);
+        SDL_free(layout);
     }
-    return textbuf;
 }
 
-SDL_Surface *TTF_RenderUNICODE_Solid(TTF_Font *font,
-                const Uint16 *text, SDL_Color fg)
+int TTF_SizeText(TTF_Font *font, const char *text, int *w, int *h)
 {
-    SDL_Surface *surface = NULL;
+    int status = -1;
     Uint8 *utf8;
 
-    TTF_CHECKPOINTER(text, NULL);
+    TTF_CHECKPOINTER(text, -1);
 
-    utf8 = SDL_stack_alloc(Uint8, UCS2_len(text)*3+1);
+    utf8 = SDL_stack_alloc(Uint8, SDL_strlen(text)*2+1);
     if ( utf8 ) {
-        UCS2_to_UTF8(text, utf8);
-        surface = TTF_RenderUTF8_Solid(font, (char *)utf8, fg);
+        LATIN1_to_UTF8(text, utf8);
+        status = TTF_SizeUTF8(font, (char *)utf8, w, h);
         SDL_stack_free(utf8);
     } else {
         SDL_OutOfMemory();
     }
-    return surface;
+    return status;
 }
 
-SDL_Surface *TTF_RenderGlyph_Solid(TTF_Font *font, Uint16 ch, SDL_Color fg)
+int TTF_SizeUTF8(TTF_Font *font, const char *text, int *w, int *h)
 {
-    Uint16 ucs2[2] = { ch, 0 };
-    Uint8 utf8[4];
+    TTF_Layout *layout;
 
-    UCS2_to_UTF8(ucs2, utf8);
-    return TTF_RenderUTF8_Solid(font, (char *)utf8, fg);
+    TTF_CHECKPOINTER(text, -1);
+
+    layout = TTF_FontLayout(font);
+    if ( !layout || Layout_SetText(layout, text) < 0 ) {
+        return -1;
+    }
+    if ( w ) {
+        *w = layout->width;
+    }
+    if ( h ) {
+        *h = layout->height;
+    }
+    return 0;
 }
 
-SDL_Surface *TTF_RenderText_Shaded(TTF_Font *font,
-                const char *text, SDL_Color fg, SDL_Color bg)
+int TTF_SizeUNICODE(TTF_Font *font, const Uint16 *text, int *w, int *h)
 {
-    SDL_Surface *surface = NULL;
+    int status = -1;
     Uint8 *utf8;
 
-    TTF_CHECKPOINTER(text, NULL);
+    TTF_CHECKPOINTER(text, -1);
 
-    utf8 = SDL_stack_alloc(Uint8, SDL_strlen(text)*2+1);
+    utf8 = SDL_stack_alloc(Uint8, UCS2_len(text)*3+1);
     if ( utf8 ) {
-        LATIN1_to_UTF8(text, utf8);
-        surface = TTF_RenderUTF8_Shaded(font, (char *)utf8, fg, bg);
+        UCS2_to_UTF8(text, utf8);
+        status = TTF_SizeUTF8(font, (char *)utf8, w, h);
         SDL_stack_free(utf8);
     } else {
         SDL_OutOfMemory();
     }
-    return surface;
+    return status;
 }
 
-/* Convert the UTF-8 text to UNICODE and render it
+/* Copy the glyphs of a layout into an 8-bit surface, using either the
+   bitmap (CACHED_BITMAP) or the pixmap (CACHED_PIXMAP) of every glyph
 */
-SDL_Surface *TTF_RenderUTF8_Shaded(TTF_Font *font,
-                const char *text, SDL_Color fg, SDL_Color bg)
+static int Render_Layout_8(TTF_Layout *layout, SDL_Surface *textbuf, int want)
 {
-    SDL_bool first;
-    int xstart;
+    TTF_Font *font = layout->font;
+    int i;
     int width;
-    int height;
-    SDL_Surface* textbuf;
-    SDL_Palette* palette;
-    int index;
-    int rdiff;
-    int gdiff;
-    int bdiff;
     Uint8* src;
     Uint8* dst;
     Uint8* dst_check;
-    int row, col;
+    int row;
     FT_Bitmap* current;
     c_glyph *glyph;
     FT_Error error;
-    FT_Long use_kerning;
-    FT_UInt prev_index = 0;
-    size_t textlen;
-
-    TTF_CHECKPOINTER(text, NULL);
-
-    /* Get the dimensions of the text surface */
-    if ( ( TTF_SizeUTF8(font, text, &width, &height) < 0 ) || !width ) {
-        TTF_SetError("Text has zero width");
-        return NULL;
-    }
-
-    /* Create the target surface */
-    textbuf = SDL_CreateRGBSurface(SDL_SWSURFACE, width, height, 8, 0, 0, 0, 0);
-    if ( textbuf == NULL ) {
-        return NULL;
-    }
+    int x, skip;
 
     /* Adding bound checking to avoid all kinds of memory corruption errors
        that may occur. */
     dst_check = (Uint8*)textbuf->pixels + textbuf->pitch * textbuf->h;
 
-    /* Fill the palette with NUM_GRAYS levels of shading from bg to fg */
-    palette = textbuf->format->palette;
-    rdiff = fg.r - bg.r;
-    gdiff = fg.g - bg.g;
-    bdiff = fg.b - bg.b;
-
-    for ( index = 0; index < NUM_GRAYS; ++index ) {
-        palette->colors[index].r = bg.r + (index*rdiff) / (NUM_GRAYS-1);
-        palette->colors[index].g = bg.g + (index*gdiff) / (NUM_GRAYS-1);
-        palette->colors[index].b = bg.b + (index*bdiff) / (NUM_GRAYS-1);
-    }
-
-    /* check kerning */
-    use_kerning = FT_HAS_KERNING( font->face ) && font->kerning;
-
-    /* Load and render each character */
-    textlen = SDL_strlen(text);
-    first = SDL_TRUE;
-    xstart = 0;
-    while ( textlen > 0 ) {
-        Uint16 c = UTF8_getch(&text, &textlen);
-        if ( c == UNICODE_BOM_NATIVE || c == UNICODE_BOM_SWAPPED ) {
-            continue;
-        }
+    for ( i = 0; i < layout->num_glyphs; ++i ) {
+        l_glyph *laid = &layout->glyphs[i];
 
-        error = Find_Glyph(font, c, CACHED_METRICS|CACHED_PIXMAP);
+        error = Find_Laid_Glyph(layout, laid, CACHED_METRICS|want);
         if ( error ) {
             TTF_SetFTError("Couldn't find glyph", error);
-            SDL_FreeSurface( textbuf );
-            return NULL;
+            return -1;
         }
         glyph = font->current;
+        if ( want == CACHED_BITMAP ) {
+            current = &glyph->bitmap;
+        } else {
+            current = &glyph->pixmap;
+        }
         /* Ensure the width of the pixmap is correct. On some cases,
          * freetype may report a larger pixmap than possible.*/
-        width = glyph->pixmap.width;
+        width = current->width;
         if (font->outline <= 0 && width > glyph->maxx - glyph->minx) {
             width = glyph->maxx - glyph->minx;
         }
-        /* do kerning, if possible AC-Patch */
-        if ( use_kerning && prev_index && glyph->index ) {
-            FT_Vector delta;
-            FT_Get_Kerning( font->face, prev_index, glyph->index, ft_kerning_default, &delta );
-            xstart += delta.x >> 6;
+        /* Clip the glyph to the sides of the surface, a word wider than
+         * the wrap length must not spill into the next row. */
+        x = laid->x + glyph->minx;
+        skip = (x < 0) ? -x : 0;
+        if ( x + width > textbuf->w ) {
+            width = textbuf->w - x;
         }
-        /* Compensate for the wrap around with negative minx's */
-        if ( first && (glyph->minx < 0) ) {
-            xstart -= glyph->minx;
+        if ( width <= skip ) {
+            continue;
         }
-        first = SDL_FALSE;
 
-        current = &glyph->pixmap;
         for ( row = 0; row < current->rows; ++row ) {
             /* Make sure we don't go either over, or under the
              * limit */
@@ -1620,145 +2628,44 @@ SDL_Surface *TTF_RenderUTF8_Shaded(TTF_Font *font,
                 continue;
             }
             dst = (Uint8*) textbuf->pixels +
-                (row+glyph->yoffset) * textbuf->pitch +
-                xstart + glyph->minx;
-            src = current->buffer + row * current->pitch;
-            for ( col=width; col>0 && dst < dst_check; --col ) {
-                *dst++ |= *src++;
-            }
-        }
+                (row+glyph->yoffset) * textbuf->pitch + x + skip;
+            src = current->buffer + row * current->pitch + skip;
 
-        xstart += glyph->advance;
-        if ( TTF_HANDLE_STYLE_BOLD(font) ) {
-            xstart += font->glyph_overhang;
+            if ( dst >= (Uint8*)textbuf->pixels && dst < dst_check ) {
+                TTF_combineRow_8(dst, src, SDL_min(width - skip, (int)(dst_check - dst)));
+            }
         }
-        prev_index = glyph->index;
-    }
-
-    /* Handle the underline style */
-    if ( TTF_HANDLE_STYLE_UNDERLINE(font) ) {
-        row = TTF_underline_top_row(font);
-        TTF_drawLine_Shaded(font, textbuf, row);
     }
+    return 0;
+}
 
-    /* Handle the strikethrough style */
-    if ( TTF_HANDLE_STYLE_STRIKETHROUGH(font) ) {
-        row = TTF_strikethrough_top_row(font);
-        TTF_drawLine_Shaded(font, textbuf, row);
-    }
-    return textbuf;
-}
-
-SDL_Surface* TTF_RenderUNICODE_Shaded( TTF_Font* font,
-                       const Uint16* text,
-                       SDL_Color fg,
-                       SDL_Color bg )
-{
-    SDL_Surface *surface = NULL;
-    Uint8 *utf8;
-
-    TTF_CHECKPOINTER(text, NULL);
-
-    utf8 = SDL_stack_alloc(Uint8, UCS2_len(text)*3+1);
-    if ( utf8 ) {
-        UCS2_to_UTF8(text, utf8);
-        surface = TTF_RenderUTF8_Shaded(font, (char *)utf8, fg, bg);
-        SDL_stack_free(utf8);
-    } else {
-        SDL_OutOfMemory();
-    }
-    return surface;
-}
-
-SDL_Surface* TTF_RenderGlyph_Shaded( TTF_Font* font,
-                     Uint16 ch,
-                     SDL_Color fg,
-                     SDL_Color bg )
-{
-    Uint16 ucs2[2] = { ch, 0 };
-    Uint8 utf8[4];
-
-    UCS2_to_UTF8(ucs2, utf8);
-    return TTF_RenderUTF8_Shaded(font, (char *)utf8, fg, bg);
-}
-
-SDL_Surface *TTF_RenderText_Blended(TTF_Font *font,
-                const char *text, SDL_Color fg)
-{
-    SDL_Surface *surface = NULL;
-    Uint8 *utf8;
-
-    TTF_CHECKPOINTER(text, NULL);
-
-    utf8 = SDL_stack_alloc(Uint8, SDL_strlen(text)*2+1);
-    if ( utf8 ) {
-        LATIN1_to_UTF8(text, utf8);
-        surface = TTF_RenderUTF8_Blended(font, (char *)utf8, fg);
-        SDL_stack_free(utf8);
-    } else {
-        SDL_OutOfMemory();
-    }
-    return surface;
-}
-
-SDL_Surface *TTF_RenderUTF8_Blended(TTF_Font *font,
-                const char *text, SDL_Color fg)
+/* Blend the glyphs of a layout into a 32-bit surface, starting at pixels.
+   The surface is already filled with the text color, only alpha changes.
+*/
+static int Render_Layout_32(TTF_Layout *layout, SDL_Surface *textbuf, Uint32 *pixels)
 {
-    SDL_bool first;
-    int xstart;
-    int width, height;
-    SDL_Surface *textbuf;
-    Uint32 alpha;
-    Uint32 pixel;
+    TTF_Font *font = layout->font;
+    int i;
+    int width;
     Uint8 *src;
     Uint32 *dst;
     Uint32 *dst_check;
-    int row, col;
+    int row;
     c_glyph *glyph;
     FT_Error error;
-    FT_Long use_kerning;
-    FT_UInt prev_index = 0;
-    size_t textlen;
-
-    TTF_CHECKPOINTER(text, NULL);
-
-    /* Get the dimensions of the text surface */
-    if ( ( TTF_SizeUTF8(font, text, &width, &height) < 0 ) || !width ) {
-        TTF_SetError("Text has zero width");
-        return(NULL);
-    }
-
-    /* Create the target surface */
-    textbuf = SDL_CreateRGBSurface(SDL_SWSURFACE, width, height, 32,
-                               0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
-    if ( textbuf == NULL ) {
-        return(NULL);
-    }
+    int x, skip;
 
     /* Adding bound checking to avoid all kinds of memory corruption errors
        that may occur. */
     dst_check = (Uint32*)textbuf->pixels + textbuf->pitch/4 * textbuf->h;
 
-    /* check kerning */
-    use_kerning = FT_HAS_KERNING( font->face ) && font->kerning;
-
-    /* Load and render each character */
-    textlen = SDL_strlen(text);
-    first = SDL_TRUE;
-    xstart = 0;
-    pixel = (fg.r<<16)|(fg.g<<8)|fg.b;
-    SDL_FillRect(textbuf, NULL, pixel); /* Initialize with fg and 0 alpha */
-    while ( textlen > 0 ) {
-        Uint16 c = UTF8_getch(&text, &textlen);
-        if ( c == UNICODE_BOM_NATIVE || c == UNICODE_BOM_SWAPPED ) {
-            continue;
-        }
+    for ( i = 0; i < layout->num_glyphs; ++i ) {
+        l_glyph *laid = &layout->glyphs[i];
 
-        error = Find_Glyph(font, c, CACHED_METRICS|CACHED_PIXMAP);
+        error = Find_Laid_Glyph(layout, laid, CACHED_METRICS|CACHED_PIXMAP);
         if ( error ) {
             TTF_SetFTError("Couldn't find glyph", error);
-            SDL_FreeSurface( textbuf );
-            return NULL;
+            return -1;
         }
         glyph = font->current;
         /* Ensure the width of the pixmap is correct. On some cases,
@@ -1767,18 +2674,15 @@ SDL_Surface *TTF_RenderUTF8_Blended(TTF_Font *font,
         if (font->outline <= 0 && width > glyph->maxx - glyph->minx) {
             width = glyph->maxx - glyph->minx;
         }
-        /* do kerning, if possible AC-Patch */
-        if ( use_kerning && prev_index && glyph->index ) {
-            FT_Vector delta;
-            FT_Get_Kerning( font->face, prev_index, glyph->index, ft_kerning_default, &delta );
-            xstart += delta.x >> 6;
+        /* Clip the glyph to the sides of the surface */
+        x = laid->x + glyph->minx;
+        skip = (x < 0) ? -x : 0;
+        if ( x + width > textbuf->w ) {
+            width = textbuf->w - x;
         }
-
-        /* Compensate for the wrap around bug with negative minx's */
-        if ( first && (glyph->minx < 0) ) {
-            xstart -= glyph->minx;
+        if ( width <= skip ) {
+            continue;
         }
-        first = SDL_FALSE;
 
         for ( row = 0; row < glyph->pixmap.rows; ++row ) {
             /* Make sure we don't go either over, or under the
@@ -1789,25 +2693,160 @@ SDL_Surface *TTF_RenderUTF8_Blended(TTF_Font *font,
             if ( row+glyph->yoffset >= textbuf->h ) {
                 continue;
             }
-            dst = (Uint32*) textbuf->pixels +
-                (row+glyph->yoffset) * textbuf->pitch/4 +
-                xstart + glyph->minx;
+            dst = pixels +
+                (row+glyph->yoffset) * textbuf->pitch/4 + x + skip;
 
             /* Added code to adjust src pointer for pixmaps to
              * account for pitch.
              * */
-            src = (Uint8*) (glyph->pixmap.buffer + glyph->pixmap.pitch * row);
-            for ( col = width; col>0 && dst < dst_check; --col) {
-                alpha = *src++;
-                *dst++ |= pixel | (alpha << 24);
+            src = (Uint8*) (glyph->pixmap.buffer + glyph->pixmap.pitch * row) + skip;
+            if ( dst >= pixels && dst < dst_check ) {
+                TTF_combineRow_32(dst, src, SDL_min(width - skip, (int)(dst_check - dst)));
             }
         }
+    }
+    return 0;
+}
 
-        xstart += glyph->advance;
-        if ( TTF_HANDLE_STYLE_BOLD(font) ) {
-            xstart += font->glyph_overhang;
-        }
-        prev_index = glyph->index;
+SDL_Surface *TTF_RenderLayout_Solid(TTF_Layout *layout, SDL_Color fg)
+{
+    TTF_Font *font;
+    SDL_Surface* textbuf;
+    SDL_Palette* palette;
+    int row;
+
+    TTF_CHECKPOINTER(layout, NULL);
+    font = layout->font;
+
+    /* Get the dimensions of the text surface */
+    if ( ( Layout_Update(layout) < 0 ) || !layout->width ) {
+        TTF_SetError( "Text has zero width" );
+        return NULL;
+    }
+
+    /* Create the target surface */
+    textbuf = SDL_CreateRGBSurface(SDL_SWSURFACE, layout->width, layout->height, 8, 0, 0, 0, 0);
+    if ( textbuf == NULL ) {
+        return NULL;
+    }
+
+    /* Fill the palette with the foreground color */
+    palette = textbuf->format->palette;
+    palette->colors[0].r = 255 - fg.r;
+    palette->colors[0].g = 255 - fg.g;
+    palette->colors[0].b = 255 - fg.b;
+    palette->colors[1].r = fg.r;
+    palette->colors[1].g = fg.g;
+    palette->colors[1].b = fg.b;
+    SDL_SetColorKey( textbuf, SDL_TRUE, 0 );
+
+    /* Render each character */
+    if ( Render_Layout_8(layout, textbuf, CACHED_BITMAP) < 0 ) {
+        SDL_FreeSurface( textbuf );
+        return NULL;
+    }
+
+    /* Handle the underline style */
+    if ( TTF_HANDLE_STYLE_UNDERLINE(font) ) {
+        row = TTF_underline_top_row(font);
+        TTF_drawLine_Solid(font, textbuf, row);
+    }
+
+    /* Handle the strikethrough style */
+    if ( TTF_HANDLE_STYLE_STRIKETHROUGH(font) ) {
+        row = TTF_strikethrough_top_row(font);
+        TTF_drawLine_Solid(font, textbuf, row);
+    }
+    return textbuf;
+}
+
+SDL_Surface *TTF_RenderLayout_Shaded(TTF_Layout *layout, SDL_Color fg, SDL_Color bg)
+{
+    TTF_Font *font;
+    SDL_Surface* textbuf;
+    SDL_Palette* palette;
+    int index;
+    int rdiff;
+    int gdiff;
+    int bdiff;
+    int row;
+
+    TTF_CHECKPOINTER(layout, NULL);
+    font = layout->font;
+
+    /* Get the dimensions of the text surface */
+    if ( ( Layout_Update(layout) < 0 ) || !layout->width ) {
+        TTF_SetError("Text has zero width");
+        return NULL;
+    }
+
+    /* Create the target surface */
+    textbuf = SDL_CreateRGBSurface(SDL_SWSURFACE, layout->width, layout->height, 8, 0, 0, 0, 0);
+    if ( textbuf == NULL ) {
+        return NULL;
+    }
+
+    /* Fill the palette with NUM_GRAYS levels of shading from bg to fg */
+    palette = textbuf->format->palette;
+    rdiff = fg.r - bg.r;
+    gdiff = fg.g - bg.g;
+    bdiff = fg.b - bg.b;
+
+    for ( index = 0; index < NUM_GRAYS; ++index ) {
+        palette->colors[index].r = bg.r + (index*rdiff) / (NUM_GRAYS-1);
+        palette->colors[index].g = bg.g + (index*gdiff) / (NUM_GRAYS-1);
+        palette->colors[index].b = bg.b + (index*bdiff) / (NUM_GRAYS-1);
+    }
+
+    /* Render each character */
+    if ( Render_Layout_8(layout, textbuf, CACHED_PIXMAP) < 0 ) {
+        SDL_FreeSurface( textbuf );
+        return NULL;
+    }
+
+    /* Handle the underline style */
+    if ( TTF_HANDLE_STYLE_UNDERLINE(font) ) {
+        row = TTF_underline_top_row(font);
+        TTF_drawLine_Shaded(font, textbuf, row);
+    }
+
+    /* Handle the strikethrough style */
+    if ( TTF_HANDLE_STYLE_STRIKETHROUGH(font) ) {
+        row = TTF_strikethrough_top_row(font);
+        TTF_drawLine_Shaded(font, textbuf, row);
+    }
+    return textbuf;
+}
+
+SDL_Surface *TTF_RenderLayout_Blended(TTF_Layout *layout, SDL_Color fg)
+{
+    TTF_Font *font;
+    SDL_Surface *textbuf;
+    Uint32 pixel;
+    int row;
+
+    TTF_CHECKPOINTER(layout, NULL);
+    font = layout->font;
+
+    /* Get the dimensions of the text surface */
+    if ( ( Layout_Update(layout) < 0 ) || !layout->width ) {
+        TTF_SetError("Text has zero width");
+        return(NULL);
+    }
+
+    /* Create the target surface */
+    textbuf = SDL_CreateRGBSurface(SDL_SWSURFACE, layout->width, layout->height, 32,
+                               0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
+    if ( textbuf == NULL ) {
+        return(NULL);
+    }
+
+    /* Render each character */
+    pixel = (fg.r<<16)|(fg.g<<8)|fg.b;
+    SDL_FillRect(textbuf, NULL, pixel); /* Initialize with fg and 0 alpha */
+    if ( Render_Layout_32(layout, textbuf, (Uint32 *)textbuf->pixels) < 0 ) {
+        SDL_FreeSurface( textbuf );
+        return NULL;
     }
 
     /* Handle the underline style */
@@ -1824,18 +2863,18 @@ SDL_Surface *TTF_RenderUTF8_Blended(TTF_Font *font,
     return(textbuf);
 }
 
-SDL_Surface *TTF_RenderUNICODE_Blended(TTF_Font *font,
-                const Uint16 *text, SDL_Color fg)
+SDL_Surface *TTF_RenderText_Solid(TTF_Font *font,
+                const char *text, SDL_Color fg)
 {
     SDL_Surface *surface = NULL;
     Uint8 *utf8;
 
     TTF_CHECKPOINTER(text, NULL);
 
-    utf8 = SDL_stack_alloc(Uint8, UCS2_len(text)*3+1);
+    utf8 = SDL_stack_alloc(Uint8, SDL_strlen(text)*2+1);
     if ( utf8 ) {
-        UCS2_to_UTF8(text, utf8);
-        surface = TTF_RenderUTF8_Blended(font, (char *)utf8, fg);
+        LATIN1_to_UTF8(text, utf8);
+        surface = TTF_RenderUTF8_Solid(font, (char *)utf8, fg);
         SDL_stack_free(utf8);
     } else {
         SDL_OutOfMemory();
@@ -1843,18 +2882,33 @@ SDL_Surface *TTF_RenderUNICODE_Blended(TTF_Font *font,
     return surface;
 }
 
+SDL_Surface *TTF_RenderUTF8_Solid(TTF_Font *font,
+                const char *text, SDL_Color fg)
+{
+    TTF_Layout *layout;
+
+    TTF_CHECKPOINTER(text, NULL);
 
-SDL_Surface *TTF_RenderText_Blended_Wrapped(TTF_Font *font, const char *text, SDL_Color fg, Uint32 wrapLength)
+    layout = TTF_FontLayout(font);
+    if ( !layout || Layout_SetText(layout, text) < 0 ) {
+        TTF_SetError( "Text has zero width" );
+        return NULL;
+    }
+    return TTF_RenderLayout_Solid(layout, fg);
+}
+
+SDL_Surface *TTF_RenderUNICODE_Solid(TTF_Font *font,
+                const Uint16 *text, SDL_Color fg)
 {
     SDL_Surface *surface = NULL;
     Uint8 *utf8;
 
     TTF_CHECKPOINTER(text, NULL);
 
-    utf8 = SDL_stack_alloc(Uint8, SDL_strlen(text)*2+1);
+    utf8 = SDL_stack_alloc(Uint8, UCS2_len(text)*3+1);
     if ( utf8 ) {
-        LATIN1_to_UTF8(text, utf8);
-        surface = TTF_RenderUTF8_Blended_Wrapped(font, (char *)utf8, fg, wrapLength);
+        UCS2_to_UTF8(text, utf8);
+        surface = TTF_RenderUTF8_Solid(font, (char *)utf8, fg);
         SDL_stack_free(utf8);
     } else {
         SDL_OutOfMemory();
@@ -1862,283 +2916,2425 @@ SDL_Surface *TTF_RenderText_Blended_Wrapped(TTF_Font *font, const char *text, SD
     return surface;
 }
 
-static SDL_bool CharacterIsDelimiter(char c, const char *delimiters)
+SDL_Surface *TTF_RenderGlyph_Solid(TTF_Font *font, Uint16 ch, SDL_Color fg)
 {
-    while (*delimiters) {
-        if (c == *delimiters) {
-            return SDL_TRUE;
-        }
-        ++delimiters;
-    }
-    return SDL_FALSE;
-}
+    Uint16 ucs2[2] = { ch, 0 };
+    Uint8 utf8[4];
+
+    UCS2_to_UTF8(ucs2, utf8);
+    return TTF_RenderUTF8_Solid(font, (char *)utf8, fg);
+}
+
+SDL_Surface *TTF_RenderText_Shaded(TTF_Font *font,
+                const char *text, SDL_Color fg, SDL_Color bg)
+{
+    SDL_Surface *surface = NULL;
+    Uint8 *utf8;
+
+    TTF_CHECKPOINTER(text, NULL);
+
+    utf8 = SDL_stack_alloc(Uint8, SDL_strlen(text)*2+1);
+    if ( utf8 ) {
+        LATIN1_to_UTF8(text, utf8);
+        surface = TTF_RenderUTF8_Shaded(font, (char *)utf8, fg, bg);
+        SDL_stack_free(utf8);
+    } else {
+        SDL_OutOfMemory();
+    }
+    return surface;
+}
+
+/* Convert the UTF-8 text to UNICODE and render it
+*/
+SDL_Surface *TTF_RenderUTF8_Shaded(TTF_Font *font,
+                const char *text, SDL_Color fg, SDL_Color bg)
+{
+    TTF_Layout *layout;
+
+    TTF_CHECKPOINTER(text, NULL);
+
+    layout = TTF_FontLayout(font);
+    if ( !layout || Layout_SetText(layout, text) < 0 ) {
+        TTF_SetError("Text has zero width");
+        return NULL;
+    }
+    return TTF_RenderLayout_Shaded(layout, fg, bg);
+}
+
+SDL_Surface* TTF_RenderUNICODE_Shaded( TTF_Font* font,
+                       const Uint16* text,
+                       SDL_Color fg,
+                       SDL_Color bg )
+{
+    SDL_Surface *surface = NULL;
+    Uint8 *utf8;
+
+    TTF_CHECKPOINTER(text, NULL);
+
+    utf8 = SDL_stack_alloc(Uint8, UCS2_len(text)*3+1);
+    if ( utf8 ) {
+        UCS2_to_UTF8(text, utf8);
+        surface = TTF_RenderUTF8_Shaded(font, (char *)utf8, fg, bg);
+        SDL_stack_free(utf8);
+    } else {
+        SDL_OutOfMemory();
+    }
+    return surface;
+}
+
+SDL_Surface* TTF_RenderGlyph_Shaded( TTF_Font* font,
+                     Uint16 ch,
+                     SDL_Color fg,
+                     SDL_Color bg )
+{
+    Uint16 ucs2[2] = { ch, 0 };
+    Uint8 utf8[4];
+
+    UCS2_to_UTF8(ucs2, utf8);
+    return TTF_RenderUTF8_Shaded(font, (char *)utf8, fg, bg);
+}
+
+SDL_Surface *TTF_RenderText_Blended(TTF_Font *font,
+                const char *text, SDL_Color fg)
+{
+    SDL_Surface *surface = NULL;
+    Uint8 *utf8;
+
+    TTF_CHECKPOINTER(text, NULL);
+
+    utf8 = SDL_stack_alloc(Uint8, SDL_strlen(text)*2+1);
+    if ( utf8 ) {
+        LATIN1_to_UTF8(text, utf8);
+        surface = TTF_RenderUTF8_Blended(font, (char *)utf8, fg);
+        SDL_stack_free(utf8);
+    } else {
+        SDL_OutOfMemory();
+    }
+    return surface;
+}
+
+SDL_Surface *TTF_RenderUTF8_Blended(TTF_Font *font,
+                const char *text, SDL_Color fg)
+{
+    TTF_Layout *layout;
+
+    TTF_CHECKPOINTER(text, NULL);
+
+    layout = TTF_FontLayout(font);
+    if ( !layout || Layout_SetText(layout, text) < 0 ) {
+        TTF_SetError("Text has zero width");
+        return(NULL);
+    }
+    return TTF_RenderLayout_Blended(layout, fg);
+}
+
+SDL_Surface *TTF_RenderUNICODE_Blended(TTF_Font *font,
+                const Uint16 *text, SDL_Color fg)
+{
+    SDL_Surface *surface = NULL;
+    Uint8 *utf8;
+
+    TTF_CHECKPOINTER(text, NULL);
+
+    utf8 = SDL_stack_alloc(Uint8, UCS2_len(text)*3+1);
+    if ( utf8 ) {
+        UCS2_to_UTF8(text, utf8);
+        surface = TTF_RenderUTF8_Blended(font, (char *)utf8, fg);
+        SDL_stack_free(utf8);
+    } else {
+        SDL_OutOfMemory();
+    }
+    return surface;
+}
+
+
+SDL_Surface *TTF_RenderText_Blended_Wrapped(TTF_Font *font, const char *text, SDL_Color fg, Uint32 wrapLength)
+{
+    SDL_Surface *surface = NULL;
+    Uint8 *utf8;
+
+    TTF_CHECKPOINTER(text, NULL);
+
+    utf8 = SDL_stack_alloc(Uint8, SDL_strlen(text)*2+1);
+    if ( utf8 ) {
+        LATIN1_to_UTF8(text, utf8);
+        surface = TTF_RenderUTF8_Blended_Wrapped(font, (char *)utf8, fg, wrapLength);
+        SDL_stack_free(utf8);
+    } else {
+        SDL_OutOfMemory();
+    }
+    return surface;
+}
+
+static SDL_bool CharacterIsDelimiter(char c, const char *delimiters)
+{
+    while (*delimiters) {
+        if (c == *delimiters) {
+            return SDL_TRUE;
+        }
+        ++delimiters;
+    }
+    return SDL_FALSE;
+}
+
+/* A line of wrapped text */
+typedef struct wrapped_line {
+    int offset;         /* byte offset of the line in the text */
+    int length;         /* bytes drawn, without the trailing whitespace */
+    int next;           /* byte offset of the line after it */
+    int width;
+    int height;
+} w_line;
+
+/* Text broken into lines, kept up to date as the text is edited */
+struct _TTF_WrappedText {
+    TTF_Font *font;
+    TTF_Layout *layout; /* measures and renders one line at a time */
+    Uint32 wrap_length;
+
+    char *text;
+    int textlen;
+    int maxtext;
+
+    w_line *lines;
+    int num_lines;
+    int max_lines;
+
+    /* The font state the lines were broken with */
+    SDL_bool wrapped;
+    Uint32 state;
+    int style;
+    int kerning;
+
+    int width;          /* of the widest line */
+    int line_height;    /* of the tallest line, every line gets it */
+};
+
+static const char *TTF_wrap_delims = " \t\r\n";
+
+static SDL_bool CharacterIsLineBreak(char c)
+{
+    return (c == '\r' || c == '\n');
+}
+
+static int Wrap_Reserve(TTF_WrappedText *wrap, int count)
+{
+    if ( count > wrap->max_lines ) {
+        int max_lines = wrap->max_lines ? wrap->max_lines : 16;
+        w_line *lines;
+
+        while ( max_lines < count ) {
+            max_lines *= 2;
+        }
+        lines = (w_line *)SDL_realloc(wrap->lines, max_lines * sizeof(*lines));
+        if ( lines == NULL ) {
+            TTF_SetError("Out of memory");
+            return -1;
+        }
+        wrap->lines = lines;
+        wrap->max_lines = max_lines;
+    }
+    return 0;
+}
+
+static int Wrap_AddLine(TTF_WrappedText *wrap, int offset, int length, int next)
+{
+    w_line *line;
+
+    if ( Wrap_Reserve(wrap, wrap->num_lines + 1) < 0 ) {
+        return -1;
+    }
+    if ( Layout_SetTextN(wrap->layout, wrap->text + offset, length) < 0 ) {
+        return -1;
+    }
+    line = &wrap->lines[wrap->num_lines++];
+    line->offset = offset;
+    line->length = length;
+    line->next = next;
+    line->width = wrap->layout->width;
+    line->height = wrap->layout->height;
+    return 0;
+}
+
+/* Break the paragraph starting at offset into lines, returns the offset
+   of the next paragraph or -1 on error
+*/
+static int Wrap_Paragraph(TTF_WrappedText *wrap, int offset)
+{
+    const char *text = wrap->text;
+    int end = offset;
+    int after;
+    int tok = offset;
+    int first;
+
+    /* The paragraph ends at the first CR, LF or CR LF */
+    while ( end < wrap->textlen && !CharacterIsLineBreak(text[end]) ) {
+        ++end;
+    }
+    after = end;
+    if ( after < wrap->textlen ) {
+        if ( text[after] == '\r' && text[after+1] == '\n' ) {
+            after += 2;
+        } else {
+            ++after;
+        }
+    }
+
+    /* Get the longest run of words that will fit in the desired space */
+    do {
+        int spot = end;
+        int next = after;
+
+        for ( ; ; ) {
+            /* Strip trailing whitespace */
+            while ( spot > tok && CharacterIsDelimiter(text[spot-1], TTF_wrap_delims) ) {
+                --spot;
+            }
+            if ( spot == tok || wrap->wrap_length == 0 ) {
+                break;
+            }
+            if ( Layout_SetTextN(wrap->layout, text + tok, spot - tok) < 0 ) {
+                return -1;
+            }
+            if ( (Uint32)wrap->layout->width <= wrap->wrap_length ) {
+                break;
+            }
+
+            /* Back up and try again... */
+            while ( spot > tok && !CharacterIsDelimiter(text[spot-1], TTF_wrap_delims) ) {
+                --spot;
+            }
+            first = tok;
+            while ( first < spot && CharacterIsDelimiter(text[first], TTF_wrap_delims) ) {
+                ++first;
+            }
+            if ( first < spot ) {
+                next = spot;
+                continue;
+            }
+
+            /* A word that does not fit gets a line of its own, without
+               the delimiters before it */
+            tok = spot;
+            while ( spot < end && !CharacterIsDelimiter(text[spot], TTF_wrap_delims) ) {
+                ++spot;
+            }
+            next = spot;
+            while ( next < end && CharacterIsDelimiter(text[next], TTF_wrap_delims) ) {
+                ++next;
+            }
+            if ( next == end ) {
+                next = after;
+            }
+            break;
+        }
+        if ( Wrap_AddLine(wrap, tok, spot - tok, next) < 0 ) {
+            return -1;
+        }
+        tok = next;
+    } while ( tok < end );
+
+    return after;
+}
+
+/* Break the text into lines, keeping the lines before offset as they
+   are, and the old lines of the last paragraphs when the text there
+   only moved by delta bytes
+*/
+static int Wrap_Lines(TTF_WrappedText *wrap, int offset, w_line *old_lines,
+                      int old_count, int suffix, int delta)
+{
+    int first = 0;
+    int i;
+
+    /* Restart from the paragraph holding offset */
+    while ( offset > 0 && CharacterIsLineBreak(wrap->text[offset-1]) ) {
+        --offset;
+    }
+    while ( offset > 0 && !CharacterIsLineBreak(wrap->text[offset-1]) ) {
+        --offset;
+    }
+    while ( first < old_count && old_lines[first].offset < offset ) {
+        ++first;
+    }
+    if ( old_lines != wrap->lines ) {
+        SDL_memcpy(wrap->lines, old_lines, first * sizeof(*old_lines));
+    }
+    wrap->num_lines = first;
+
+    while ( offset < wrap->textlen || wrap->num_lines == 0 ) {
+        offset = Wrap_Paragraph(wrap, offset);
+        if ( offset < 0 ) {
+            return -1;
+        }
+
+        /* The rest of the text did not change, neither do its lines */
+        if ( offset > 0 && offset - 1 >= wrap->textlen - suffix ) {
+            int old_offset = offset - delta;
+            int j = first;
+
+            while ( j < old_count && old_lines[j].offset < old_offset ) {
+                ++j;
+            }
+            if ( j < old_count && old_lines[j].offset == old_offset ) {
+                if ( Wrap_Reserve(wrap, wrap->num_lines + old_count - j) < 0 ) {
+                    return -1;
+                }
+                for ( ; j < old_count; ++j ) {
+                    w_line *line = &wrap->lines[wrap->num_lines++];
+
+                    *line = old_lines[j];
+                    line->offset += delta;
+                    line->next += delta;
+                }
+                break;
+            }
+        }
+        if ( offset >= wrap->textlen ) {
+            break;
+        }
+    }
+
+    wrap->width = 0;
+    wrap->line_height = wrap->font->height;
+    for ( i = 0; i < wrap->num_lines; ++i ) {
+        if ( wrap->lines[i].width > wrap->width ) {
+            wrap->width = wrap->lines[i].width;
+        }
+        if ( wrap->lines[i].height > wrap->line_height ) {
+            wrap->line_height = wrap->lines[i].height;
+        }
+    }
+    wrap->wrapped = SDL_TRUE;
+    wrap->state = wrap->font->glyph_state;
+    wrap->style = wrap->font->style;
+    wrap->kerning = wrap->font->kerning;
+    return 0;
+}
+
+static SDL_bool Wrap_IsCurrent(TTF_WrappedText *wrap)
+{
+    TTF_Font *font = wrap->font;
+
+    return ( wrap->wrapped &&
+             wrap->state == font->glyph_state &&
+             wrap->style == font->style &&
+             wrap->kerning == font->kerning );
+}
+
+/* Break all the lines again if the font style changed since */
+static int Wrap_Update(TTF_WrappedText *wrap)
+{
+    if ( Wrap_IsCurrent(wrap) ) {
+        return 0;
+    }
+    return Wrap_Lines(wrap, 0, wrap->lines, 0, 0, 0);
+}
+
+/* Blend count lines from first into a 32-bit surface, pitch rows apart */
+static int Render_Wrapped_Lines(TTF_WrappedText *wrap, SDL_Surface *textbuf,
+                                int first, int count, int pitch)
+{
+    int i;
+
+    for ( i = 0; i < count; ++i ) {
+        const w_line *line = &wrap->lines[first + i];
+
+        if ( Layout_SetTextN(wrap->layout, wrap->text + line->offset, line->length) < 0 ||
+             Render_Layout_32(wrap->layout, textbuf,
+                              (Uint32 *)textbuf->pixels + textbuf->pitch/4 * pitch * i) < 0 ) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+TTF_WrappedText *TTF_CreateWrappedText(TTF_Font *font, Uint32 wrapLength)
+{
+    TTF_WrappedText *wrap;
+
+    TTF_CHECKPOINTER(font, NULL);
+
+    wrap = (TTF_WrappedText *)SDL_calloc(1, sizeof(*wrap));
+    if ( wrap == NULL ) {
+        TTF_SetError("Out of memory");
+        return NULL;
+    }
+    wrap->font = font;
+    wrap->wrap_length = wrapLength;
+    wrap->layout = TTF_CreateLayout(font);
+    if ( wrap->layout == NULL ) {
+        SDL_free(wrap);
+        return NULL;
+    }
+    if ( TTF_SetWrappedTextUTF8(wrap, "") < 0 ) {
+        TTF_FreeWrappedText(wrap);
+        return NULL;
+    }
+    return wrap;
+}
+
+void TTF_FreeWrappedText(TTF_WrappedText *wrap)
+{
+    if ( wrap == NULL ) {
+        return;
+    }
+    TTF_FreeLayout(wrap->layout);
+    SDL_free(wrap->text);
+    SDL_free(wrap->lines);
+    SDL_free(wrap);
+}
+
+int TTF_SetWrappedTextUTF8(TTF_WrappedText *wrap, const char *text)
+{
+    int textlen;
+    int prefix = 0;
+    int suffix = 0;
+    int old_textlen;
+    w_line *old_lines;
+    int old_count;
+    int status;
+
+    TTF_CHECKPOINTER(wrap, -1);
+    TTF_CHECKPOINTER(text, -1);
+
+    textlen = (int)SDL_strlen(text);
+    old_textlen = wrap->textlen;
+    if ( wrap->text ) {
+        /* Only the lines from the first edited paragraph on change */
+        while ( prefix < textlen && prefix < old_textlen && text[prefix] == wrap->text[prefix] ) {
+            ++prefix;
+        }
+        if ( prefix == textlen && prefix == old_textlen ) {
+            return Wrap_Update(wrap);
+        }
+        while ( suffix < textlen - prefix && suffix < old_textlen - prefix &&
+                text[textlen-1-suffix] == wrap->text[old_textlen-1-suffix] ) {
+            ++suffix;
+        }
+    }
+
+    if ( textlen + 1 > wrap->maxtext ) {
+        char *copy = (char *)SDL_realloc(wrap->text, textlen + 1);
+
+        if ( copy == NULL ) {
+            TTF_SetError("Out of memory");
+            return -1;
+        }
+        wrap->text = copy;
+        wrap->maxtext = textlen + 1;
+    }
+    SDL_memcpy(wrap->text, text, textlen + 1);
+    wrap->textlen = textlen;
+
+    if ( !Wrap_IsCurrent(wrap) ) {
+        return Wrap_Lines(wrap, 0, wrap->lines, 0, 0, 0);
+    }
+
+    /* The lines after the edit are copied back from the old ones */
+    old_count = wrap->num_lines;
+    old_lines = (w_line *)SDL_malloc(old_count * sizeof(*old_lines) + 1);
+    if ( old_lines == NULL ) {
+        TTF_SetError("Out of memory");
+        return -1;
+    }
+    SDL_memcpy(old_lines, wrap->lines, old_count * sizeof(*old_lines));
+    status = Wrap_Lines(wrap, prefix, old_lines, old_count, suffix, textlen - old_textlen);
+    SDL_free(old_lines);
+    return status;
+}
+
+int TTF_SetWrappedTextLength(TTF_WrappedText *wrap, Uint32 wrapLength)
+{
+    TTF_CHECKPOINTER(wrap, -1);
+
+    if ( wrapLength != wrap->wrap_length ) {
+        wrap->wrap_length = wrapLength;
+        wrap->wrapped = SDL_FALSE;
+    }
+    return Wrap_Update(wrap);
+}
+
+int TTF_GetWrappedTextLines(TTF_WrappedText *wrap)
+{
+    TTF_CHECKPOINTER(wrap, -1);
+
+    if ( Wrap_Update(wrap) < 0 ) {
+        return -1;
+    }
+    return wrap->num_lines;
+}
+
+int TTF_GetWrappedTextLine(TTF_WrappedText *wrap, int line, SDL_Rect *box, int *offset, int *length)
+{
+    TTF_CHECKPOINTER(wrap, -1);
+
+    if ( Wrap_Update(wrap) < 0 ) {
+        return -1;
+    }
+    if ( line < 0 || line >= wrap->num_lines ) {
+        TTF_SetError("Line out of range");
+        return -1;
+    }
+    if ( box ) {
+        box->x = 0;
+        box->y = line * wrap->line_height;
+        box->w = wrap->lines[line].width;
+        box->h = wrap->line_height;
+    }
+    if ( offset ) {
+        *offset = wrap->lines[line].offset;
+    }
+    if ( length ) {
+        *length = wrap->lines[line].length;
+    }
+    return 0;
+}
+
+int TTF_SizeWrappedText(TTF_WrappedText *wrap, int *w, int *h)
+{
+    TTF_CHECKPOINTER(wrap, -1);
+
+    if ( Wrap_Update(wrap) < 0 ) {
+        return -1;
+    }
+    if ( w ) {
+        *w = wrap->wrap_length ? (int)wrap->wrap_length : wrap->width;
+    }
+    if ( h ) {
+        *h = wrap->num_lines * wrap->line_height;
+    }
+    return 0;
+}
+
+SDL_Surface *TTF_RenderWrappedText_Blended(TTF_WrappedText *wrap, int first_line,
+                                           int num_lines, SDL_Color fg)
+{
+    SDL_Surface *textbuf;
+    Uint32 pixel;
+    int width;
+
+    TTF_CHECKPOINTER(wrap, NULL);
+
+    if ( Wrap_Update(wrap) < 0 ) {
+        return NULL;
+    }
+    if ( first_line < 0 ) {
+        first_line = 0;
+    }
+    if ( num_lines < 0 || first_line + num_lines > wrap->num_lines ) {
+        num_lines = wrap->num_lines - first_line;
+    }
+    width = wrap->wrap_length ? (int)wrap->wrap_length : wrap->width;
+    if ( num_lines <= 0 || !width ) {
+        TTF_SetError("Text has zero width");
+        return NULL;
+    }
+
+    textbuf = SDL_CreateRGBSurface(SDL_SWSURFACE, width, wrap->line_height * num_lines,
+                                   32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
+    if ( textbuf == NULL ) {
+        return NULL;
+    }
+    pixel = (fg.r<<16)|(fg.g<<8)|fg.b;
+    SDL_FillRect(textbuf, NULL, pixel); /* Initialize with fg and 0 alpha */
+    if ( Render_Wrapped_Lines(wrap, textbuf, first_line, num_lines, wrap->line_height) < 0 ) {
+        SDL_FreeSurface(textbuf);
+        return NULL;
+    }
+    return textbuf;
+}
 
 SDL_Surface *TTF_RenderUTF8_Blended_Wrapped(TTF_Font *font,
                                     const char *text, SDL_Color fg, Uint32 wrapLength)
 {
-    SDL_bool first;
-    int xstart;
-    int width, height;
+    int width, height;
+    SDL_Surface *textbuf;
+    TTF_WrappedText *wrap = NULL;
+    TTF_Layout *layout;
+    Uint32 pixel;
+    const int lineSpace = 2;
+    int numLines, status;
+
+    TTF_CHECKPOINTER(text, NULL);
+
+    /* Get the dimensions of the text surface */
+    if ( (TTF_SizeUTF8(font, text, &width, &height) < 0) || !width ) {
+        TTF_SetError("Text has zero width");
+        return(NULL);
+    }
+
+    /* Text rendered again with a few changes is only wrapped again there */
+    numLines = 1;
+    if ( wrapLength > 0 && *text ) {
+        wrap = TTF_FontWrap(font);
+        if ( wrap == NULL ||
+             TTF_SetWrappedTextLength(wrap, wrapLength) < 0 ||
+             TTF_SetWrappedTextUTF8(wrap, text) < 0 ) {
+            return(NULL);
+        }
+        numLines = wrap->num_lines;
+    }
+
+    /* Create the target surface */
+    textbuf = SDL_CreateRGBSurface(SDL_SWSURFACE,
+            (numLines > 1) ? wrapLength : width,
+            height * numLines + (lineSpace * (numLines - 1)),
+            32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
+    if ( textbuf == NULL ) {
+        return(NULL);
+    }
+
+    /* Load and render each character */
+    pixel = (fg.r<<16)|(fg.g<<8)|fg.b;
+    SDL_FillRect(textbuf, NULL, pixel); /* Initialize with fg and 0 alpha */
+
+    if ( wrap ) {
+        status = Render_Wrapped_Lines(wrap, textbuf, 0, numLines, height);
+    } else {
+        layout = TTF_FontLayout(font);
+        status = ( layout && Layout_SetText(layout, text) == 0 ) ?
+            Render_Layout_32(layout, textbuf, (Uint32 *)textbuf->pixels) : -1;
+    }
+    if ( status < 0 ) {
+        SDL_FreeSurface( textbuf );
+        return NULL;
+    }
+    return(textbuf);
+}
+
+SDL_Surface *TTF_RenderUNICODE_Blended_Wrapped(TTF_Font *font, const Uint16* text,
+                                               SDL_Color fg, Uint32 wrapLength)
+{
+    SDL_Surface *surface = NULL;
+    Uint8 *utf8;
+
+    TTF_CHECKPOINTER(text, NULL);
+
+    utf8 = SDL_stack_alloc(Uint8, UCS2_len(text)*3+1);
+    if ( utf8 ) {
+        UCS2_to_UTF8(text, utf8);
+        surface = TTF_RenderUTF8_Blended_Wrapped(font, (char *)utf8, fg, wrapLength);
+        SDL_stack_free(utf8);
+    } else {
+        SDL_OutOfMemory();
+    }
+    return surface;
+}
+
+SDL_Surface *TTF_RenderGlyph_Blended(TTF_Font *font, Uint16 ch, SDL_Color fg)
+{
+    Uint16 ucs2[2] = { ch, 0 };
+    Uint8 utf8[4];
+
+    UCS2_to_UTF8(ucs2, utf8);
+    return TTF_RenderUTF8_Blended(font, (char *)utf8, fg);
+}
+
+/* The render modes a text cache entry can hold */
+#define TEXT_CACHE_SOLID    0
+#define TEXT_CACHE_SHADED   1
+#define TEXT_CACHE_BLENDED  2
+#define TEXT_CACHE_TEXTURE  3
+
+/* A rendered string and everything it was rendered with */
+typedef struct cached_text {
+    Uint32 hash;
+    Uint32 font_id;
+    Uint32 state;
+    int style;
+    int kerning;
+    int mode;
+    SDL_Color fg;
+    SDL_Color bg;
+    SDL_Renderer *renderer;
+    char *text;
+
+    SDL_Surface *surface;
+    SDL_Texture *texture;
+    int surface_refs;
+    int texture_refs;
+    size_t bytes;
+
+    struct cached_text *chain;      /* next entry in the hash bucket */
+    struct cached_text *prev;       /* LRU list, most recently used first */
+    struct cached_text *next;
+} t_text;
+
+struct _TTF_TextCache {
+    t_text **buckets;
+    Uint32 buckets_mask;
+    int count;
+    t_text *head;
+    t_text *tail;
+    size_t bytes;
+    size_t max_bytes;
+    Uint32 hits;
+    Uint32 misses;
+    Uint32 evictions;
+    SDL_mutex *lock;
+};
+
+#define TEXT_CACHE_BUCKETS  64
+
+static Uint32 TextCache_Hash(TTF_Font *font, int mode, const char *text,
+                             SDL_Color fg, SDL_Color bg)
+{
+    /* FNV-1a over the text, then the rest of the key */
+    Uint32 hash = 2166136261u;
+    const Uint8 *p;
+
+    for ( p = (const Uint8 *)text; *p; ++p ) {
+        hash = (hash ^ *p) * 16777619u;
+    }
+    hash = (hash ^ font->id) * 16777619u;
+    hash = (hash ^ font->glyph_state) * 16777619u;
+    hash = (hash ^ (Uint32)font->style) * 16777619u;
+    hash = (hash ^ (Uint32)mode) * 16777619u;
+    hash = (hash ^ ((fg.r << 24) | (fg.g << 16) | (fg.b << 8) | fg.a)) * 16777619u;
+    hash = (hash ^ ((bg.r << 24) | (bg.g << 16) | (bg.b << 8) | bg.a)) * 16777619u;
+    return hash;
+}
+
+static SDL_bool TextCache_SameColor(SDL_Color a, SDL_Color b)
+{
+    return (a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a);
+}
+
+static void TextCache_Unlink(TTF_TextCache *cache, t_text *entry)
+{
+    if ( entry->prev ) {
+        entry->prev->next = entry->next;
+    } else {
+        cache->head = entry->next;
+    }
+    if ( entry->next ) {
+        entry->next->prev = entry->prev;
+    } else {
+        cache->tail = entry->prev;
+    }
+    entry->prev = entry->next = NULL;
+}
+
+static void TextCache_PushFront(TTF_TextCache *cache, t_text *entry)
+{
+    entry->prev = NULL;
+    entry->next = cache->head;
+    if ( cache->head ) {
+        cache->head->prev = entry;
+    } else {
+        cache->tail = entry;
+    }
+    cache->head = entry;
+}
+
+static void TextCache_Free(TTF_TextCache *cache, t_text *entry)
+{
+    t_text **link = &cache->buckets[entry->hash & cache->buckets_mask];
+
+    while ( *link != entry ) {
+        link = &(*link)->chain;
+    }
+    *link = entry->chain;
+    TextCache_Unlink(cache, entry);
+
+    if ( entry->surface ) {
+        SDL_FreeSurface(entry->surface);
+    }
+    if ( entry->texture ) {
+        SDL_DestroyTexture(entry->texture);
+    }
+    cache->bytes -= entry->bytes;
+    --cache->count;
+    SDL_free(entry->text);
+    SDL_free(entry);
+}
+
+/* Drop least recently used entries nobody holds until we fit the budget */
+static void TextCache_Trim(TTF_TextCache *cache)
+{
+    t_text *entry = cache->tail;
+
+    while ( entry && cache->bytes > cache->max_bytes ) {
+        t_text *prev = entry->prev;
+
+        if ( entry->surface_refs == 0 && entry->texture_refs == 0 ) {
+            TextCache_Free(cache, entry);
+            ++cache->evictions;
+        }
+        entry = prev;
+    }
+}
+
+static void TextCache_Grow(TTF_TextCache *cache)
+{
+    Uint32 size = (cache->buckets_mask + 1) * 2;
+    t_text **buckets;
+    Uint32 i;
+
+    buckets = (t_text **)SDL_calloc(size, sizeof(*buckets));
+    if ( buckets == NULL ) {
+        /* Longer chains, but still correct */
+        return;
+    }
+    for ( i = 0; i <= cache->buckets_mask; ++i ) {
+        t_text *entry = cache->buckets[i];
+
+        while ( entry ) {
+            t_text *chain = entry->chain;
+
+            entry->chain = buckets[entry->hash & (size - 1)];
+            buckets[entry->hash & (size - 1)] = entry;
+            entry = chain;
+        }
+    }
+    SDL_free(cache->buckets);
+    cache->buckets = buckets;
+    cache->buckets_mask = size - 1;
+}
+
+/* Find a cached entry, with the cache locked */
+static t_text *TextCache_Find(TTF_TextCache *cache, Uint32 hash, SDL_Renderer *renderer,
+                              TTF_Font *font, int mode, const char *text,
+                              SDL_Color fg, SDL_Color bg)
+{
+    t_text *entry;
+
+    for ( entry = cache->buckets[hash & cache->buckets_mask]; entry; entry = entry->chain ) {
+        if ( entry->hash == hash &&
+             entry->font_id == font->id &&
+             entry->state == font->glyph_state &&
+             entry->style == font->style &&
+             entry->kerning == font->kerning &&
+             entry->mode == mode &&
+             entry->renderer == renderer &&
+             TextCache_SameColor(entry->fg, fg) &&
+             TextCache_SameColor(entry->bg, bg) &&
+             SDL_strcmp(entry->text, text) == 0 ) {
+            if ( entry != cache->head ) {
+                TextCache_Unlink(cache, entry);
+                TextCache_PushFront(cache, entry);
+            }
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+/* Free an entry that never made it into the cache */
+static void TextCache_Discard(t_text *entry)
+{
+    if ( entry->surface ) {
+        SDL_FreeSurface(entry->surface);
+    }
+    if ( entry->texture ) {
+        SDL_DestroyTexture(entry->texture);
+    }
+    SDL_free(entry->text);
+    SDL_free(entry);
+}
+
+/* Render an entry for the text, without the cache locked */
+static t_text *TextCache_Render(Uint32 hash, SDL_Renderer *renderer,
+                                TTF_Font *font, int mode, const char *text,
+                                SDL_Color fg, SDL_Color bg)
+{
+    t_text *entry;
+    SDL_Surface *surface;
+
+    switch (mode) {
+        case TEXT_CACHE_SOLID:
+            surface = TTF_RenderUTF8_Solid(font, text, fg);
+            break;
+        case TEXT_CACHE_SHADED:
+            surface = TTF_RenderUTF8_Shaded(font, text, fg, bg);
+            break;
+        default:
+            surface = TTF_RenderUTF8_Blended(font, text, fg);
+            break;
+    }
+    if ( surface == NULL ) {
+        return NULL;
+    }
+
+    entry = (t_text *)SDL_calloc(1, sizeof(*entry));
+    if ( entry ) {
+        entry->text = SDL_strdup(text);
+    }
+    if ( entry == NULL || entry->text == NULL ) {
+        SDL_free(entry);
+        SDL_FreeSurface(surface);
+        TTF_SetError("Out of memory");
+        return NULL;
+    }
+    entry->hash = hash;
+    entry->font_id = font->id;
+    entry->state = font->glyph_state;
+    entry->style = font->style;
+    entry->kerning = font->kerning;
+    entry->mode = mode;
+    entry->fg = fg;
+    entry->bg = bg;
+    entry->renderer = renderer;
+
+    if ( mode == TEXT_CACHE_TEXTURE ) {
+        entry->texture = SDL_CreateTextureFromSurface(renderer, surface);
+        entry->bytes = (size_t)surface->w * surface->h * 4;
+        SDL_FreeSurface(surface);
+        if ( entry->texture == NULL ) {
+            TTF_SetError(SDL_GetError());
+            TextCache_Discard(entry);
+            return NULL;
+        }
+    } else {
+        entry->surface = surface;
+        entry->bytes = (size_t)surface->pitch * surface->h;
+    }
+    return entry;
+}
+
+/* Find the entry for the text, rendering it if it isn't cached yet.
+   The cache is locked on return, whether or not an entry was found.
+   Text is rendered with the cache unlocked, so other threads can use it
+   meanwhile, and if one of them cached the same text first theirs is kept.
+ */
+static t_text *TextCache_Lookup(TTF_TextCache *cache, SDL_Renderer *renderer,
+                                TTF_Font *font, int mode, const char *text,
+                                SDL_Color fg, SDL_Color bg)
+{
+    Uint32 hash;
+    t_text *entry;
+    t_text *rendered;
+
+    hash = TextCache_Hash(font, mode, text, fg, bg);
+    SDL_LockMutex(cache->lock);
+    entry = TextCache_Find(cache, hash, renderer, font, mode, text, fg, bg);
+    if ( entry ) {
+        ++cache->hits;
+        return entry;
+    }
+    ++cache->misses;
+    SDL_UnlockMutex(cache->lock);
+
+    rendered = TextCache_Render(hash, renderer, font, mode, text, fg, bg);
+
+    SDL_LockMutex(cache->lock);
+    if ( rendered == NULL ) {
+        return NULL;
+    }
+    entry = TextCache_Find(cache, hash, renderer, font, mode, text, fg, bg);
+    if ( entry ) {
+        TextCache_Discard(rendered);
+        return entry;
+    }
+    entry = rendered;
+    if ( cache->count >= 2 * (int)(cache->buckets_mask + 1) ) {
+        TextCache_Grow(cache);
+    }
+    entry->chain = cache->buckets[hash & cache->buckets_mask];
+    cache->buckets[hash & cache->buckets_mask] = entry;
+    TextCache_PushFront(cache, entry);
+    cache->bytes += entry->bytes;
+    ++cache->count;
+    return entry;
+}
+
+TTF_TextCache *TTF_CreateTextCache(size_t max_bytes)
+{
+    TTF_TextCache *cache;
+
+    cache = (TTF_TextCache *)SDL_calloc(1, sizeof(*cache));
+    if ( cache == NULL ) {
+        TTF_SetError("Out of memory");
+        return NULL;
+    }
+    cache->buckets = (t_text **)SDL_calloc(TEXT_CACHE_BUCKETS, sizeof(*cache->buckets));
+    if ( cache->buckets == NULL ) {
+        SDL_free(cache);
+        TTF_SetError("Out of memory");
+        return NULL;
+    }
+    cache->lock = SDL_CreateMutex();
+    if ( cache->lock == NULL ) {
+        SDL_free(cache->buckets);
+        SDL_free(cache);
+        TTF_SetError("Couldn't create mutex");
+        return NULL;
+    }
+    cache->buckets_mask = TEXT_CACHE_BUCKETS - 1;
+    cache->max_bytes = max_bytes;
+    return cache;
+}
+
+void TTF_ClearTextCache(TTF_TextCache *cache)
+{
+    if ( cache == NULL ) {
+        return;
+    }
+    /* Surfaces still held by callers live on until they release them */
+    SDL_LockMutex(cache->lock);
+    while ( cache->head ) {
+        if ( cache->head->surface ) {
+            cache->head->surface->refcount += cache->head->surface_refs;
+        }
+        TextCache_Free(cache, cache->head);
+    }
+    SDL_UnlockMutex(cache->lock);
+}
+
+void TTF_DestroyTextCache(TTF_TextCache *cache)
+{
+    if ( cache == NULL ) {
+        return;
+    }
+    TTF_ClearTextCache(cache);
+    SDL_DestroyMutex(cache->lock);
+    SDL_free(cache->buckets);
+    SDL_free(cache);
+}
+
+static SDL_Surface *TextCache_Surface(TTF_TextCache *cache, TTF_Font *font, int mode,
+                                      const char *text, SDL_Color fg, SDL_Color bg)
+{
+    t_text *entry;
+    SDL_Surface *surface;
+
+    if ( cache == NULL ) {
+        switch (mode) {
+            case TEXT_CACHE_SOLID:
+                return TTF_RenderUTF8_Solid(font, text, fg);
+            case TEXT_CACHE_SHADED:
+                return TTF_RenderUTF8_Shaded(font, text, fg, bg);
+            default:
+                return TTF_RenderUTF8_Blended(font, text, fg);
+        }
+    }
+
+    TTF_CHECKPOINTER(font, NULL);
+    TTF_CHECKPOINTER(text, NULL);
+
+    entry = TextCache_Lookup(cache, NULL, font, mode, text, fg, bg);
+    if ( entry == NULL ) {
+        SDL_UnlockMutex(cache->lock);
+        return NULL;
+    }
+    /* Take the caller's reference before trimming, so it survives */
+    ++entry->surface_refs;
+    surface = entry->surface;
+    TextCache_Trim(cache);
+    SDL_UnlockMutex(cache->lock);
+    return surface;
+}
+
+SDL_Surface *TTF_CacheUTF8_Solid(TTF_TextCache *cache, TTF_Font *font,
+                                 const char *text, SDL_Color fg)
+{
+    SDL_Color none = { 0, 0, 0, 0 };
+
+    return TextCache_Surface(cache, font, TEXT_CACHE_SOLID, text, fg, none);
+}
+
+SDL_Surface *TTF_CacheUTF8_Shaded(TTF_TextCache *cache, TTF_Font *font,
+                                  const char *text, SDL_Color fg, SDL_Color bg)
+{
+    return TextCache_Surface(cache, font, TEXT_CACHE_SHADED, text, fg, bg);
+}
+
+SDL_Surface *TTF_CacheUTF8_Blended(TTF_TextCache *cache, TTF_Font *font,
+                                   const char *text, SDL_Color fg)
+{
+    SDL_Color none = { 0, 0, 0, 0 };
+
+    return TextCache_Surface(cache, font, TEXT_CACHE_BLENDED, text, fg, none);
+}
+
+SDL_Texture *TTF_CacheUTF8_Texture(TTF_TextCache *cache, SDL_Renderer *renderer,
+                                   TTF_Font *font, const char *text, SDL_Color fg)
+{
+    SDL_Color none = { 0, 0, 0, 0 };
+    t_text *entry;
+    SDL_Texture *texture;
+
+    TTF_CHECKPOINTER(cache, NULL);
+    TTF_CHECKPOINTER(renderer, NULL);
+    TTF_CHECKPOINTER(font, NULL);
+    TTF_CHECKPOINTER(text, NULL);
+
+    entry = TextCache_Lookup(cache, renderer, font, TEXT_CACHE_TEXTURE, text, fg, none);
+    if ( entry == NULL ) {
+        SDL_UnlockMutex(cache->lock);
+        return NULL;
+    }
+    ++entry->texture_refs;
+    texture = entry->texture;
+    TextCache_Trim(cache);
+    SDL_UnlockMutex(cache->lock);
+    return texture;
+}
+
+void TTF_ReleaseCachedSurface(TTF_TextCache *cache, SDL_Surface *surface)
+{
+    t_text *entry;
+
+    if ( surface == NULL ) {
+        return;
+    }
+    if ( cache == NULL ) {
+        SDL_FreeSurface(surface);
+        return;
+    }
+    /* The surface refcount is only touched under the lock, so threads
+       sharing the cache can't race on it */
+    SDL_LockMutex(cache->lock);
+    for ( entry = cache->head; entry; entry = entry->next ) {
+        if ( entry->surface == surface ) {
+            if ( entry->surface_refs > 0 ) {
+                --entry->surface_refs;
+            }
+            break;
+        }
+    }
+    if ( entry == NULL ) {
+        /* Held across TTF_ClearTextCache(), the caller owns a reference */
+        SDL_FreeSurface(surface);
+    }
+    TextCache_Trim(cache);
+    SDL_UnlockMutex(cache->lock);
+}
+
+void TTF_ReleaseCachedTexture(TTF_TextCache *cache, SDL_Texture *texture)
+{
+    t_text *entry;
+
+    if ( cache == NULL || texture == NULL ) {
+        return;
+    }
+    SDL_LockMutex(cache->lock);
+    for ( entry = cache->head; entry; entry = entry->next ) {
+        if ( entry->texture == texture ) {
+            if ( entry->texture_refs > 0 ) {
+                --entry->texture_refs;
+            }
+            break;
+        }
+    }
+    TextCache_Trim(cache);
+    SDL_UnlockMutex(cache->lock);
+}
+
+void TTF_GetTextCacheStats(const TTF_TextCache *cache, Uint32 *hits,
+                           Uint32 *misses, Uint32 *evictions, size_t *bytes)
+{
+    if ( cache ) {
+        SDL_LockMutex(cache->lock);
+    }
+    if ( hits ) {
+        *hits = cache ? cache->hits : 0;
+    }
+    if ( misses ) {
+        *misses = cache ? cache->misses : 0;
+    }
+    if ( evictions ) {
+        *evictions = cache ? cache->evictions : 0;
+    }
+    if ( bytes ) {
+        *bytes = cache ? cache->bytes : 0;
+    }
+    if ( cache ) {
+        SDL_UnlockMutex(cache->lock);
+    }
+}
+
+/* Signed distance field glyphs */
+#define SDF_ATLAS_MIN_WIDTH 256
+#define SDF_INF             1e20f
+
+/* Where a glyph's distance field sits in the atlas, and how to place it */
+typedef struct sdf_glyph {
+    Uint32 ch;
+    SDL_bool used;
+    SDL_Rect rect;      /* the field, spread pixels bigger than the glyph on each side */
+    int minx;
+    int yoffset;
+} s_glyph;
+
+struct _TTF_SDFAtlas {
+    TTF_Font *font;
+    int spread;
+    Uint32 state;       /* the glyph state of the font the fields were built with */
+
+    s_glyph *glyphs;    /* open addressing, keyed by character */
+    int num_glyphs;
+    int max_glyphs;
+
+    SDL_Surface *surface;
+    int shelf_x;        /* next free position on the current shelf */
+    int shelf_y;
+    int shelf_h;
+
+    /* Scratch space for the distance transform */
+    float *outside;
+    float *inside;
+    float *f;
+    float *d;
+    float *z;
+    int *v;
+    int scratch_size;
+    int scratch_line;
+};
+
+/* Squared distance to the nearest feature along one line, after
+   Felzenszwalb and Huttenlocher, "Distance Transforms of Sampled Functions"
+*/
+static void SDF_Transform1D(const float *f, float *d, int *v, float *z, int n)
+{
+    int k = 0;
+    int q;
+    float s;
+
+    v[0] = 0;
+    z[0] = -SDF_INF;
+    z[1] = SDF_INF;
+    for ( q = 1; q < n; ++q ) {
+        s = ((f[q] + (float)(q * q)) - (f[v[k]] + (float)(v[k] * v[k]))) / (float)(2 * q - 2 * v[k]);
+        while ( s <= z[k] ) {
+            --k;
+            s = ((f[q] + (float)(q * q)) - (f[v[k]] + (float)(v[k] * v[k]))) / (float)(2 * q - 2 * v[k]);
+        }
+        ++k;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = SDF_INF;
+    }
+    k = 0;
+    for ( q = 0; q < n; ++q ) {
+        while ( z[k + 1] < (float)q ) {
+            ++k;
+        }
+        d[q] = (float)((q - v[k]) * (q - v[k])) + f[v[k]];
+    }
+}
+
+static void SDF_Transform2D(TTF_SDFAtlas *atlas, float *grid, int w, int h)
+{
+    int x, y;
+
+    for ( x = 0; x < w; ++x ) {
+        for ( y = 0; y < h; ++y ) {
+            atlas->f[y] = grid[y * w + x];
+        }
+        SDF_Transform1D(atlas->f, atlas->d, atlas->v, atlas->z, h);
+        for ( y = 0; y < h; ++y ) {
+            grid[y * w + x] = atlas->d[y];
+        }
+    }
+    for ( y = 0; y < h; ++y ) {
+        SDL_memcpy(atlas->f, grid + y * w, w * sizeof(float));
+        SDF_Transform1D(atlas->f, atlas->d, atlas->v, atlas->z, w);
+        SDL_memcpy(grid + y * w, atlas->d, w * sizeof(float));
+    }
+}
+
+static int SDF_Reserve(TTF_SDFAtlas *atlas, int w, int h)
+{
+    int size = w * h;
+    int line = SDL_max(w, h) + 1;
+
+    if ( size > atlas->scratch_size ) {
+        float *outside = (float *)SDL_realloc(atlas->outside, size * sizeof(float));
+        float *inside;
+
+        if ( outside == NULL ) {
+            TTF_SetError("Out of memory");
+            return -1;
+        }
+        atlas->outside = outside;
+        inside = (float *)SDL_realloc(atlas->inside, size * sizeof(float));
+        if ( inside == NULL ) {
+            TTF_SetError("Out of memory");
+            return -1;
+        }
+        atlas->inside = inside;
+        atlas->scratch_size = size;
+    }
+    if ( line > atlas->scratch_line ) {
+        float *f = (float *)SDL_realloc(atlas->f, line * sizeof(float));
+        float *d = f ? (float *)SDL_realloc(atlas->d, line * sizeof(float)) : NULL;
+        float *z = d ? (float *)SDL_realloc(atlas->z, (line + 1) * sizeof(float)) : NULL;
+        int *v = z ? (int *)SDL_realloc(atlas->v, line * sizeof(int)) : NULL;
+
+        if ( f ) {
+            atlas->f = f;
+        }
+        if ( d ) {
+            atlas->d = d;
+        }
+        if ( z ) {
+            atlas->z = z;
+        }
+        if ( v == NULL ) {
+            TTF_SetError("Out of memory");
+            return -1;
+        }
+        atlas->v = v;
+        atlas->scratch_line = line;
+    }
+    return 0;
+}
+
+/* Build the distance field of a coverage pixmap into dst, which has room
+   for the pixmap and spread pixels around it.  128 is the outline, more
+   is inside the glyph and 0 or 255 are spread pixels away from it.
+*/
+static int SDF_Build(TTF_SDFAtlas *atlas, const FT_Bitmap *pixmap, int width,
+                     Uint8 *dst, int dst_pitch)
+{
+    int spread = atlas->spread;
+    int w = width + 2 * spread;
+    int h = pixmap->rows + 2 * spread;
+    int x, y;
+
+    if ( SDF_Reserve(atlas, w, h) < 0 ) {
+        return -1;
+    }
+
+    for ( y = 0; y < h; ++y ) {
+        for ( x = 0; x < w; ++x ) {
+            int px = x - spread;
+            int py = y - spread;
+            Uint8 c = 0;
+
+            if ( px >= 0 && px < width && py >= 0 && py < pixmap->rows ) {
+                c = pixmap->buffer[py * pixmap->pitch + px];
+            }
+            atlas->outside[y * w + x] = (c >= NUM_GRAYS / 2) ? 0.0f : SDF_INF;
+            atlas->inside[y * w + x] = (c >= NUM_GRAYS / 2) ? SDF_INF : 0.0f;
+        }
+    }
+    SDF_Transform2D(atlas, atlas->outside, w, h);
+    SDF_Transform2D(atlas, atlas->inside, w, h);
+
+    for ( y = 0; y < h; ++y ) {
+        Uint8 *row = dst + y * dst_pitch;
+
+        for ( x = 0; x < w; ++x ) {
+            int px = x - spread;
+            int py = y - spread;
+            int c = 0;
+            float dist;
+            float value;
+
+            if ( px >= 0 && px < width && py >= 0 && py < pixmap->rows ) {
+                c = pixmap->buffer[py * pixmap->pitch + px];
+            }
+            if ( c > 0 && c < NUM_GRAYS - 1 ) {
+                /* Antialiased pixels say how far the edge is better than the grid */
+                dist = 0.5f - (float)c / (NUM_GRAYS - 1);
+            } else if ( atlas->outside[y * w + x] > 0.0f ) {
+                dist = SDL_sqrtf(atlas->outside[y * w + x]) - 0.5f;
+            } else {
+                dist = 0.5f - SDL_sqrtf(atlas->inside[y * w + x]);
+            }
+            value = 128.0f - dist * 127.0f / (float)spread;
+            if ( value < 0.0f ) {
+                value = 0.0f;
+            } else if ( value > 255.0f ) {
+                value = 255.0f;
+            }
+            row[x] = (Uint8)(value + 0.5f);
+        }
+    }
+    return 0;
+}
+
+/* Find room for a w by h field on the shelves, growing the atlas down */
+static int SDF_Pack(TTF_SDFAtlas *atlas, int w, int h, SDL_Rect *rect)
+{
+    SDL_Surface *surface = atlas->surface;
+
+    if ( w > surface->w ) {
+        TTF_SetError("Glyph too wide for the atlas");
+        return -1;
+    }
+    if ( atlas->shelf_x + w > surface->w ) {
+        atlas->shelf_x = 0;
+        atlas->shelf_y += atlas->shelf_h;
+        atlas->shelf_h = 0;
+    }
+    if ( atlas->shelf_y + h > surface->h ) {
+        int height = surface->h;
+        SDL_Surface *grown;
+        int y;
+
+        while ( atlas->shelf_y + h > height ) {
+            height *= 2;
+        }
+        grown = SDL_CreateRGBSurface(SDL_SWSURFACE, surface->w, height, 8, 0, 0, 0, 0);
+        if ( grown == NULL ) {
+            return -1;
+        }
+        SDL_SetPaletteColors(grown->format->palette, surface->format->palette->colors, 0, 256);
+        SDL_memset(grown->pixels, 0, grown->pitch * grown->h);
+        for ( y = 0; y < surface->h; ++y ) {
+            SDL_memcpy((Uint8 *)grown->pixels + y * grown->pitch,
+                       (Uint8 *)surface->pixels + y * surface->pitch, surface->w);
+        }
+        SDL_FreeSurface(surface);
+        atlas->surface = surface = grown;
+    }
+    rect->x = atlas->shelf_x;
+    rect->y = atlas->shelf_y;
+    rect->w = w;
+    rect->h = h;
+    atlas->shelf_x += w;
+    if ( h > atlas->shelf_h ) {
+        atlas->shelf_h = h;
+    }
+    return 0;
+}
+
+static void SDF_Flush(TTF_SDFAtlas *atlas)
+{
+    SDL_memset(atlas->glyphs, 0, atlas->max_glyphs * sizeof(*atlas->glyphs));
+    atlas->num_glyphs = 0;
+    atlas->shelf_x = 0;
+    atlas->shelf_y = 0;
+    atlas->shelf_h = 0;
+    SDL_memset(atlas->surface->pixels, 0, atlas->surface->pitch * atlas->surface->h);
+    atlas->state = atlas->font->glyph_state;
+}
+
+static s_glyph *SDF_Slot(s_glyph *glyphs, int max_glyphs, Uint32 ch)
+{
+    Uint32 mask = (Uint32)max_glyphs - 1;
+    Uint32 i = (ch * 0x9E3779B9) & mask;
+
+    while ( glyphs[i].used && glyphs[i].ch != ch ) {
+        i = (i + 1) & mask;
+    }
+    return &glyphs[i];
+}
+
+/* Get the field of a character, building it the first time it is seen */
+static s_glyph *SDF_Find(TTF_SDFAtlas *atlas, Uint32 ch)
+{
+    TTF_Font *font = atlas->font;
+    s_glyph *entry;
+    c_glyph *glyph;
+    FT_Error error;
+    int width;
+
+    if ( atlas->state != font->glyph_state ) {
+        SDF_Flush(atlas);
+    }
+
+    entry = SDF_Slot(atlas->glyphs, atlas->max_glyphs, ch);
+    if ( entry->used ) {
+        return entry;
+    }
+
+    /* Keep the table at most half full */
+    if ( (atlas->num_glyphs + 1) * 2 > atlas->max_glyphs ) {
+        int size = atlas->max_glyphs * 2;
+        s_glyph *glyphs = (s_glyph *)SDL_calloc(size, sizeof(*glyphs));
+        int i;
+
+        if ( glyphs == NULL ) {
+            TTF_SetError("Out of memory");
+            return NULL;
+        }
+        for ( i = 0; i < atlas->max_glyphs; ++i ) {
+            if ( atlas->glyphs[i].used ) {
+                *SDF_Slot(glyphs, size, atlas->glyphs[i].ch) = atlas->glyphs[i];
+            }
+        }
+        SDL_free(atlas->glyphs);
+        atlas->glyphs = glyphs;
+        atlas->max_glyphs = size;
+        entry = SDF_Slot(glyphs, size, ch);
+    }
+
+    error = Find_Glyph(font, ch, CACHED_METRICS|CACHED_PIXMAP);
+    if ( error ) {
+        TTF_SetFTError("Couldn't find glyph", error);
+        return NULL;
+    }
+    glyph = font->current;
+
+    /* The same width Render_Layout_32() draws */
+    width = glyph->pixmap.width;
+    if ( font->outline <= 0 && width > glyph->maxx - glyph->minx ) {
+        width = glyph->maxx - glyph->minx;
+    }
+
+    entry->ch = ch;
+    entry->minx = glyph->minx;
+    entry->yoffset = glyph->yoffset;
+    SDL_zero(entry->rect);
+    if ( width > 0 && glyph->pixmap.rows > 0 ) {
+        SDL_Surface *surface;
+
+        if ( SDF_Pack(atlas, width + 2 * atlas->spread,
+                      glyph->pixmap.rows + 2 * atlas->spread, &entry->rect) < 0 ) {
+            return NULL;
+        }
+        surface = atlas->surface;
+        if ( SDF_Build(atlas, &glyph->pixmap, width,
+                       (Uint8 *)surface->pixels + entry->rect.y * surface->pitch + entry->rect.x,
+                       surface->pitch) < 0 ) {
+            return NULL;
+        }
+    }
+    entry->used = SDL_TRUE;
+    ++atlas->num_glyphs;
+    return entry;
+}
+
+/* Resample a field at scale and blend it into the alpha of the surface */
+static void SDF_Draw(TTF_SDFAtlas *atlas, const s_glyph *entry, SDL_Surface *textbuf,
+                     float x0, float y0, float scale)
+{
+    const SDL_Surface *field = atlas->surface;
+    const Uint8 *base = (const Uint8 *)field->pixels + entry->rect.y * field->pitch + entry->rect.x;
+    /* Field steps per output pixel turn into output pixels per distance */
+    float sharpness = scale * (float)atlas->spread / 127.0f;
+    int left = SDL_max(0, (int)SDL_floor(x0 * scale));
+    int top = SDL_max(0, (int)SDL_floor(y0 * scale));
+    int right = SDL_min(textbuf->w, (int)SDL_ceil((x0 + entry->rect.w) * scale));
+    int bottom = SDL_min(textbuf->h, (int)SDL_ceil((y0 + entry->rect.h) * scale));
+    int ox, oy;
+
+    for ( oy = top; oy < bottom; ++oy ) {
+        Uint32 *dst = (Uint32 *)((Uint8 *)textbuf->pixels + oy * textbuf->pitch);
+        float fy = ((float)oy + 0.5f) / scale - y0 - 0.5f;
+        int iy = (int)SDL_floor(fy);
+        float wy = fy - (float)iy;
+
+        for ( ox = left; ox < right; ++ox ) {
+            float fx = ((float)ox + 0.5f) / scale - x0 - 0.5f;
+            int ix = (int)SDL_floor(fx);
+            float wx = fx - (float)ix;
+            float s[4];
+            float value;
+            float alpha;
+            int i;
+
+            /* Samples off the field are far outside the glyph */
+            for ( i = 0; i < 4; ++i ) {
+                int sx = ix + (i & 1);
+                int sy = iy + (i >> 1);
+
+                if ( sx < 0 || sy < 0 || sx >= entry->rect.w || sy >= entry->rect.h ) {
+                    s[i] = 0.0f;
+                } else {
+                    s[i] = (float)base[sy * field->pitch + sx];
+                }
+            }
+            value = (s[0] * (1.0f - wx) + s[1] * wx) * (1.0f - wy) +
+                    (s[2] * (1.0f - wx) + s[3] * wx) * wy;
+
+            /* One output pixel of antialiasing around the outline */
+            alpha = 0.5f + (value - 128.0f) * sharpness;
+            if ( alpha > 0.0f ) {
+                Uint32 a = (alpha >= 1.0f) ? 255 : (Uint32)(alpha * 255.0f + 0.5f);
+
+                if ( (a << 24) > (dst[ox] & 0xFF000000) ) {
+                    dst[ox] = (dst[ox] & 0x00FFFFFF) | (a << 24);
+                }
+            }
+        }
+    }
+}
+
+/* Fill the rows of an underline or strikethrough scaled from the font size */
+static void SDF_DrawLine(TTF_Font *font, SDL_Surface *textbuf, int row, float scale, Uint32 pixel)
+{
+    int height = font->underline_height;
+    int top, bottom, y;
+
+    if ( font->outline > 0 ) {
+        height += font->outline * 2;
+    }
+    top = SDL_max(0, (int)SDL_floor(row * scale));
+    bottom = SDL_min(textbuf->h, (int)SDL_ceil((row + height) * scale));
+    for ( y = top; y < bottom; ++y ) {
+        TTF_fillRow_32((Uint32 *)((Uint8 *)textbuf->pixels + y * textbuf->pitch),
+                       pixel | 0xFF000000, textbuf->w);
+    }
+}
+
+void TTF_FreeSDFAtlas(TTF_SDFAtlas *atlas)
+{
+    if ( atlas == NULL ) {
+        return;
+    }
+    SDL_FreeSurface(atlas->surface);
+    SDL_free(atlas->glyphs);
+    SDL_free(atlas->outside);
+    SDL_free(atlas->inside);
+    SDL_free(atlas->f);
+    SDL_free(atlas->d);
+    SDL_free(atlas->z);
+    SDL_free(atlas->v);
+    SDL_free(atlas);
+}
+
+TTF_SDFAtlas *TTF_CreateSDFAtlas(TTF_Font *font, int spread)
+{
+    TTF_SDFAtlas *atlas;
+    SDL_Color grays[256];
+    int width;
+    int i;
+
+    TTF_CHECKPOINTER(font, NULL);
+
+    if ( spread < 1 ) {
+        spread = 1;
+    }
+    atlas = (TTF_SDFAtlas *)SDL_calloc(1, sizeof(*atlas));
+    if ( atlas == NULL ) {
+        TTF_SetError("Out of memory");
+        return NULL;
+    }
+    atlas->font = font;
+    atlas->spread = spread;
+    atlas->state = font->glyph_state;
+
+    atlas->max_glyphs = 128;
+    atlas->glyphs = (s_glyph *)SDL_calloc(atlas->max_glyphs, sizeof(*atlas->glyphs));
+    if ( atlas->glyphs == NULL ) {
+        TTF_SetError("Out of memory");
+        TTF_FreeSDFAtlas(atlas);
+        return NULL;
+    }
+
+    /* Room for a few of the widest glyphs on a shelf */
+    width = SDF_ATLAS_MIN_WIDTH;
+    while ( width < 4 * (font->height + 2 * spread) ) {
+        width *= 2;
+    }
+    atlas->surface = SDL_CreateRGBSurface(SDL_SWSURFACE, width, width / 2, 8, 0, 0, 0, 0);
+    if ( atlas->surface == NULL ) {
+        TTF_FreeSDFAtlas(atlas);
+        return NULL;
+    }
+    for ( i = 0; i < 256; ++i ) {
+        grays[i].r = grays[i].g = grays[i].b = (Uint8)i;
+        grays[i].a = 255;
+    }
+    SDL_SetPaletteColors(atlas->surface->format->palette, grays, 0, 256);
+    SDL_memset(atlas->surface->pixels, 0, atlas->surface->pitch * atlas->surface->h);
+    return atlas;
+}
+
+int TTF_AddSDFGlyphsUTF8(TTF_SDFAtlas *atlas, const char *text)
+{
+    size_t textlen;
+
+    TTF_CHECKPOINTER(atlas, -1);
+    TTF_CHECKPOINTER(text, -1);
+
+    textlen = SDL_strlen(text);
+    while ( textlen > 0 ) {
+        Uint32 c = UTF8_getch(&text, &textlen);
+        if ( c == UNICODE_BOM_NATIVE || c == UNICODE_BOM_SWAPPED ) {
+            continue;
+        }
+        if ( SDF_Find(atlas, c) == NULL ) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int TTF_GetSDFGlyph(TTF_SDFAtlas *atlas, Uint32 ch, SDL_Rect *rect, int *xoffset, int *yoffset)
+{
+    s_glyph *entry;
+
+    TTF_CHECKPOINTER(atlas, -1);
+
+    entry = SDF_Find(atlas, ch);
+    if ( entry == NULL ) {
+        return -1;
+    }
+    if ( rect ) {
+        *rect = entry->rect;
+    }
+    if ( xoffset ) {
+        *xoffset = entry->minx - atlas->spread;
+    }
+    if ( yoffset ) {
+        *yoffset = entry->yoffset - atlas->spread;
+    }
+    return 0;
+}
+
+SDL_Surface *TTF_GetSDFAtlasSurface(TTF_SDFAtlas *atlas)
+{
+    TTF_CHECKPOINTER(atlas, NULL);
+
+    return atlas->surface;
+}
+
+int TTF_SizeSDF_UTF8(TTF_SDFAtlas *atlas, const char *text, float scale, int *w, int *h)
+{
+    TTF_Layout *layout;
+
+    TTF_CHECKPOINTER(atlas, -1);
+    TTF_CHECKPOINTER(text, -1);
+
+    layout = TTF_FontLayout(atlas->font);
+    if ( layout == NULL || Layout_SetText(layout, text) < 0 ) {
+        return -1;
+    }
+    if ( w ) {
+        *w = (int)SDL_ceil(layout->width * scale);
+    }
+    if ( h ) {
+        *h = (int)SDL_ceil(layout->height * scale);
+    }
+    return 0;
+}
+
+SDL_Surface *TTF_RenderSDF_UTF8(TTF_SDFAtlas *atlas, const char *text, SDL_Color fg, float scale)
+{
+    TTF_Font *font;
+    TTF_Layout *layout;
     SDL_Surface *textbuf;
-    Uint32 alpha;
     Uint32 pixel;
-    Uint8 *src;
-    Uint32 *dst;
-    Uint32 *dst_check;
-    int row, col;
-    c_glyph *glyph;
-    FT_Error error;
-    FT_Long use_kerning;
-    FT_UInt prev_index = 0;
-    const int lineSpace = 2;
-    int line, numLines, rowSize;
-    char *str, **strLines;
-    size_t textlen;
+    int width, height;
+    int i;
 
+    TTF_CHECKPOINTER(atlas, NULL);
     TTF_CHECKPOINTER(text, NULL);
+    font = atlas->font;
 
-    /* Get the dimensions of the text surface */
-    if ( (TTF_SizeUTF8(font, text, &width, &height) < 0) || !width ) {
+    if ( scale <= 0.0f ) {
+        TTF_SetError("Invalid scale");
+        return NULL;
+    }
+
+    /* Lay the text out at the size of the atlas, then scale the positions */
+    layout = TTF_FontLayout(font);
+    if ( layout == NULL || Layout_SetText(layout, text) < 0 ) {
+        return NULL;
+    }
+    width = (int)SDL_ceil(layout->width * scale);
+    height = (int)SDL_ceil(layout->height * scale);
+    if ( !width ) {
         TTF_SetError("Text has zero width");
-        return(NULL);
+        return NULL;
     }
 
-    numLines = 1;
-    str = NULL;
-    strLines = NULL;
-    if ( wrapLength > 0 && *text ) {
-        const char *wrapDelims = " \t\r\n";
-        int w, h;
-        int line = 0;
-        char *spot, *tok, *next_tok, *end;
-        char delim;
-        size_t str_len = SDL_strlen(text);
+    textbuf = SDL_CreateRGBSurface(SDL_SWSURFACE, width, height, 32,
+                               0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
+    if ( textbuf == NULL ) {
+        return NULL;
+    }
+    pixel = (fg.r<<16)|(fg.g<<8)|fg.b;
+    SDL_FillRect(textbuf, NULL, pixel); /* Initialize with fg and 0 alpha */
 
-        numLines = 0;
+    for ( i = 0; i < layout->num_glyphs; ++i ) {
+        l_glyph *laid = &layout->glyphs[i];
+        s_glyph *entry = SDF_Find(atlas, laid->ch);
 
-        str = SDL_stack_alloc(char, str_len+1);
-        if ( str == NULL ) {
-            TTF_SetError("Out of memory");
-            return(NULL);
+        if ( entry == NULL ) {
+            SDL_FreeSurface(textbuf);
+            return NULL;
+        }
+        if ( entry->rect.w > 0 ) {
+            SDF_Draw(atlas, entry, textbuf,
+                     (float)(laid->x + entry->minx - atlas->spread),
+                     (float)(entry->yoffset - atlas->spread), scale);
         }
+    }
 
-        SDL_strlcpy(str, text, str_len+1);
-        tok = str;
-        end = str + str_len;
-        do {
-            strLines = (char **)SDL_realloc(strLines, (numLines+1)*sizeof(*strLines));
-            if (!strLines) {
-                TTF_SetError("Out of memory");
-                return(NULL);
-            }
-            strLines[numLines++] = tok;
+    if ( TTF_HANDLE_STYLE_UNDERLINE(font) ) {
+        SDF_DrawLine(font, textbuf, TTF_underline_top_row(font), scale, pixel);
+    }
+    if ( TTF_HANDLE_STYLE_STRIKETHROUGH(font) ) {
+        SDF_DrawLine(font, textbuf, TTF_strikethrough_top_row(font), scale, pixel);
+    }
+    return textbuf;
+}
 
-            /* Look for the end of the line */
-            if ((spot = SDL_strchr(tok, '\r')) != NULL ||
-                (spot = SDL_strchr(tok, '\n')) != NULL) {
-                if (*spot == '\r') {
-                    ++spot;
-                }
-                if (*spot == '\n') {
-                    ++spot;
-                }
-            } else {
-                spot = end;
-            }
-            next_tok = spot;
-
-            /* Get the longest string that will fit in the desired space */
-            for ( ; ; ) {
-                /* Strip trailing whitespace */
-                while ( spot > tok &&
-                        CharacterIsDelimiter(spot[-1], wrapDelims) ) {
-                    --spot;
-                }
-                if ( spot == tok ) {
-                    if (CharacterIsDelimiter(*spot, wrapDelims)) {
-                        *spot = '\0';
-                    }
-                    break;
-                }
-                delim = *spot;
-                *spot = '\0';
+/* Glyph atlas textures */
+#define ATLAS_PAGE_DEFAULT  512
+#define ATLAS_PAGES_DEFAULT 4
+#define ATLAS_PADDING       1
+#define ATLAS_BLANK         0x00FFFFFF  /* white, the color mod gives the text color */
+
+/* Where a glyph sits in the atlas, and how to place it */
+typedef struct atlas_glyph {
+    Uint32 font;        /* the id of the font */
+    Uint32 state;
+    Uint32 ch;
+    SDL_bool used;
+    int page;
+    SDL_Rect rect;      /* empty for glyphs with nothing to draw */
+    int minx;
+    int yoffset;
+} a_glyph;
+
+/* A segment of the skyline, the top of what is packed below it */
+typedef struct atlas_node {
+    int x;
+    int y;
+    int w;
+} a_node;
+
+typedef struct atlas_page {
+    SDL_Texture *texture;
+    Uint32 *pixels;     /* what the texture holds once the dirty rect is uploaded */
+    SDL_Rect dirty;
+    a_node *skyline;
+    int num_nodes;
+    Uint32 lru;         /* the last draw using the page */
+} a_page;
+
+/* A copy from a page waiting to be issued with the others from its page */
+typedef struct atlas_draw {
+    int page;
+    SDL_Rect src;
+    SDL_Rect dst;
+} a_draw;
+
+struct _TTF_Atlas {
+    SDL_Renderer *renderer;
+    int page_size;
+    int max_pages;
+
+    a_page *pages;
+    int num_pages;
+    Uint32 clock;
+
+    a_glyph *glyphs;    /* open addressing, keyed by font, state and character */
+    int num_glyphs;
+    int max_glyphs;
+
+    a_draw *draws;
+    int num_draws;
+    int max_draws;
+    SDL_Color color;
+};
 
-                TTF_SizeUTF8(font, tok, &w, &h);
-                if ((Uint32)w <= wrapLength) {
-                    break;
-                } else {
-                    /* Back up and try again... */
-                    *spot = delim;
-                }
+static a_glyph *Atlas_Slot(a_glyph *glyphs, int max_glyphs, Uint32 font, Uint32 state, Uint32 ch)
+{
+    Uint32 mask = (Uint32)max_glyphs - 1;
+    Uint32 i = ((ch ^ (font << 21) ^ (state << 11)) * 0x9E3779B9) & mask;
 
-                while ( spot > tok &&
-                        !CharacterIsDelimiter(spot[-1], wrapDelims) ) {
-                    --spot;
-                }
-                if ( spot > tok ) {
-                    next_tok = spot;
-                }
-            }
-            tok = next_tok;
-        } while (tok < end);
+    while ( glyphs[i].used &&
+            (glyphs[i].ch != ch || glyphs[i].font != font || glyphs[i].state != state) ) {
+        i = (i + 1) & mask;
     }
+    return &glyphs[i];
+}
 
-    /* Create the target surface */
-    textbuf = SDL_CreateRGBSurface(SDL_SWSURFACE,
-            (numLines > 1) ? wrapLength : width,
-            height * numLines + (lineSpace * (numLines - 1)),
-            32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
-    if ( textbuf == NULL ) {
-        if ( strLines ) {
-            SDL_free(strLines);
-            SDL_stack_free(str);
+/* Rebuild the table at size, dropping the glyphs on page drop, if any */
+static int Atlas_Rehash(TTF_Atlas *atlas, int size, int drop)
+{
+    a_glyph *glyphs = (a_glyph *)SDL_calloc(size, sizeof(*glyphs));
+    int i;
+
+    if ( glyphs == NULL ) {
+        TTF_SetError("Out of memory");
+        return -1;
+    }
+    atlas->num_glyphs = 0;
+    for ( i = 0; i < atlas->max_glyphs; ++i ) {
+        a_glyph *entry = &atlas->glyphs[i];
+        if ( entry->used && (entry->rect.w == 0 || entry->page != drop) ) {
+            *Atlas_Slot(glyphs, size, entry->font, entry->state, entry->ch) = *entry;
+            ++atlas->num_glyphs;
         }
-        return(NULL);
     }
+    SDL_free(atlas->glyphs);
+    atlas->glyphs = glyphs;
+    atlas->max_glyphs = size;
+    return 0;
+}
 
-    rowSize = textbuf->pitch/4 * height;
+static void Atlas_ClearPage(TTF_Atlas *atlas, a_page *page)
+{
+    int size = atlas->page_size;
+
+    TTF_fillRow_32(page->pixels, ATLAS_BLANK, size * size);
+    page->dirty.x = 0;
+    page->dirty.y = 0;
+    page->dirty.w = size;
+    page->dirty.h = size;
+    page->skyline[0].x = 0;
+    page->skyline[0].y = 0;
+    page->skyline[0].w = size;
+    page->num_nodes = 1;
+}
 
-    /* Adding bound checking to avoid all kinds of memory corruption errors
-     that may occur. */
-    dst_check = (Uint32*)textbuf->pixels + textbuf->pitch/4 * textbuf->h;
+static a_page *Atlas_AddPage(TTF_Atlas *atlas)
+{
+    int size = atlas->page_size;
+    a_page *pages;
+    a_page *page;
 
-    /* check kerning */
-    use_kerning = FT_HAS_KERNING( font->face ) && font->kerning;
+    pages = (a_page *)SDL_realloc(atlas->pages, (atlas->num_pages + 1) * sizeof(*pages));
+    if ( pages == NULL ) {
+        TTF_SetError("Out of memory");
+        return NULL;
+    }
+    atlas->pages = pages;
+    page = &pages[atlas->num_pages];
+    SDL_zerop(page);
+
+    page->pixels = (Uint32 *)SDL_malloc(size * size * sizeof(*page->pixels));
+    /* Nodes are at least a pixel wide, and packing inserts one before merging */
+    page->skyline = (a_node *)SDL_malloc((size + 1) * sizeof(*page->skyline));
+    if ( page->pixels == NULL || page->skyline == NULL ) {
+        TTF_SetError("Out of memory");
+        SDL_free(page->pixels);
+        SDL_free(page->skyline);
+        return NULL;
+    }
+    page->texture = SDL_CreateTexture(atlas->renderer, SDL_PIXELFORMAT_ARGB8888,
+                                      SDL_TEXTUREACCESS_STATIC, size, size);
+    if ( page->texture == NULL ) {
+        SDL_free(page->pixels);
+        SDL_free(page->skyline);
+        return NULL;
+    }
+    SDL_SetTextureBlendMode(page->texture, SDL_BLENDMODE_BLEND);
+    Atlas_ClearPage(atlas, page);
+    ++atlas->num_pages;
+    return page;
+}
 
-    /* Load and render each character */
-    pixel = (fg.r<<16)|(fg.g<<8)|fg.b;
-    SDL_FillRect(textbuf, NULL, pixel); /* Initialize with fg and 0 alpha */
+/* The lowest y a w by h rect fits at with its left edge on node i */
+static int Atlas_Fit(const a_page *page, int i, int w, int h, int size)
+{
+    int x = page->skyline[i].x;
+    int y = 0;
 
-    for ( line = 0; line < numLines; line++ ) {
-        if ( strLines ) {
-            text = strLines[line];
+    if ( x + w > size ) {
+        return -1;
+    }
+    for ( ; w > 0; ++i ) {
+        if ( page->skyline[i].y > y ) {
+            y = page->skyline[i].y;
         }
-        textlen = SDL_strlen(text);
-        first = SDL_TRUE;
-        xstart = 0;
-        while ( textlen > 0 ) {
-            Uint16 c = UTF8_getch(&text, &textlen);
-            if ( c == UNICODE_BOM_NATIVE || c == UNICODE_BOM_SWAPPED ) {
-                continue;
-            }
+        if ( y + h > size ) {
+            return -1;
+        }
+        w -= page->skyline[i].w;
+    }
+    return y;
+}
 
-            error = Find_Glyph(font, c, CACHED_METRICS|CACHED_PIXMAP);
-            if ( error ) {
-                TTF_SetFTError("Couldn't find glyph", error);
-                SDL_FreeSurface( textbuf );
-                return NULL;
-            }
-            glyph = font->current;
-            /* Ensure the width of the pixmap is correct. On some cases,
-             * freetype may report a larger pixmap than possible.*/
-            width = glyph->pixmap.width;
-            if ( font->outline <= 0 && width > glyph->maxx - glyph->minx ) {
-                width = glyph->maxx - glyph->minx;
+/* Skyline bottom-left packing: put the rect where its bottom is lowest */
+static SDL_bool Atlas_Pack(a_page *page, int w, int h, int size, SDL_Rect *rect)
+{
+    a_node *skyline = page->skyline;
+    int best = -1;
+    int best_y = size;
+    int best_w = size;
+    int i;
+
+    for ( i = 0; i < page->num_nodes; ++i ) {
+        int y = Atlas_Fit(page, i, w, h, size);
+        if ( y >= 0 && (y + h < best_y || (y + h == best_y && skyline[i].w < best_w)) ) {
+            best = i;
+            best_y = y + h;
+            best_w = skyline[i].w;
+        }
+    }
+    if ( best < 0 ) {
+        return SDL_FALSE;
+    }
+    rect->x = skyline[best].x;
+    rect->y = best_y - h;
+    rect->w = w;
+    rect->h = h;
+
+    /* The rect raises the skyline over its width, cutting into the nodes after it */
+    SDL_memmove(&skyline[best + 1], &skyline[best], (page->num_nodes - best) * sizeof(*skyline));
+    ++page->num_nodes;
+    skyline[best].x = rect->x;
+    skyline[best].y = best_y;
+    skyline[best].w = w;
+    i = best + 1;
+    while ( i < page->num_nodes ) {
+        int cut = skyline[i-1].x + skyline[i-1].w - skyline[i].x;
+        if ( cut <= 0 ) {
+            break;
+        }
+        skyline[i].x += cut;
+        skyline[i].w -= cut;
+        if ( skyline[i].w > 0 ) {
+            break;
+        }
+        SDL_memmove(&skyline[i], &skyline[i + 1], (page->num_nodes - i - 1) * sizeof(*skyline));
+        --page->num_nodes;
+    }
+
+    /* Merge neighbors at the same height */
+    for ( i = 0; i + 1 < page->num_nodes; ) {
+        if ( skyline[i].y == skyline[i+1].y ) {
+            skyline[i].w += skyline[i+1].w;
+            SDL_memmove(&skyline[i + 1], &skyline[i + 2], (page->num_nodes - i - 2) * sizeof(*skyline));
+            --page->num_nodes;
+        } else {
+            ++i;
+        }
+    }
+    return SDL_TRUE;
+}
+
+/* Upload the part of the page changed since it was last drawn */
+static void Atlas_Upload(TTF_Atlas *atlas, a_page *page)
+{
+    SDL_Rect *dirty = &page->dirty;
+
+    if ( dirty->w > 0 ) {
+        SDL_UpdateTexture(page->texture, dirty,
+                          page->pixels + dirty->y * atlas->page_size + dirty->x,
+                          atlas->page_size * sizeof(*page->pixels));
+        SDL_zerop(dirty);
+    }
+}
+
+/* Issue the pending copies, one texture and color mod at a time */
+static void Atlas_Draw(TTF_Atlas *atlas)
+{
+    int i, j;
+
+    for ( i = 0; i < atlas->num_pages; ++i ) {
+        a_page *page = &atlas->pages[i];
+        SDL_bool bound = SDL_FALSE;
+
+        for ( j = 0; j < atlas->num_draws; ++j ) {
+            a_draw *draw = &atlas->draws[j];
+            if ( draw->page != i ) {
+                continue;
             }
-            /* do kerning, if possible AC-Patch */
-            if ( use_kerning && prev_index && glyph->index ) {
-                FT_Vector delta;
-                FT_Get_Kerning( font->face, prev_index, glyph->index, ft_kerning_default, &delta );
-                xstart += delta.x >> 6;
+            if ( !bound ) {
+                Atlas_Upload(atlas, page);
+                SDL_SetTextureColorMod(page->texture, atlas->color.r, atlas->color.g, atlas->color.b);
+                bound = SDL_TRUE;
             }
+            SDL_RenderCopy(atlas->renderer, page->texture, &draw->src, &draw->dst);
+        }
+    }
+    atlas->num_draws = 0;
+}
 
-            /* Compensate for the wrap around bug with negative minx's */
-            if ( first && (glyph->minx < 0) ) {
-                xstart -= glyph->minx;
-            }
-            first = SDL_FALSE;
+/* Find room for a w by h glyph, in a new page or the least recently used
+   one if every page is full.  Copies pending from that page are issued
+   before it is cleared.
+*/
+static int Atlas_Place(TTF_Atlas *atlas, int w, int h, SDL_Rect *rect)
+{
+    int size = atlas->page_size;
+    int i, oldest;
 
-            for ( row = 0; row < glyph->pixmap.rows; ++row ) {
-                /* Make sure we don't go either over, or under the
-                 * limit */
-                if ( row+glyph->yoffset < 0 ) {
-                    continue;
-                }
-                if ( row+glyph->yoffset >= textbuf->h ) {
-                    continue;
-                }
-                dst =  ((Uint32*)textbuf->pixels + rowSize * line) +
-                (row+glyph->yoffset) * textbuf->pitch/4 +
-                xstart + glyph->minx;
-
-                /* Added code to adjust src pointer for pixmaps to
-                 * account for pitch.
-                 * */
-                src = (Uint8*) (glyph->pixmap.buffer + glyph->pixmap.pitch * row);
-                for ( col = width; col>0 && dst < dst_check; --col) {
-                    alpha = *src++;
-                    *dst++ |= pixel | (alpha << 24);
-                }
-            }
+    if ( w > size || h > size ) {
+        TTF_SetError("Glyph too large for the atlas");
+        return -1;
+    }
+    for ( i = 0; i < atlas->num_pages; ++i ) {
+        if ( Atlas_Pack(&atlas->pages[i], w, h, size, rect) ) {
+            return i;
+        }
+    }
+    if ( atlas->num_pages < atlas->max_pages ) {
+        a_page *page = Atlas_AddPage(atlas);
+        if ( page == NULL ) {
+            return -1;
+        }
+        Atlas_Pack(page, w, h, size, rect);
+        return atlas->num_pages - 1;
+    }
+
+    oldest = 0;
+    for ( i = 1; i < atlas->num_pages; ++i ) {
+        if ( atlas->pages[i].lru < atlas->pages[oldest].lru ) {
+            oldest = i;
+        }
+    }
+    Atlas_Draw(atlas);
+    if ( Atlas_Rehash(atlas, atlas->max_glyphs, oldest) < 0 ) {
+        return -1;
+    }
+    Atlas_ClearPage(atlas, &atlas->pages[oldest]);
+    Atlas_Pack(&atlas->pages[oldest], w, h, size, rect);
+    return oldest;
+}
+
+/* Get a glyph of the current state of a font, adding it the first time */
+static a_glyph *Atlas_Find(TTF_Atlas *atlas, TTF_Font *font, Uint32 ch)
+{
+    Uint32 state = font->glyph_state;
+    a_glyph *entry;
+    c_glyph *glyph;
+    FT_Error error;
+    int width;
+
+    entry = Atlas_Slot(atlas->glyphs, atlas->max_glyphs, font->id, state, ch);
+    if ( entry->used ) {
+        return entry;
+    }
+
+    /* Keep the table at most half full */
+    if ( (atlas->num_glyphs + 1) * 2 > atlas->max_glyphs ) {
+        if ( Atlas_Rehash(atlas, atlas->max_glyphs * 2, -1) < 0 ) {
+            return NULL;
+        }
+        entry = Atlas_Slot(atlas->glyphs, atlas->max_glyphs, font->id, state, ch);
+    }
+
+    error = Find_Glyph(font, ch, CACHED_METRICS|CACHED_PIXMAP);
+    if ( error ) {
+        TTF_SetFTError("Couldn't find glyph", error);
+        return NULL;
+    }
+    glyph = font->current;
 
-            xstart += glyph->advance;
-            if ( TTF_HANDLE_STYLE_BOLD(font) ) {
-                xstart += font->glyph_overhang;
+    /* The same width Render_Layout_32() draws */
+    width = glyph->pixmap.width;
+    if ( font->outline <= 0 && width > glyph->maxx - glyph->minx ) {
+        width = glyph->maxx - glyph->minx;
+    }
+
+    if ( width > 0 && glyph->pixmap.rows > 0 ) {
+        SDL_Rect rect;
+        a_page *page;
+        int page_index;
+        int row, col;
+
+        page_index = Atlas_Place(atlas, width + ATLAS_PADDING, glyph->pixmap.rows + ATLAS_PADDING, &rect);
+        if ( page_index < 0 ) {
+            return NULL;
+        }
+        /* Placing may have rebuilt the table */
+        entry = Atlas_Slot(atlas->glyphs, atlas->max_glyphs, font->id, state, ch);
+        page = &atlas->pages[page_index];
+        rect.w -= ATLAS_PADDING;
+        rect.h -= ATLAS_PADDING;
+        for ( row = 0; row < rect.h; ++row ) {
+            const Uint8 *src = glyph->pixmap.buffer + row * glyph->pixmap.pitch;
+            Uint32 *dst = page->pixels + (rect.y + row) * atlas->page_size + rect.x;
+            for ( col = 0; col < rect.w; ++col ) {
+                dst[col] = ATLAS_BLANK | ((Uint32)src[col] << 24);
             }
-            prev_index = glyph->index;
         }
+        if ( page->dirty.w > 0 ) {
+            SDL_UnionRect(&page->dirty, &rect, &page->dirty);
+        } else {
+            page->dirty = rect;
+        }
+        entry->page = page_index;
+        entry->rect = rect;
+    } else {
+        entry->page = 0;
+        SDL_zero(entry->rect);
+    }
+    entry->font = font->id;
+    entry->state = state;
+    entry->ch = ch;
+    entry->minx = glyph->minx;
+    entry->yoffset = glyph->yoffset;
+    entry->used = SDL_TRUE;
+    ++atlas->num_glyphs;
+    return entry;
+}
+
+static int Atlas_AddDraw(TTF_Atlas *atlas, const a_glyph *entry, int x, int y)
+{
+    a_draw *draw;
 
-        /* Handle the underline style *
-        if ( TTF_HANDLE_STYLE_UNDERLINE(font) ) {
-            row = TTF_underline_top_row(font);
-            TTF_drawLine_Blended(font, textbuf, row, pixel);
+    if ( atlas->num_draws == atlas->max_draws ) {
+        int max = atlas->max_draws ? atlas->max_draws * 2 : 64;
+        a_draw *draws = (a_draw *)SDL_realloc(atlas->draws, max * sizeof(*draws));
+        if ( draws == NULL ) {
+            TTF_SetError("Out of memory");
+            return -1;
         }
-        */
+        atlas->draws = draws;
+        atlas->max_draws = max;
+    }
+    draw = &atlas->draws[atlas->num_draws++];
+    draw->page = entry->page;
+    draw->src = entry->rect;
+    draw->dst.x = x + entry->minx;
+    draw->dst.y = y + entry->yoffset;
+    draw->dst.w = entry->rect.w;
+    draw->dst.h = entry->rect.h;
+    atlas->pages[entry->page].lru = atlas->clock;
+    return 0;
+}
+
+static void Atlas_DrawLine(TTF_Atlas *atlas, TTF_Font *font, TTF_Layout *layout, int x, int y)
+{
+    SDL_Renderer *renderer = atlas->renderer;
+    SDL_Color color = atlas->color;
+    Uint8 r, g, b, a;
+    SDL_Rect line;
+
+    line.x = x;
+    line.y = y;
+    line.w = layout->width;
+    line.h = font->underline_height;
+    /* Take outline into account */
+    if ( font->outline > 0 ) {
+        line.h += font->outline * 2;
+    }
+    SDL_GetRenderDrawColor(renderer, &r, &g, &b, &a);
+    SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, 255);
+    SDL_RenderFillRect(renderer, &line);
+    SDL_SetRenderDrawColor(renderer, r, g, b, a);
+}
+
+TTF_Atlas *TTF_CreateAtlas(SDL_Renderer *renderer, int page_size, int max_pages)
+{
+    TTF_Atlas *atlas;
+    SDL_RendererInfo info;
+
+    TTF_CHECKPOINTER(renderer, NULL);
 
-        /* Handle the strikethrough style *
-        if ( TTF_HANDLE_STYLE_STRIKETHROUGH(font) ) {
-            row = TTF_strikethrough_top_row(font);
-            TTF_drawLine_Blended(font, textbuf, row, pixel);
+    if ( page_size <= 0 ) {
+        page_size = ATLAS_PAGE_DEFAULT;
+    }
+    if ( max_pages <= 0 ) {
+        max_pages = ATLAS_PAGES_DEFAULT;
+    }
+    if ( SDL_GetRendererInfo(renderer, &info) == 0 ) {
+        if ( info.max_texture_width && page_size > info.max_texture_width ) {
+            page_size = info.max_texture_width;
+        }
+        if ( info.max_texture_height && page_size > info.max_texture_height ) {
+            page_size = info.max_texture_height;
         }
-        */
     }
 
-    if ( strLines ) {
-        SDL_free(strLines);
-        SDL_stack_free(str);
+    atlas = (TTF_Atlas *)SDL_calloc(1, sizeof(*atlas));
+    if ( atlas == NULL ) {
+        TTF_SetError("Out of memory");
+        return NULL;
     }
-    return(textbuf);
+    atlas->renderer = renderer;
+    atlas->page_size = page_size;
+    atlas->max_pages = max_pages;
+    atlas->max_glyphs = 256;
+    atlas->glyphs = (a_glyph *)SDL_calloc(atlas->max_glyphs, sizeof(*atlas->glyphs));
+    if ( atlas->glyphs == NULL ) {
+        TTF_SetError("Out of memory");
+        TTF_FreeAtlas(atlas);
+        return NULL;
+    }
+    return atlas;
 }
 
-SDL_Surface *TTF_RenderUNICODE_Blended_Wrapped(TTF_Font *font, const Uint16* text,
-                                               SDL_Color fg, Uint32 wrapLength)
+void TTF_ClearAtlas(TTF_Atlas *atlas)
 {
-    SDL_Surface *surface = NULL;
+    int i;
+
+    if ( !atlas ) {
+        return;
+    }
+    for ( i = 0; i < atlas->num_pages; ++i ) {
+        SDL_DestroyTexture(atlas->pages[i].texture);
+        SDL_free(atlas->pages[i].pixels);
+        SDL_free(atlas->pages[i].skyline);
+    }
+    SDL_free(atlas->pages);
+    atlas->pages = NULL;
+    atlas->num_pages = 0;
+    if ( atlas->glyphs ) {
+        SDL_memset(atlas->glyphs, 0, atlas->max_glyphs * sizeof(*atlas->glyphs));
+    }
+    atlas->num_glyphs = 0;
+    atlas->num_draws = 0;
+}
+
+void TTF_FreeAtlas(TTF_Atlas *atlas)
+{
+    if ( atlas ) {
+        TTF_ClearAtlas(atlas);
+        SDL_free(atlas->glyphs);
+        SDL_free(atlas->draws);
+        SDL_free(atlas);
+    }
+}
+
+int TTF_DrawText(TTF_Atlas *atlas, TTF_Font *font, const char *text, int x, int y, SDL_Color fg)
+{
+    int status = -1;
     Uint8 *utf8;
 
-    TTF_CHECKPOINTER(text, NULL);
+    TTF_CHECKPOINTER(text, -1);
 
-    utf8 = SDL_stack_alloc(Uint8, UCS2_len(text)*3+1);
+    utf8 = SDL_stack_alloc(Uint8, SDL_strlen(text)*2+1);
     if ( utf8 ) {
-        UCS2_to_UTF8(text, utf8);
-        surface = TTF_RenderUTF8_Blended_Wrapped(font, (char *)utf8, fg, wrapLength);
+        LATIN1_to_UTF8(text, utf8);
+        status = TTF_DrawUTF8(atlas, font, (char *)utf8, x, y, fg);
         SDL_stack_free(utf8);
     } else {
         SDL_OutOfMemory();
     }
-    return surface;
+    return status;
 }
 
-SDL_Surface *TTF_RenderGlyph_Blended(TTF_Font *font, Uint16 ch, SDL_Color fg)
+int TTF_DrawUTF8(TTF_Atlas *atlas, TTF_Font *font, const char *text, int x, int y, SDL_Color fg)
 {
-    Uint16 ucs2[2] = { ch, 0 };
-    Uint8 utf8[4];
+    TTF_Layout *layout;
+    int i;
 
-    UCS2_to_UTF8(ucs2, utf8);
-    return TTF_RenderUTF8_Blended(font, (char *)utf8, fg);
+    TTF_CHECKPOINTER(atlas, -1);
+    TTF_CHECKPOINTER(font, -1);
+    TTF_CHECKPOINTER(text, -1);
+
+    layout = TTF_FontLayout(font);
+    if ( layout == NULL || Layout_SetText(layout, text) < 0 ) {
+        return -1;
+    }
+
+    ++atlas->clock;
+    atlas->color = fg;
+    for ( i = 0; i < layout->num_glyphs; ++i ) {
+        l_glyph *laid = &layout->glyphs[i];
+        a_glyph *entry = Atlas_Find(atlas, font, laid->ch);
+
+        if ( entry == NULL ) {
+            atlas->num_draws = 0;
+            return -1;
+        }
+        if ( entry->rect.w > 0 && Atlas_AddDraw(atlas, entry, x + laid->x, y) < 0 ) {
+            atlas->num_draws = 0;
+            return -1;
+        }
+    }
+    Atlas_Draw(atlas);
+
+    if ( TTF_HANDLE_STYLE_UNDERLINE(font) ) {
+        Atlas_DrawLine(atlas, font, layout, x, y + TTF_underline_top_row(font));
+    }
+    if ( TTF_HANDLE_STYLE_STRIKETHROUGH(font) ) {
+        Atlas_DrawLine(atlas, font, layout, x, y + TTF_strikethrough_top_row(font));
+    }
+    return 0;
+}
+
+/* Glyphs rendered with different styles, outlines or hinting live side
+   by side in the cache, so switching back and forth does not flush it.
+   UNDERLINE and STRIKETHROUGH do not impact glyph drawing.
+ */
+static void TTF_UpdateGlyphState( TTF_Font* font )
+{
+    font->glyph_state = (Uint32)(font->style & ~TTF_STYLE_NO_GLYPH_CHANGE) |
+                        ((Uint32)TTF_GetFontHinting(font) << 4) |
+                        ((Uint32)font->outline << 8);
 }
 
 void TTF_SetFontStyle( TTF_Font* font, int style )
 {
-    int prev_style = font->style;
     font->style = style | font->face_style;
-
-    /* Flush the cache if the style has changed.
-     * Ignore UNDERLINE which does not impact glyph drawning.
-     * */
-    if ( (font->style | TTF_STYLE_NO_GLYPH_CHANGE ) != ( prev_style | TTF_STYLE_NO_GLYPH_CHANGE )) {
-        Flush_Cache( font );
-    }
+    TTF_UpdateGlyphState( font );
 }
 
 int TTF_GetFontStyle( const TTF_Font* font )
@@ -2149,7 +5345,7 @@ int TTF_GetFontStyle( const TTF_Font* font )
 void TTF_SetFontOutline( TTF_Font* font, int outline )
 {
     font->outline = outline;
-    Flush_Cache( font );
+    TTF_UpdateGlyphState( font );
 }
 
 int TTF_GetFontOutline( const TTF_Font* font )
@@ -2168,7 +5364,7 @@ void TTF_SetFontHinting( TTF_Font* font, int hinting )
     else
         font->hinting = 0;
 
-    Flush_Cache( font );
+    TTF_UpdateGlyphState( font );
 }
 
 int TTF_GetFontHinting( const TTF_Font* font )
@@ -2187,6 +5383,8 @@ void TTF_Quit( void )
     if ( TTF_initialized ) {
         if ( --TTF_initialized == 0 ) {
             FT_Done_FreeType( library );
+            SDL_DestroyMutex( TTF_lock );
+            TTF_lock = NULL;
         }
     }
 }
@@ -2200,7 +5398,7 @@ int TTF_WasInit( void )
 int TTF_GetFontKerningSize(TTF_Font* font, int prev_index, int index)
 {
     FT_Vector delta;
-    FT_Get_Kerning( font->face, prev_index, index, ft_kerning_default, &delta );
+    Get_Kerning( font, prev_index, index, &delta );
     return (delta.x >> 6);
 }
 
@@ -2232,7 +5430,7 @@ int TTF_GetFontKerningSizeGlyphs(TTF_Font *font, Uint16 previous_ch, Uint16 ch)
     }
     prev_index = font->current->index;
 
-    error = FT_Get_Kerning(font->face, prev_index, glyph_index, ft_kerning_default, &delta);
+    error = Get_Kerning( font, prev_index, glyph_index, &delta );
     if (error) {
         TTF_SetFTError("Couldn't get glyph kerning", error);
         return -1;
@@ -88,15 +88,33 @@ typedef struct _TTF_Font TTF_Font;
 /* Initialize the TTF engine - returns 0 if successful, -1 on error */
 extern DECLSPEC int SDLCALL TTF_Init(void);
 
+/* Thread safety:
+ * TTF_Init() and TTF_Quit() must be called from one thread, with no other
+ * SDL_ttf call in progress.  Everything else may be called from any thread
+ * as long as each TTF_Font, and the layouts created on it, is used by one
+ * thread at a time.  Fonts opened from the same file share their face and
+ * take turns using it while loading glyphs, but keep their own size, glyph
+ * cache and style, so threads rendering text should each open, or
+ * duplicate, their own fonts.  A TTF_TextCache may be shared by threads;
+ * its textures must be asked for on the thread using the renderer.
+ */
+
 /* Open a font file and create a font of the specified point size.
  * Some .fon fonts will have several sizes embedded in the file, so the
  * point size becomes the index of choosing which size.  If the value
- * is too high, the last indexed size will be the default. */
+ * is too high, the last indexed size will be the default.
+ * Fonts opened by file name share the file data and the parsed face
+ * with the other sizes open from the same file and face index. */
 extern DECLSPEC TTF_Font * SDLCALL TTF_OpenFont(const char *file, int ptsize);
 extern DECLSPEC TTF_Font * SDLCALL TTF_OpenFontIndex(const char *file, int ptsize, long index);
 extern DECLSPEC TTF_Font * SDLCALL TTF_OpenFontRW(SDL_RWops *src, int freesrc, int ptsize);
 extern DECLSPEC TTF_Font * SDLCALL TTF_OpenFontIndexRW(SDL_RWops *src, int freesrc, int ptsize, long index);
 
+/* Open another font on the face and size of an open font, with the same
+ * style, outline, hinting, kerning and glyph cache size, for use by
+ * another thread.  It must be closed with TTF_CloseFont() as well. */
+extern DECLSPEC TTF_Font * SDLCALL TTF_DuplicateFont(TTF_Font *font);
+
 /* Set and retrieve the font style */
 #define TTF_STYLE_NORMAL        0x00
 #define TTF_STYLE_BOLD          0x01
@@ -146,6 +164,7 @@ extern DECLSPEC char * SDLCALL TTF_FontFaceStyleName(const TTF_Font *font);
 
 /* Check wether a glyph is provided by the font or not */
 extern DECLSPEC int SDLCALL TTF_GlyphIsProvided(const TTF_Font *font, Uint16 ch);
+extern DECLSPEC int SDLCALL TTF_GlyphIsProvided32(const TTF_Font *font, Uint32 ch);
 
 /* Get the metrics (dimensions) of a glyph
    To understand what these metrics mean, here is a useful link:
@@ -154,6 +173,38 @@ extern DECLSPEC int SDLCALL TTF_GlyphIsProvided(const TTF_Font *font, Uint16 ch)
 extern DECLSPEC int SDLCALL TTF_GlyphMetrics(TTF_Font *font, Uint16 ch,
                      int *minx, int *maxx,
                                      int *miny, int *maxy, int *advance);
+extern DECLSPEC int SDLCALL TTF_GlyphMetrics32(TTF_Font *font, Uint32 ch,
+                     int *minx, int *maxx,
+                                     int *miny, int *maxy, int *advance);
+
+/* Set and retrieve the number of glyphs the font keeps rendered.
+   The size is rounded up to a whole number of cache sets, changing it
+   drops every cached glyph.  Glyphs are keyed by codepoint, style,
+   outline and hinting, so switching those does not flush the cache.
+   TTF_SetGlyphCacheSize() returns 0 if successful, -1 on error.
+ */
+extern DECLSPEC int SDLCALL TTF_SetGlyphCacheSize(TTF_Font *font, int size);
+extern DECLSPEC int SDLCALL TTF_GetGlyphCacheSize(const TTF_Font *font);
+
+/* Get the glyph cache counters since the font was opened or the last
+   TTF_ResetGlyphCacheStats().  Any of the pointers may be NULL.
+ */
+extern DECLSPEC void SDLCALL TTF_GetGlyphCacheStats(const TTF_Font *font,
+                     Uint32 *hits, Uint32 *misses, Uint32 *evictions);
+extern DECLSPEC void SDLCALL TTF_ResetGlyphCacheStats(TTF_Font *font);
+
+/* Save the rendered glyphs of a font to a file, and load them back when
+   the same font file is opened at the same size, so those glyphs never
+   go through FreeType.  The file keeps every style, outline and hinting
+   the glyphs were rendered with, saving adds to the glyphs loaded.
+   A file made for another font file, size or FreeType version is
+   refused, the font then renders its glyphs as usual.  Loaded glyphs
+   are used from the mapped file; saving copies them into memory first,
+   so a font can save to the file it loaded.
+   These functions return 0 if successful, -1 on error.
+ */
+extern DECLSPEC int SDLCALL TTF_SaveGlyphCache(TTF_Font *font, const char *file);
+extern DECLSPEC int SDLCALL TTF_LoadGlyphCache(TTF_Font *font, const char *file);
 
 /* Get the dimensions of a rendered string of text */
 extern DECLSPEC int SDLCALL TTF_SizeText(TTF_Font *font, const char *text, int *w, int *h);
@@ -239,6 +290,187 @@ extern DECLSPEC SDL_Surface * SDLCALL TTF_RenderUNICODE_Blended_Wrapped(TTF_Font
 extern DECLSPEC SDL_Surface * SDLCALL TTF_RenderGlyph_Blended(TTF_Font *font,
                         Uint16 ch, SDL_Color fg);
 
+/* A layout is a line of text decoded and positioned once with a given
+   font, so it can be measured, hit-tested and rendered without walking
+   the string again.  It follows style, outline, hinting and kerning
+   changes of its font, and must be freed before the font is closed.
+ */
+typedef struct _TTF_Layout TTF_Layout;
+
+extern DECLSPEC TTF_Layout * SDLCALL TTF_CreateLayout(TTF_Font *font);
+extern DECLSPEC void SDLCALL TTF_FreeLayout(TTF_Layout *layout);
+
+/* Set the text of a layout, returns 0 if successful, -1 on error */
+extern DECLSPEC int SDLCALL TTF_SetLayoutTextUTF8(TTF_Layout *layout, const char *text);
+
+/* Get the dimensions of the rendered layout, as TTF_SizeUTF8() does */
+extern DECLSPEC int SDLCALL TTF_SizeLayout(TTF_Layout *layout, int *w, int *h);
+
+/* Get the x position, in surface pixels, of the caret before the
+   character at the given byte offset of the text.  Offsets past the
+   end give the position after the last character.
+ */
+extern DECLSPEC int SDLCALL TTF_GetLayoutCaretX(TTF_Layout *layout, int offset);
+
+/* Get the byte offset of the character boundary closest to x */
+extern DECLSPEC int SDLCALL TTF_GetLayoutOffsetAtX(TTF_Layout *layout, int x);
+
+/* Render a layout, as the TTF_RenderUTF8_*() functions do */
+extern DECLSPEC SDL_Surface * SDLCALL TTF_RenderLayout_Solid(TTF_Layout *layout,
+                SDL_Color fg);
+extern DECLSPEC SDL_Surface * SDLCALL TTF_RenderLayout_Shaded(TTF_Layout *layout,
+                SDL_Color fg, SDL_Color bg);
+extern DECLSPEC SDL_Surface * SDLCALL TTF_RenderLayout_Blended(TTF_Layout *layout,
+                SDL_Color fg);
+
+/* A text cache keeps rendered strings around, keyed by font, style,
+   colors, render mode and text, and drops the least recently used ones
+   once their pixels take more than max_bytes.
+   Surfaces returned by the cache are shared: they must not be modified,
+   and are released with TTF_ReleaseCachedSurface().  Textures are
+   released with TTF_ReleaseCachedTexture().  Entries still in use are
+   never evicted.
+   Surfaces still held when the cache is cleared live on until they are
+   released; release them before destroying the cache.  Clearing or
+   destroying the cache destroys the textures it created, so do it before
+   destroying their renderer.
+ */
+typedef struct _TTF_TextCache TTF_TextCache;
+
+extern DECLSPEC TTF_TextCache * SDLCALL TTF_CreateTextCache(size_t max_bytes);
+extern DECLSPEC void SDLCALL TTF_ClearTextCache(TTF_TextCache *cache);
+extern DECLSPEC void SDLCALL TTF_DestroyTextCache(TTF_TextCache *cache);
+
+/* Get text rendered as the TTF_RenderUTF8_*() functions do, from the
+   cache if it was rendered before.  With a NULL cache the text is just
+   rendered.
+ */
+extern DECLSPEC SDL_Surface * SDLCALL TTF_CacheUTF8_Solid(TTF_TextCache *cache,
+                TTF_Font *font, const char *text, SDL_Color fg);
+extern DECLSPEC SDL_Surface * SDLCALL TTF_CacheUTF8_Shaded(TTF_TextCache *cache,
+                TTF_Font *font, const char *text, SDL_Color fg, SDL_Color bg);
+extern DECLSPEC SDL_Surface * SDLCALL TTF_CacheUTF8_Blended(TTF_TextCache *cache,
+                TTF_Font *font, const char *text, SDL_Color fg);
+extern DECLSPEC void SDLCALL TTF_ReleaseCachedSurface(TTF_TextCache *cache,
+                SDL_Surface *surface);
+
+/* Get a texture of the text rendered with TTF_RenderUTF8_Blended(), from
+   the cache if it was created before for this renderer.
+ */
+extern DECLSPEC SDL_Texture * SDLCALL TTF_CacheUTF8_Texture(TTF_TextCache *cache,
+                SDL_Renderer *renderer, TTF_Font *font, const char *text, SDL_Color fg);
+extern DECLSPEC void SDLCALL TTF_ReleaseCachedTexture(TTF_TextCache *cache,
+                SDL_Texture *texture);
+
+/* Get the text cache counters and the bytes it holds.  Any of the
+   pointers may be NULL.
+ */
+extern DECLSPEC void SDLCALL TTF_GetTextCacheStats(const TTF_TextCache *cache,
+                Uint32 *hits, Uint32 *misses, Uint32 *evictions, size_t *bytes);
+
+/* Wrapped text is broken into lines once, and only broken again from
+   the first changed paragraph on when its text is set again, so text
+   being edited stays cheap to lay out.  Lines break at CR, LF and CR LF,
+   and at spaces and tabs to fit wrapLength pixels, if it is not 0.
+   It follows the style of its font, and must be freed before the font
+   is closed.
+ */
+typedef struct _TTF_WrappedText TTF_WrappedText;
+
+extern DECLSPEC TTF_WrappedText * SDLCALL TTF_CreateWrappedText(TTF_Font *font, Uint32 wrapLength);
+extern DECLSPEC void SDLCALL TTF_FreeWrappedText(TTF_WrappedText *wrap);
+
+/* Set the text or the width to wrap to, returns 0 or -1 on error */
+extern DECLSPEC int SDLCALL TTF_SetWrappedTextUTF8(TTF_WrappedText *wrap, const char *text);
+extern DECLSPEC int SDLCALL TTF_SetWrappedTextLength(TTF_WrappedText *wrap, Uint32 wrapLength);
+
+/* Get the number of lines, or -1 on error */
+extern DECLSPEC int SDLCALL TTF_GetWrappedTextLines(TTF_WrappedText *wrap);
+
+/* Get the box of a line in the rendered text, and the bytes of the
+   text it shows.  Returns 0, or -1 on error.
+ */
+extern DECLSPEC int SDLCALL TTF_GetWrappedTextLine(TTF_WrappedText *wrap, int line,
+                SDL_Rect *box, int *offset, int *length);
+
+/* Get the dimensions of all the lines rendered */
+extern DECLSPEC int SDLCALL TTF_SizeWrappedText(TTF_WrappedText *wrap, int *w, int *h);
+
+/* Create a 32-bit ARGB surface and render num_lines lines from
+   first_line, or all the lines from it if num_lines is -1.  Each line
+   takes the height of a line box.
+ */
+extern DECLSPEC SDL_Surface * SDLCALL TTF_RenderWrappedText_Blended(TTF_WrappedText *wrap,
+                int first_line, int num_lines, SDL_Color fg);
+
+/* A signed distance field atlas holds one field per glyph of a font,
+   built at the font's size, so text can be drawn sharp at any scale
+   from one set of glyphs.  Open the font at a large size, 32 to 64
+   points, and keep the spread, the distance in pixels the fields reach
+   around the outlines, at 4 to 8.  The atlas follows the style and
+   outline of its font, and must be freed before the font is closed.
+ */
+typedef struct _TTF_SDFAtlas TTF_SDFAtlas;
+
+extern DECLSPEC TTF_SDFAtlas * SDLCALL TTF_CreateSDFAtlas(TTF_Font *font, int spread);
+extern DECLSPEC void SDLCALL TTF_FreeSDFAtlas(TTF_SDFAtlas *atlas);
+
+/* Build the fields of the characters of a text ahead of time */
+extern DECLSPEC int SDLCALL TTF_AddSDFGlyphsUTF8(TTF_SDFAtlas *atlas, const char *text);
+
+/* Get where the field of a character is in the atlas surface, and where
+   its top left corner goes relative to the pen position and the top of
+   the line, at the size of the font.  Returns 0, or -1 on error.
+ */
+extern DECLSPEC int SDLCALL TTF_GetSDFGlyph(TTF_SDFAtlas *atlas, Uint32 ch,
+                SDL_Rect *rect, int *xoffset, int *yoffset);
+
+/* Get the 8-bit atlas surface.  128 is the outline of the glyphs, higher
+   values are inside.  It may be replaced by a larger one when glyphs
+   are added.
+ */
+extern DECLSPEC SDL_Surface * SDLCALL TTF_GetSDFAtlasSurface(TTF_SDFAtlas *atlas);
+
+/* Get the dimensions of text rendered at scale times the font's size */
+extern DECLSPEC int SDLCALL TTF_SizeSDF_UTF8(TTF_SDFAtlas *atlas,
+                const char *text, float scale, int *w, int *h);
+
+/* Create a 32-bit ARGB surface and render the text at scale times the
+   font's size from the distance fields.  This is the reference for
+   shaders drawing the atlas, and serves software rendering.
+ */
+extern DECLSPEC SDL_Surface * SDLCALL TTF_RenderSDF_UTF8(TTF_SDFAtlas *atlas,
+                const char *text, SDL_Color fg, float scale);
+
+/* A glyph atlas keeps the glyphs of any number of fonts in textures of
+   a renderer, so text is drawn straight from them with no surface or
+   texture created per string.  Glyphs are packed into square pages of
+   page_size pixels, up to max_pages of them; when they are all full,
+   the page used least recently is cleared for the new glyphs.  Zero
+   picks 512 pixels and 4 pages.  Only the parts of a page changed
+   since it was last drawn are uploaded.
+   Use an atlas from the thread of its renderer, clear it when the
+   renderer loses its textures, and free it before the renderer.
+ */
+typedef struct _TTF_Atlas TTF_Atlas;
+
+extern DECLSPEC TTF_Atlas * SDLCALL TTF_CreateAtlas(SDL_Renderer *renderer,
+                int page_size, int max_pages);
+extern DECLSPEC void SDLCALL TTF_ClearAtlas(TTF_Atlas *atlas);
+extern DECLSPEC void SDLCALL TTF_FreeAtlas(TTF_Atlas *atlas);
+
+/* Draw text with its top left corner at x, y of the render target, as
+   TTF_RenderText_Blended() and TTF_RenderUTF8_Blended() render it, with
+   one copy per glyph.  Where glyphs overlap they are blended over each
+   other instead of keeping the strongest coverage.  The alpha of fg is
+   not used.
+   Returns 0, or -1 on error.
+ */
+extern DECLSPEC int SDLCALL TTF_DrawText(TTF_Atlas *atlas, TTF_Font *font,
+                const char *text, int x, int y, SDL_Color fg);
+extern DECLSPEC int SDLCALL TTF_DrawUTF8(TTF_Atlas *atlas, TTF_Font *font,
+                const char *text, int x, int y, SDL_Color fg);
+
 /* For compatibility with previous versions, here are the old functions */
 #define TTF_RenderText(font, text, fg, bg)  \
     TTF_RenderText_Shaded(font, text, fg, bg)
@@ -0,0 +1,415 @@
+/*
+  testttf:  Checks of the SDL_ttf library that need no display.
+  Copyright (C) 2001-2016 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/* Render text offscreen and check the results, exiting with the number
+   of failed checks.  Textures are made with the software renderer on a
+   surface, so no window or video driver is needed.
+ */
+
+/* quiet windows compiler warnings */
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "SDL.h"
+#include "SDL_ttf.h"
+
+#define DEFAULT_PTSIZE  18
+#define GLYPH_FILE      "testttf.glyphs"
+#define DEFAULT_TEXT    "The quick brown fox jumped over the lazy dog"
+
+static char *Usage =
+"Usage: %s <font>.ttf [ptsize]\n";
+
+static int failures = 0;
+
+static void check(int ok, const char *what)
+{
+    printf("%s: %s\n", ok ? "pass" : "FAIL", what);
+    if ( !ok ) {
+        ++failures;
+    }
+}
+
+static void test_text_cache(TTF_Font *font, SDL_Renderer *renderer)
+{
+    SDL_Color white = { 0xFF, 0xFF, 0xFF, 0xFF };
+    SDL_Color red = { 0xFF, 0x00, 0x00, 0xFF };
+    TTF_TextCache *cache;
+    SDL_Surface *a, *b, *c;
+    SDL_Texture *ta, *tb;
+    Uint32 hits, misses, evictions;
+    size_t bytes;
+
+    cache = TTF_CreateTextCache(1024 * 1024);
+    check(cache != NULL, "create a text cache");
+    if ( !cache ) {
+        return;
+    }
+
+    a = TTF_CacheUTF8_Blended(cache, font, "Open", white);
+    b = TTF_CacheUTF8_Blended(cache, font, "Open", white);
+    c = TTF_CacheUTF8_Blended(cache, font, "Open", red);
+    check(a && a == b, "the same text comes from the cache");
+    check(c && c != a, "text in another color is rendered again");
+    TTF_GetTextCacheStats(cache, &hits, &misses, NULL, &bytes);
+    check(hits == 1 && misses == 2 && bytes > 0, "surface lookups are counted");
+
+    ta = TTF_CacheUTF8_Texture(cache, renderer, font, "Save", white);
+    tb = TTF_CacheUTF8_Texture(cache, renderer, font, "Save", white);
+    check(ta && ta == tb, "textures are shared");
+    TTF_ReleaseCachedTexture(cache, ta);
+    TTF_ReleaseCachedTexture(cache, tb);
+    TTF_ReleaseCachedSurface(cache, a);
+    TTF_ReleaseCachedSurface(cache, b);
+
+    /* A surface held across a clear stays valid until released */
+    TTF_ClearTextCache(cache);
+    check(c->w > 0 && c->refcount == 1, "held text survives a clear");
+    TTF_ReleaseCachedSurface(cache, c);
+    TTF_DestroyTextCache(cache);
+
+    /* Nothing fits in an empty budget, but what is held stays */
+    cache = TTF_CreateTextCache(0);
+    a = TTF_CacheUTF8_Blended(cache, font, "Open", white);
+    TTF_GetTextCacheStats(cache, NULL, NULL, &evictions, NULL);
+    check(a && evictions == 0, "held text is not evicted");
+    TTF_ReleaseCachedSurface(cache, a);
+    b = TTF_CacheUTF8_Blended(cache, font, "Save", white);
+    TTF_GetTextCacheStats(cache, NULL, NULL, &evictions, &bytes);
+    check(b && evictions == 1, "released text is evicted over budget");
+    TTF_ReleaseCachedSurface(cache, b);
+    TTF_DestroyTextCache(cache);
+}
+
+typedef struct {
+    TTF_TextCache *cache;
+    TTF_Font *font;
+    int failed;
+} cache_thread;
+
+static int SDLCALL CacheThread(void *data)
+{
+    cache_thread *info = (cache_thread *)data;
+    SDL_Color white = { 0xFF, 0xFF, 0xFF, 0xFF };
+    SDL_Surface *surface;
+    int i;
+
+    for ( i = 0; i < 2000; ++i ) {
+        surface = TTF_CacheUTF8_Blended(info->cache, info->font, (i & 1) ? "Open" : "Save", white);
+        if ( surface == NULL || surface->w <= 0 ) {
+            ++info->failed;
+        }
+        TTF_ReleaseCachedSurface(info->cache, surface);
+    }
+    return 0;
+}
+
+static void test_text_cache_threads(TTF_Font *font)
+{
+    cache_thread info[2];
+    SDL_Thread *threads[2];
+    Uint32 hits, misses;
+    int i, failed = 0;
+
+    /* A small budget, so threads evict what the other just released */
+    info[0].cache = TTF_CreateTextCache(1);
+    for ( i = 0; i < 2; ++i ) {
+        info[i].cache = info[0].cache;
+        info[i].font = TTF_DuplicateFont(font);
+        info[i].failed = 0;
+        threads[i] = SDL_CreateThread(CacheThread, "CacheThread", &info[i]);
+    }
+    for ( i = 0; i < 2; ++i ) {
+        SDL_WaitThread(threads[i], NULL);
+        failed += info[i].failed;
+        TTF_CloseFont(info[i].font);
+    }
+    TTF_GetTextCacheStats(info[0].cache, &hits, &misses, NULL, NULL);
+    check(failed == 0 && hits + misses == 4000, "threads share a text cache");
+    TTF_DestroyTextCache(info[0].cache);
+}
+
+/* Add up the alpha of an ARGB surface, the coverage of what is drawn */
+static double coverage(SDL_Surface *surface)
+{
+    double total = 0.0;
+    int x, y;
+
+    for ( y = 0; y < surface->h; ++y ) {
+        const Uint32 *row = (const Uint32 *)((const Uint8 *)surface->pixels + y * surface->pitch);
+        for ( x = 0; x < surface->w; ++x ) {
+            total += (row[x] >> 24) / 255.0;
+        }
+    }
+    return total;
+}
+
+static void test_sdf(TTF_Font *font)
+{
+    SDL_Color white = { 0xFF, 0xFF, 0xFF, 0xFF };
+    TTF_SDFAtlas *atlas;
+    SDL_Surface *sdf, *blended;
+    double a, b;
+
+    atlas = TTF_CreateSDFAtlas(font, 4);
+    check(atlas != NULL, "create an SDF atlas");
+    if ( !atlas ) {
+        return;
+    }
+
+    /* At 1:1 the fields should cover about what the outlines do */
+    sdf = TTF_RenderSDF_UTF8(atlas, "Hamburgefonts", white, 1.0f);
+    blended = TTF_RenderUTF8_Blended(font, "Hamburgefonts", white);
+    check(sdf && blended, "render text from the fields and blended");
+    if ( sdf && blended ) {
+        a = coverage(sdf);
+        b = coverage(blended);
+        check(sdf->w == blended->w && sdf->h == blended->h,
+              "SDF text has the size of blended text");
+        check(b > 0.0 && SDL_fabs(a - b) <= b * 0.05,
+              "SDF text covers what blended text does");
+    }
+    SDL_FreeSurface(sdf);
+    SDL_FreeSurface(blended);
+    TTF_FreeSDFAtlas(atlas);
+}
+
+static void test_wrap(TTF_Font *font)
+{
+    SDL_Color white = { 0xFF, 0xFF, 0xFF, 0xFF };
+    const char *word = "Supercalifragilistic";
+    TTF_WrappedText *wrap;
+    SDL_Surface *wrapped, *single;
+    int offset, length;
+    int x, y, same;
+
+    /* An over-long word gets a line of its own, without the blanks before it */
+    wrap = TTF_CreateWrappedText(font, 40);
+    check(wrap && TTF_SetWrappedTextUTF8(wrap, "   Supercalifragilistic word") == 0,
+          "wrap text with an over-long word");
+    if ( !wrap ) {
+        return;
+    }
+    check(TTF_GetWrappedTextLines(wrap) == 2 &&
+          TTF_GetWrappedTextLine(wrap, 0, NULL, &offset, &length) == 0 &&
+          offset == 3 && length == (int)strlen(word),
+          "an over-long word starts its line");
+    TTF_FreeWrappedText(wrap);
+
+    /* and is cut at the wrap length, not carried into the next row */
+    wrapped = TTF_RenderUTF8_Blended_Wrapped(font, "Supercalifragilistic word", white, 40);
+    single = TTF_RenderUTF8_Blended(font, word, white);
+    check(wrapped && single && wrapped->w == 40 && single->w > 40,
+          "render an over-long word wrapped");
+    if ( wrapped && single ) {
+        same = 1;
+        for ( y = 0; y < single->h; ++y ) {
+            const Uint32 *a = (const Uint32 *)((const Uint8 *)wrapped->pixels + y * wrapped->pitch);
+            const Uint32 *b = (const Uint32 *)((const Uint8 *)single->pixels + y * single->pitch);
+            for ( x = 0; x < wrapped->w; ++x ) {
+                if ( (a[x] >> 24) != (b[x] >> 24) ) {
+                    same = 0;
+                }
+            }
+        }
+        check(same, "an over-long word is clipped to the surface");
+    }
+    SDL_FreeSurface(wrapped);
+    SDL_FreeSurface(single);
+}
+
+/* Draw text from a glyph atlas onto black and check it against blended
+   text blitted there, within rounding.  The target is opaque, so only
+   the colors are compared. */
+static int atlas_matches(TTF_Font *font, SDL_Surface *target, SDL_Renderer *renderer,
+                         int page_size, int max_pages)
+{
+    SDL_Color fg = { 0x40, 0xC0, 0xFF, 0xFF };
+    TTF_Atlas *atlas;
+    SDL_Surface *blended, *expected;
+    SDL_Rect dst = { 10, 20, 0, 0 };
+    int x, y, i, same;
+
+    atlas = TTF_CreateAtlas(renderer, page_size, max_pages);
+    blended = TTF_RenderUTF8_Blended(font, DEFAULT_TEXT, fg);
+    expected = SDL_CreateRGBSurface(0, target->w, target->h, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
+    same = (atlas && blended && expected);
+    if ( same ) {
+        SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0xFF);
+        SDL_RenderClear(renderer);
+        same = (TTF_DrawUTF8(atlas, font, DEFAULT_TEXT, dst.x, dst.y, fg) == 0);
+        SDL_RenderPresent(renderer);
+        SDL_FillRect(expected, NULL, 0xFF000000);
+        SDL_BlitSurface(blended, NULL, expected, &dst);
+    }
+    for ( y = 0; same && y < target->h; ++y ) {
+        const Uint32 *a = (const Uint32 *)((const Uint8 *)target->pixels + y * target->pitch);
+        const Uint32 *b = (const Uint32 *)((const Uint8 *)expected->pixels + y * expected->pitch);
+        for ( x = 0; x < target->w; ++x ) {
+            for ( i = 0; i < 24; i += 8 ) {
+                int diff = (int)((a[x] >> i) & 0xFF) - (int)((b[x] >> i) & 0xFF);
+                if ( diff < -1 || diff > 1 ) {
+                    same = 0;
+                }
+            }
+        }
+    }
+    SDL_FreeSurface(expected);
+    SDL_FreeSurface(blended);
+    TTF_FreeAtlas(atlas);
+    return same;
+}
+
+static void test_atlas(TTF_Font *font, SDL_Surface *target, SDL_Renderer *renderer)
+{
+    check(atlas_matches(font, target, renderer, 0, 0),
+          "atlas text draws as blended text");
+    check(atlas_matches(font, target, renderer, 64, 16),
+          "atlas text spread over several pages draws as blended text");
+    check(atlas_matches(font, target, renderer, 64, 2),
+          "atlas text draws as blended text while pages are recycled");
+}
+
+/* Save the glyph cache, then load it back, and a copy of it with the
+   metrics of a glyph made up */
+static void test_glyph_cache(TTF_Font *font)
+{
+    SDL_Color white = { 0xFF, 0xFF, 0xFF, 0xFF };
+    const char *file = GLYPH_FILE;
+    const char *corrupt = "testttf-corrupt.glyphs";
+    SDL_Surface *before, *after;
+    SDL_RWops *src;
+    Uint8 *data;
+    Sint64 size;
+
+    before = TTF_RenderUTF8_Blended(font, "Glyphs", white);
+    check(before && TTF_SaveGlyphCache(font, file) == 0, "save the glyph cache");
+    check(TTF_LoadGlyphCache(font, file) == 0, "load the glyph cache");
+    after = TTF_RenderUTF8_Blended(font, "Glyphs", white);
+    check(before && after && before->w == after->w && before->h == after->h,
+          "text renders the same from the glyph cache file");
+    SDL_FreeSurface(after);
+
+    /* Saving over the file the glyphs were loaded from keeps them, with
+       the glyph cache emptied so they all come from the file */
+    TTF_SetGlyphCacheSize(font, TTF_GetGlyphCacheSize(font));
+    check(TTF_SaveGlyphCache(font, file) == 0 &&
+          TTF_LoadGlyphCache(font, file) == 0, "save the glyph cache where it was loaded");
+    after = TTF_RenderUTF8_Blended(font, "Glyphs", white);
+    check(before && after && before->w == after->w && before->h == after->h,
+          "text renders the same after saving the glyph cache again");
+    SDL_FreeSurface(before);
+    SDL_FreeSurface(after);
+
+    /* maxx of the first record below its minx */
+    data = NULL;
+    src = SDL_RWFromFile(file, "rb");
+    size = src ? SDL_RWsize(src) : -1;
+    if ( size > 64 ) {
+        data = (Uint8 *)SDL_malloc((size_t)size);
+    }
+    if ( data && SDL_RWread(src, data, (size_t)size, 1) == 1 ) {
+        data[60] = 0x00;
+        data[61] = 0x00;
+        data[62] = 0x00;
+        data[63] = 0x80;
+        SDL_RWclose(src);
+        src = SDL_RWFromFile(corrupt, "wb");
+        if ( src && SDL_RWwrite(src, data, (size_t)size, 1) != 1 ) {
+            SDL_RWclose(src);
+            src = NULL;
+        }
+        if ( src ) {
+            SDL_RWclose(src);
+            check(TTF_LoadGlyphCache(font, corrupt) < 0,
+                  "a glyph cache file with bad metrics is rejected");
+        } else {
+            check(0, "write a corrupt glyph cache file");
+        }
+    } else {
+        check(0, "read the glyph cache file");
+        if ( src ) {
+            SDL_RWclose(src);
+        }
+    }
+    SDL_free(data);
+    remove(corrupt);
+}
+
+int main(int argc, char *argv[])
+{
+    SDL_Surface *target;
+    SDL_Renderer *renderer;
+    TTF_Font *font;
+    int ptsize;
+
+    if ( argc < 2 ) {
+        fprintf(stderr, Usage, argv[0]);
+        return(1);
+    }
+    ptsize = DEFAULT_PTSIZE;
+    if ( argc > 2 && atoi(argv[2]) > 0 ) {
+        ptsize = atoi(argv[2]);
+    }
+
+    if ( SDL_Init(0) < 0 || TTF_Init() < 0 ) {
+        fprintf(stderr, "Couldn't initialize: %s\n", SDL_GetError());
+        return(2);
+    }
+    font = TTF_OpenFont(argv[1], ptsize);
+    if ( font == NULL ) {
+        fprintf(stderr, "Couldn't load %d pt font from %s: %s\n",
+                    ptsize, argv[1], SDL_GetError());
+        TTF_Quit();
+        SDL_Quit();
+        return(2);
+    }
+    target = SDL_CreateRGBSurface(0, 640, 480, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
+    renderer = target ? SDL_CreateSoftwareRenderer(target) : NULL;
+    if ( renderer == NULL ) {
+        fprintf(stderr, "Couldn't create a software renderer: %s\n", SDL_GetError());
+        TTF_CloseFont(font);
+        TTF_Quit();
+        SDL_Quit();
+        return(2);
+    }
+
+    test_text_cache(font, renderer);
+    test_text_cache_threads(font);
+    test_sdf(font);
+    test_wrap(font);
+    test_atlas(font, target, renderer);
+    test_glyph_cache(font);
+
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(target);
+    TTF_CloseFont(font);
+    TTF_Quit();
+    SDL_Quit();
+    remove(GLYPH_FILE);
+    printf("%d failed\n", failures);
+    return(failures);
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
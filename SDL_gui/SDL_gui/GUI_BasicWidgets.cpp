@@ -70,8 +70,10 @@ isDown(false),
 radius(5),
 color(col),
 borderColor(cBlack),
-texImage(NULL)
+texImage(NULL),
+ownImage(true)
 {
+    imageRect.x = imageRect.y = imageRect.w = imageRect.h = 0;
     titleColor = cWhite;
     createTitleTexture();
     
@@ -97,11 +99,26 @@ texImage(NULL)
 
 GUI_Button::~GUI_Button()
 {
-    if( texImage ) {
+    if( texImage && ownImage ) {
         SDL_DestroyTexture( texImage );
     }
 }
 
+void GUI_Button::setImage( SDL_Texture *tex, const SDL_Rect *rect, bool own )
+{
+    if( texImage && ownImage && texImage != tex ) {
+        SDL_DestroyTexture( texImage );
+    }
+    texImage = tex;
+    ownImage = own;
+    if( rect ) {
+        imageRect = *rect;
+    }
+    else {
+        imageRect.x = imageRect.y = imageRect.w = imageRect.h = 0;
+    }
+}
+
 void GUI_Button::draw()
 {
     GUI_WinBase::predraw();
@@ -120,14 +137,22 @@ void GUI_Button::draw()
 
     if( texImage ) {
         int w, h;
-        SDL_QueryTexture(texImage, NULL, NULL, &w, &h);
+        const SDL_Rect *src = NULL;
+        if( imageRect.w > 0 && imageRect.h > 0 ) {
+            src = &imageRect;
+            w = imageRect.w;
+            h = imageRect.h;
+        }
+        else {
+            SDL_QueryTexture(texImage, NULL, NULL, &w, &h);
+        }
         if( isDown )
         {
             w -= 2;
             h -= 2;
         }
         
-        SDL_RenderCopy(GUI_renderer, texImage, NULL, GUI_MakeRect((tw_area.w-w)/2, (tw_area.h-h)/2, w, h));
+        SDL_RenderCopy(GUI_renderer, texImage, src, GUI_MakeRect((tw_area.w-w)/2, (tw_area.h-h)/2, w, h));
     }
     else {
         SDL_RenderCopy(GUI_renderer, titleTexture, NULL, &title_area);
@@ -197,13 +222,12 @@ GUI_WinBase(pw,t,x,y,0,0,cClear),
 cmd(c),
 padding(5),
 text(t),
-text_index(0)
+text_index(0),
+layout(NULL)
 {
     titleColor = cBlack;
-    createTitleTexture();
+    updateText();
     
-    title_area.x = padding;
-    title_area.y = padding;
     if( width == 0 ) {
         tw_area.w = title_area.w+padding*2;
     }
@@ -217,15 +241,46 @@ text_index(0)
 
 GUI_EditText::~GUI_EditText()
 {
-    
+    // the texture is our own, not one from the text cache
+    if( titleTexture ) {
+        SDL_DestroyTexture( titleTexture );
+        titleTexture = NULL;
+    }
+    TTF_FreeLayout( layout );
 }
 
 void GUI_EditText::setText( const char *t )
 {
     text = t;
     text_index = 0;
+    updateText();
+}
+
+void GUI_EditText::updateText()
+{
     title_str = text.c_str();
-    createTitleTexture();
+    if( !layout )
+        layout = TTF_CreateLayout( GUI_title_font );
+    
+    // the text is laid out once per edit, for the texture, the caret and the hit test;
+    // the texture isn't cached, each edit would only fill the text cache
+    if( titleTexture ) {
+        SDL_DestroyTexture( titleTexture );
+        titleTexture = NULL;
+    }
+    title_area.w = 0;
+    title_area.h = TTF_FontHeight( GUI_title_font );
+    if( layout && TTF_SetLayoutTextUTF8( layout, title_str ) == 0 && title_str[0] ) {
+        SDL_Surface *titleSurface = TTF_RenderLayout_Blended( layout, titleColor );
+        if( titleSurface ) {
+            titleTexture = SDL_CreateTextureFromSurface( GUI_renderer, titleSurface );
+            title_area.w = titleSurface->w;
+            title_area.h = titleSurface->h;
+            SDL_FreeSurface( titleSurface );
+        }
+        if( titleTexture == NULL )
+            GUI_Log( "CreateTitle Texture failed.\n" );
+    }
     title_area.x = padding;
     title_area.y = padding;
 }
@@ -240,12 +295,12 @@ void GUI_EditText::draw()
     SDL_RenderCopy(GUI_renderer, titleTexture, NULL, &title_area);
     
     long currentTime = SDL_GetTicks()/500;
-    if( isFocus && (currentTime & 1) ) {
-        int w, h;
-        
-        TTF_SizeUTF8( GUI_title_font, text.substr(0,text_index).c_str(), &w, &h );
-        int x = padding+w;
-        GUI_DrawLine( x, padding, x, tw_area.h-padding, cBlue );
+    if( isFocus && (currentTime & 1) && layout ) {
+        int x = TTF_GetLayoutCaretX( layout, text_index );
+        if( x >= 0 ) {
+            x += padding;
+            GUI_DrawLine( x, padding, x, tw_area.h-padding, cBlue );
+        }
     }
 }
 
@@ -272,44 +327,11 @@ bool GUI_EditText::handleEvents(SDL_Event *ev) {
                 GUI_mouseCapturedWindow = (SDL_Window *)this;
                 SDL_StartTextInput();
             }
-            if( isFocus ) {
+            if( isFocus && layout ) {
                 int xx = padding+tw_area.x;
-                char cc[4];
-                cc[3] = 0;
-                int j=0;
-                for( int i=0; i<text.length(); i++ ) {
-                    unsigned char c = text.at(i);
-                    int ww, hh;
-                    if( (c & 0x80) == 0 ) {
-                        cc[j++] = c;
-                    }
-                    else if( (c & 0xc0) == 0xc0 ) {
-                        cc[j++] = c;
-                        c = text.at(i+j);
-                        while( (c & 0xC0) == 0x80 ) {
-                            cc[j++] = c;
-                            c = text.at(i+j);
-                        }
-                    }
-                    cc[j] = 0;
-                    TTF_SizeUTF8( GUI_title_font, text.substr(0,i+j).c_str(), &ww, &hh );
-                    if( j == 3 ) {
-                        //GUI_Log( "%i %i %02X %02X %02X: %i %i\n", i, j, (int)(unsigned char)cc[0], (int)(unsigned char)cc[1], (int)(unsigned char)cc[2], xx+ww, x );
-                    }
-                    else {
-                        //GUI_Log( "%i %i %s: %i %i\n", i, j, cc, xx+ww, x );
-                    }
-                    if( (xx+ww) > x+4 ) {
-                        text_index = i;
-                        break;
-                    }
-                    else {
-                        text_index = i+1;
-                    }
-                    i += j-1;
-                    //xx += ww;
-                    j = 0;
-                }
+                text_index = TTF_GetLayoutOffsetAtX( layout, x-xx );
+                if( text_index < 0 )
+                    text_index = 0;
                 return true;
             }
             return false;
@@ -346,10 +368,7 @@ bool GUI_EditText::handleEvents(SDL_Event *ev) {
                 }
                 if( oi != text_index ) {
                     text = text.substr(0,text_index)+text.substr(oi);
-                    title_str = text.c_str();
-                    createTitleTexture();
-                    title_area.x = padding;
-                    title_area.y = padding;
+                    updateText();
                 }
             }
             return true;
@@ -359,10 +378,7 @@ bool GUI_EditText::handleEvents(SDL_Event *ev) {
                 return false;
             text.insert( text_index, std::string( ev->text.text ) );
             text_index += strlen(ev->text.text);
-            title_str = text.c_str();
-            createTitleTexture();
-            title_area.x = padding;
-            title_area.y = padding;
+            updateText();
             
             return true;
         }
@@ -431,6 +447,8 @@ void GUI_ListCell::draw()
             title_area.x = 8;
         }
         SDL_RenderCopy(GUI_renderer, titleTexture, NULL, &title_area);
+        // the texture is shared with other widgets showing the same label
+        SDL_SetTextureColorMod( titleTexture, 255, 255, 255 );
 
         if( checked ) {
             SDL_RenderCopy(GUI_renderer, GUI_checkTexture, NULL, GUI_MakeRect(3, 4, 16, 13));
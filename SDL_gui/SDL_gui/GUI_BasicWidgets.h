@@ -38,6 +38,10 @@ struct GUI_Button:GUI_WinBase {
     SDL_Color color;
     SDL_Color borderColor;
     SDL_Texture *texImage;
+    SDL_Rect imageRect;     // part of texImage to draw, all of it when empty
+    bool ownImage;          // false for shared textures, such as atlas pages
+    
+    void setImage( SDL_Texture *tex, const SDL_Rect *rect=NULL, bool own=false );
     
     virtual void draw();
     virtual bool handleEvents( SDL_Event *ev );
@@ -53,11 +57,13 @@ struct GUI_EditText:GUI_WinBase {
     
     std::string text;
     int text_index;
+    TTF_Layout *layout;     // laid out text, shared by the texture, caret and hit test
     
     virtual void draw();
     virtual bool handleEvents( SDL_Event *ev );
     
     void setText( const char *t );
+    void updateText();
 };
 
 struct GUI_ListCell:GUI_WinBase {
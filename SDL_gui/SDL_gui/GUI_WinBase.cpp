@@ -67,7 +67,7 @@ GUI_WinBase::~GUI_WinBase() {
         parent->remove_child(this);
     
     if( titleTexture )
-        SDL_DestroyTexture( titleTexture );
+        TTF_ReleaseCachedTexture( GUI_textCache, titleTexture );
     
 }
 
@@ -117,27 +117,30 @@ void GUI_WinBase::show()
 
 
 void GUI_WinBase::createTitleTexture( int fontSize ) {
-    if( titleTexture )
-        SDL_DestroyTexture( titleTexture );
+    if( titleTexture ) {
+        TTF_ReleaseCachedTexture( GUI_textCache, titleTexture );
+        titleTexture = NULL;
+    }
     
     if( title_str && title_str[0] ) {
         //GUI_Log( title_str );
-        SDL_Surface *titleSurface = TTF_RenderUTF8_Blended( GUI_fonts[fontSize-1], title_str, titleColor );
-        title_area.w = titleSurface->w;
-        title_area.h = titleSurface->h;
-        title_area.x = (tw_area.w-titleSurface->w) / 2;
-        title_area.y = (tw_area.h-titleSurface->h) / 2;
-        
-        titleTexture = SDL_CreateTextureFromSurface(GUI_renderer, titleSurface);
+        // shared with every widget showing the same label, so recreating one costs a lookup
+        titleTexture = TTF_CacheUTF8_Texture( GUI_textCache, GUI_renderer, GUI_fonts[fontSize-1], title_str, titleColor );
         if ( titleTexture == NULL){
             GUI_Log( "CreateTitle Texture failed.\n" );
+            return;
         }
-        SDL_FreeSurface(titleSurface);
+        int w, h;
+        SDL_QueryTexture( titleTexture, NULL, NULL, &w, &h );
+        title_area.w = w;
+        title_area.h = h;
+        title_area.x = (tw_area.w-w) / 2;
+        title_area.y = (tw_area.h-h) / 2;
     }
     else {
-        SDL_Surface *titleSurface = TTF_RenderUTF8_Blended( GUI_title_font, " ", titleColor );
+        SDL_Surface *titleSurface = TTF_CacheUTF8_Blended( GUI_textCache, GUI_title_font, " ", titleColor );
         title_area.h = titleSurface->h;
-        SDL_FreeSurface(titleSurface);
+        TTF_ReleaseCachedSurface( GUI_textCache, titleSurface );
     }
 }
 
@@ -82,6 +82,9 @@ TTF_Font *GUI_mono_font = NULL;
 
 TTF_Font *GUI_fonts[3];
 
+TTF_TextCache *GUI_textCache = NULL;
+IMG_ImageCache *GUI_imageCache = NULL;
+
 SDL_Texture *GUI_crossTexture;
 SDL_Texture *GUI_dropdownTexture;
 SDL_Texture *GUI_checkTexture;
@@ -203,6 +206,12 @@ SDL_Window* GUI_CreateWindow(const char *title, int sx, int sy)
     GUI_fonts[1] = GUI_def_font;
     GUI_fonts[2] = GUI_title_font;
     
+    // rendered labels and titles, shared between widgets
+    GUI_textCache = TTF_CreateTextCache( 4*1024*1024 );
+    
+    // images and icons, kept decoded and uploaded so screens shown again load nothing
+    GUI_imageCache = IMG_CreateImageCache( 16*1024*1024, 64*1024*1024 );
+    
     int osx = sx;
     int osy = sy;
     GUI_Log("requested: %d %d\n", sx, sy);
@@ -247,6 +256,10 @@ SDL_Window* GUI_CreateWindow(const char *title, int sx, int sy)
     
     //Now create a window with title "SDL" at 0, 0 on the screen with w:800 h:600 and show it
     GUI_window = SDL_CreateWindow("SDL", 0, 0, sx, sy, style );
+    if (GUI_window == NULL){
+        // offscreen drivers (dummy) have no GL, the software renderer does not need it
+        GUI_window = SDL_CreateWindow("SDL", 0, 0, sx, sy, style & ~SDL_WINDOW_OPENGL );
+    }
     if (GUI_window == NULL){
         GUI_Log("GUI_CreateRenderer Error");
         return NULL;
@@ -312,6 +325,14 @@ void GUI_Quit( void )
         delete GUI_topWin;
         GUI_topWin = NULL;
     }
+    if( GUI_textCache ) {
+        TTF_DestroyTextCache( GUI_textCache );
+        GUI_textCache = NULL;
+    }
+    if( GUI_imageCache ) {
+        IMG_DestroyImageCache( GUI_imageCache );
+        GUI_imageCache = NULL;
+    }
     if( GUI_window ) {
         SDL_DestroyWindow(GUI_window);
         GUI_window = NULL;
@@ -454,6 +475,15 @@ void doLoop()
 
 }
 
+bool GUI_RunFrame(bool (*user_handle_ev)(SDL_Event *)) {
+    GUI_running=true;
+    user_handle_events = user_handle_ev;
+    quit=false;
+    doLoop();
+    GUI_running = false;
+    return !quit;
+}
+
 void GUI_Run(bool (*user_handle_ev)(SDL_Event *)) {
     GUI_running=true;
 
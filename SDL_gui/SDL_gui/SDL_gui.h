@@ -12,6 +12,7 @@
 #include <stdio.h>
 #include "SDL.h"
 #include "SDL_ttf.h"
+#include "SDL_image.h"
 
 #define MAX(a,b) ((a) > (b) ? a : b)
 #define MIN(a,b) ((a) < (b) ? a : b)
@@ -48,6 +49,7 @@ SDL_Window* GUI_CreateWindow(const char *title="GUI", int sx=0, int sy=0);
 void GUI_Quit( void );
 void GUI_Log( const char * format, ... );
 void GUI_Run( bool (*user_handle_ev)(SDL_Event *) = NULL );
+bool GUI_RunFrame( bool (*user_handle_ev)(SDL_Event *) = NULL ); // one unpaced frame, false on quit
 
 struct GUI_Point {
     short x, y;
@@ -99,6 +101,8 @@ extern SDL_Texture *GUI_crossTexture;
 extern SDL_Texture *GUI_dropdownTexture;
 extern SDL_Texture *GUI_checkTexture;
 extern TTF_Font *GUI_fonts[3];
+extern TTF_TextCache *GUI_textCache;
+extern IMG_ImageCache *GUI_imageCache;
 
 
 extern  Uint32  GUI_EventID;
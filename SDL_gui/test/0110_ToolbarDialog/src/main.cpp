@@ -124,6 +124,7 @@ void cellDraw( GUI_WinBase * w ) {
         c->title_area.x = 8;
     }
     SDL_RenderCopy(GUI_renderer, c->titleTexture, NULL, &c->title_area);
+    SDL_SetTextureColorMod( c->titleTexture, 255, 255, 255 );
     
     if( c->checked ) {
         SDL_RenderCopy(GUI_renderer, GUI_checkTexture, NULL, GUI_MakeRect(3, 4, 16, 13));
@@ -243,7 +244,7 @@ SDL_Texture* loadTexture(const std::string &filename, SDL_Renderer *ren)
     std::string imagePath = GUI_getResourcePath() + filename;
     
     GUI_Log("Load:%s\n", imagePath.c_str() );
-    SDL_Texture *tex = IMG_LoadTexture(ren, imagePath.c_str());
+    SDL_Texture *tex = IMG_CacheLoadTexture(GUI_imageCache, ren, imagePath.c_str(), 0, 0);
     if (tex == NULL){
         GUI_Log( "Load image %s failed.", filename.c_str() );
     }
@@ -354,7 +355,7 @@ main(int argc, char *argv[])
                 }
             }
         );
-        bttnFile->texImage = textureFileIcon;
+        bttnFile->setImage( textureFileIcon );
         bttnFile->color = cClear;
         
         new GUI_Button( topBar, "C", 48, 8, 32, 32, cGrey,
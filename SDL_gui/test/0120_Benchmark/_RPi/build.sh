@@ -0,0 +1 @@
+g++ -o test ../src/main.cpp $SDL_GUI_ROOT/SDL_gui/GUI_utils.cpp $SDL_GUI_ROOT/SDL_gui/GUI_BasicWidgets.cpp $SDL_GUI_ROOT/SDL_gui/GUI_MainWin.cpp $SDL_GUI_ROOT/SDL_gui/GUI_TopWin.cpp $SDL_GUI_ROOT/SDL_gui/GUI_WinBase.cpp $SDL_GUI_ROOT/SDL_gui/SDL_gui.cpp $SDL_GUI_ROOT/SDL_gui/jsFileUtils.cpp `sdl2-config --cflags --libs` -I$SDL_GUI_ROOT/SDL_gui -std=gnu++11 -lSDL2_image -lSDL2_ttf -lboost_filesystem -lboost_system
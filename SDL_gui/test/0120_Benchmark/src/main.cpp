@@ -0,0 +1,675 @@
+//
+//  main.cpp
+//  Benchmark
+//
+//  Headless frame-cost benchmark for SDL_gui.
+//
+//  Runs scripted widget scenes offscreen (SDL_VIDEODRIVER=dummy, software
+//  renderer), optionally replaying an event stream recorded in one of them,
+//  and prints one JSON document with per-frame time percentiles, heap
+//  allocations and the renderer statistics (SDL_RenderGetStats) for each
+//  scene. --trace writes a chrome://tracing file of every renderer backend
+//  call.
+//
+//    test [--scene shapes|windows|widgets|all] [--frames N] [--warmup N]
+//         [--size WxH] [--events file] [--out file|-] [--trace file]
+//    test --record file [--scene name]    (interactive, real video driver)
+//
+//  Event stream files are plain text, one event per line, '#' comments:
+//
+//    <frame> down <button> <x> <y>
+//    <frame> up <button> <x> <y>
+//    <frame> motion <x> <y>
+//    <frame> key <keycode>
+//    <frame> text <utf8>
+//
+//  Events are pushed right before the frame they belong to is run. The
+//  report goes to benchmark.json unless --out says otherwise ('-' is
+//  stdout; GUI_Log() output shares stdout, so prefer a file).
+//
+
+#ifdef _WIN32
+#define _CRT_SECURE_NO_WARNINGS
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <new>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include "SDL_gui.h"
+#include "GUI_TopWin.h"
+#include "GUI_MainWin.h"
+#include "GUI_BasicWidgets.h"
+#include "GUI_utils.h"
+
+/* ---------------------------------------------------------------------- */
+/* Counters                                                               */
+/* ---------------------------------------------------------------------- */
+
+struct BenchCounters {
+    Uint64 allocations;
+    Uint64 allocBytes;
+};
+
+static BenchCounters counters;
+static bool counting = false;
+
+// Every C++ allocation made by SDL_gui goes through here. SDL's own
+// SDL_malloc() calls are not visible to the benchmark.
+void *operator new(size_t size)
+{
+    if( counting ) {
+        ++counters.allocations;
+        counters.allocBytes += size;
+    }
+    void *p = malloc( size ? size : 1 );
+    if( !p )
+        throw std::bad_alloc();
+    return p;
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *p) throw()
+{
+    free( p );
+}
+
+void operator delete[](void *p) throw()
+{
+    free( p );
+}
+
+
+/* ---------------------------------------------------------------------- */
+/* Event streams                                                          */
+/* ---------------------------------------------------------------------- */
+
+struct BenchEvent {
+    int frame;
+    SDL_Event ev;
+};
+
+static void pushMouseButton( std::vector<BenchEvent> &v, int frame, bool down, int button, int x, int y )
+{
+    BenchEvent e;
+    SDL_zero( e.ev );
+    e.frame = frame;
+    e.ev.type = down ? SDL_MOUSEBUTTONDOWN : SDL_MOUSEBUTTONUP;
+    e.ev.button.state = down ? SDL_PRESSED : SDL_RELEASED;
+    e.ev.button.button = button;
+    e.ev.button.clicks = 1;
+    e.ev.button.x = x;
+    e.ev.button.y = y;
+    v.push_back( e );
+}
+
+static void pushMouseMotion( std::vector<BenchEvent> &v, int frame, int x, int y )
+{
+    BenchEvent e;
+    SDL_zero( e.ev );
+    e.frame = frame;
+    e.ev.type = SDL_MOUSEMOTION;
+    e.ev.motion.state = SDL_BUTTON_LMASK;
+    e.ev.motion.x = x;
+    e.ev.motion.y = y;
+    v.push_back( e );
+}
+
+static void pushKey( std::vector<BenchEvent> &v, int frame, SDL_Keycode key )
+{
+    BenchEvent e;
+    SDL_zero( e.ev );
+    e.frame = frame;
+    e.ev.type = SDL_KEYDOWN;
+    e.ev.key.state = SDL_PRESSED;
+    e.ev.key.keysym.sym = key;
+    e.ev.key.keysym.scancode = SDL_GetScancodeFromKey( key );
+    v.push_back( e );
+}
+
+static void pushText( std::vector<BenchEvent> &v, int frame, const char *text )
+{
+    BenchEvent e;
+    SDL_zero( e.ev );
+    e.frame = frame;
+    e.ev.type = SDL_TEXTINPUT;
+    SDL_strlcpy( e.ev.text.text, text, sizeof(e.ev.text.text) );
+    v.push_back( e );
+}
+
+static bool loadEvents( const char *fn, std::vector<BenchEvent> &v )
+{
+    FILE *f = fopen( fn, "r" );
+    if( !f ) {
+        GUI_Log( "Can't open event stream %s\n", fn );
+        return false;
+    }
+    char line[256];
+    int lineNo = 0;
+    while( fgets( line, sizeof(line), f ) ) {
+        ++lineNo;
+        char *p = line;
+        while( *p == ' ' || *p == '\t' )
+            ++p;
+        if( *p == '#' || *p == '\n' || *p == '\r' || *p == 0 )
+            continue;
+        p[strcspn( p, "\r\n" )] = 0;
+
+        int frame, a, b, c, n = 0;
+        char type[16];
+        if( sscanf( p, "%d %15s %n", &frame, type, &n ) < 2 ) {
+            GUI_Log( "%s:%d: malformed event\n", fn, lineNo );
+            fclose( f );
+            return false;
+        }
+        const char *args = p + n;
+        if( !strcmp( type, "down" ) && sscanf( args, "%d %d %d", &a, &b, &c ) == 3 ) {
+            pushMouseButton( v, frame, true, a, b, c );
+        }
+        else if( !strcmp( type, "up" ) && sscanf( args, "%d %d %d", &a, &b, &c ) == 3 ) {
+            pushMouseButton( v, frame, false, a, b, c );
+        }
+        else if( !strcmp( type, "motion" ) && sscanf( args, "%d %d", &a, &b ) == 2 ) {
+            pushMouseMotion( v, frame, a, b );
+        }
+        else if( !strcmp( type, "key" ) && sscanf( args, "%d", &a ) == 1 ) {
+            pushKey( v, frame, a );
+        }
+        else if( !strcmp( type, "text" ) ) {
+            pushText( v, frame, args );
+        }
+        else {
+            GUI_Log( "%s:%d: unknown event '%s'\n", fn, lineNo, type );
+            fclose( f );
+            return false;
+        }
+    }
+    fclose( f );
+    std::stable_sort( v.begin(), v.end(), []( const BenchEvent &l, const BenchEvent &r ) {
+        return l.frame < r.frame;
+    });
+    return true;
+}
+
+static FILE *recordFile = NULL;
+static int recordFrame = 0;
+
+static int recordWatch( void *userdata, SDL_Event *ev )
+{
+    switch( ev->type ) {
+        case SDL_MOUSEBUTTONDOWN:
+        case SDL_MOUSEBUTTONUP:
+            fprintf( recordFile, "%d %s %d %d %d\n", recordFrame,
+                     ev->type == SDL_MOUSEBUTTONDOWN ? "down" : "up",
+                     ev->button.button, ev->button.x, ev->button.y );
+            break;
+        case SDL_MOUSEMOTION:
+            if( ev->motion.state )
+                fprintf( recordFile, "%d motion %d %d\n", recordFrame, ev->motion.x, ev->motion.y );
+            break;
+        case SDL_KEYDOWN:
+            fprintf( recordFile, "%d key %d\n", recordFrame, ev->key.keysym.sym );
+            break;
+        case SDL_TEXTINPUT:
+            fprintf( recordFile, "%d text %s\n", recordFrame, ev->text.text );
+            break;
+    }
+    return 1;
+}
+
+/* ---------------------------------------------------------------------- */
+/* Scenes                                                                 */
+/* ---------------------------------------------------------------------- */
+
+struct BenchScene {
+    const char *name;
+    void (*build)( void );
+    void (*script)( std::vector<BenchEvent> &v, int frames );
+};
+
+// 0080_Shapes: rects, round rects and circles, no interaction.
+static void buildShapes( void )
+{
+    GUI_MainWin *mainWin = new GUI_MainWin(GUI_topWin, "Shapes", 20, 20, GUI_windowWidth-40, GUI_windowHeight-40, cRed, 1,
+        []( GUI_WinBase *w ) {
+            int cx = w->getWidth()/2, cy = w->getHeight()/2;
+
+            GUI_FillRect( cx-310, cy-17,  95, 44, cYellow );
+            GUI_DrawRect( cx-310, cy-17,  95, 44, cGreen );
+            GUI_FillRoundRect( cx-310, cy-17,  95, 44, 22, cCyan );
+            GUI_DrawRoundRect( cx-310, cy-17,  95, 44, 22, cBlack );
+            GUI_FillRoundRect( cx-200, cy-32, 105, 66, 21, cCyan );
+            GUI_DrawRoundRect( cx-200, cy-32, 105, 66, 21, cBlack );
+            GUI_FillRect( cx-80,  cy-40, 160, 80, cYellow );
+            GUI_DrawRect( cx-80,  cy-40, 160, 80, cGreen );
+            GUI_FillRoundRect( cx-80,  cy-40, 160, 80, 20, cCyan );
+            GUI_DrawRoundRect( cx-80,  cy-40, 160, 80, 20, cBlack );
+            GUI_FillRoundRect( cx+95,  cy-32, 106, 66, 20, cCyan );
+            GUI_DrawRoundRect( cx+95,  cy-32, 106, 66, 20, cBlack );
+            GUI_FillRoundRect( cx+215, cy-17,  95, 44, 22, cCyan );
+            GUI_DrawRoundRect( cx+215, cy-17,  95, 44, 22, cBlack );
+
+            GUI_FillCircle( cx, cy-100, 45, cCyan );
+            GUI_DrawCircle( cx, cy-100, 45, cBlack );
+            int r = 45;
+            int ccx = 0;
+            for( int i=0; i<6; i++ ) {
+                ccx += r;
+                r -= 7;
+                ccx += r+6;
+                GUI_FillCircle( cx+ccx, cy-100, r, cCyan );
+                GUI_DrawCircle( cx+ccx, cy-100, r, cBlack );
+                GUI_FillCircle( cx-ccx, cy-100, r, cCyan );
+                GUI_DrawCircle( cx-ccx, cy-100, r, cBlack );
+            }
+            for( int i=0; i<5; i++ ) {
+                GUI_FillRect( cx-310+i*125, cy+60, 95, 60, cCyan );
+                GUI_DrawRect( cx-310+i*125, cy+60, 95, 60, cBlack );
+            }
+        }
+    );
+    mainWin->canClose = false;
+    mainWin->canMove = false;
+}
+
+static void createTestWindows( int x, int y, const char *title, SDL_Color bgcol )
+{
+    GUI_MainWin *mainWin = new GUI_MainWin(GUI_topWin, title, x, y, 320, 240+32, bgcol);
+    mainWin->canClose = false;
+
+    GUI_WinBase *greenWin = new GUI_WinBase(mainWin, "Green", 20, 20, 280, 200, cGreen);
+    greenWin->border = 1;
+    new GUI_WinBase(mainWin, "White", 10, 10, 120, 90, cWhite);
+
+    GUI_WinBase *blueWin = new GUI_WinBase(greenWin, "Blue", 20, 20, 240, 160, cBlue);
+    blueWin->border = 1;
+    new GUI_WinBase(greenWin, "Grey", 10, 10, 120, 90, cGrey);
+    new GUI_WinBase(blueWin, "Yellow", 10, 10, 120, 90, cYellow);
+    new GUI_WinBase(blueWin, "Cyan", 20, 20, 120, 90, cCyan);
+}
+
+// 0090_Windows: overlapping nested windows.
+static void buildWindows( void )
+{
+    createTestWindows( 20, 20, "Red", cRed );
+    createTestWindows( 380, 60, "Dark", cDarkGrey );
+    createTestWindows( 200, 120, "Magenta", cMagenta );
+}
+
+// Drag each window around by its title bar, which also raises it.
+static void scriptWindows( std::vector<BenchEvent> &v, int frames )
+{
+    static const int grab[3][2] = { { 200, 115 }, { 560, 75 }, { 100, 35 } };
+    int frame = 0;
+    for( int w=0; frame<frames; w=(w+1)%3 ) {
+        int x = grab[w][0], y = grab[w][1];
+        pushMouseButton( v, frame++, true, SDL_BUTTON_LEFT, x, y );
+        for( int i=1; i<=20 && frame<frames; i++ )
+            pushMouseMotion( v, frame++, x+(i<=10 ? i : 20-i)*4, y+(i<=10 ? i : 20-i)*2 );
+        pushMouseButton( v, frame++, false, SDL_BUTTON_LEFT, x, y );
+    }
+}
+
+static const char *listItems[] = {
+    "New", "Open...", "---", "Save", "Save As...", "---", "Close", "Quit"
+};
+
+// 0100_EditText / 0110_ToolbarDialog: labels, buttons, edit text and a list.
+static void buildWidgets( void )
+{
+    GUI_MainWin *mainWin = new GUI_MainWin(GUI_topWin, "Widgets", 20, 20, GUI_windowWidth-40, GUI_windowHeight-40, cDarkGrey);
+    mainWin->canClose = false;
+    mainWin->canMove = false;
+
+    for( int i=0; i<6; i++ ) {
+        char s[32];
+        sprintf( s, "Label %d", i );
+        new GUI_Label( mainWin, s, 10, 10+i*24, 120, cBlack );
+    }
+    for( int i=0; i<8; i++ ) {
+        char s[32];
+        sprintf( s, "Button %d", i );
+        new GUI_Button( mainWin, s, 140+(i%4)*90, 10+(i/4)*40, 80, 30, cBlue );
+    }
+    new GUI_EditText( mainWin, "Edit me", 140, 100, 300 );
+    new GUI_List( mainWin, listItems, sizeof(listItems)/sizeof(listItems[0]), 460, 10, 180, 240, 0 );
+}
+
+// Press every button, then type into the edit box.
+static void scriptWidgets( std::vector<BenchEvent> &v, int frames )
+{
+    int frame = 0;
+    while( frame < frames ) {
+        for( int i=0; i<8 && frame<frames; i++ ) {
+            int x = 20+1+140+(i%4)*90+40, y = 20+32+10+(i/4)*40+15;
+            pushMouseButton( v, frame++, true, SDL_BUTTON_LEFT, x, y );
+            pushMouseButton( v, frame++, false, SDL_BUTTON_LEFT, x, y );
+        }
+        if( frame+2 >= frames )
+            break;
+        pushMouseButton( v, frame++, true, SDL_BUTTON_LEFT, 20+1+140+150, 20+32+100+10 );
+        pushMouseButton( v, frame++, false, SDL_BUTTON_LEFT, 20+1+140+150, 20+32+100+10 );
+        for( const char *t = "benchmark"; *t && frame<frames; t++ ) {
+            char s[2] = { *t, 0 };
+            pushText( v, frame++, s );
+        }
+        for( int i=0; i<9 && frame<frames; i++ )
+            pushKey( v, frame++, SDLK_BACKSPACE );
+    }
+}
+
+static const BenchScene scenes[] = {
+    { "shapes",  buildShapes,  NULL },
+    { "windows", buildWindows, scriptWindows },
+    { "widgets", buildWidgets, scriptWidgets },
+};
+static const int numScenes = sizeof(scenes)/sizeof(scenes[0]);
+
+/* ---------------------------------------------------------------------- */
+/* Runner                                                                 */
+/* ---------------------------------------------------------------------- */
+
+struct BenchResult {
+    const char *name;
+    int frames;
+    int events;
+    std::vector<double> frameMs;
+    BenchCounters total;
+    SDL_RenderStats render;
+};
+
+static void addRenderStats( SDL_RenderStats &total, const SDL_RenderStats &frame )
+{
+    total.frames += frame.frames;
+    total.draw_calls += frame.draw_calls;
+    total.state_changes += frame.state_changes;
+    total.textures_created += frame.textures_created;
+    total.textures_destroyed += frame.textures_destroyed;
+    total.texture_uploads += frame.texture_uploads;
+    total.bytes_uploaded += frame.bytes_uploaded;
+    for( int i=0; i<SDL_RENDERSTAT_NUM_CALLS; i++ ) {
+        total.calls[i] += frame.calls[i];
+        total.time_ns[i] += frame.time_ns[i];
+    }
+}
+
+static void beginScene( const BenchScene *scene )
+{
+    new GUI_TopWin( scene->name, GUI_Rect(0,0,GUI_windowWidth,GUI_windowHeight), 0, NULL );
+    scene->build();
+}
+
+static void endScene( void )
+{
+    delete GUI_topWin;
+    GUI_topWin = NULL;
+    GUI_mouseCapturedWindow = NULL;
+    GUI_modalWindow = NULL;
+    SDL_StopTextInput();
+    SDL_FlushEvents( SDL_FIRSTEVENT, SDL_LASTEVENT );
+}
+
+static void runScene( const BenchScene *scene, const std::vector<BenchEvent> *events, int warmup, int frames, BenchResult &res )
+{
+    std::vector<BenchEvent> scripted;
+    if( !events ) {
+        if( scene->script )
+            scene->script( scripted, frames );
+        events = &scripted;
+    }
+
+    beginScene( scene );
+    for( int i=0; i<warmup; i++ )
+        GUI_RunFrame();
+
+    res.name = scene->name;
+    res.frames = frames;
+    res.events = 0;
+    res.frameMs.clear();
+    res.frameMs.reserve( frames );
+    SDL_zero( res.total );
+    SDL_zero( res.render );
+
+    const double toMs = 1000.0 / (double)SDL_GetPerformanceFrequency();
+    size_t next = 0;
+    for( int f=0; f<frames; f++ ) {
+        for( ; next<events->size() && (*events)[next].frame<=f; next++ ) {
+            SDL_Event ev = (*events)[next].ev;
+            SDL_PushEvent( &ev );
+            res.events++;
+        }
+        SDL_zero( counters );
+        counting = true;
+        Uint64 start = SDL_GetPerformanceCounter();
+        GUI_RunFrame();
+        Uint64 end = SDL_GetPerformanceCounter();
+        counting = false;
+
+        res.frameMs.push_back( (double)(end-start) * toMs );
+        SDL_RenderStats frame;
+        SDL_RenderGetStats( GUI_renderer, &frame );
+        addRenderStats( res.render, frame );
+        res.total.allocations += counters.allocations;
+        res.total.allocBytes += counters.allocBytes;
+    }
+    endScene();
+}
+
+static const char *renderCallNames[SDL_RENDERSTAT_NUM_CALLS] = {
+    "create_texture", "destroy_texture", "update_texture", "lock_texture", "unlock_texture",
+    "texture_state", "set_render_target", "update_viewport", "update_clip_rect",
+    "clear", "draw_points", "draw_lines", "fill_rects", "copy", "copy_ex",
+    "read_pixels", "present"
+};
+
+static double percentile( const std::vector<double> &sorted, double p )
+{
+    if( sorted.empty() )
+        return 0;
+    size_t rank = (size_t)(p / 100.0 * sorted.size() + 0.5);
+    if( rank < 1 )
+        rank = 1;
+    if( rank > sorted.size() )
+        rank = sorted.size();
+    return sorted[rank-1];
+}
+
+static void writeJSON( FILE *f, const std::vector<BenchResult> &results )
+{
+    fprintf( f, "{\n" );
+    fprintf( f, "  \"benchmark\": \"SDL_gui\",\n" );
+    fprintf( f, "  \"video_driver\": \"%s\",\n", SDL_GetCurrentVideoDriver() );
+    SDL_RendererInfo info;
+    SDL_GetRendererInfo( GUI_renderer, &info );
+    fprintf( f, "  \"render_driver\": \"%s\",\n", info.name );
+    fprintf( f, "  \"width\": %d,\n  \"height\": %d,\n", GUI_windowWidth, GUI_windowHeight );
+    fprintf( f, "  \"scenes\": [\n" );
+    for( size_t i=0; i<results.size(); i++ ) {
+        const BenchResult &r = results[i];
+        std::vector<double> sorted = r.frameMs;
+        std::sort( sorted.begin(), sorted.end() );
+        double sum = 0;
+        for( size_t j=0; j<sorted.size(); j++ )
+            sum += sorted[j];
+        double n = r.frames ? (double)r.frames : 1.0;
+
+        fprintf( f, "    {\n" );
+        fprintf( f, "      \"name\": \"%s\",\n", r.name );
+        fprintf( f, "      \"frames\": %d,\n", r.frames );
+        fprintf( f, "      \"events\": %d,\n", r.events );
+        fprintf( f, "      \"frame_ms\": { \"min\": %.4f, \"mean\": %.4f, \"p50\": %.4f, \"p90\": %.4f, \"p99\": %.4f, \"max\": %.4f },\n",
+                 sorted.empty() ? 0 : sorted.front(), sum / n,
+                 percentile( sorted, 50 ), percentile( sorted, 90 ), percentile( sorted, 99 ),
+                 sorted.empty() ? 0 : sorted.back() );
+        fprintf( f, "      \"draw_calls\": { \"total\": %u, \"per_frame\": %.2f },\n",
+                 r.render.draw_calls, r.render.draw_calls / n );
+        fprintf( f, "      \"state_changes\": { \"total\": %u, \"per_frame\": %.2f },\n",
+                 r.render.state_changes, r.render.state_changes / n );
+        fprintf( f, "      \"textures\": { \"created\": %u, \"destroyed\": %u, \"uploads\": %u, \"bytes_uploaded\": %llu },\n",
+                 r.render.textures_created, r.render.textures_destroyed, r.render.texture_uploads,
+                 (unsigned long long)r.render.bytes_uploaded );
+        fprintf( f, "      \"backend\": {" );
+        for( int c=0, first=1; c<SDL_RENDERSTAT_NUM_CALLS; c++ ) {
+            if( !r.render.calls[c] )
+                continue;
+            fprintf( f, "%s\n        \"%s\": { \"calls\": %u, \"ms\": %.4f }", first ? "" : ",",
+                     renderCallNames[c], r.render.calls[c], r.render.time_ns[c] / 1000000.0 );
+            first = 0;
+        }
+        fprintf( f, "\n      },\n" );
+        fprintf( f, "      \"allocations\": { \"total\": %llu, \"per_frame\": %.2f, \"bytes\": %llu }\n",
+                 (unsigned long long)r.total.allocations, r.total.allocations / n,
+                 (unsigned long long)r.total.allocBytes );
+        fprintf( f, "    }%s\n", i+1<results.size() ? "," : "" );
+    }
+    fprintf( f, "  ]\n}\n" );
+}
+
+static void usage( const char *argv0 )
+{
+    fprintf( stderr, "usage: %s [--scene shapes|windows|widgets|all] [--frames N] [--warmup N]\n"
+                     "       [--size WxH] [--events file] [--out file|-] [--trace file] [--record file]\n", argv0 );
+}
+
+int
+main(int argc, char *argv[])
+{
+    const char *sceneName = "all";
+    const char *eventsFile = NULL;
+    const char *outFile = "benchmark.json";
+    const char *recordPath = NULL;
+    const char *tracePath = NULL;
+    int frames = 300, warmup = 30;
+    int sx = 720, sy = 405;
+
+    for( int i=1; i<argc; i++ ) {
+        const char *arg = argv[i];
+        const char *val = i+1 < argc ? argv[i+1] : NULL;
+        if( !strcmp( arg, "--scene" ) && val ) { sceneName = val; i++; }
+        else if( !strcmp( arg, "--frames" ) && val ) { frames = atoi( val ); i++; }
+        else if( !strcmp( arg, "--warmup" ) && val ) { warmup = atoi( val ); i++; }
+        else if( !strcmp( arg, "--size" ) && val && sscanf( val, "%dx%d", &sx, &sy ) == 2 ) { i++; }
+        else if( !strcmp( arg, "--events" ) && val ) { eventsFile = val; i++; }
+        else if( !strcmp( arg, "--out" ) && val ) { outFile = val; i++; }
+        else if( !strcmp( arg, "--record" ) && val ) { recordPath = val; i++; }
+        else if( !strcmp( arg, "--trace" ) && val ) { tracePath = val; i++; }
+        else {
+            usage( argv[0] );
+            return 1;
+        }
+    }
+    if( frames <= 0 || warmup < 0 ) {
+        usage( argv[0] );
+        return 1;
+    }
+
+    const BenchScene *only = NULL;
+    if( strcmp( sceneName, "all" ) ) {
+        for( int i=0; i<numScenes; i++ )
+            if( !strcmp( scenes[i].name, sceneName ) )
+                only = &scenes[i];
+        if( !only ) {
+            fprintf( stderr, "unknown scene '%s'\n", sceneName );
+            return 1;
+        }
+    }
+
+    // a recorded stream belongs to the one scene it was recorded in
+    if( eventsFile && !only ) {
+        fprintf( stderr, "--events needs a single --scene\n" );
+        return 1;
+    }
+
+    std::vector<BenchEvent> events;
+    if( eventsFile && !loadEvents( eventsFile, events ) )
+        return 1;
+
+    if( !recordPath ) {
+        // headless unless the caller asked for something else
+        SDL_setenv( "SDL_VIDEODRIVER", "dummy", 0 );
+        SDL_SetHint( SDL_HINT_RENDER_DRIVER, "software" );
+    }
+
+    if (SDL_Init(SDL_INIT_VIDEO|SDL_INIT_TIMER) < 0) {
+        GUI_Log( "Could not initialize SDL: %s\n", SDL_GetError() );
+        return 1;
+    }
+    if (TTF_Init() != 0){
+        GUI_Log( "TTF_Init failed.\n" );
+        SDL_Quit();
+        return 1;
+    }
+    if( GUI_Init() != 0 ) {
+        GUI_Log( "GUI_Init failed.\n" );
+        TTF_Quit();
+        SDL_Quit();
+        return 1;
+    }
+    if( GUI_CreateWindow( "Benchmark", sx, sy ) == NULL ) {
+        GUI_Log( "GUI_CreateWindow Error: %s\n", SDL_GetError() );
+        TTF_Quit();
+        SDL_Quit();
+        return 1;
+    }
+    SCREEN_WIDTH = GUI_windowWidth;
+    SCREEN_HEIGHT = GUI_windowHeight;
+
+    int status = 0;
+    if( recordPath ) {
+        recordFile = fopen( recordPath, "w" );
+        if( !recordFile ) {
+            GUI_Log( "Can't write %s\n", recordPath );
+            status = 1;
+        }
+        else {
+            fprintf( recordFile, "# SDL_gui event stream, scene %s, %dx%d\n",
+                     only ? only->name : scenes[0].name, GUI_windowWidth, GUI_windowHeight );
+            beginScene( only ? only : &scenes[0] );
+            SDL_AddEventWatch( recordWatch, NULL );
+            for( recordFrame=0; GUI_RunFrame(); recordFrame++ )
+                SDL_Delay( 1000/60 );
+            SDL_DelEventWatch( recordWatch, NULL );
+            endScene();
+            fclose( recordFile );
+        }
+    }
+    else {
+        SDL_RenderSetStatsEnabled( GUI_renderer, SDL_TRUE, SDL_TRUE );
+        if( tracePath && SDL_RenderStartTrace( GUI_renderer, tracePath ) < 0 )
+            GUI_Log( "Can't write %s: %s\n", tracePath, SDL_GetError() );
+
+        std::vector<BenchResult> results;
+        for( int i=0; i<numScenes; i++ ) {
+            if( only && only != &scenes[i] )
+                continue;
+            results.push_back( BenchResult() );
+            runScene( &scenes[i], eventsFile ? &events : NULL, warmup, frames, results.back() );
+        }
+
+        FILE *f = strcmp( outFile, "-" ) ? fopen( outFile, "w" ) : stdout;
+        if( !f ) {
+            GUI_Log( "Can't write %s\n", outFile );
+            status = 1;
+        }
+        else {
+            writeJSON( f, results );
+            if( f != stdout )
+                fclose( f );
+        }
+    }
+
+    GUI_Quit();
+    TTF_Quit();
+    SDL_Quit();
+
+    return status;
+}